@@ -8,6 +8,8 @@ set(sources
    src/ConsoleOutput.cpp
    src/Coordinates.cpp
    src/CPUSide.cpp
+   src/DCDOutput.cpp
+   src/DCDSetup.cpp
    src/CalculateEnergy.cpp
    src/CheckpointOutput.cpp
    src/CheckpointSetup.cpp
@@ -24,6 +26,7 @@ set(sources
    src/HistOutput.cpp
    src/InputFileReader.cpp
    src/Main.cpp
+   src/MappedFile.cpp
    src/MoleculeKind.cpp
    src/MoleculeLookup.cpp
    src/Molecules.cpp
@@ -31,17 +34,24 @@ set(sources
    src/MoveSettings.cpp
    src/NoEwald.cpp
    src/OutConst.cpp
+   src/OutputPipeline.cpp
    src/OutputVars.cpp
    src/ParallelTemperingPreprocessor.cpp
    src/ParallelTemperingUtilities.cpp
+   src/PDBFrameIndex.cpp
    src/PDBSetup.cpp
    src/PDBOutput.cpp
    src/PRNGSetup.cpp
    src/PSFOutput.cpp
    src/Reader.cpp
+   src/ReplicaExchange.cpp
+   src/RigidPoses.cpp
    src/Simulation.cpp
    src/StaticVals.cpp
    src/System.cpp
+   src/SystemImage.cpp
+   src/TimeSeriesWriter.cpp
+   src/cbmc/ConformerReservoir.cpp
    src/cbmc/DCCrankShaftAng.cpp
    src/cbmc/DCCrankShaftDih.cpp
    src/cbmc/DCCyclic.cpp
@@ -56,9 +66,11 @@ set(sources
    src/cbmc/DCHedronCycle.cpp
    src/cbmc/DCLinear.cpp
    src/cbmc/DCOnSphere.cpp
+   src/cbmc/DCRigid.cpp
    src/cbmc/DCRotateCOM.cpp
    src/cbmc/DCRotateOnAtom.cpp
    src/cbmc/DCSingle.cpp
+   src/cbmc/TrialLibrary.cpp
    src/cbmc/TrialMol.cpp)
 
 set(headers
@@ -68,6 +80,7 @@ set(headers
    src/CalculateEnergy.h
    src/CBMC.h
    src/CellList.h
+   src/CheckpointConst.h
    src/CheckpointOutput.h
    src/CheckpointSetup.h
    src/Clock.h
@@ -78,6 +91,10 @@ set(headers
    src/Coordinates.h
    src/CoordinateSetup.h
    src/CPUSide.h
+   src/DCDConst.h
+   src/DCDOutput.h
+   src/DCDSetup.h
+   src/DirtyMolecules.h
    src/EnergyTypes.h
    src/EnPartCntSampleOutput.h
    src/EnsemblePreprocessor.h
@@ -101,6 +118,7 @@ set(headers
    src/HistOutput.h
    src/InputAbstracts.h
    src/InputFileReader.h
+   src/MappedFile.h
    src/MersenneTwister.h
    src/MoleculeKind.h
    src/MoleculeLookup.h
@@ -112,16 +130,21 @@ set(headers
    src/NoEwald.h
    src/OutConst.h
    src/OutputAbstracts.h
+   src/OutputPipeline.h
    src/OutputVars.h
    src/ParallelTemperingPreprocessor.h
    src/ParallelTemperingUtilities.h
    src/PDBConst.h
    src/PDBOutput.h
+   src/PDBFrameIndex.h
    src/PDBSetup.h
    src/PRNG.h
    src/PRNGSetup.h
    src/PSFOutput.h
+   src/Quaternion.h
    src/Reader.h
+   src/ReplicaExchange.h
+   src/RigidPoses.h
    src/SeedReader.h
    src/Setup.h
    src/SimEventFrequency.h
@@ -129,9 +152,14 @@ set(headers
    src/StaticVals.h
    src/SubdividedArray.h
    src/System.h
+   src/SystemImage.h
+   src/ThreadSplit.h
+   src/TimeSeriesConst.h
+   src/TimeSeriesWriter.h
    src/TransformMatrix.h
    src/Writer.h
    src/XYZArray.h
+   src/cbmc/ConformerReservoir.h
    src/cbmc/DCComponent.h
    src/cbmc/DCCrankShaftAng.h
    src/cbmc/DCCrankShaftDih.h
@@ -148,12 +176,15 @@ set(headers
    src/cbmc/DCHedronCycle.h
    src/cbmc/DCLinear.h
    src/cbmc/DCOnSphere.h
+   src/cbmc/DCRigid.h
    src/cbmc/DCRotateCOM.h
    src/cbmc/DCRotateOnAtom.h
    src/cbmc/DCSingle.h
+   src/cbmc/TrialLibrary.h
    src/cbmc/TrialMol.h
    src/moves/CFCMC.h
    src/moves/CrankShaft.h
+   src/moves/DelayedAccept.h
    src/moves/IntraMoleculeExchange1.h
    src/moves/IntraMoleculeExchange2.h
    src/moves/IntraMoleculeExchange3.h
@@ -183,6 +214,12 @@ set(libHeaders
 set(libSources
     lib/FloydWarshallCycle.cpp)
 
+set(seriesToolSources
+    src/tools/TimeSeriesTool.cpp)
+
+set(benchmarkSources
+    src/benchmarks/MoleculeLookupBench.cpp)
+
 set(cudaHeaders
     src/GPU/ConstantDefinitionsCUDAKernel.cuh
     src/GPU/CalculateMinImageCUDAKernel.cuh
@@ -74,3 +74,27 @@ if(ENSEMBLE_NPT)
    endif()
 endif()
 
+if(GOMC_TOOLS)
+   #Converts the binary time series output to CSV or summary statistics
+   add_executable(TimeSeriesTool ${seriesToolSources} src/TimeSeriesConst.h)
+   set_target_properties(TimeSeriesTool PROPERTIES 
+      OUTPUT_NAME GOMC_TimeSeries)
+endif()
+
+if(GOMC_BENCHMARKS)
+   #Links the GCMC build without its main, so ShiftMolBox is available
+   set(benchLibSources ${sources})
+   list(REMOVE_ITEM benchLibSources src/Main.cpp)
+   add_executable(MolLookupBench ${benchmarkSources} ${benchLibSources}
+      ${headers} ${libHeaders} ${libSources})
+   set_target_properties(MolLookupBench PROPERTIES 
+      OUTPUT_NAME GOMC_MolLookupBench
+      COMPILE_FLAGS "${GC_flags}")
+   if(WIN32)
+      #needed for hostname
+      target_link_libraries(MolLookupBench ws2_32)
+   endif()
+   if(MPI_FOUND)
+      target_link_libraries(MolLookupBench ${MPI_LIBRARIES})
+   endif()
+endif()
@@ -8,6 +8,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #define LAMBDA_H
 
 #include "BasicTypes.h" //For ulong, uint
+#include <vector>
 
 //Defining lambda class to handle fractional molecule
 class Lambda
@@ -47,6 +48,32 @@ protected:
   bool isFraction[BOX_TOTAL];
 };
 
+//Distinct values of a lambda schedule. Neighboring windows often share
+//a value (lambdaVDW stays at 1 while Coulomb is turned off), so the work
+//that depends on lambda only needs to be done once per distinct value.
+struct LambdaUnique {
+  std::vector<double> value;
+  //position of each state's lambda in value
+  std::vector<uint> index;
+
+  LambdaUnique(const std::vector<double> &lambda) : index(lambda.size())
+  {
+    for(uint s = 0; s < lambda.size(); s++) {
+      uint u = 0;
+      while(u < value.size() && value[u] != lambda[s])
+        u++;
+      if(u == value.size())
+        value.push_back(lambda[s]);
+      index[s] = u;
+    }
+  }
+
+  uint Size() const
+  {
+    return value.size();
+  }
+};
+
 inline void Lambda::Set(const double vdw, const double coulomb, const uint mol,
                         const uint kind, const uint box)
 {
@@ -19,6 +19,8 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 
 void BlockAverage::Init(std::ofstream* file0,
                         std::ofstream* file1,
+                        TimeSeriesWriter* series0,
+                        TimeSeriesWriter* series1,
                         const bool en,
                         const double scale,
                         std::string const& var,
@@ -26,6 +28,8 @@ void BlockAverage::Init(std::ofstream* file0,
 {
   outBlock0 = file0;
   outBlock1 = file1;
+  seriesBlock0 = series0;
+  seriesBlock1 = series1;
   tot = bTot;
   block = new double[tot];
   uintSrc = new uint *[tot];
@@ -52,61 +56,27 @@ void BlockAverage::Sum(void)
       block[b] += *dblSrc[b] * scl;
 }
 
-void BlockAverage::DoWrite(const ulong step, uint precision)
-{
-  if (tot >= 1) {
-    if (outBlock0->is_open()) {
-      if(std::abs(block[0]) > 1e99) {
-        (*outBlock0) << std::right << std::scientific  << std::setprecision(precision - 1) <<
-                     std::setw(OUTPUTWIDTH);
-        (*outBlock0) << block[0];
-      } else {
-        (*outBlock0) << std::right << std::scientific  << std::setprecision(precision) <<
-                     std::setw(OUTPUTWIDTH);
-        (*outBlock0) << block[0];
-      }
-    } else
-      std::cerr << "Unable to write to Box_0 output file" << std::endl;
-  }
-  if (tot >= 2) {
-    if (outBlock1->is_open()) {
-      if(std::abs(block[0]) > 1e99) {
-        (*outBlock1) << std::right << std::scientific  << std::setprecision(precision - 1) <<
-                     std::setw(OUTPUTWIDTH);
-        (*outBlock1) << block[1];
-      } else {
-        (*outBlock1) << std::right << std::scientific  << std::setprecision(precision) <<
-                     std::setw(OUTPUTWIDTH);
-        (*outBlock1) << block[1];
-      }
-    } else
-      std::cerr << "Unable to write to Box_1 output file" << std::endl;
-  }
-  Zero();
-}
-
 void BlockAverages::Init(pdb_setup::Atoms const& atoms,
                          config_setup::Output const& output)
 {
-#if GOMC_LIB_MPI
-  std::string name = pathToReplicaOutputDirectory + "Blk_" + uniqueName + "_BOX_0.dat";
-#else
-  std::string name = "Blk_" + uniqueName + "_BOX_0.dat";
-#endif
-  outBlock0.open(name.c_str(), std::ofstream::out);
+  std::string name = pathToReplicaOutputDirectory + "Blk_" + uniqueName + "_BOX_0";
+  if(output.statistics.format.text)
+    outBlock0.open((name + ".dat").c_str(), std::ofstream::out);
+  if(output.statistics.format.binary)
+    seriesBlock0.Open(name + ".bin");
   if(BOXES_WITH_U_NB >= 2) {
-#if GOMC_LIB_MPI
-    name = pathToReplicaOutputDirectory + "Blk_" + uniqueName + "_BOX_1.dat";
-#else
-    name = "Blk_" + uniqueName + "_BOX_1.dat";
-#endif
-    outBlock1.open(name.c_str(), std::ofstream::out);
+    name = pathToReplicaOutputDirectory + "Blk_" + uniqueName + "_BOX_1";
+    if(output.statistics.format.text)
+      outBlock1.open((name + ".dat").c_str(), std::ofstream::out);
+    if(output.statistics.format.binary)
+      seriesBlock1.Open(name + ".bin");
   }
   InitVals(output.statistics.settings.block);
   AllocBlocks();
   InitWatchSingle(output.statistics.vars);
   InitWatchMulti(output.statistics.vars);
-  outBlock0 << std::endl;
+  if(outBlock0.is_open())
+    outBlock0 << std::endl;
   if(outBlock1.is_open())
     outBlock1 << std::endl;
 }
@@ -131,45 +101,96 @@ void BlockAverages::Sample(const ulong step)
 
 void BlockAverages::DoOutput(const ulong step)
 {
-  ulong nextStep = step + 1;
-  outBlock0 << std::left << std::scientific << std::setw(OUTPUTWIDTH) << nextStep;
-  outBlock1 << std::left << std::scientific << std::setw(OUTPUTWIDTH) << nextStep;
-  for (uint v = 0; v < totalBlocks; ++v) {
-    if(v < out::TOTAL_SINGLE)
-      blocks[v].Write(nextStep, firstPrint, 8);
-    else
-      blocks[v].Write(nextStep, firstPrint, 8);
+  BlockRow & row = rows[nextRow];
+  nextRow = 1 - nextRow;
+  pipeline.Acquire(row);
+  row.step = step + 1;
+  row.flush = false;
+  row.values[0].clear();
+  row.values[1].clear();
+  for (uint v = 0; v < totalBlocks; ++v)
+    blocks[v].Collect(row.values);
+  pipeline.Submit(row);
+}
+
+void BlockAverages::FlushSeries(void)
+{
+  BlockRow & row = rows[nextRow];
+  nextRow = 1 - nextRow;
+  pipeline.Acquire(row);
+  row.flush = true;
+  pipeline.Submit(row);
+}
+
+void BlockRow::Write()
+{
+  out->WriteRow(*this);
+}
+
+void BlockAverages::WriteRow(BlockRow const& row)
+{
+  if (row.flush) {
+    seriesBlock0.Flush();
+    seriesBlock1.Flush();
+    return;
   }
-  outBlock0 << std::endl;
-  if(outBlock1.is_open())
-    outBlock1 << std::endl;
+  std::ofstream * file[2] = {&outBlock0, &outBlock1};
+  TimeSeriesWriter * series[2] = {&seriesBlock0, &seriesBlock1};
+  for (uint b = 0; b < 2; ++b) {
+    if (file[b]->is_open()) {
+      (*file[b]) << std::left << std::scientific << std::setw(OUTPUTWIDTH)
+                 << row.step;
+      for (uint v = 0; v < row.values[b].size(); ++v)
+        WriteValue(*file[b], row.values[b][v]);
+      (*file[b]) << std::endl;
+    } else if (!row.values[b].empty() && !series[b]->IsOpen()) {
+      std::cerr << "Unable to write to Box_" << b << " output file"
+                << std::endl;
+    }
+    series[b]->Add(row.step);
+    for (uint v = 0; v < row.values[b].size(); ++v)
+      series[b]->Add(row.values[b][v]);
+    series[b]->EndRow();
+  }
+}
+
+void BlockAverages::WriteValue(std::ofstream & file, const double value)
+{
+  //one digit less keeps three digit exponents in the column width
+  const uint precision = 8;
+  file << std::right << std::scientific << std::setw(OUTPUTWIDTH)
+       << std::setprecision(std::abs(value) > 1e99 ? precision - 1 : precision)
+       << value;
 }
 
 void BlockAverages::InitWatchSingle(config_setup::TrackedVars const& tracked)
 {
-  outBlock0 << std::left << std::scientific << std::setw(OUTPUTWIDTH) << "#STEPS";
+  if(outBlock0.is_open())
+    outBlock0 << std::left << std::scientific << std::setw(OUTPUTWIDTH) << "#STEPS";
   if(outBlock1.is_open())
     outBlock1 << std::left << std::scientific << std::setw(OUTPUTWIDTH) << "#STEPS";
+  seriesBlock0.AddColumn("STEPS");
+  seriesBlock1.AddColumn("STEPS");
   //Note: The order of Init should be same as order of SetRef
-  blocks[out::ENERGY_TOTAL_IDX].Init(&outBlock0, &outBlock1, tracked.energy.block, invSteps, out::ENERGY_TOTAL, BOXES_WITH_U_NB);
-  blocks[out::ENERGY_INTER_IDX].Init(&outBlock0, &outBlock1, tracked.energy.block, invSteps, out::ENERGY_INTER, BOXES_WITH_U_NB);
-  blocks[out::ENERGY_TC_IDX].Init(&outBlock0, &outBlock1, tracked.energy.block, invSteps, out::ENERGY_TC, BOXES_WITH_U_NB);
-  blocks[out::ENERGY_INTRA_B_IDX].Init(&outBlock0, &outBlock1, tracked.energy.block, invSteps, out::ENERGY_INTRA_B, BOXES_WITH_U_NB);
-  blocks[out::ENERGY_INTRA_NB_IDX].Init(&outBlock0, &outBlock1, tracked.energy.block, invSteps, out::ENERGY_INTRA_NB, BOXES_WITH_U_NB);
-  blocks[out::ENERGY_ELECT_IDX].Init(&outBlock0, &outBlock1, tracked.energy.block, invSteps, out::ENERGY_ELECT, BOXES_WITH_U_NB);
-  blocks[out::ENERGY_REAL_IDX].Init(&outBlock0, &outBlock1, tracked.energy.block, invSteps, out::ENERGY_REAL, BOXES_WITH_U_NB);
-  blocks[out::ENERGY_RECIP_IDX].Init(&outBlock0, &outBlock1, tracked.energy.block, invSteps, out::ENERGY_RECIP, BOXES_WITH_U_NB);
-  blocks[out::VIRIAL_TOTAL_IDX].Init(&outBlock0, &outBlock1, tracked.pressure.block, invSteps, out::VIRIAL_TOTAL, BOXES_WITH_U_NB);
-  blocks[out::PRESSURE_IDX].Init(&outBlock0, &outBlock1, tracked.pressure.block, invSteps, out::PRESSURE, BOXES_WITH_U_NB);
-  blocks[out::MOL_NUM_IDX].Init(&outBlock0, &outBlock1, tracked.molNum.block, invSteps, out::MOL_NUM, BOXES_WITH_U_NB);
-  blocks[out::DENSITY_IDX].Init(&outBlock0, &outBlock1, tracked.density.block, invSteps, out::DENSITY, BOXES_WITH_U_NB);
-  blocks[out::SURF_TENSION_IDX].Init(&outBlock0, &outBlock1, tracked.surfaceTension.block, invSteps, out::SURF_TENSION, BOXES_WITH_U_NB);
+  blocks[out::ENERGY_TOTAL_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.energy.block, invSteps, out::ENERGY_TOTAL, BOXES_WITH_U_NB);
+  blocks[out::ENERGY_INTER_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.energy.block, invSteps, out::ENERGY_INTER, BOXES_WITH_U_NB);
+  blocks[out::ENERGY_TC_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.energy.block, invSteps, out::ENERGY_TC, BOXES_WITH_U_NB);
+  blocks[out::ENERGY_INTRA_B_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.energy.block, invSteps, out::ENERGY_INTRA_B, BOXES_WITH_U_NB);
+  blocks[out::ENERGY_INTRA_NB_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.energy.block, invSteps, out::ENERGY_INTRA_NB, BOXES_WITH_U_NB);
+  blocks[out::ENERGY_ELECT_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.energy.block, invSteps, out::ENERGY_ELECT, BOXES_WITH_U_NB);
+  blocks[out::ENERGY_REAL_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.energy.block, invSteps, out::ENERGY_REAL, BOXES_WITH_U_NB);
+  blocks[out::ENERGY_RECIP_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.energy.block, invSteps, out::ENERGY_RECIP, BOXES_WITH_U_NB);
+  blocks[out::VIRIAL_TOTAL_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.pressure.block, invSteps, out::VIRIAL_TOTAL, BOXES_WITH_U_NB);
+  blocks[out::PRESSURE_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.pressure.block, invSteps, out::PRESSURE, BOXES_WITH_U_NB);
+  blocks[out::MOL_NUM_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.molNum.block, invSteps, out::MOL_NUM, BOXES_WITH_U_NB);
+  blocks[out::DENSITY_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.density.block, invSteps, out::DENSITY, BOXES_WITH_U_NB);
+  blocks[out::SURF_TENSION_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.surfaceTension.block, invSteps, out::SURF_TENSION, BOXES_WITH_U_NB);
 #if ENSEMBLE == GEMC
-  blocks[out::VOLUME_IDX].Init(&outBlock0, &outBlock1, tracked.volume.block, invSteps, out::VOLUME, BOXES_WITH_U_NB);
-  blocks[out::HEAT_OF_VAP_IDX].Init(&outBlock0, &outBlock1, tracked.energy.block, invSteps, out::HEAT_OF_VAP, BOXES_WITH_U_NB);
+  blocks[out::VOLUME_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.volume.block, invSteps, out::VOLUME, BOXES_WITH_U_NB);
+  blocks[out::HEAT_OF_VAP_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.energy.block, invSteps, out::HEAT_OF_VAP, BOXES_WITH_U_NB);
 #endif
 #if ENSEMBLE == NPT
-  blocks[out::VOLUME_IDX].Init(&outBlock0, &outBlock1, tracked.volume.block, invSteps, out::VOLUME, BOXES_WITH_U_NB);
+  blocks[out::VOLUME_IDX].Init(&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.volume.block, invSteps, out::VOLUME, BOXES_WITH_U_NB);
 #endif
 
   //Note: The order of Init should be same as order of Init
@@ -213,7 +234,7 @@ void BlockAverages::InitWatchMulti(config_setup::TrackedVars const& tracked)
     if (var->numKinds > 1) {
       name = out::MOL_FRACTION + "_" + trimKindName;
       blocks[bkStart + out::MOL_FRACTION_IDX * var->numKinds].Init
-      (&outBlock0, &outBlock1, tracked.molNum.block, invSteps, name, BOXES_WITH_U_NB);
+      (&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.molNum.block, invSteps, name, BOXES_WITH_U_NB);
     }
     for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
       uint kArrIdx = b * var->numKinds + k;
@@ -234,7 +255,7 @@ void BlockAverages::InitWatchMulti(config_setup::TrackedVars const& tracked)
       //Init mol density
       name = out::MOL_DENSITY + "_" + trimKindName;
       blocks[bkStart + out::MOL_DENSITY_IDX * var->numKinds].Init
-      (&outBlock0, &outBlock1, tracked.molNum.block, invSteps, name, BOXES_WITH_U_NB);
+      (&outBlock0, &outBlock1, &seriesBlock0, &seriesBlock1, tracked.molNum.block, invSteps, name, BOXES_WITH_U_NB);
     }
     for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
       uint kArrIdx = b * var->numKinds + k;
@@ -252,15 +273,17 @@ void BlockAverage::printTitle(std::string output, uint boxes)
   if(tot >= 1) {
     if((*outBlock0).is_open()) {
       (*outBlock0) << std::left << std::scientific << std::setw(OUTPUTWIDTH) << output;
-    } else {
+    } else if(!seriesBlock0->IsOpen()) {
       std::cerr << "Unable to write to Block_0 output file!" << std::endl;
     }
+    seriesBlock0->AddColumn(output);
   }
   if(tot >= 2) {
     if((*outBlock1).is_open()) {
       (*outBlock1) << std::left << std::scientific << std::setw(OUTPUTWIDTH) << output;
-    } else {
+    } else if(!seriesBlock1->IsOpen()) {
       std::cerr << "Unable to write to Block_1 output file!" << std::endl;
     }
+    seriesBlock1->AddColumn(output);
   }
 }
\ No newline at end of file
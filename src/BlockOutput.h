@@ -21,10 +21,27 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "PDBSetup.h" //For atoms class.
 #include "BoxDimensions.h" //For BOXES_WITH_VOLUME
 #include "BoxDimensionsNonOrth.h"
+#include "TimeSeriesWriter.h"
+#include "OutputPipeline.h"
 
 #include <limits> //for std::numeric_limits
 
 class System;
+struct BlockAverages;
+
+//Block averages of one output step. They are taken on the simulation
+//thread and formatted by the output pipeline.
+struct BlockRow : OutputJob {
+  BlockRow() : out(NULL), flush(false) {}
+  virtual void Write();
+
+  BlockAverages * out;
+  ulong step;
+  //no values, only writes the rows buffered for the binary files
+  bool flush;
+  //average of each enabled block, for the file of each box
+  std::vector<double> values[2];
+};
 
 struct BlockAverage {
   BlockAverage(): enable(false), block(NULL), uintSrc(NULL), dblSrc(NULL) {}
@@ -43,6 +60,8 @@ struct BlockAverage {
   //Initializes name, and enable
   void Init(std::ofstream *file0,
             std::ofstream *file1,
+            TimeSeriesWriter *series0,
+            TimeSeriesWriter *series1,
             const bool en,
             const double scl,
             std::string const& var,
@@ -60,11 +79,14 @@ struct BlockAverage {
     dblSrc[b] = NULL;
   }
   void Sum(void);
-  void Write(const ulong step, const bool firstPrint, uint precision)
+  //Appends the averages to the values of each box and starts a new block
+  void Collect(std::vector<double> * values)
   {
-    first = firstPrint;
-    if (enable)
-      DoWrite(step, precision);
+    if (!enable)
+      return;
+    for (uint b = 0; b < tot; ++b)
+      values[b].push_back(block[b]);
+    Zero();
   }
 
 private:
@@ -74,12 +96,12 @@ private:
       block[b] = 0.0;
     samples = 0;
   }
-  void DoWrite(const ulong step, uint precision);
   void printTitle(std::string output, uint boxes);
 
   std::ofstream* outBlock0;
   std::ofstream* outBlock1;
-  bool first;
+  TimeSeriesWriter* seriesBlock0;
+  TimeSeriesWriter* seriesBlock1;
   std::string name, varName;
   uint ** uintSrc, tot;
   double ** dblSrc;
@@ -89,12 +111,12 @@ private:
 };
 /**********************************************************************/
 struct BlockAverages : OutputableBase {
-  BlockAverages(): blocks(NULL) {}
-
-  BlockAverages(OutputVars & v)
+  BlockAverages(OutputVars & v, OutputPipeline & pipe) : pipeline(pipe),
+    nextRow(0)
   {
     this->var = &v;
     blocks = NULL;
+    rows[0].out = rows[1].out = this;
   }
 
   ~BlockAverages(void)
@@ -115,8 +137,17 @@ struct BlockAverages : OutputableBase {
 
   virtual void Sample(const ulong step);
   virtual void DoOutput(const ulong step);
+  //Writes the rows buffered for the binary files, after the rows queued
+  //before
+  void FlushSeries(void);
 
 private:
+  friend struct BlockRow;
+
+  //Formats and writes a row, on the pipeline thread
+  void WriteRow(BlockRow const& row);
+  void WriteValue(std::ofstream & file, const double value);
+
   void InitVals(config_setup::EventSettings const& event)
   {
     stepsPerOut = event.frequency;
@@ -129,6 +160,13 @@ private:
 
   std::ofstream outBlock0;
   std::ofstream outBlock1;
+  //Binary copies of the files, for StatisticsFormat BINARY or BOTH
+  TimeSeriesWriter seriesBlock0;
+  TimeSeriesWriter seriesBlock1;
+  OutputPipeline & pipeline;
+  //double buffer, one row is filled while the other is written
+  BlockRow rows[2];
+  uint nextRow;
   //Block vars
   BlockAverage * blocks;
   uint numKindBlocks, totalBlocks;
@@ -9,7 +9,8 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "MolSetup.h"
 #include "DCLinear.h"
 #include "DCGraph.h"
-#include "DCCyclic.h"
+#include "DCCyclic.h"
+#include "DCRigid.h"
 #include <vector>
 
 
@@ -17,7 +18,7 @@ namespace cbmc
 {
 
 CBMC* MakeCBMC(System& sys, const Forcefield& ff,
-               const MoleculeKind& kind, const Setup& set)
+               const MoleculeKind& kind, const Setup& set, PRNG* prng)
 {
 
   std::vector<uint> bondCount(kind.NumAtoms(), 0);
@@ -28,13 +29,15 @@ CBMC* MakeCBMC(System& sys, const Forcefield& ff,
 
   bool cyclic = (kind.NumBonds() > kind.NumAtoms() - 1) ? true : false;
 
-  if(cyclic) {
-    return new DCCyclic(sys, ff, kind, set);
+  if(kind.IsRigid()) {
+    return new DCRigid(sys, ff, kind, set, prng);
+  } else if(cyclic) {
+    return new DCCyclic(sys, ff, kind, set, prng);
   } else if (kind.NumAtoms() > 2) {
     //Any molecule woth 3 atoms and more will be built in DCGraph
-    return new DCGraph(sys, ff, kind, set);
+    return new DCGraph(sys, ff, kind, set, prng);
   } else {
-    return new DCLinear(sys, ff, kind, set);
+    return new DCLinear(sys, ff, kind, set, prng);
   }
 }
 
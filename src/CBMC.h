@@ -21,6 +21,7 @@ class Forcefield;
 class MoleculeKind;
 class Setup;
 class System;
+class PRNG;
 
 namespace cbmc
 {
@@ -58,8 +59,10 @@ public:
 //Max allowed bonds to any atom
 static const uint MAX_BONDS = 6;
 //Factory function, determines, prepares and returns appropriate CBMC
+//The builder draws from prng, or from the system PRNG if it is NULL
 CBMC* MakeCBMC(System& sys, const Forcefield& ff,
-               const MoleculeKind& kind, const Setup& set);
+               const MoleculeKind& kind, const Setup& set,
+               PRNG* prng = NULL);
 }
 
 
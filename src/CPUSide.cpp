@@ -9,26 +9,36 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "CPUSide.h" //Spec declaration
 
 CPUSide::CPUSide(System & sys, StaticVals & statV) :
-  varRef(sys, statV), pdb(sys, statV), console(varRef), block(varRef),
-  hist(varRef), checkpoint(sys, statV)
+  varRef(sys, statV), console(varRef), pdb(sys, statV, pipeline),
+  dcd(sys, statV, pipeline), block(varRef, pipeline), hist(varRef, pipeline),
+  checkpoint(sys, statV, pipeline)
 #if ENSEMBLE == GCMC
-  , sample_N_E(varRef)
+  , sample_N_E(varRef, pipeline)
 #endif
 #if ENSEMBLE == NVT || ENSEMBLE == NPT
-  , freeEnergy(varRef, sys)
+  , freeEnergy(varRef, sys, pipeline)
 #endif
 {}
 
+CPUSide::~CPUSide()
+{
+  Flush();
+}
+
 void CPUSide::Init(PDBSetup const& pdbSet, config_setup::Output const& out,
                    const ulong tillEquil, const ulong totSteps, ulong startStep)
 {
   equilSteps = tillEquil;
+  restartFreq = out.restart.settings.enable ? out.restart.settings.frequency : 0;
+  checkpointFreq = out.checkpoint.enable ? out.checkpoint.frequency : 0;
   //Initialize arrays in object that collects references and calc'ed vals.
   varRef.Init(pdbSet.atoms);
   //Initialize output components.
   timer.Init(out.console.frequency, totSteps, startStep);
+  pipeline.Init(out.async);
   outObj.push_back(&console);
   outObj.push_back(&pdb);
+  outObj.push_back(&dcd);
   if (out.statistics.settings.block.enable)
     outObj.push_back(&block);
   if (out.checkpoint.enable)
@@ -54,5 +64,21 @@ void CPUSide::Output(const ulong step)
   //Do standard output events.
   for (uint o = 0; o < outObj.size(); o++)
     outObj[o]->Output(step);
+  if((restartFreq != 0 && (step + 1) % restartFreq == 0) ||
+      (checkpointFreq != 0 && (step + 1) % checkpointFreq == 0)) {
+    block.FlushSeries();
+#if ENSEMBLE == GCMC
+    sample_N_E.FlushSeries();
+#endif
+#if ENSEMBLE == NVT || ENSEMBLE == NPT
+    freeEnergy.FlushSeries();
+#endif
+  }
   timer.CheckTime(step);
 }
+
+void CPUSide::Flush(void)
+{
+  pipeline.Flush();
+  checkpoint.Flush();
+}
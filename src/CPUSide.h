@@ -11,6 +11,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "Clock.h"
 #include "ConsoleOutput.h"
 #include "PDBOutput.h"
+#include "DCDOutput.h"
 #include "BlockOutput.h"
 #include "HistOutput.h"
 #include "ConfigSetup.h"
@@ -18,6 +19,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "CheckpointOutput.h"
 #include "EnPartCntSampleOutput.h"
 #include "FreeEnergyOutput.h"
+#include "OutputPipeline.h"
 
 #include <vector>
 
@@ -27,16 +29,26 @@ class OutputableBase;
 
 struct CPUSide {
   CPUSide(System & sys, StaticVals & statV);
+  ~CPUSide();
   void Init(PDBSetup const& pdbSet, config_setup::Output const& out,
             const ulong tillEquil, const ulong totSteps, ulong startStep);
   void Output(const ulong step);
+  //Waits until all output is written
+  void Flush(void);
 
   ulong equilSteps;
 private:
   Clock timer;
   std::vector<OutputableBase *> outObj;
+  //Binary statistics are flushed with each restart file and checkpoint, 0
+  //if disabled
+  ulong restartFreq, checkpointFreq;
+  //Declared before the outputs that use them, so they outlive them
+  OutputPipeline pipeline;
+  OutputVars varRef;
   ConsoleOutput console;
   PDBOutput pdb;
+  DCDOutput dcd;
   BlockAverages block;
   Histogram hist;
   CheckpointOutput checkpoint;
@@ -46,7 +58,6 @@ private:
 #if ENSEMBLE == NVT || ENSEMBLE == NPT
   FreeEnergyOutput freeEnergy;
 #endif
-  OutputVars varRef;
 };
 
 #endif /*CPU_SIDE_H*/
@@ -22,7 +22,12 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "TrialMol.h"
 #include "GeomLib.h"
 #include "NumLib.h"
+#include "../lib/Lambda.h"
 #include <cassert>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #ifdef GOMC_CUDA
 #include "CalculateEnergyCUDAKernel.cuh"
 #include "CalculateForceCUDAKernel.cuh"
@@ -60,6 +65,7 @@ CalculateEnergy::CalculateEnergy(StaticVals & stat, System & sys) :
 #endif
   , cellList(sys.cellList)
 {
+  idealGas = false;
 }
 
 
@@ -70,6 +76,16 @@ void CalculateEnergy::Init(System & sys)
   electrostatic = forcefield.electrostatic;
   ewald = forcefield.ewald;
   multiParticleEnabled = sys.statV.multiParticleEnabled;
+  boxParallel = sys.statV.boxParallel;
+#ifdef _OPENMP
+  //each box or task team runs its own parallel regions
+  if(boxParallel || sys.statV.recipParallel) {
+#if _OPENMP < 201811
+    omp_set_nested(1);
+#endif
+    omp_set_max_active_levels(2);
+  }
+#endif
   for(uint m = 0; m < mols.count; ++m) {
     const MoleculeKind& molKind = mols.GetKind(m);
     if(molKind.NumAtoms() > maxAtomInMol)
@@ -80,6 +96,22 @@ void CalculateEnergy::Init(System & sys)
       particleCharge.push_back(molKind.AtomCharge(a));
     }
   }
+  molIntraBond.assign(mols.count, 0.0);
+  molIntraNonbond.assign(mols.count, 0.0);
+  molIntraBox.assign(mols.count, 0);
+  checkIntraCache = sys.statV.intraCacheCheck;
+  if(sys.statV.earlyReject) {
+    uint count = forcefield.particles->NumKinds();
+    pairEpsilon.resize(count * count);
+    pairSigmaSq.resize(count * count);
+    for(uint i = 0; i < count; ++i) {
+      for(uint j = 0; j < count; ++j) {
+        double sigma = forcefield.particles->GetSigma(i, j);
+        pairEpsilon[i * count + j] = forcefield.particles->GetEpsilon(i, j);
+        pairSigmaSq[i * count + j] = sigma * sigma;
+      }
+    }
+  }
 #ifdef GOMC_CUDA
   InitCoordinatesCUDA(forcefield.particles->getCUDAVars(),
                       currentCoords.Count(), maxAtomInMol, currentCOM.Count());
@@ -92,27 +124,70 @@ SystemPotential CalculateEnergy::SystemTotal()
     SystemInter(SystemPotential(), currentCoords, currentCOM, currentAxes);
 
   //system intra
-  for (uint b = 0; b < BOX_TOTAL; ++b) {
+  int threads[2];
+  bool concurrent = BOX_TOTAL == 2 && BoxThreads(threads, 0, BOX_TOTAL - 1);
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(BOX_TOTAL) schedule(static, 1) \
+  if(concurrent)
+#endif
+  for (int b = 0; b < BOX_TOTAL; ++b) {
+#ifdef _OPENMP
+    if(concurrent)
+      omp_set_num_threads(threads[b]);
+#endif
     double bondEnergy[2] = {0};
     double bondEn = 0.0, nonbondEn = 0.0, self = 0.0, correction = 0.0;
     MoleculeLookup::box_iterator thisMol = molLookup.BoxBegin(b);
     MoleculeLookup::box_iterator end = molLookup.BoxEnd(b);
     std::vector<uint> molID;
 
+    std::vector<uint> stale;
+
     while (thisMol != end) {
       molID.push_back(*thisMol);
+      if(molIntraBox[*thisMol] != b + 1)
+        stale.push_back(*thisMol);
       ++thisMol;
     }
 
+    //only molecules whose conformation changed need their intramolecular
+    //energy recalculated
 #ifdef _OPENMP
-    #pragma omp parallel for default(none) private(bondEnergy) shared(b, molID) \
+    #pragma omp parallel for default(none) private(bondEnergy) shared(b, stale)
+#endif
+    for (uint i = 0; i < stale.size(); i++) {
+      MoleculeIntra(stale[i], b, bondEnergy);
+      molIntraBond[stale[i]] = bondEnergy[0];
+      molIntraNonbond[stale[i]] = bondEnergy[1];
+    }
+    for (uint i = 0; i < stale.size(); i++) {
+      molIntraBox[stale[i]] = b + 1;
+    }
+
+    //cross-check the cache against a full recalculation and keep the
+    //recalculated energy, so the totals below are the full recalculation
+    //and the caller sees any drift of the running energy
+    for (uint i = 0; checkIntraCache && i < molID.size(); i++) {
+      MoleculeIntra(molID[i], b, bondEnergy);
+      if(!num::approximatelyEqual(bondEnergy[0], molIntraBond[molID[i]],
+                                  1.0e-6) ||
+          !num::approximatelyEqual(bondEnergy[1], molIntraNonbond[molID[i]],
+                                   1.0e-6)) {
+        std::cout << "Warning: Cached intramolecular energy of molecule "
+                  << molID[i] << " in box " << b
+                  << " differs from the recalculated energy!\n";
+        molIntraBond[molID[i]] = bondEnergy[0];
+        molIntraNonbond[molID[i]] = bondEnergy[1];
+      }
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for default(none) shared(b, molID) \
     reduction(+:bondEn, nonbondEn, correction)
 #endif
     for (int i = 0; i < molID.size(); i++) {
-      //calculate nonbonded energy
-      MoleculeIntra(molID[i], b, bondEnergy);
-      bondEn += bondEnergy[0];
-      nonbondEn += bondEnergy[1];
+      bondEn += molIntraBond[molID[i]];
+      nonbondEn += molIntraNonbond[molID[i]];
       //calculate correction term of electrostatic interaction
       correction += calcEwald->MolCorrection(molID[i], b);
     }
@@ -146,13 +221,30 @@ SystemPotential CalculateEnergy::SystemInter(SystemPotential potential,
     XYZArray const& com,
     BoxDimensions const& boxAxes)
 {
-  for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+  //each box works on its own copy, so boxes can run concurrently
+  SystemPotential boxPot[BOXES_WITH_U_NB];
+  int threads[2];
+  bool concurrent = BOXES_WITH_U_NB == 2 &&
+                    BoxThreads(threads, 0, BOXES_WITH_U_NB - 1);
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(BOXES_WITH_U_NB) schedule(static, 1) \
+  if(concurrent)
+#endif
+  for (int b = 0; b < BOXES_WITH_U_NB; ++b) {
+#ifdef _OPENMP
+    if(concurrent)
+      omp_set_num_threads(threads[b]);
+#endif
     //calculate LJ interaction and real term of electrostatic interaction
-    potential = BoxInter(potential, coords, boxAxes, b);
+    boxPot[b] = BoxInter(potential, coords, boxAxes, b);
     //calculate reciprocal term of electrostatic interaction
-    potential.boxEnergy[b].recip = calcEwald->BoxReciprocal(b);
+    boxPot[b].boxEnergy[b].recip = calcEwald->BoxReciprocal(b);
   }
 
+  for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    potential.boxEnergy[b] = boxPot[b].boxEnergy[b];
+    potential.boxVirial[b] = boxPot[b].boxVirial[b];
+  }
   potential.Total();
 
   return potential;
@@ -267,6 +359,60 @@ reduction(+:tempREn, tempLJEn)
   return potential;
 }
 
+double CalculateEnergy::BoxLJ(XYZArray const& coords,
+                              BoxDimensions const& boxAxes,
+                              const uint box, const double cutoff)
+{
+  if (box >= BOXES_WITH_U_NB)
+    return 0.0;
+
+  double tempLJEn = 0.0;
+  double cutoffSq = cutoff * cutoff;
+
+  std::vector<int> cellVector, cellStartIndex, mapParticleToCell;
+  std::vector< std::vector<int> > neighborList;
+  cellList.GetCellListNeighbor(box, currentCoords.Count(),
+                               cellVector, cellStartIndex, mapParticleToCell);
+  neighborList = cellList.GetNeighborList(box);
+
+#ifdef _OPENMP
+#if GCC_VERSION >= 90000
+  #pragma omp parallel for default(none) shared(boxAxes, cellStartIndex, \
+  cellVector, coords, mapParticleToCell, box, neighborList, cutoffSq) \
+reduction(+:tempLJEn)
+#else
+  #pragma omp parallel for default(none) shared(boxAxes, cellStartIndex, \
+  cellVector, coords, mapParticleToCell, neighborList, cutoffSq) \
+reduction(+:tempLJEn)
+#endif
+#endif
+  for(int currParticleIdx = 0; currParticleIdx < cellVector.size(); currParticleIdx++) {
+    int currParticle = cellVector[currParticleIdx];
+    int currCell = mapParticleToCell[currParticle];
+    for(int nCellIndex = 0; nCellIndex < NUMBER_OF_NEIGHBOR_CELL; nCellIndex++) {
+      int neighborCell = neighborList[currCell][nCellIndex];
+      int endIndex = cellStartIndex[neighborCell + 1];
+      for(int nParticleIndex = cellStartIndex[neighborCell];
+          nParticleIndex < endIndex; nParticleIndex++) {
+        int nParticle = cellVector[nParticleIndex];
+
+        if(currParticle < nParticle && particleMol[currParticle] != particleMol[nParticle]) {
+          double distSq;
+          XYZ virComponents;
+          if(boxAxes.InRcut(distSq, virComponents, coords, currParticle, nParticle, box) &&
+              distSq < cutoffSq) {
+            double lambdaVDW = GetLambdaVDW(particleMol[currParticle], particleMol[nParticle], box);
+            tempLJEn += forcefield.particles->CalcEn(distSq,
+                        particleKind[currParticle], particleKind[nParticle], lambdaVDW);
+          }
+        }
+      }
+    }
+  }
+
+  return tempLJEn;
+}
+
 SystemPotential CalculateEnergy::BoxForce(SystemPotential potential,
     XYZArray const& coords,
     XYZArray& atomForce,
@@ -399,6 +545,66 @@ reduction(+:tempREn, tempLJEn, aForcex[:atomCount], aForcey[:atomCount], \
 // NOTE: The calculation of W12, W13, and W23 is expensive and would not be
 // required for pressure and surface tension calculation. So, they have been
 // commented out. If you need to calculate them, uncomment them.
+void CalculateEnergy::VirialCalc(Virial * virial)
+{
+  int threads[2];
+  bool concurrent = BOXES_WITH_U_NB == 2 &&
+                    BoxThreads(threads, 0, BOXES_WITH_U_NB - 1);
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(BOXES_WITH_U_NB) schedule(static, 1) \
+  if(concurrent)
+#endif
+  for (int b = 0; b < BOXES_WITH_U_NB; ++b) {
+#ifdef _OPENMP
+    if(concurrent)
+      omp_set_num_threads(threads[b]);
+#endif
+    virial[b] = VirialCalc(b);
+  }
+}
+
+bool CalculateEnergy::BoxThreads(int * threads, const uint b0,
+                                 const uint b1) const
+{
+#ifdef _OPENMP
+  int total = omp_get_max_threads();
+  if(!boxParallel || total < 2 || omp_in_parallel())
+    return false;
+
+  double w0 = BoxWork(b0), w1 = BoxWork(b1);
+  int t0 = total / 2;
+  if(w0 + w1 > 0.0)
+    t0 = (int)(total * w0 / (w0 + w1) + 0.5);
+  threads[0] = std::min(std::max(t0, 1), total - 1);
+  threads[1] = total - threads[0];
+  return true;
+#else
+  return false;
+#endif
+}
+
+double CalculateEnergy::BoxWork(const uint box) const
+{
+  if (box >= BOXES_WITH_U_NB)
+    return 0.0;
+
+  double atoms = 0.0;
+  for (uint k = 0; k < mols.GetKindsCount(); ++k) {
+    atoms += (double)molLookup.NumKindInBox(k, box) * mols.kinds[k].NumAtoms();
+  }
+  //pairs within rCut per atom, counted once
+  double rCut = currentAxes.rCut[box];
+  double work = atoms * (1.0 + atoms * currentAxes.volInv[box] *
+                         2.0 / 3.0 * M_PI * rCut * rCut * rCut);
+  //half of the k vectors within the reciprocal cutoff, per atom
+  if (ewald) {
+    double kCut = forcefield.recip_rcut[box];
+    work += atoms * currentAxes.volume[box] * kCut * kCut * kCut /
+            (12.0 * M_PI * M_PI);
+  }
+  return work;
+}
+
 Virial CalculateEnergy::VirialCalc(const uint box)
 {
   //store virial and energy of reference and modify the virial
@@ -669,6 +875,148 @@ bool CalculateEnergy::MoleculeInter(Intermolecular &inter_LJ,
   return overlap;
 }
 
+bool CalculateEnergy::MoleculePairs(MolPairs &pairs,
+                                    XYZArray const& molCoords,
+                                    const uint molIndex,
+                                    const uint box) const
+{
+  double tempREn = 0.0, tempLJEn = 0.0;
+  pairs.list.clear();
+  pairs.oldLJ = pairs.oldReal = 0.0;
+
+  if (box >= BOXES_WITH_U_NB)
+    return false;
+
+  uint length = mols.GetKind(molIndex).NumAtoms();
+  uint start = mols.MolStart(molIndex);
+  uint count = forcefield.particles->NumKinds();
+
+  for (uint p = 0; p < length; ++p) {
+    uint atom = start + p;
+    CellList::Neighbors n = cellList.EnumerateLocal(currentCoords[atom], box);
+    std::vector<uint> nIndex;
+    while (!n.Done()) {
+      nIndex.push_back(*n);
+      n.Next();
+    }
+
+#ifdef _OPENMP
+#if GCC_VERSION >= 90000
+    #pragma omp parallel for default(none) shared(atom, nIndex, box, molIndex) \
+    reduction(+:tempREn, tempLJEn)
+#else
+    #pragma omp parallel for default(none) shared(atom, nIndex) \
+    reduction(+:tempREn, tempLJEn)
+#endif
+#endif
+    for(int i = 0; i < nIndex.size(); i++) {
+      double distSq = 0.0;
+      XYZ virComponents;
+      if (currentAxes.InRcut(distSq, virComponents, currentCoords, atom,
+                             nIndex[i], box)) {
+        double lambdaVDW = GetLambdaVDW(molIndex, particleMol[nIndex[i]], box);
+
+        if (electrostatic) {
+          double lambdaCoulomb = GetLambdaCoulomb(molIndex, particleMol[nIndex[i]],
+                                                  box);
+          double qi_qj_fact = particleCharge[atom] * particleCharge[nIndex[i]] *
+                              num::qqFact;
+
+          tempREn += forcefield.particles->CalcCoulomb(distSq, particleKind[atom],
+                     particleKind[nIndex[i]], qi_qj_fact, lambdaCoulomb, box);
+        }
+
+        tempLJEn += forcefield.particles->CalcEn(distSq, particleKind[atom],
+                    particleKind[nIndex[i]], lambdaVDW);
+      }
+    }
+
+    //list the pairs at the new position. A pair never goes below -epsilon
+    //(Mie, shifted or switched) plus, for unlike charges, qi*qj/r, which
+    //bounds the real space term (erfc <= 1, shift and switch only raise it).
+    //Scaled pairs (lambda < 1) stay above the same bound.
+    n = cellList.EnumerateLocal(molCoords[p], box);
+    while (!n.Done()) {
+      double distSq = 0.0;
+      XYZ virComponents;
+      if (currentAxes.InRcut(distSq, virComponents, molCoords, p,
+                             currentCoords, *n, box)) {
+        if(distSq < forcefield.rCutLowSq) {
+          pairs.list.clear();
+          return true;
+        }
+        MolPairs::Pair pair;
+        pair.p = p;
+        pair.partner = *n;
+        pair.distSq = distSq;
+        pair.bound = -pairEpsilon[particleKind[atom] * count +
+                                  particleKind[*n]];
+        if (electrostatic) {
+          double qi_qj_fact = particleCharge[atom] * particleCharge[*n] *
+                              num::qqFact;
+          if(qi_qj_fact < 0.0)
+            pair.bound += qi_qj_fact / sqrt(distSq);
+        }
+        pairs.list.push_back(pair);
+      }
+      n.Next();
+    }
+  }
+
+  pairs.oldLJ = tempLJEn;
+  pairs.oldReal = tempREn;
+
+  //pairs inside sigma are the ones that can reject the move, so they go
+  //first, then bound becomes the sum over the pair and all later ones
+  uint repulsive = 0;
+  for(uint i = 0; i < pairs.list.size(); i++) {
+    uint kinds = particleKind[start + pairs.list[i].p] * count +
+                 particleKind[pairs.list[i].partner];
+    if(pairs.list[i].distSq < pairSigmaSq[kinds])
+      std::swap(pairs.list[i], pairs.list[repulsive++]);
+  }
+  for(int i = (int)pairs.list.size() - 2; i >= 0; i--) {
+    pairs.list[i].bound += pairs.list[i + 1].bound;
+  }
+  return false;
+}
+
+bool CalculateEnergy::MoleculePairsEnergy(Intermolecular &inter_LJ,
+    Intermolecular &inter_coulomb,
+    MolPairs const& pairs,
+    XYZArray const& molCoords,
+    const uint molIndex,
+    const uint box,
+    const double maxChange) const
+{
+  double tempREn = -pairs.oldReal, tempLJEn = -pairs.oldLJ;
+  uint start = mols.MolStart(molIndex);
+
+  for(uint i = 0; i < pairs.list.size(); i++) {
+    MolPairs::Pair const& pair = pairs.list[i];
+    if(tempREn + tempLJEn + pair.bound > maxChange)
+      return true;
+
+    uint atom = start + pair.p;
+    double lambdaVDW = GetLambdaVDW(molIndex, particleMol[pair.partner], box);
+    if (electrostatic) {
+      double lambdaCoulomb = GetLambdaCoulomb(molIndex,
+                                              particleMol[pair.partner], box);
+      double qi_qj_fact = particleCharge[atom] * particleCharge[pair.partner] *
+                          num::qqFact;
+      tempREn += forcefield.particles->CalcCoulomb(pair.distSq,
+                 particleKind[atom], particleKind[pair.partner], qi_qj_fact,
+                 lambdaCoulomb, box);
+    }
+    tempLJEn += forcefield.particles->CalcEn(pair.distSq, particleKind[atom],
+                particleKind[pair.partner], lambdaVDW);
+  }
+
+  inter_LJ.energy = tempLJEn;
+  inter_coulomb.energy = tempREn;
+  return false;
+}
+
 // Calculate 1-N nonbonded intra energy
 void CalculateEnergy::ParticleNonbonded(double* inter,
                                         cbmc::TrialMol const& trialMol,
@@ -707,6 +1055,9 @@ void CalculateEnergy::ParticleNonbonded(double* inter,
   }
 }
 
+// Trial positions are grouped by the cell they fall in, so each neighbor set
+// is gathered only once and every trial of the group is evaluated against it
+// inside a single parallel region.
 void CalculateEnergy::ParticleInter(double* en, double *real,
                                     XYZArray const& trialPos,
                                     bool* overlap,
@@ -715,60 +1066,93 @@ void CalculateEnergy::ParticleInter(double* en, double *real,
                                     const uint box,
                                     const uint trials) const
 {
-  if(box >= BOXES_WITH_U_NB)
+  if(box >= BOXES_WITH_U_NB || idealGas)
     return;
-  double tempLJ, tempReal;
   MoleculeKind const& thisKind = mols.GetKind(molIndex);
   uint kindI = thisKind.AtomKind(partIndex);
   double kindICharge = thisKind.AtomCharge(partIndex);
-  std::vector<uint> nIndex;
 
+  //group the trials by cell, trialList stores trials of group g in the
+  //range [trialStart[g], trialStart[g + 1])
+  std::vector<int> groupCell;
+  std::vector<uint> trialGroup(trials);
   for(uint t = 0; t < trials; ++t) {
-    nIndex.clear();
-    tempReal = 0.0;
-    tempLJ = 0.0;
-    CellList::Neighbors n = cellList.EnumerateLocal(trialPos[t], box);
+    int cell = cellList.PositionToCell(trialPos[t], box);
+    uint g = std::find(groupCell.begin(), groupCell.end(), cell) -
+             groupCell.begin();
+    if(g == groupCell.size())
+      groupCell.push_back(cell);
+    trialGroup[t] = g;
+  }
+  uint groups = groupCell.size();
+  std::vector<uint> trialStart(groups + 1, 0), trialList(trials);
+  for(uint t = 0; t < trials; ++t)
+    ++trialStart[trialGroup[t] + 1];
+  for(uint g = 0; g < groups; ++g)
+    trialStart[g + 1] += trialStart[g];
+  std::vector<uint> slot(trialStart.begin(), trialStart.end() - 1);
+  for(uint t = 0; t < trials; ++t)
+    trialList[slot[trialGroup[t]]++] = t;
+
+  //gather the neighbors of every group once, remembering their group
+  std::vector<uint> nIndex, nGroup;
+  for(uint g = 0; g < groups; ++g) {
+    CellList::Neighbors n = cellList.EnumerateLocal(groupCell[g], box);
     while (!n.Done()) {
       nIndex.push_back(*n);
+      nGroup.push_back(g);
       n.Next();
     }
+  }
 
-#ifdef _OPENMP
+  std::vector<double> tempLJVec(trials, 0.0), tempRealVec(trials, 0.0);
+  double *tempLJ = &tempLJVec[0];
+  double *tempReal = &tempRealVec[0];
+
+#if defined _OPENMP && _OPENMP >= 201511 // check if OpenMP version is 4.5
 #if GCC_VERSION >= 90000
-    #pragma omp parallel for default(none) shared(kindI, kindICharge, nIndex, \
-    overlap, t, trialPos, box, molIndex) \
-reduction(+:tempLJ, tempReal)
+  #pragma omp parallel for default(none) shared(kindI, kindICharge, nIndex, \
+  nGroup, trialStart, trialList, overlap, trialPos, box, molIndex, trials) \
+reduction(+:tempLJ[:trials], tempReal[:trials])
 #else
-    #pragma omp parallel for default(none) shared(kindI, kindICharge, nIndex, \
-    overlap, t, trialPos) \
-reduction(+:tempLJ, tempReal)
+  #pragma omp parallel for default(none) shared(kindI, kindICharge, nIndex, \
+  nGroup, trialStart, trialList, overlap, trialPos) \
+reduction(+:tempLJ[:trials], tempReal[:trials])
 #endif
 #endif
-    for(int i = 0; i < nIndex.size(); i++) {
-      double distSq = 0.0;
-      if(currentAxes.InRcut(distSq, trialPos, t, currentCoords, nIndex[i], box)) {
-        double lambdaVDW = GetLambdaVDW(molIndex, particleMol[nIndex[i]], box);
+  for(int i = 0; i < nIndex.size(); i++) {
+    uint neighbor = nIndex[i];
+    uint g = nGroup[i];
+    uint neighborKind = particleKind[neighbor];
+    double lambdaVDW = GetLambdaVDW(molIndex, particleMol[neighbor], box);
+    double lambdaCoulomb = 0.0, qi_qj_Fact = 0.0;
+    if(electrostatic) {
+      lambdaCoulomb = GetLambdaCoulomb(molIndex, particleMol[neighbor], box);
+      qi_qj_Fact = particleCharge[neighbor] * kindICharge * num::qqFact;
+    }
 
+    for(uint j = trialStart[g]; j < trialStart[g + 1]; ++j) {
+      uint t = trialList[j];
+      double distSq = 0.0;
+      if(currentAxes.InRcut(distSq, trialPos, t, currentCoords, neighbor, box)) {
         if(distSq < forcefield.rCutLowSq) {
           overlap[t] |= true;
         }
-        tempLJ += forcefield.particles->CalcEn(distSq, kindI,
-                                               particleKind[nIndex[i]],
-                                               lambdaVDW);
+        tempLJ[t] += forcefield.particles->CalcEn(distSq, kindI, neighborKind,
+                     lambdaVDW);
         if(electrostatic) {
-          double lambdaCoulomb = GetLambdaCoulomb(molIndex, particleMol[nIndex[i]],
-                                                  box);
-          double qi_qj_Fact = particleCharge[nIndex[i]] * kindICharge * num::qqFact;
-          tempReal += forcefield.particles->CalcCoulomb(distSq, kindI,
-                      particleKind[nIndex[i]], qi_qj_Fact, lambdaCoulomb, box);
+          tempReal[t] += forcefield.particles->CalcCoulomb(distSq, kindI,
+                         neighborKind, qi_qj_Fact, lambdaCoulomb, box);
         }
       }
     }
-    en[t] += tempLJ;
-    real[t] += tempReal;
   }
-}
 
+  for(uint t = 0; t < trials; ++t) {
+    en[t] += tempLJ[t];
+    real[t] += tempReal[t];
+  }
+}
 
 //Calculates the change in the TC from adding numChange atoms of a kind
 Intermolecular CalculateEnergy::MoleculeTailChange(const uint box,
@@ -861,6 +1245,19 @@ Energy CalculateEnergy::MoleculeIntra(cbmc::TrialMol const &mol,
   return Energy(bondEn, intraNonbondEn, 0.0, 0.0, 0.0, 0.0, 0.0);
 }
 
+Energy CalculateEnergy::MoleculeIntraCached(cbmc::TrialMol const &mol,
+    const uint molIndex)
+{
+  if(molIntraBox[molIndex] != mol.GetBox() + 1) {
+    Energy intra = MoleculeIntra(mol, molIndex);
+    molIntraBond[molIndex] = intra.intraBond;
+    molIntraNonbond[molIndex] = intra.intraNonbond;
+    molIntraBox[molIndex] = mol.GetBox() + 1;
+  }
+  return Energy(molIntraBond[molIndex], molIntraNonbond[molIndex], 0.0, 0.0,
+                0.0, 0.0, 0.0);
+}
+
 void CalculateEnergy::BondVectors(XYZArray & vecs,
                                   MoleculeKind const& molKind,
                                   const uint molIndex,
@@ -1475,44 +1872,20 @@ bool CalculateEnergy::FindMolInCavity(std::vector< std::vector<uint> > &mol,
                                       const XYZArray& invCav, const uint box,
                                       const uint kind, const uint exRatio)
 {
-  uint k;
   mol.clear();
   mol.resize(molLookup.GetNumKind());
-  double maxLength = cavDim.Max();
 
-  if(maxLength <= currentAxes.rCut[box]) {
-    CellList::Neighbors n = cellList.EnumerateLocal(center, box);
-    while (!n.Done()) {
-      if(currentAxes.InCavity(currentCOM.Get(particleMol[*n]), center, cavDim,
-                              invCav, box)) {
-        uint molIndex = particleMol[*n];
-        //if molecule can be transfer between boxes
-        if(!molLookup.IsNoSwap(molIndex)) {
-          k = mols.GetMolKind(molIndex);
-          bool exist = std::find(mol[k].begin(), mol[k].end(), molIndex) !=
-                       mol[k].end();
-          if(!exist)
-            mol[k].push_back(molIndex);
-        }
-      }
-      n.Next();
-    }
-  } else {
-    MoleculeLookup::box_iterator n = molLookup.BoxBegin(box);
-    MoleculeLookup::box_iterator end = molLookup.BoxEnd(box);
-    while (n != end) {
-      if(currentAxes.InCavity(currentCOM.Get(*n), center, cavDim, invCav, box)) {
-        uint molIndex = *n;
-        //if molecule can be transfer between boxes
-        if(!molLookup.IsNoSwap(molIndex)) {
-          k = mols.GetMolKind(molIndex);
-          bool exist = std::find(mol[k].begin(), mol[k].end(), molIndex) !=
-                       mol[k].end();
-          if(!exist)
-            mol[k].push_back(molIndex);
-        }
-      }
-      n++;
+  //Only the molecules of the exchanged kind in the COM cells overlapping
+  //the cavity are visited, each once. The other kinds stay empty.
+  std::vector<uint> near;
+  cellList.MolsNearCavity(near, center, cavDim, invCav, box, kind);
+  for(uint i = 0; i < near.size(); i++) {
+    uint molIndex = near[i];
+    //if molecule can be transfer between boxes
+    if(!molLookup.IsNoSwap(molIndex) &&
+        currentAxes.InCavity(currentCOM.Get(molIndex), center, cavDim,
+                             invCav, box)) {
+      mol[kind].push_back(molIndex);
     }
   }
 
@@ -1660,67 +2033,79 @@ void CalculateEnergy::EnergyChange(Energy *energyDiff, Energy &dUdL_VDW,
   std::fill_n(tempLJEnDiff, lambdaSize, 0.0);
   std::fill_n(tempREnDiff, lambdaSize, 0.0);
 
-  // Calculate the vdw, short range electrostatic energy
+  //Soft-core terms are evaluated once per distinct lambda value
+  LambdaUnique uVDW(lambda_VDW), uCoul(lambda_Coul);
+  std::vector<double> coefVDW(uVDW.Size()), coefCoul(uCoul.Size());
+  for(uint u = 0; u < uVDW.Size(); u++)
+    coefVDW[u] = forcefield.particles->LambdaCoef(uVDW.value[u]);
+  for(uint u = 0; u < uCoul.Size(); u++)
+    coefCoul[u] = forcefield.particles->LambdaCoef(uCoul.value[u]);
+
+  //Gather the neighbors of all atoms of the molecule once
+  std::vector<uint> pAtom, nIndex;
   for (uint p = 0; p < length; ++p) {
     uint atom = start + p;
     CellList::Neighbors n = cellList.EnumerateLocal(currentCoords[atom], box);
-    n = cellList.EnumerateLocal(currentCoords[atom], box);
-
-    std::vector<uint> nIndex;
-
-    //store atom index in neighboring cell
     while (!n.Done()) {
       if(particleMol[*n] != molIndex) {
+        pAtom.push_back(atom);
         nIndex.push_back(*n);
       }
       n.Next();
     }
+  }
 
+  // Calculate the vdw, short range electrostatic energy
 #if defined _OPENMP && _OPENMP >= 201511 // check if OpenMP version is 4.5
 #if GCC_VERSION >= 90000
-    #pragma omp parallel for default(none) shared(atom, lambda_Coul, lambda_VDW, \
-    lambdaSize, nIndex, box, iState) \
+  #pragma omp parallel default(none) shared(lambda_Coul, lambda_VDW, \
+  lambdaSize, pAtom, nIndex, uVDW, uCoul, coefVDW, coefCoul, box, iState) \
 reduction(+:dudl_VDW, dudl_Coul, tempREnDiff[:lambdaSize], tempLJEnDiff[:lambdaSize])
 #else
-    #pragma omp parallel for default(none) shared(atom, lambda_Coul, lambda_VDW, \
-    lambdaSize, nIndex) \
+  #pragma omp parallel default(none) shared(lambda_Coul, lambda_VDW, \
+  lambdaSize, pAtom, nIndex, uVDW, uCoul, coefVDW, coefCoul) \
 reduction(+:dudl_VDW, dudl_Coul, tempREnDiff[:lambdaSize], tempLJEnDiff[:lambdaSize])
 #endif
 #endif
-    for(int i = 0; i < nIndex.size(); i++) {
+  {
+    std::vector<double> enVDW(uVDW.Size()), enCoul(uCoul.Size(), 0.0);
+#if defined _OPENMP && _OPENMP >= 201511
+    #pragma omp for
+#endif
+    for(int i = 0; i < (int) nIndex.size(); i++) {
+      uint atom = pAtom[i];
       double distSq = 0.0;
       XYZ virComponents;
       if(currentAxes.InRcut(distSq, virComponents, currentCoords, atom,
                             nIndex[i], box)) {
-        double qi_qj_fact = 0.0, energyOldCoul = 0.0;
-        //Calculate the energy of current state
-        double energyOldVDW = forcefield.particles->CalcEn(distSq, particleKind[atom],
-                              particleKind[nIndex[i]],
-                              lambda_VDW[iState]);
+        double qi_qj_fact = 0.0;
+        uint kindI = particleKind[atom], kindJ = particleKind[nIndex[i]];
+        //Calculate the energy of all states
+        forcefield.particles->CalcEnLambda(&enVDW[0], distSq, kindI, kindJ,
+                                           uVDW.value, coefVDW);
+        double energyOldVDW = enVDW[uVDW.index[iState]];
         //Calculate du/dl in VDW for current state
-        dudl_VDW += forcefield.particles->CalcdEndL(distSq, particleKind[atom],
-                    particleKind[nIndex[i]], lambda_VDW[iState]);
+        dudl_VDW += forcefield.particles->CalcdEndL(distSq, kindI, kindJ,
+                    lambda_VDW[iState]);
 
         if(electrostatic) {
           qi_qj_fact = particleCharge[atom] * particleCharge[nIndex[i]] *
                        num::qqFact;
-          energyOldCoul = forcefield.particles->CalcCoulomb(distSq, particleKind[atom],
-                          particleKind[nIndex[i]], qi_qj_fact,
-                          lambda_Coul[iState], box);
+          forcefield.particles->CalcCoulombLambda(&enCoul[0], distSq, kindI,
+                                                  kindJ, qi_qj_fact,
+                                                  uCoul.value, coefCoul, box);
           //Calculate du/dl in Coulomb for current state.
-          dudl_Coul += forcefield.particles->CalcCoulombdEndL(distSq, particleKind[atom],
-                       particleKind[nIndex[i]], qi_qj_fact,
-                       lambda_Coul[iState], box);
+          dudl_Coul += forcefield.particles->CalcCoulombdEndL(distSq, kindI,
+                       kindJ, qi_qj_fact, lambda_Coul[iState], box);
         }
+        double energyOldCoul = enCoul[uCoul.index[iState]];
 
         for(int s = 0; s < lambdaSize; s++) {
-          //Calculate the energy of other state
-          tempLJEnDiff[s] += forcefield.particles->CalcEn(distSq, particleKind[atom],
-                             particleKind[nIndex[i]], lambda_VDW[s]);
+          //Energy difference of other state
+          tempLJEnDiff[s] += enVDW[uVDW.index[s]];
           tempLJEnDiff[s] += -energyOldVDW;
           if(electrostatic) {
-            tempREnDiff[s] += forcefield.particles->CalcCoulomb(distSq, particleKind[atom],
-                              particleKind[nIndex[i]], qi_qj_fact, lambda_Coul[s], box);
+            tempREnDiff[s] += enCoul[uCoul.index[s]];
             tempREnDiff[s] += -energyOldCoul;
           }
         }
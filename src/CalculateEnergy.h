@@ -47,6 +47,19 @@ namespace cbmc
 class TrialMol;
 }
 
+//! Pairs of a molecule at its trial position, for early rejection
+struct MolPairs {
+  struct Pair {
+    uint p;          //atom within the molecule
+    uint partner;    //particle it interacts with
+    double distSq;
+    double bound;    //lower bound of the energy of this and all later pairs
+  };
+  std::vector<Pair> list;
+  //energy of the molecule at its current position
+  double oldLJ, oldReal;
+};
+
 class CalculateEnergy
 {
 public:
@@ -54,6 +67,13 @@ public:
 
   void Init(System & sys);
 
+  //! Switch off all intermolecular interactions of CBMC trials, so
+  //! molecules are grown as an ideal gas (used to fill conformer reservoirs)
+  void SetIdealGas(const bool enable)
+  {
+    idealGas = enable;
+  }
+
   //! Calculates total energy/virial of all boxes in the system
   SystemPotential SystemTotal() ;
 
@@ -63,6 +83,12 @@ public:
                            BoxDimensions const& boxAxes,
                            const uint box);
 
+  //! Calculates LJ energy of a single box for pairs closer than cutoff,
+  //! without tail correction. Cheap surrogate used to screen volume and
+  //! multi-particle moves.
+  double BoxLJ(XYZArray const& coords, BoxDimensions const& boxAxes,
+               const uint box, const double cutoff);
+
   //! Calculates force of a single box in the system
   SystemPotential BoxForce(SystemPotential potential,
                            XYZArray const& coords,
@@ -74,6 +100,14 @@ public:
   //! Calculate force and virial for the box
   Virial VirialCalc(const uint box);
 
+  //! Calculate virial of every box with nonbonded interactions
+  void VirialCalc(Virial * virial);
+
+  //! Split the threads between boxes b0 and b1 in proportion to their
+  //! estimated work, so both can be evaluated at once. Returns false if
+  //! the boxes should be evaluated one after the other with all threads.
+  bool BoxThreads(int * threads, const uint b0, const uint b1) const;
+
   //! Set the force for atom and mol to zero for box
   void ResetForce(XYZArray& atomForce, XYZArray& molForce, uint box);
 
@@ -101,6 +135,22 @@ public:
                      XYZArray const& molCoords, const uint molIndex,
                      const uint box) const;
 
+  //! Early rejection version of MoleculeInter, first step. Sums the energy
+  //! of molIndex at its current position and lists its pairs at molCoords,
+  //! repulsive ones first, with a lower bound of the energy left.
+  //! @return true on overlap, without listing all pairs
+  bool MoleculePairs(MolPairs &pairs, XYZArray const& molCoords,
+                     const uint molIndex, const uint box) const;
+
+  //! Second step, adds the energy of the listed pairs and stops as soon as
+  //! the energy change is certain to be larger than maxChange.
+  //! @return true if stopped, inter_LJ and inter_coulomb are not set then
+  bool MoleculePairsEnergy(Intermolecular &inter_LJ,
+                           Intermolecular &inter_coulomb,
+                           MolPairs const& pairs, XYZArray const& molCoords,
+                           const uint molIndex, const uint box,
+                           const double maxChange) const;
+
   //! Calculates Nonbonded intra energy (LJ and coulomb )for
   //!                       candidate positions
   //! @param energy Return array, must be pre-allocated to size n
@@ -163,6 +213,25 @@ public:
   //used in molecule exchange for calculating bonded and intraNonbonded energy
   Energy MoleculeIntra(cbmc::TrialMol const &mol, const uint molIndex) const;
 
+  //! Cached bonded and intraNonbonded energy of a molecule, only recomputed
+  //! (from mol) after its internal degrees of freedom changed or when the
+  //! cached value was computed in another box.
+  //! @param mol Rigid-body trial holding the current conformation of molIndex
+  Energy MoleculeIntraCached(cbmc::TrialMol const &mol, const uint molIndex);
+
+  //! Marks the cached intramolecular energy of a molecule as stale, must be
+  //! called whenever a move may change its internal conformation
+  void InvalidateMoleculeIntra(const uint molIndex)
+  {
+    molIntraBox[molIndex] = 0;
+  }
+
+  //! Marks the cached intramolecular energy of all molecules as stale
+  void InvalidateMoleculeIntra()
+  {
+    molIntraBox.assign(mols.count, 0);
+  }
+
 
   //! Calculates Nonbonded 1_3 intramolecule energy of a full molecule
   //for Martini forcefield
@@ -182,7 +251,8 @@ public:
                        XYZArray& molTorque,
                        const uint box);
 
-  //Finding the molecule inside cavity and store the molecule Index.
+  //Finding the molecule of kind inside cavity and store the molecule Index
+  //in mol[kind].
   bool FindMolInCavity(std::vector< std::vector<uint> > &mol, const XYZ& center,
                        const XYZ& cavDim, const XYZArray& invCav,
                        const uint box, const uint kind, const uint exRatio);
@@ -298,6 +368,8 @@ private:
   double GetLambdaVDW(uint molA, uint molB, uint box) const;
   double GetLambdaCoulomb(uint molA, uint molB, uint box) const;
   uint NumberOfParticlesInsideBox(uint box);
+  //Estimated cost of a full real space plus reciprocal evaluation of box
+  double BoxWork(const uint box) const;
 
 
   const Forcefield& forcefield;
@@ -312,10 +384,24 @@ private:
   XYZArray& molForceRef;
   bool multiParticleEnabled;
   bool electrostatic, ewald;
+  bool idealGas;
+  bool boxParallel;
 
   std::vector<int> particleKind;
   std::vector<int> particleMol;
   std::vector<double> particleCharge;
+  //per kind pair: depth of the LJ well and sigma^2, for early rejection
+  std::vector<double> pairEpsilon, pairSigmaSq;
+  //cached intramolecular energy of each molecule, see MoleculeIntraCached
+  std::vector<double> molIntraBond, molIntraNonbond;
+  //box + 1 that the cached energy of each molecule was computed in, 0 if
+  //stale. The bonded terms are 0 in boxes >= BOXES_WITH_U_B, so an entry
+  //from another box is a miss. One byte per molecule, so the boxes may set
+  //their entries concurrently in SystemTotal
+  std::vector<char> molIntraBox;
+  //recalculate every cached intramolecular energy in SystemTotal and warn
+  //about any that differ
+  bool checkIntraCache;
   const CellList& cellList;
 };
 
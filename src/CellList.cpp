@@ -12,6 +12,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "MoleculeLookup.h"
 
 #include <algorithm>
+#include <cmath>
 
 const int CellList::END_CELL;
 
@@ -20,6 +21,7 @@ CellList::CellList(const Molecules& mols,  BoxDimensions& dims)
 {
   dimensions = &dims;
   isBuilt = false;
+  molCells = false;
   for(uint b = 0; b < BOX_TOTAL; b++) {
     edgeCells[b][0] = edgeCells[b][1] = edgeCells[b][2] = 0;
   }
@@ -58,6 +60,13 @@ CellList::CellList(const CellList & other) : mols(other.mols)
   }
   //neighbors(other.neighbors);
   //head(other.head);
+
+  molCells = other.molCells;
+  molNext = other.molNext;
+  molCell = other.molCell;
+  for(uint b = 0; b < BOX_TOTAL; b++) {
+    molHead[b] = other.molHead[b];
+  }
 }
 
 
@@ -111,6 +120,22 @@ void CellList::RemoveMol(const int molIndex, const int box, const XYZArray& pos)
     }
     ++p;
   }
+
+  if(molCells) {
+    int cell = MolHead(molCell[molIndex], mols->GetMolKind(molIndex));
+    int at = molHead[box][cell];
+    if (at == molIndex) {
+      molHead[box][cell] = molNext[molIndex];
+    } else {
+      while(at != END_CELL) {
+        if (molNext[at] == molIndex) {
+          molNext[at] = molNext[molIndex];
+          break;
+        }
+        at = molNext[at];
+      }
+    }
+  }
 }
 
 void CellList::AddMol(const int molIndex, const int box, const XYZArray& pos)
@@ -130,6 +155,34 @@ void CellList::AddMol(const int molIndex, const int box, const XYZArray& pos)
     head[box][cell] = p;
     ++p;
   }
+
+  if(molCells) {
+    molCell[molIndex] = MolToCell(molIndex, box, pos);
+    int cell = MolHead(molCell[molIndex], mols->GetMolKind(molIndex));
+    molNext[molIndex] = molHead[box][cell];
+    molHead[box][cell] = molIndex;
+  }
+}
+
+int CellList::MolHead(const int cell, const uint kind) const
+{
+  return cell * mols->GetKindsCount() + kind;
+}
+
+int CellList::MolToCell(const int molIndex, const int box,
+                        const XYZArray& pos) const
+{
+  //Geometric center of the unwrapped molecule, same as COM::SetNew
+  int start = mols->MolStart(molIndex);
+  int end = mols->MolEnd(molIndex);
+  XYZ ref = pos[start];
+  XYZ sum;
+  for(int p = start + 1; p < end; ++p) {
+    sum += dimensions->MinImage(pos[p] - ref, box);
+  }
+  XYZ center = ref + sum * (1.0 / (end - start));
+  dimensions->WrapPBC(center.x, center.y, center.z, box);
+  return PositionToCell(center, box);
 }
 
 // Resize all boxes to match current axes
@@ -226,10 +279,16 @@ void CellList::GridAll(BoxDimensions& dims, const XYZArray& pos,
   dimensions = &dims;
   list.resize(pos.Count());
   ResizeGrid(dims);
+  if(molCells) {
+    molNext.resize(mols->count);
+    molCell.resize(mols->count);
+  }
   for (int b = 0; b < BOX_TOTAL; ++b) {
     head[b].assign(edgeCells[b][0] * edgeCells[b][1] *
                    edgeCells[b][2],
                    END_CELL);
+    if(molCells)
+      molHead[b].assign(head[b].size() * mols->GetKindsCount(), END_CELL);
     MoleculeLookup::box_iterator it = lookup.BoxBegin(b),
                                  end = lookup.BoxEnd(b);
 
@@ -241,6 +300,21 @@ void CellList::GridAll(BoxDimensions& dims, const XYZArray& pos,
   }
 }
 
+void CellList::Swap(CellList & other)
+{
+  list.swap(other.list);
+  for (int b = 0; b < BOX_TOTAL; ++b) {
+    neighbors[b].swap(other.neighbors[b]);
+    head[b].swap(other.head[b]);
+    molHead[b].swap(other.molHead[b]);
+    std::swap(cellSize[b], other.cellSize[b]);
+    for (int i = 0; i < 3; ++i)
+      std::swap(edgeCells[b][i], other.edgeCells[b][i]);
+  }
+  molNext.swap(other.molNext);
+  molCell.swap(other.molCell);
+}
+
 void CellList::GridBox(BoxDimensions& dims, const XYZArray& pos,
                        const MoleculeLookup& lookup, const uint b)
 {
@@ -249,6 +323,11 @@ void CellList::GridBox(BoxDimensions& dims, const XYZArray& pos,
   ResizeGridBox(dims, b);
   head[b].assign(edgeCells[b][0] * edgeCells[b][1] *
                  edgeCells[b][2], END_CELL);
+  if(molCells) {
+    molNext.resize(mols->count);
+    molCell.resize(mols->count);
+    molHead[b].assign(head[b].size() * mols->GetKindsCount(), END_CELL);
+  }
   MoleculeLookup::box_iterator it = lookup.BoxBegin(b),
                                end = lookup.BoxEnd(b);
 
@@ -265,6 +344,56 @@ CellList::Pairs CellList::EnumeratePairs(int box) const
   return CellList::Pairs(*this, box);
 }
 
+void CellList::MolsNearCavity(std::vector<uint>& found, const XYZ& center,
+                              const XYZ& cavDim, const XYZArray& invCav,
+                              const uint box, const uint kind) const
+{
+  assert(molCells);
+  //Half extent of the cavity's bounding box in unslanted coordinates. The
+  //rows of invCav are the cavity axes. A small pad covers round-off
+  //between the COM used here and the one stored in COM.
+  const double* row[3] = {invCav.x, invCav.y, invCav.z};
+  const double half[3] = {0.5 * cavDim.x, 0.5 * cavDim.y, 0.5 * cavDim.z};
+  XYZ extent(1.0e-6, 1.0e-6, 1.0e-6);
+  for(uint r = 0; r < 3; ++r) {
+    XYZ u = dimensions->TransformUnSlant(XYZ(row[r][0], row[r][1], row[r][2]),
+                                         box);
+    extent.x += half[r] * std::abs(u.x);
+    extent.y += half[r] * std::abs(u.y);
+    extent.z += half[r] * std::abs(u.z);
+  }
+  XYZ c = dimensions->TransformUnSlant(center, box);
+
+  //Cell range along each axis, capped so no cell is visited twice
+  const int* eCells = edgeCells[box];
+  int lo[3], n[3];
+  lo[0] = (int)floor((c.x - extent.x) / cellSize[box].x);
+  lo[1] = (int)floor((c.y - extent.y) / cellSize[box].y);
+  lo[2] = (int)floor((c.z - extent.z) / cellSize[box].z);
+  n[0] = (int)floor((c.x + extent.x) / cellSize[box].x) - lo[0] + 1;
+  n[1] = (int)floor((c.y + extent.y) / cellSize[box].y) - lo[1] + 1;
+  n[2] = (int)floor((c.z + extent.z) / cellSize[box].z) - lo[2] + 1;
+  for(uint i = 0; i < 3; ++i) {
+    n[i] = std::min(n[i], eCells[i]);
+    lo[i] = ((lo[i] % eCells[i]) + eCells[i]) % eCells[i];
+  }
+
+  for(int i = 0; i < n[0]; ++i) {
+    int x = (lo[0] + i) % eCells[0];
+    for(int j = 0; j < n[1]; ++j) {
+      int y = (lo[1] + j) % eCells[1];
+      for(int k = 0; k < n[2]; ++k) {
+        int z = (lo[2] + k) % eCells[2];
+        int cell = x * eCells[1] * eCells[2] + y * eCells[2] + z;
+        for(int m = molHead[box][MolHead(cell, kind)]; m != END_CELL;
+            m = molNext[m]) {
+          found.push_back(m);
+        }
+      }
+    }
+  }
+}
+
 void CellList::GetCellListNeighbor(uint box, int coordinateSize,
                                    std::vector<int> &cellVector, std::vector<int> &cellStartIndex,
                                    std::vector<int> &mapParticleToCell) const
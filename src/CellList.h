@@ -25,10 +25,19 @@ public:
   explicit CellList(const Molecules& mols, BoxDimensions& dims);
   CellList(const CellList & other);
   void SetCutoff();
+  //Also keep molecules in cells by their center of mass, needed for
+  //cavity queries
+  void EnableMolCells()
+  {
+    molCells = true;
+  }
 
   void RemoveMol(const int molIndex, const int box, const XYZArray& pos);
   void AddMol(const int molIndex, const int box, const XYZArray& pos);
   void GridAll(BoxDimensions& dims, const XYZArray& pos, const MoleculeLookup& lookup);
+  //Exchanges the cell contents with a list of the same system, e.g. when
+  //replicas swap their coordinates
+  void Swap(CellList & other);
   void GridBox(BoxDimensions& dims, const XYZArray& pos, const MoleculeLookup& lookup,
                const uint b);
   void GetCellListNeighbor(uint box, int coordinateSize, std::vector<int> &cellVector,
@@ -51,6 +60,14 @@ public:
   class Pairs;
   Pairs EnumeratePairs(int box) const;
 
+  // Appends every molecule of the given kind whose COM cell overlaps the
+  // cavity centered at center with side lengths cavDim and orientation
+  // invCav. Each molecule is listed at most once, the caller does the
+  // exact InCavity test.
+  void MolsNearCavity(std::vector<uint>& found, const XYZ& center,
+                      const XYZ& cavDim, const XYZArray& invCav,
+                      const uint box, const uint kind) const;
+
   int CellsInBox(int box) const
   {
     return head[box].size();
@@ -76,6 +93,10 @@ private:
   void ResizeGridBox(const BoxDimensions& dims, const uint b);
   // Rebuild head/neighbor lists in box b to match current grid
   void RebuildNeighbors(int b);
+  // Cell of the center of mass of molIndex, computed from pos
+  int MolToCell(const int molIndex, const int box, const XYZArray& pos) const;
+  // Index in molHead of the molecules of a kind in a cell
+  int MolHead(const int cell, const uint kind) const;
 
   XYZ cellSize[BOX_TOTAL];
   int edgeCells[BOX_TOTAL][3];
@@ -83,6 +104,14 @@ private:
   BoxDimensions *dimensions;
   double cutoff[BOX_TOTAL];
   bool isBuilt;
+
+  //Molecule COM cells, same grid as the atoms. molHead/molNext link
+  //molecules the way head/list link atoms, with one list per cell and
+  //molecule kind.
+  bool molCells;
+  std::vector<int> molHead[BOX_TOTAL];
+  std::vector<int> molNext;
+  std::vector<int> molCell;
 };
 
 
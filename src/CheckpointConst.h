@@ -0,0 +1,79 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef CHECKPOINT_CONST_H
+#define CHECKPOINT_CONST_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <sstream>
+
+//Layout of the versioned checkpoint file, in native byte order. The file
+//starts with MAGIC, the version and the number of sections, followed by
+//the section table and the sections themselves. Files without MAGIC are
+//read as the legacy format of 8 bytes per value.
+//
+//A delta checkpoint has the same layout, with DELTA_BASE and DELTA_COORD
+//in place of COORD. Delta k applies on top of the full checkpoint and
+//deltas 1 to k - 1 that share its base step.
+namespace checkpoint
+{
+static const char MAGIC[8] = {'G', 'O', 'M', 'C', 'C', 'H', 'K', 'P'};
+static const uint32_t VERSION = 1;
+
+//Section ids
+enum {
+  STEP = 0,
+  BOX_DIM,
+  PRNG,
+  COORD,
+  MOL_LOOKUP,
+  MOVE_SETTINGS,
+  //empty unless parallel tempering was enabled
+  PRNG_PT,
+  //delta only: step of the full checkpoint and number of the delta
+  DELTA_BASE,
+  //delta only: atom ranges of the molecules moved since the last
+  //checkpoint and their coordinates
+  DELTA_COORD,
+  //parallel tempering only: temperature slot the replica runs at, which
+  //differs from its index once the labels were exchanged
+  PT_SLOT,
+  SECTION_COUNT
+};
+
+//One entry of the section table, offset is from the start of the file
+struct Section {
+  uint32_t id;
+  uint32_t checksum;
+  uint64_t offset;
+  uint64_t size;
+};
+
+static const size_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t);
+
+//Name of delta checkpoint k, next to checkpoint.dat in directory
+inline std::string DeltaName(std::string const& directory, const uint32_t k)
+{
+  std::stringstream name;
+  name << directory << "checkpoint_delta_" << k << ".dat";
+  return name.str();
+}
+
+//32-bit FNV-1a hash of a section
+inline uint32_t Checksum(const char * data, const size_t size)
+{
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= (unsigned char)data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+}
+
+#endif /*CHECKPOINT_CONST_H*/
@@ -6,40 +6,34 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 ********************************************************************************/
 
 #include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
 #include "CheckpointOutput.h"
 #include "MoleculeLookup.h"
 #include "System.h"
+#ifndef _WIN32
+#include <unistd.h> //for fsync
+#endif
 
-namespace
+CheckpointOutput::CheckpointOutput(System & sys, StaticVals const& statV,
+                                   OutputPipeline & pipe) :
+  moveSetRef(sys.moveSettings), molLookupRef(sys.molLookupRef),
+  boxDimRef(sys.boxDimRef),  molRef(statV.mol), prngRef(sys.prng),
+  prngPTRef(sys.prngParallelTemp),
+  temperatureSlotRef(sys.temperatureSlot),
+  exchangeLockRef(sys.exchangeLock),
+  coordCurrRef(sys.coordinates), dirtyMolRef(sys.dirtyMols), pipeline(pipe),
+  enableParallelTempering(sys.ms != NULL && sys.prngParallelTemp != NULL),
+  skipBusy(false), enableDelta(false), deltasPerBase(0), deltaCount(0),
+  baseStep(0), target(&pipe)
 {
-union dbl_output_union {
-  char bin_value[8];
-  double dbl_value;
-};
-
-union uint32_output_union {
-  char bin_value[8];
-  uint32_t uint_value;
-};
-
-union int8_input_union {
-  char bin_value[1];
-  int8_t int_value;
-};
+  file.out = this;
 }
 
-CheckpointOutput::CheckpointOutput(System & sys, StaticVals const& statV) :
-  moveSetRef(sys.moveSettings), molLookupRef(sys.molLookupRef),
-  boxDimRef(sys.boxDimRef),  molRef(statV.mol), prngRef(sys.prng),
-#if GOMC_LIB_MPI
-  prngPTRef(*sys.prngParallelTemp),
-  enableParallelTempering(sys.ms->parallelTemperingEnabled),
-#else
-  enableParallelTempering(false),
-#endif
-  coordCurrRef(sys.coordinates)
+void CheckpointFile::Write()
 {
-  outputFile = NULL;
+  out->writeFile(*this);
 }
 
 void CheckpointOutput::Init(pdb_setup::Atoms const& atoms,
@@ -47,57 +41,197 @@ void CheckpointOutput::Init(pdb_setup::Atoms const& atoms,
 {
   enableOutCheckpoint = output.checkpoint.enable;
   stepsPerCheckpoint = output.checkpoint.frequency;
-#if GOMC_LIB_MPI
-  filename = pathToReplicaOutputDirectory + "checkpoint.dat";
-#else
-  filename = "checkpoint.dat";
-#endif
+  directory = pathToReplicaOutputDirectory;
+  filename = directory + "checkpoint.dat";
+  skipBusy = output.asyncCheckpoint.skip;
+  enableDelta = output.deltaCheckpoint.enable;
+  deltasPerBase = output.deltaCheckpoint.perBase;
+  //the first checkpoint of a run is a full one
+  deltaCount = deltasPerBase;
+  //Without a writer of its own, the checkpoint is queued behind the other
+  //output on the shared pipeline
+  target = &pipeline;
+  if(enableOutCheckpoint && output.asyncCheckpoint.enable) {
+    //One checkpoint in flight, the snapshot is reused for the next one
+    config_setup::AsyncOutput async;
+    async.enable = true;
+    async.depth = 1;
+    writer.Init(async);
+    target = &writer;
+  }
 }
 
 void CheckpointOutput::DoOutput(const ulong step)
 {
   if(enableOutCheckpoint) {
-    openOutputFile();
+    if(skipBusy && target->Busy(file)) {
+      std::cout << "Checkpoint of step " << step + 1 << " skipped, the "
+                << "last checkpoint is still being written" << std::endl;
+      return;
+    }
+    //The restart files queued before the checkpoint are on disk with it
+    if(target == &writer)
+      pipeline.Flush();
+    target->Acquire(file);
+    //A delta holds no more than a full checkpoint once every molecule moved
+    bool delta = enableDelta && deltaCount < deltasPerBase &&
+                 !dirtyMolRef.All();
+    beginFile(step, delta);
+    beginSection(checkpoint::STEP);
     printStepNumber(step);
+    endSection();
+    if(delta) {
+      deltaCount++;
+      beginSection(checkpoint::DELTA_BASE);
+      outputBytes(&baseStep, sizeof(baseStep));
+      outputUint(deltaCount);
+      endSection();
+    } else {
+      deltaCount = 0;
+      baseStep = step + 1;
+    }
+    beginSection(checkpoint::BOX_DIM);
     printBoxDimensionsData();
+    endSection();
+    beginSection(checkpoint::PRNG);
     printRandomNumbers();
-    printCoordinates();
+    endSection();
+    if(delta) {
+      beginSection(checkpoint::DELTA_COORD);
+      printMovedCoordinates();
+    } else {
+      beginSection(checkpoint::COORD);
+      printCoordinates();
+    }
+    endSection();
+    dirtyMolRef.Clear();
+    beginSection(checkpoint::MOL_LOOKUP);
     printMoleculeLookupData();
+    endSection();
+    beginSection(checkpoint::MOVE_SETTINGS);
     printMoveSettingsData();
-#if GOMC_LIB_MPI
-    printParallelTemperingBoolean();
+    endSection();
+    if(exchangeLockRef != NULL)
+      exchangeLockRef->lock();
+    beginSection(checkpoint::PRNG_PT);
     if(enableParallelTempering)
       printRandomNumbersParallelTempering();
-#endif
-    std::cout << "Checkpoint saved to " << filename << std::endl;
+    endSection();
+    if(enableParallelTempering) {
+      beginSection(checkpoint::PT_SLOT);
+      outputUint(temperatureSlotRef);
+      endSection();
+    }
+    if(exchangeLockRef != NULL)
+      exchangeLockRef->unlock();
+    target->Submit(file);
   }
 }
 
-void CheckpointOutput::printParallelTemperingBoolean()
+void CheckpointOutput::beginFile(const ulong step, const bool delta)
 {
-  int8_t s = (int8_t) enableParallelTempering;
-  outputIntIn1Char(s);
+  file.step = step;
+  file.delta = delta;
+  file.name = delta ? checkpoint::DeltaName(directory, deltaCount + 1) :
+              filename;
+  file.buffer.clear();
+  file.sections.clear();
+  //The header and section table are filled in by writeFile, there is room
+  //in the table for every section
+  file.buffer.resize(checkpoint::HEADER_SIZE + checkpoint::SECTION_COUNT *
+                     sizeof(checkpoint::Section));
+}
+
+void CheckpointOutput::beginSection(const uint32_t id)
+{
+  checkpoint::Section section;
+  section.id = id;
+  section.checksum = 0;
+  section.offset = file.buffer.size();
+  section.size = 0;
+  file.sections.push_back(section);
+}
+
+void CheckpointOutput::endSection()
+{
+  checkpoint::Section & section = file.sections.back();
+  section.size = file.buffer.size() - section.offset;
+}
+
+void CheckpointOutput::writeFile(CheckpointFile & f)
+{
+  std::vector<char> & buffer = f.buffer;
+  std::vector<checkpoint::Section> & sections = f.sections;
+  for(uint i = 0; i < sections.size(); i++) {
+    sections[i].checksum = checkpoint::Checksum(&buffer[0] +
+                           sections[i].offset, sections[i].size);
+  }
+  uint32_t version = checkpoint::VERSION;
+  uint32_t count = sections.size();
+  char * pos = &buffer[0];
+  memcpy(pos, checkpoint::MAGIC, sizeof(checkpoint::MAGIC));
+  pos += sizeof(checkpoint::MAGIC);
+  memcpy(pos, &version, sizeof(version));
+  pos += sizeof(version);
+  memcpy(pos, &count, sizeof(count));
+  pos += sizeof(count);
+  memcpy(pos, &sections[0], count * sizeof(checkpoint::Section));
+
+  //Write next to the old checkpoint and replace it only once the new one
+  //is complete, so a crash never leaves a torn checkpoint behind
+  std::string tempName = f.name + ".tmp";
+  FILE * outputFile = fopen(tempName.c_str(), "wb");
+  if(outputFile == NULL) {
+    fprintf(stderr, "Error opening checkpoint output file %s\n",
+            tempName.c_str());
+    exit(EXIT_FAILURE);
+  }
+  bool good = fwrite(&buffer[0], 1, buffer.size(), outputFile) ==
+              buffer.size() && fflush(outputFile) == 0;
+#ifndef _WIN32
+  good = good && fsync(fileno(outputFile)) == 0;
+#endif
+  good = fclose(outputFile) == 0 && good;
+#ifdef _WIN32
+  //rename does not replace an existing file on Windows
+  remove(f.name.c_str());
+#endif
+  if(!good || rename(tempName.c_str(), f.name.c_str()) != 0) {
+    fprintf(stderr, "Error writing checkpoint output file %s\n",
+            f.name.c_str());
+    exit(EXIT_FAILURE);
+  }
+  //The deltas of the last full checkpoint are stale now
+  if(!f.delta) {
+    for(uint k = 1; remove(checkpoint::DeltaName(directory, k).c_str()) == 0;
+        k++) {}
+  }
+  //One write, so the line is not split by output from the simulation
+  std::stringstream saved;
+  saved << (f.delta ? "Delta checkpoint" : "Checkpoint") << " of step "
+        << f.step + 1 << " saved to " << f.name << "\n";
+  std::cout << saved.str() << std::flush;
 }
 
 void CheckpointOutput::printStepNumber(const ulong step)
 {
-  uint32_t s = (uint32_t) step + 1;
-  outputUintIn8Chars(s);
+  uint64_t s = step + 1;
+  outputBytes(&s, sizeof(s));
 }
 
 void CheckpointOutput::printBoxDimensionsData()
 {
   // print the number of boxes
   uint32_t totalBoxes = BOX_TOTAL;
-  outputUintIn8Chars(totalBoxes);
+  outputUint(totalBoxes);
   for(int b = 0; b < totalBoxes; b++) {
     XYZ axis = boxDimRef.axis.Get(b);
-    outputDoubleIn8Chars(axis.x);
-    outputDoubleIn8Chars(axis.y);
-    outputDoubleIn8Chars(axis.z);
-    outputDoubleIn8Chars(boxDimRef.cosAngle[b][0]);
-    outputDoubleIn8Chars(boxDimRef.cosAngle[b][1]);
-    outputDoubleIn8Chars(boxDimRef.cosAngle[b][2]);
+    outputDouble(axis.x);
+    outputDouble(axis.y);
+    outputDouble(axis.z);
+    outputDouble(boxDimRef.cosAngle[b][0]);
+    outputDouble(boxDimRef.cosAngle[b][1]);
+    outputDouble(boxDimRef.cosAngle[b][2]);
   }
 }
 
@@ -105,99 +239,98 @@ void CheckpointOutput::printRandomNumbers()
 {
   // First let's save the state array inside prng
   // the length of the array is 624
-  // there is a save function inside MersenneTwister.h file
-  // to read back we can use the load function
-  const int N = 624;
-  // The MT::save function also appends the "left" variable,
-  // so need to allocate one more array element
-  uint32_t* saveArray = new uint32_t[N + 1];
-  prngRef.GetGenerator()->save(saveArray);
-  for(int i = 0; i < N; i++) {
-    outputUintIn8Chars(saveArray[i]);
-  }
+  outputBytes(prngRef.GetGenerator()->state, MTRand::N * sizeof(uint32_t));
 
   // Save the location of pointer in state
   uint32_t location = prngRef.GetGenerator()->pNext -
                       prngRef.GetGenerator()->state;
-  outputUintIn8Chars(location);
+  outputUint(location);
 
   // save the "left" value so we can restore it later
-  outputUintIn8Chars(prngRef.GetGenerator()->left);
+  outputUint(prngRef.GetGenerator()->left);
 
   // let's save seedValue just in case
   // not sure if that is used or not, or how important it is
-  outputUintIn8Chars(prngRef.GetGenerator()->seedValue);
-
-  delete[] saveArray;
+  outputUint(prngRef.GetGenerator()->seedValue);
 }
 
-#if GOMC_LIB_MPI
 void CheckpointOutput::printRandomNumbersParallelTempering()
 {
   // First let's save the state array inside prng
   // the length of the array is 624
-  // there is a save function inside MersenneTwister.h file
-  // to read back we can use the load function
-  const int N = 624;
-  uint32_t* saveArray = new uint32_t[N];
-  prngPTRef.GetGenerator()->save(saveArray);
-  for(int i = 0; i < N; i++) {
-    outputUintIn8Chars(saveArray[i]);
-  }
+  outputBytes(prngPTRef->GetGenerator()->state, MTRand::N * sizeof(uint32_t));
 
   // Save the location of pointer in state
-  uint32_t location = prngPTRef.GetGenerator()->pNext -
-                      prngPTRef.GetGenerator()->state;
-  outputUintIn8Chars(location);
+  uint32_t location = prngPTRef->GetGenerator()->pNext -
+                      prngPTRef->GetGenerator()->state;
+  outputUint(location);
 
   // save the "left" value so we can restore it later
-  outputUintIn8Chars(prngPTRef.GetGenerator()->left);
+  outputUint(prngPTRef->GetGenerator()->left);
 
   // let's save seedValue just in case
   // not sure if that is used or not, or how important it is
-  outputUintIn8Chars(prngPTRef.GetGenerator()->seedValue);
+  outputUint(prngPTRef->GetGenerator()->seedValue);
 }
-#endif
 
 void CheckpointOutput::printCoordinates()
 {
   // first let's print the count
   uint32_t count = coordCurrRef.Count();
-  outputUintIn8Chars(count);
+  outputUint(count);
 
-  // now let's print the coordinates one by one
-  for(int i = 0; i < count; i++) {
-    outputDoubleIn8Chars(coordCurrRef[i].x);
-    outputDoubleIn8Chars(coordCurrRef[i].y);
-    outputDoubleIn8Chars(coordCurrRef[i].z);
-  }
+  // now the x, y and z arrays
+  outputBytes(coordCurrRef.x, count * sizeof(double));
+  outputBytes(coordCurrRef.y, count * sizeof(double));
+  outputBytes(coordCurrRef.z, count * sizeof(double));
 }
 
-void CheckpointOutput::printMoleculeLookupData()
+void CheckpointOutput::printMovedCoordinates()
 {
-  // print the size of molLookup array
-  outputUintIn8Chars(molLookupRef.molLookupCount);
-  // print the molLookup array itself
-  for(int i = 0; i < molLookupRef.molLookupCount; i++) {
-    outputUintIn8Chars(molLookupRef.molLookup[i]);
+  // the atom range of every moved molecule
+  std::vector<uint> const& moved = dirtyMolRef.List();
+  uint32_t count = moved.size(), atoms = 0;
+  outputUint(count);
+  for(uint i = 0; i < count; i++) {
+    uint start, stop;
+    molRef.GetRangeStartStop(start, stop, moved[i]);
+    outputUint(start);
+    outputUint(stop - start);
+    atoms += stop - start;
   }
 
-  // print the size of boxAndKindStart array
-  outputUintIn8Chars(molLookupRef.boxAndKindStartCount);
-  // print the BoxAndKindStart array
-  for(int i = 0; i < molLookupRef.boxAndKindStartCount; i++) {
-    outputUintIn8Chars(molLookupRef.boxAndKindStart[i]);
+  // then their x, y and z arrays
+  outputUint(atoms);
+  for(uint d = 0; d < 3; d++) {
+    double const* xyz = (d == 0 ? coordCurrRef.x :
+                         (d == 1 ? coordCurrRef.y : coordCurrRef.z));
+    for(uint i = 0; i < count; i++) {
+      uint start, stop;
+      molRef.GetRangeStartStop(start, stop, moved[i]);
+      outputBytes(xyz + start, (stop - start) * sizeof(double));
+    }
   }
+}
+
+void CheckpointOutput::printMoleculeLookupData()
+{
+  // print the size of molLookup array and the array itself
+  outputUint(molLookupRef.molLookupCount);
+  outputBytes(molLookupRef.molLookup,
+              molLookupRef.molLookupCount * sizeof(uint));
+
+  // print the size of boxAndKindStart array and the array itself
+  outputUint(molLookupRef.boxAndKindStartCount);
+  outputBytes(molLookupRef.boxAndKindStart,
+              molLookupRef.boxAndKindStartCount * sizeof(uint));
 
   // print numKinds
-  outputUintIn8Chars(molLookupRef.numKinds);
+  outputUint(molLookupRef.numKinds);
 
-  //print the size of fixedAtom array
-  outputUintIn8Chars((uint)molLookupRef.fixedAtom.size());
-  //print the fixedAtom array itself
-  for(int i = 0; i < molLookupRef.fixedAtom.size(); i++) {
-    outputUintIn8Chars(molLookupRef.fixedAtom[i]);
-  }
+  //print the size of fixedAtom array and the array itself
+  outputUint((uint)molLookupRef.fixedAtom.size());
+  outputBytes(molLookupRef.fixedAtom.data(),
+              molLookupRef.fixedAtom.size() * sizeof(uint));
 }
 
 void CheckpointOutput::printMoveSettingsData()
@@ -214,136 +347,81 @@ void CheckpointOutput::printMoveSettingsData()
   printVector1DDouble(moveSetRef.mp_r_max);
 }
 
-void CheckpointOutput::printVector3DDouble(std::vector< std::vector< std::vector<double> > > data)
+void CheckpointOutput::printVector3DDouble(std::vector< std::vector< std::vector<double> > > const& data)
 {
-  // print size of tempTries
+  // print size of array
   ulong size_x = data.size();
   ulong size_y = data[0].size();
   ulong size_z = data[0][0].size();
-  outputUintIn8Chars(size_x);
-  outputUintIn8Chars(size_y);
-  outputUintIn8Chars(size_z);
+  outputUint(size_x);
+  outputUint(size_y);
+  outputUint(size_z);
 
-  // print tempTries array
+  // print array itself, one innermost row at a time
   for(int i = 0; i < size_x; i++) {
     for(int j = 0; j < size_y; j++) {
-      for(int k = 0; k < size_z; k++) {
-        outputDoubleIn8Chars(data[i][j][k]);
-      }
+      outputBytes(data[i][j].data(), size_z * sizeof(double));
     }
   }
 }
 
-void CheckpointOutput::printVector3DUint(std::vector< std::vector< std::vector<uint> > > data)
+void CheckpointOutput::printVector3DUint(std::vector< std::vector< std::vector<uint> > > const& data)
 {
-  // print size of tempTries
+  // print size of array
   ulong size_x = data.size();
   ulong size_y = data[0].size();
   ulong size_z = data[0][0].size();
-  outputUintIn8Chars(size_x);
-  outputUintIn8Chars(size_y);
-  outputUintIn8Chars(size_z);
+  outputUint(size_x);
+  outputUint(size_y);
+  outputUint(size_z);
 
-  // print tempTries array
+  // print array itself, one innermost row at a time
   for(int i = 0; i < size_x; i++) {
     for(int j = 0; j < size_y; j++) {
-      for(int k = 0; k < size_z; k++) {
-        outputUintIn8Chars(data[i][j][k]);
-      }
+      outputBytes(data[i][j].data(), size_z * sizeof(uint));
     }
   }
 }
 
-void CheckpointOutput::printVector2DUint(std::vector< std::vector< uint > > data)
+void CheckpointOutput::printVector2DUint(std::vector< std::vector< uint > > const& data)
 {
   // print size of array
   ulong size_x = data.size();
   ulong size_y = data[0].size();
-  outputUintIn8Chars(size_x);
-  outputUintIn8Chars(size_y);
+  outputUint(size_x);
+  outputUint(size_y);
 
   // print array itself
   for(int i = 0; i < size_x; i++) {
-    for(int j = 0; j < size_y; j++) {
-      outputUintIn8Chars(data[i][j]);
-    }
+    outputBytes(data[i].data(), size_y * sizeof(uint));
   }
 }
 
-void CheckpointOutput::printVector1DDouble(std::vector< double > data)
+void CheckpointOutput::printVector1DDouble(std::vector< double > const& data)
 {
   // print size of array
   ulong size_x = data.size();
-  outputUintIn8Chars(size_x);
+  outputUint(size_x);
 
   // print array iteself
-  for(int i = 0; i < size_x; i++) {
-    outputDoubleIn8Chars(data[i]);
-  }
+  outputBytes(data.data(), size_x * sizeof(double));
 }
 
-void CheckpointOutput::openOutputFile()
+void CheckpointOutput::outputBytes(const void * data, const size_t size)
 {
-  outputFile = fopen(filename.c_str(), "wb");
-  if(outputFile == NULL) {
-    fprintf(stderr, "Error opening checkpoint output file %s\n",
-            filename.c_str());
-    exit(EXIT_FAILURE);
-  }
+  if(size == 0)
+    return;
+  size_t pos = file.buffer.size();
+  file.buffer.resize(pos + size);
+  memcpy(&file.buffer[pos], data, size);
 }
 
-void CheckpointOutput::outputDoubleIn8Chars(double data)
+void CheckpointOutput::outputDouble(double data)
 {
-  if(outputFile == NULL) {
-    fprintf(stderr, "Error opening checkpoint output file %s\n",
-            filename.c_str());
-    exit(EXIT_FAILURE);
-  }
-  dbl_output_union temp;
-  temp.dbl_value = data;
-  fprintf(outputFile, "%c%c%c%c%c%c%c%c",
-          temp.bin_value[0],
-          temp.bin_value[1],
-          temp.bin_value[2],
-          temp.bin_value[3],
-          temp.bin_value[4],
-          temp.bin_value[5],
-          temp.bin_value[6],
-          temp.bin_value[7]);
-  fflush(outputFile);
+  outputBytes(&data, sizeof(data));
 }
 
-void CheckpointOutput::outputIntIn1Char(int8_t data)
+void CheckpointOutput::outputUint(uint32_t data)
 {
-  if(outputFile == NULL) {
-    fprintf(stderr, "Error opening checkpoint output file %s\n",
-            filename.c_str());
-    exit(EXIT_FAILURE);
-  }
-  int8_input_union temp;
-  temp.int_value = data;
-  fprintf(outputFile, "%c",
-          temp.bin_value[0]);
-  fflush(outputFile);
+  outputBytes(&data, sizeof(data));
 }
-
-void CheckpointOutput::outputUintIn8Chars(uint32_t data)
-{
-  if(outputFile == NULL) {
-    fprintf(stderr, "Error opening checkpoint output file %s\n",
-            filename.c_str());
-    exit(EXIT_FAILURE);
-  }
-  uint32_output_union temp;
-  temp.uint_value = data;
-  fprintf(outputFile, "%c%c%c%c%c%c%c%c",
-          temp.bin_value[0],
-          temp.bin_value[1],
-          temp.bin_value[2],
-          temp.bin_value[3],
-          temp.bin_value[4],
-          temp.bin_value[5],
-          temp.bin_value[6],
-          temp.bin_value[7]);
-  fflush(outputFile);
-}
\ No newline at end of file
@@ -11,18 +11,34 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "Coordinates.h"
 #include "MoveBase.h"
 #include <iostream>
+#include <mutex>
 #include "GOMC_Config.h"
+#include "OutputPipeline.h"
+#include "CheckpointConst.h"
+
+class CheckpointOutput;
+
+//Snapshot of the state a checkpoint is written from, laid out as the
+//checkpoint file. It is taken on the simulation thread, the checksums
+//and the write happen on the checkpoint writer.
+struct CheckpointFile : OutputJob {
+  CheckpointFile() : out(NULL) {}
+  virtual void Write();
+
+  CheckpointOutput * out;
+  ulong step;
+  bool delta;
+  std::string name;
+  //kept between checkpoints so it is only allocated once
+  std::vector<char> buffer;
+  std::vector<checkpoint::Section> sections;
+};
 
 class CheckpointOutput : public OutputableBase
 {
 public:
-  CheckpointOutput(System & sys, StaticVals const& statV);
-
-  ~CheckpointOutput()
-  {
-    if(outputFile)
-      fclose(outputFile);
-  }
+  CheckpointOutput(System & sys, StaticVals const& statV,
+                   OutputPipeline & pipe);
 
   virtual void DoOutput(const ulong step);
   virtual void Init(pdb_setup::Atoms const& atoms,
@@ -39,41 +55,65 @@ public:
     }
   }
 
+  //Waits until the last checkpoint is on disk
+  void Flush()
+  {
+    target->Flush();
+  }
+
 private:
+  friend struct CheckpointFile;
+
   MoveSettings & moveSetRef;
   MoleculeLookup & molLookupRef;
   BoxDimensions & boxDimRef;
   Molecules const & molRef;
   PRNG & prngRef;
-#if GOMC_LIB_MPI
-  PRNG & prngPTRef;
-#endif
+  //exchange generator and temperature slot of a parallel tempering replica
+  PRNG * prngPTRef;
+  int const& temperatureSlotRef;
+  std::mutex * const& exchangeLockRef;
   Coordinates & coordCurrRef;
+  DirtyMolecules & dirtyMolRef;
+  OutputPipeline & pipeline;
 
   bool enableOutCheckpoint;
   bool enableParallelTempering;
-  std::string filename;
-  FILE* outputFile;
+  std::string directory, filename;
   ulong stepsPerCheckpoint;
+  //skip a checkpoint that is due while the last one is being written
+  bool skipBusy;
+  //deltas written since the last full checkpoint, and its step
+  bool enableDelta;
+  uint deltasPerBase, deltaCount;
+  uint64_t baseStep;
+  CheckpointFile file;
+  //Declared after file, so it is flushed before file goes away. Writes
+  //on its own thread with AsyncCheckpoint
+  OutputPipeline writer;
+  //writer with AsyncCheckpoint, else the shared output pipeline
+  OutputPipeline * target;
 
-  void openOutputFile();
-  void printParallelTemperingBoolean();
+  void beginFile(const ulong step, const bool delta);
+  void beginSection(const uint32_t id);
+  void endSection();
+  //Fills in the header and checksums and replaces the checkpoint file
+  void writeFile(CheckpointFile & f);
   void printStepNumber(ulong step);
   void printRandomNumbers();
-#if GOMC_LIB_MPI
   void printRandomNumbersParallelTempering();
-#endif
   void printCoordinates();
+  void printMovedCoordinates();
   void printMoleculeLookupData();
   void printMoveSettingsData();
   void printBoxDimensionsData();
 
-  void printVector3DDouble(std::vector< std::vector< std::vector<double> > > data);
-  void printVector3DUint(std::vector< std::vector< std::vector<uint> > > data);
-  void printVector2DUint(std::vector< std::vector< uint > > data);
-  void printVector1DDouble(std::vector< double > data);
-  void outputDoubleIn8Chars(double data);
-  void outputIntIn1Char(int8_t data);
-  void outputUintIn8Chars(uint32_t data);
+  void printVector3DDouble(std::vector< std::vector< std::vector<double> > > const& data);
+  void printVector3DUint(std::vector< std::vector< std::vector<uint> > > const& data);
+  void printVector2DUint(std::vector< std::vector< uint > > const& data);
+  void printVector1DDouble(std::vector< double > const& data);
+  void outputBytes(const void * data, const size_t size);
+  void outputDouble(double data);
+  void outputUint(uint32_t data);
 
 };
@@ -6,6 +6,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 ********************************************************************************/
 
 #include <stdint.h>
+#include <cstring>
 #include "CheckpointSetup.h"
 #include "MoleculeLookup.h"
 #include "System.h"
@@ -32,31 +33,273 @@ CheckpointSetup::CheckpointSetup(System & sys, StaticVals const& statV) :
   moveSetRef(sys.moveSettings), molLookupRef(sys.molLookupRef),
   boxDimRef(sys.boxDimRef),  molRef(statV.mol), prngRef(sys.prng),
   coordCurrRef(sys.coordinates)
-#if GOMC_LIB_MPI
-  , filename(sys.ms->replicaInputDirectoryPath + "checkpoint.dat")
-#else
-  , filename("checkpoint.dat")
-#endif
+  , directory(sys.ms != NULL ? sys.ms->replicaInputDirectoryPath : "")
+  , filename(directory + "checkpoint.dat")
 {
   inputFile = NULL;
   saveArray = NULL;
+  saveArrayPT = NULL;
+  parallelTemperingWasEnabled = 0;
+  temperatureSlot = -1;
+  readPos = readEnd = 0;
 }
 
 void CheckpointSetup::ReadAll()
 {
   openInputFile();
-  readStepNumber();
-  readBoxDimensionsData();
-  readRandomNumbers();
-  readCoordinates();
-  readMoleculeLookupData();
-  readMoveSettingsData();
+  if(readFileHeader(filename)) {
+    readSections();
+    std::cout << "Checkpoint loaded from " << filename << std::endl;
+    readDeltas();
+  } else {
+    // legacy checkpoint, 8 bytes per value
+    readStepNumber();
+    readBoxDimensionsData();
+    readRandomNumbers();
+    readCoordinates();
+    readMoleculeLookupData();
+    readMoveSettingsData();
 #if GOMC_LIB_MPI
-  readParallelTemperingBoolean();
-  if(parallelTemperingWasEnabled)
-    readRandomNumbersParallelTempering();
+    readParallelTemperingBoolean();
+    if(parallelTemperingWasEnabled)
+      readRandomNumbersParallelTempering();
 #endif
-  std::cout << "Checkpoint loaded from " << filename << std::endl;
+    std::cout << "Checkpoint loaded from " << filename << std::endl;
+  }
+  closeInputFile();
+}
+
+void CheckpointSetup::readDeltas()
+{
+  // apply the deltas of this full checkpoint in order, up to the first
+  // one that is missing or belongs to another full checkpoint
+  uint64_t baseStep = stepNumber;
+  for(uint32_t k = 1; ; k++) {
+    std::string name = checkpoint::DeltaName(directory, k);
+    closeInputFile();
+    inputFile = fopen(name.c_str(), "rb");
+    if(inputFile == NULL || !readFileHeader(name))
+      break;
+    uint64_t base;
+    openSection(checkpoint::DELTA_BASE);
+    readBytes(&base, sizeof(base));
+    if(base != baseStep || readUint() != k)
+      break;
+    readSections();
+    std::cout << "Checkpoint delta loaded from " << name << std::endl;
+  }
+}
+
+void CheckpointSetup::closeInputFile()
+{
+  if(inputFile != NULL) {
+    fclose(inputFile);
+    inputFile = NULL;
+  }
+}
+
+bool CheckpointSetup::readFileHeader(std::string const& name)
+{
+  char magic[sizeof(checkpoint::MAGIC)];
+  if(fread(magic, 1, sizeof(magic), inputFile) != sizeof(magic) ||
+      memcmp(magic, checkpoint::MAGIC, sizeof(magic)) != 0) {
+    rewind(inputFile);
+    return false;
+  }
+
+  // read the whole file at once
+  fseek(inputFile, 0, SEEK_END);
+  long size = ftell(inputFile);
+  rewind(inputFile);
+  buffer.resize(size);
+  if(fread(&buffer[0], 1, size, inputFile) != (size_t)size ||
+      buffer.size() < checkpoint::HEADER_SIZE) {
+    std::cerr << "CheckpointSetup couldn't read required data from binary!\n";
+    exit(EXIT_FAILURE);
+  }
+
+  uint32_t version, count;
+  readPos = sizeof(magic);
+  readEnd = buffer.size();
+  readBytes(&version, sizeof(version));
+  readBytes(&count, sizeof(count));
+  if(version > checkpoint::VERSION) {
+    std::cerr << "ERROR: Checkpoint file " << name << " has version "
+              << version << ", this GOMC reads up to version "
+              << checkpoint::VERSION << "!\n";
+    exit(EXIT_FAILURE);
+  }
+  if(count > (readEnd - readPos) / sizeof(checkpoint::Section)) {
+    std::cerr << "ERROR: Checkpoint file " << name << " is corrupt, "
+              << "its section table of " << count
+              << " sections does not fit in the file!\n";
+    exit(EXIT_FAILURE);
+  }
+  sections.resize(count);
+  readBytes(sections.data(), count * sizeof(checkpoint::Section));
+
+  for(uint i = 0; i < count; i++) {
+    checkpoint::Section const& s = sections[i];
+    if(s.offset > buffer.size() || s.size > buffer.size() - s.offset ||
+        checkpoint::Checksum(&buffer[0] + s.offset, s.size) != s.checksum) {
+      std::cerr << "ERROR: Checkpoint file " << name << " is corrupt, "
+                << "section " << s.id << " does not match its checksum!\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  return true;
+}
+
+void CheckpointSetup::readSections()
+{
+  openSection(checkpoint::STEP);
+  uint64_t step;
+  readBytes(&step, sizeof(step));
+  stepNumber = step;
+
+  openSection(checkpoint::BOX_DIM);
+  readBoxDimensionsData();
+
+  openSection(checkpoint::PRNG);
+  readSectionRandomNumbers(saveArray, seedLocation, seedLeft, seedValue);
+
+  if(hasSection(checkpoint::COORD)) {
+    openSection(checkpoint::COORD);
+    readSectionCoordinates();
+  } else {
+    openSection(checkpoint::DELTA_COORD);
+    readSectionMovedCoordinates();
+  }
+
+  openSection(checkpoint::MOL_LOOKUP);
+  readSectionMoleculeLookupData();
+
+  openSection(checkpoint::MOVE_SETTINGS);
+  readMoveSettingsData();
+
+  // the parallel tempering generator is only saved when it was used
+  openSection(checkpoint::PRNG_PT);
+  parallelTemperingWasEnabled = readPos != readEnd;
+  if(parallelTemperingWasEnabled) {
+    readSectionRandomNumbers(saveArrayPT, seedLocationPT, seedLeftPT,
+                             seedValuePT);
+  }
+  // checkpoints written before the slot was saved start from the identity
+  if(hasSection(checkpoint::PT_SLOT)) {
+    openSection(checkpoint::PT_SLOT);
+    temperatureSlot = (int32_t)readUint();
+  }
+}
+
+bool CheckpointSetup::hasSection(const uint32_t id) const
+{
+  for(uint i = 0; i < sections.size(); i++) {
+    if(sections[i].id == id)
+      return true;
+  }
+  return false;
+}
+
+void CheckpointSetup::openSection(const uint32_t id)
+{
+  for(uint i = 0; i < sections.size(); i++) {
+    if(sections[i].id == id) {
+      readPos = sections[i].offset;
+      readEnd = sections[i].offset + sections[i].size;
+      return;
+    }
+  }
+  std::cerr << "ERROR: Checkpoint file " << filename << " has no section "
+            << id << "!\n";
+  exit(EXIT_FAILURE);
+}
+
+void CheckpointSetup::readSectionRandomNumbers(uint32_t* & state,
+    uint32_t & location,
+    uint32_t & left,
+    uint32_t & value)
+{
+  // the state array, with room for "left" as MTRand::load expects
+  if(state != NULL)
+    delete[] state;
+  state = new uint32_t[MTRand::SAVE];
+  readBytes(state, MTRand::N * sizeof(uint32_t));
+  location = readUint();
+  left = readUint();
+  state[MTRand::N] = left;
+  value = readUint();
+}
+
+void CheckpointSetup::readSectionCoordinates()
+{
+  coordLength = readUint();
+  coords.Init(coordLength);
+  readBytes(coords.x, coordLength * sizeof(double));
+  readBytes(coords.y, coordLength * sizeof(double));
+  readBytes(coords.z, coordLength * sizeof(double));
+}
+
+void CheckpointSetup::readSectionMovedCoordinates()
+{
+  // atom ranges of the moved molecules
+  std::vector<uint32_t> start(readUint()), length(start.size());
+  for(uint i = 0; i < start.size(); i++) {
+    start[i] = readUint();
+    length[i] = readUint();
+    if(start[i] > coordLength || length[i] > coordLength - start[i]) {
+      std::cerr << "ERROR: Checkpoint delta does not match the coordinates "
+                << "of the full checkpoint!\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  readUint();
+
+  // their x, y and z arrays, over the coordinates read so far
+  double * xyz[3] = {coords.x, coords.y, coords.z};
+  for(uint d = 0; d < 3; d++) {
+    for(uint i = 0; i < start.size(); i++)
+      readBytes(xyz[d] + start[i], length[i] * sizeof(double));
+  }
+}
+
+void CheckpointSetup::readSectionMoleculeLookupData()
+{
+  molLookupVec.resize(readUint());
+  readBytes(molLookupVec.data(), molLookupVec.size() * sizeof(uint32_t));
+  boxAndKindStartVec.resize(readUint());
+  readBytes(boxAndKindStartVec.data(),
+            boxAndKindStartVec.size() * sizeof(uint32_t));
+  numKinds = readUint();
+  fixedAtomVec.resize(readUint());
+  readBytes(fixedAtomVec.data(), fixedAtomVec.size() * sizeof(uint32_t));
+}
+
+void CheckpointSetup::readBytes(void * data, const size_t size)
+{
+  if(size > readEnd - readPos) {
+    std::cerr << "CheckpointSetup couldn't read required data from binary!\n";
+    exit(EXIT_FAILURE);
+  }
+  memcpy(data, &buffer[0] + readPos, size);
+  readPos += size;
+}
+
+double CheckpointSetup::readDouble()
+{
+  if(buffer.empty())
+    return readDoubleIn8Chars();
+  double data;
+  readBytes(&data, sizeof(data));
+  return data;
+}
+
+uint32_t CheckpointSetup::readUint()
+{
+  if(buffer.empty())
+    return readUintIn8Chars();
+  uint32_t data;
+  readBytes(&data, sizeof(data));
+  return data;
 }
 
 void CheckpointSetup::readParallelTemperingBoolean()
@@ -72,19 +315,19 @@ void CheckpointSetup::readStepNumber()
 void CheckpointSetup::readBoxDimensionsData()
 {
   // read the number of boxes
-  totalBoxes = readUintIn8Chars();
+  totalBoxes = readUint();
   axis.resize(totalBoxes);
   cosAngle.resize(totalBoxes);
 
   for(int b = 0; b < totalBoxes; b++) {
     axis[b].resize(3);
     cosAngle[b].resize(3);
-    axis[b][0] = readDoubleIn8Chars();
-    axis[b][1] = readDoubleIn8Chars();
-    axis[b][2] = readDoubleIn8Chars();
-    cosAngle[b][0] = readDoubleIn8Chars();
-    cosAngle[b][1] = readDoubleIn8Chars();
-    cosAngle[b][2] = readDoubleIn8Chars();
+    axis[b][0] = readDouble();
+    axis[b][1] = readDouble();
+    axis[b][2] = readDouble();
+    cosAngle[b][0] = readDouble();
+    cosAngle[b][1] = readDouble();
+    cosAngle[b][2] = readDouble();
   }
 }
 
@@ -316,7 +559,6 @@ bool CheckpointSetup::CheckIfParallelTemperingWasEnabled()
 }
 
 
-#if GOMC_LIB_MPI
 void CheckpointSetup::SetPRNGVariablesPT(PRNG & prng)
 {
   prng.GetGenerator()->load(saveArrayPT);
@@ -324,7 +566,6 @@ void CheckpointSetup::SetPRNGVariablesPT(PRNG & prng)
   prng.GetGenerator()->left = seedLeftPT;
   prng.GetGenerator()->seedValue = seedValuePT;
 }
-#endif
 
 void CheckpointSetup::SetCoordinates(Coordinates & coordinates)
 {
@@ -345,6 +586,7 @@ void CheckpointSetup::SetMoleculeLookup(MoleculeLookup & molLookupRef)
     molLookupRef.boxAndKindStart[i] = this->boxAndKindStartVec[i];
   }
   molLookupRef.numKinds = this->numKinds;
+  molLookupRef.InitPosition();
 }
 
 void CheckpointSetup::SetMoveSettings(MoveSettings & moveSettings)
@@ -365,9 +607,9 @@ void
 CheckpointSetup::readVector3DDouble(std::vector<std::vector<std::vector<double> > > &data)
 {
   // read size of data
-  ulong size_x = readUintIn8Chars();
-  ulong size_y = readUintIn8Chars();
-  ulong size_z = readUintIn8Chars();
+  ulong size_x = readUint();
+  ulong size_y = readUint();
+  ulong size_z = readUint();
 
   // read array
   data.resize(size_x);
@@ -376,7 +618,7 @@ CheckpointSetup::readVector3DDouble(std::vector<std::vector<std::vector<double>
     for(int j = 0; j < size_y; j++) {
       data[i][j].resize(size_z);
       for(int k = 0; k < size_z; k++) {
-        data[i][j][k] = readDoubleIn8Chars();
+        data[i][j][k] = readDouble();
       }
     }
   }
@@ -385,9 +627,9 @@ CheckpointSetup::readVector3DDouble(std::vector<std::vector<std::vector<double>
 void CheckpointSetup::readVector3DUint(std::vector<std::vector<std::vector<uint> > > &data)
 {
   // read size of data
-  ulong size_x = readUintIn8Chars();
-  ulong size_y = readUintIn8Chars();
-  ulong size_z = readUintIn8Chars();
+  ulong size_x = readUint();
+  ulong size_y = readUint();
+  ulong size_z = readUint();
 
   // read array
   data.resize(size_x);
@@ -396,7 +638,7 @@ void CheckpointSetup::readVector3DUint(std::vector<std::vector<std::vector<uint>
     for(int j = 0; j < size_y; j++) {
       data[i][j].resize(size_z);
       for(int k = 0; k < size_z; k++) {
-        data[i][j][k] = readUintIn8Chars();
+        data[i][j][k] = readUint();
       }
     }
   }
@@ -405,15 +647,15 @@ void CheckpointSetup::readVector3DUint(std::vector<std::vector<std::vector<uint>
 void CheckpointSetup::readVector2DUint(std::vector<std::vector<uint> > &data)
 {
   // read size of data
-  ulong size_x = readUintIn8Chars();
-  ulong size_y = readUintIn8Chars();
+  ulong size_x = readUint();
+  ulong size_y = readUint();
 
   // read array
   data.resize(size_x);
   for(int i = 0; i < size_x; i++) {
     data[i].resize(size_y);
     for(int j = 0; j < size_y; j++) {
-      data[i][j] = readUintIn8Chars();
+      data[i][j] = readUint();
     }
   }
 }
@@ -421,11 +663,11 @@ void CheckpointSetup::readVector2DUint(std::vector<std::vector<uint> > &data)
 void CheckpointSetup::readVector1DDouble(std::vector<double> &data)
 {
 // read size of data
-  ulong size_x = readUintIn8Chars();
+  ulong size_x = readUint();
 
   // read array
   data.resize(size_x);
   for(int i = 0; i < size_x; i++) {
-    data[i] = readDoubleIn8Chars();
+    data[i] = readDouble();
   }
 }
@@ -9,6 +9,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "OutputAbstracts.h"
 #include "MoveSettings.h"
 #include "Coordinates.h"
+#include "CheckpointConst.h"
 #include <iostream>
 
 class CheckpointSetup
@@ -26,15 +27,22 @@ public:
       delete [] saveArray;
       saveArray = NULL;
     }
+    if(saveArrayPT != NULL) {
+      delete [] saveArrayPT;
+      saveArrayPT = NULL;
+    }
   }
 
   void ReadAll();
   void SetStepNumber(ulong & startStep);
   void SetPRNGVariables(PRNG & prng);
   bool CheckIfParallelTemperingWasEnabled();
-#if GOMC_LIB_MPI
   void SetPRNGVariablesPT(PRNG & prng);
-#endif
+  //temperature slot of a parallel tempering replica, -1 if not saved
+  int GetTemperatureSlot() const
+  {
+    return temperatureSlot;
+  }
   void SetBoxDimensions(BoxDimensions & boxDimRef);
   void SetCoordinates(Coordinates & coordinates);
   void SetMoleculeLookup(MoleculeLookup & molLookupRef);
@@ -48,8 +56,13 @@ private:
   Coordinates & coordCurrRef;
   PRNG & prngRef;
 
-  std::string filename;
+  std::string directory, filename;
   FILE* inputFile;
+  //whole contents and section table of a versioned checkpoint, empty for
+  //a legacy one
+  std::vector<char> buffer;
+  std::vector<checkpoint::Section> sections;
+  size_t readPos, readEnd;
 
   // the following variables will hold the data read from checkpoint
   // and will be passed to the rest of the code via Get functions
@@ -78,15 +91,30 @@ private:
   void readRandomNumbers();
 #if GOMC_LIB_MPI
   void readRandomNumbersParallelTempering();
+#endif
   uint32_t* saveArrayPT;
   uint32_t seedLocationPT, seedLeftPT, seedValuePT;
-#endif
+  int32_t temperatureSlot;
   void readCoordinates();
   void readMoleculeLookupData();
   void readMoveSettingsData();
   void readBoxDimensionsData();
   void closeInputFile();
 
+  bool readFileHeader(std::string const& name);
+  void readSections();
+  void readDeltas();
+  bool hasSection(const uint32_t id) const;
+  void openSection(const uint32_t id);
+  void readSectionRandomNumbers(uint32_t* & state, uint32_t & location,
+                                uint32_t & left, uint32_t & value);
+  void readSectionCoordinates();
+  void readSectionMovedCoordinates();
+  void readSectionMoleculeLookupData();
+  void readBytes(void * data, const size_t size);
+  double readDouble();
+  uint32_t readUint();
+
   void readVector3DDouble(std::vector< std::vector< std::vector <double> > > & data);
   void readVector3DUint(std::vector< std::vector< std::vector <uint> > > & data);
   void readVector2DUint(std::vector< std::vector< uint > > & data);
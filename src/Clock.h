@@ -37,6 +37,8 @@ struct Clock {
   void SetStart();
   void SetStop();
   double GetTimDiff();
+  //Prints the time since SetStart after label, and starts over
+  void Lap(char const*const label);
   void CompletionTime(uint &day, uint &hr, uint &min);
 
 private:
@@ -116,6 +118,13 @@ inline double Clock::GetTimDiff()
 #endif
 }
 
+inline void Clock::Lap(char const*const label)
+{
+  SetStop();
+  printf("%-40s %-.4f sec.\n", label, GetTimDiff());
+  SetStart();
+}
+
 inline void Clock::CompletionTime(uint &day, uint &hr, uint &min)
 {
   double speed = 0.0;
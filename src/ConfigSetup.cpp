@@ -39,6 +39,8 @@ ConfigSetup::ConfigSetup(void)
   in.restart.enable = false;
   in.restart.step = ULONG_MAX;
   in.restart.recalcTrajectory = false;
+  in.restart.recalcFromDCD = false;
+  in.restart.frameIndexCache = false;
   in.restart.restartFromCheckpoint = false;
   in.prng.seed = UINT_MAX;
   in.prngParallelTempering.seed = UINT_MAX;
@@ -61,6 +63,11 @@ ConfigSetup::ConfigSetup(void)
   sys.step.pressureCalc = true;
   sys.step.parallelTempFreq = ULONG_MAX;
   sys.step.parallelTemperingAttemptsPerExchange = 0;
+  sys.step.parallelTemp = false;
+  sys.step.replicaPinning = false;
+  sys.step.parallelTempSwapLabels = false;
+  sys.step.parallelTempAsync = false;
+  sys.step.parallelTempMaxWait = 100;
   sys.step.pressureCalc = false;
   in.ffKind.numOfKinds = 0;
   sys.exclude.EXCLUDE_KIND = UINT_MAX;
@@ -69,7 +76,12 @@ ConfigSetup::ConfigSetup(void)
   for(i = 0; i < BOX_TOTAL; i++) {
     in.files.pdb.name[i] = "";
     in.files.psf.name[i] = "";
+    in.files.dcd.name[i] = "";
   }
+  sys.boxParallel = false;
+  sys.recipParallel = false;
+  sys.earlyReject = false;
+  sys.intraCacheCheck = false;
 #if ENSEMBLE == GEMC
   sys.gemc.kind = UINT_MAX;
   sys.gemc.pressure = DBL_MAX;
@@ -95,9 +107,13 @@ ConfigSetup::ConfigSetup(void)
   sys.moves.crankShaft = DBL_MAX;
   sys.moves.intraMemc = DBL_MAX;
   out.state.settings.enable = true;
+  out.state.format.pdb = true;
+  out.state.format.dcd = false;
   out.restart.settings.enable = true;
   out.console.enable = true;
   out.statistics.settings.block.enable = true;
+  out.statistics.format.text = true;
+  out.statistics.format.binary = false;
 #if ENSEMBLE == GCMC
   sys.chemPot.isFugacity = false;
   out.statistics.settings.hist.enable = false;
@@ -110,7 +126,14 @@ ConfigSetup::ConfigSetup(void)
 #endif
   out.checkpoint.enable = false;
   out.checkpoint.frequency = ULONG_MAX;
+  out.async.enable = false;
+  out.async.depth = 2;
+  out.asyncCheckpoint.enable = false;
+  out.asyncCheckpoint.skip = false;
+  out.deltaCheckpoint.enable = false;
+  out.deltaCheckpoint.perBase = 10;
   out.statistics.settings.uniqueStr.val = "";
+  out.statistics.settings.uniqueStr.replica = false;
   out.state.settings.frequency = ULONG_MAX;
   out.restart.settings.frequency = ULONG_MAX;
   out.console.frequency = ULONG_MAX;
@@ -121,6 +144,9 @@ ConfigSetup::ConfigSetup(void)
   out.statistics.vars.pressure.fluct = false;
   out.statistics.vars.surfaceTension.block = false;
   out.statistics.vars.surfaceTension.fluct = false;
+  sys.cbmcTrials.library = false;
+  sys.cbmcTrials.reservoir = 0;
+  sys.cbmcTrials.rigid = false;
 #ifdef VARIABLE_PARTICLE_NUMBER
   sys.moves.transfer = DBL_MAX;
   sys.moves.memc = DBL_MAX;
@@ -235,6 +261,14 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
       }
     } else if(CheckString(line[0], "Parameters")) {
       in.files.param.name = line[1];
+    } else if(CheckString(line[0], "SystemImage")) {
+      if (multisim != NULL) {
+        in.files.image.name = multisim->replicaInputDirectoryPath + line[1];
+      } else {
+        in.files.image.name = line[1];
+      }
+      printf("%-40s %-s \n", "Info: System image file",
+             in.files.image.name.c_str());
     } else if(CheckString(line[0], "Coordinates")) {
       uint boxnum = stringtoi(line[1]);
       if(boxnum >= BOX_TOTAL) {
@@ -246,6 +280,24 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
       } else {
         in.files.pdb.name[boxnum] = line[2];
       }
+    } else if(CheckString(line[0], "Trajectory")) {
+      uint boxnum = stringtoi(line[1]);
+      if(boxnum >= BOX_TOTAL) {
+        std::cout << "Error: Simulation requires " << BOX_TOTAL << " DCD file(s)!\n";
+        exit(EXIT_FAILURE);
+      }
+      if (multisim != NULL) {
+        in.files.dcd.name[boxnum] = multisim->replicaInputDirectoryPath + line[2];
+      } else {
+        in.files.dcd.name[boxnum] = line[2];
+      }
+      in.restart.recalcFromDCD = true;
+    } else if(CheckString(line[0], "FrameIndexCache")) {
+      in.restart.frameIndexCache = checkBool(line[1]);
+      if(in.restart.frameIndexCache)
+        printf("%-40s %-s \n", "Info: PDB frame index cache", "Active");
+      else
+        printf("%-40s %-s \n", "Info: PDB frame index cache", "Inactive");
     } else if(CheckString(line[0], "Structure")) {
       uint boxnum = stringtoi(line[1]);
       if(boxnum >= BOX_TOTAL) {
@@ -271,6 +323,12 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
       sys.gemc.pressure = stringtod(line[1]);
       printf("%-40s %-4.4f bar\n", "Info: Input Pressure", sys.gemc.pressure);
       sys.gemc.pressure *= unit::BAR_TO_K_MOLECULE_PER_A3;
+    } else if(CheckString(line[0], "BoxParallel")) {
+      sys.boxParallel = checkBool(line[1]);
+      if(sys.boxParallel)
+        printf("%-40s %-s \n", "Info: Box-parallel evaluation", "Active");
+      else
+        printf("%-40s %-s \n", "Info: Box-parallel evaluation", "Inactive");
     }
 #endif
 #if ENSEMBLE == NPT
@@ -419,6 +477,21 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
     } else if(CheckString(line[0], "RcutLow")) {
       sys.ff.cutoffLow = stringtod(line[1]);
       printf("%-40s %-4.4f A\n", "Info: Short Range Cutoff", sys.ff.cutoffLow);
+    } else if(CheckString(line[0], "EarlyRejection")) {
+      sys.earlyReject = checkBool(line[1]);
+      if(sys.earlyReject) {
+        printf("%-40s %-s \n", "Info: Early rejection Disp./Rot.", "Active");
+      } else {
+        printf("%-40s %-s \n", "Info: Early rejection Disp./Rot.",
+               "Inactive");
+      }
+    } else if(CheckString(line[0], "IntraCacheCheck")) {
+      sys.intraCacheCheck = checkBool(line[1]);
+      if(sys.intraCacheCheck) {
+        printf("%-40s %-s \n", "Info: Intra energy cache check", "Active");
+      } else {
+        printf("%-40s %-s \n", "Info: Intra energy cache check", "Inactive");
+      }
     } else if(CheckString(line[0], "Exclude")) {
       if(line[1] == sys.exclude.EXC_ONETWO) {
         sys.exclude.EXCLUDE_KIND = sys.exclude.EXC_ONETWO_KIND;
@@ -464,6 +537,14 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
       } else {
         printf("%-40s %-s \n", "Info: Cache Ewald Fourier", "Inactive");
       }
+    } else if(CheckString(line[0], "RecipParallel")) {
+      sys.recipParallel = checkBool(line[1]);
+      if(sys.recipParallel) {
+        printf("%-40s %-s \n", "Info: Concurrent real/recip. space", "Active");
+      } else {
+        printf("%-40s %-s \n", "Info: Concurrent real/recip. space",
+               "Inactive");
+      }
     } else if(CheckString(line[0], "1-4scaling")) {
       sys.elect.oneFourScale = stringtod(line[1]);
     } else if(CheckString(line[0], "Dielectric")) {
@@ -518,6 +599,27 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
       sys.step.parallelTemperingAttemptsPerExchange = stringtoi(line[1]);
       printf("%-40s %lu \n", "Info: Number of Attempts Per Exchange Move",
              sys.step.parallelTemperingAttemptsPerExchange);
+    } else if(CheckString(line[0], "ReplicaPinning")) {
+      sys.step.replicaPinning = checkBool(line[1]);
+      if(sys.step.replicaPinning)
+        printf("%-40s %-s \n", "Info: Pin replica threads", "Active");
+      else
+        printf("%-40s %-s \n", "Info: Pin replica threads", "Inactive");
+    } else if(CheckString(line[0], "ParallelTemperingSwapLabels")) {
+      sys.step.parallelTempSwapLabels = checkBool(line[1]);
+      if(sys.step.parallelTempSwapLabels)
+        printf("%-40s %-s \n", "Info: Exchange temperature labels", "Active");
+      else
+        printf("%-40s %-s \n", "Info: Exchange temperature labels", "Inactive");
+    } else if(CheckString(line[0], "ParallelTemperingAsync")) {
+      sys.step.parallelTempAsync = checkBool(line[1]);
+      if(line.size() == 3)
+        sys.step.parallelTempMaxWait = stringtoi(line[2]);
+      if(sys.step.parallelTempAsync) {
+        printf("%-40s %-lu ms \n", "Info: Asynchronous exchange, max wait",
+               sys.step.parallelTempMaxWait);
+      } else
+        printf("%-40s %-s \n", "Info: Asynchronous exchange", "Inactive");
     } else if(CheckString(line[0], "DisFreq")) {
       sys.moves.displace = stringtod(line[1]);
       printf("%-40s %-4.4f \n", "Info: Displacement move frequency",
@@ -530,6 +632,41 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
       printf("%-40s %-4.4f \n",
              "Info: Multi-Particle move frequency",
              sys.moves.multiParticle);
+    } else if(CheckString(line[0], "DelayedAcceptance")) {
+      config_setup::Surrogate * surr = NULL;
+      if(CheckString(line[1], "MultiParticle"))
+        surr = &sys.mpSurrogate;
+#ifdef VARIABLE_VOLUME
+      else if(CheckString(line[1], "Volume"))
+        surr = &sys.volSurrogate;
+#endif
+      if(surr == NULL || line.size() < 3) {
+        std::cout << "Error: Delayed acceptance needs a move (MultiParticle"
+#ifdef VARIABLE_VOLUME
+                  << " or Volume"
+#endif
+                  << ") and a surrogate energy (Real, LJ or None)!\n";
+        exit(EXIT_FAILURE);
+      }
+      if(CheckString(line[2], "Real")) {
+        surr->kind = surr->SURR_REAL;
+        printf("%-40s %-s \n", ("Info: Delayed acceptance " + line[1]).c_str(),
+               "Real space, old reciprocal");
+      } else if(CheckString(line[2], "LJ") && line.size() == 4) {
+        surr->kind = surr->SURR_LJ;
+        surr->cutoff = stringtod(line[3]);
+        printf("%-40s %-s %4.4f A \n",
+               ("Info: Delayed acceptance " + line[1]).c_str(),
+               "LJ only, cutoff", surr->cutoff);
+      } else if(CheckString(line[2], "None")) {
+        surr->kind = surr->SURR_NONE;
+        printf("%-40s %-s \n", ("Info: Delayed acceptance " + line[1]).c_str(),
+               "Inactive");
+      } else {
+        std::cout << "Error: Unknown surrogate energy " << line[2] << " for "
+                  << "delayed acceptance! Use Real, LJ <cutoff> or None.\n";
+        exit(EXIT_FAILURE);
+      }
     } else if(CheckString(line[0], "IntraSwapFreq")) {
       sys.moves.intraSwap = stringtod(line[1]);
       printf("%-40s %-4.4f \n", "Info: Intra-Swap move frequency",
@@ -777,6 +914,22 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
       sys.cbmcTrials.bonded.dih = stringtoi(line[1]);
       printf("%-40s %-4d \n", "Info: CBMC Dihedral trials",
              sys.cbmcTrials.bonded.dih);
+    } else if(CheckString(line[0], "CBMC_Library")) {
+      sys.cbmcTrials.library = checkBool(line[1]);
+      if(sys.cbmcTrials.library)
+        printf("%-40s %-s \n", "Info: CBMC trial library", "Active");
+      else
+        printf("%-40s %-s \n", "Info: CBMC trial library", "Inactive");
+    } else if(CheckString(line[0], "CBMC_Reservoir")) {
+      sys.cbmcTrials.reservoir = stringtoi(line[1]);
+      printf("%-40s %-4d \n", "Info: CBMC conformer reservoir size",
+             sys.cbmcTrials.reservoir);
+    } else if(CheckString(line[0], "CBMC_Rigid")) {
+      sys.cbmcTrials.rigid = checkBool(line[1]);
+      if(sys.cbmcTrials.rigid)
+        printf("%-40s %-s \n", "Info: CBMC rigid kinds", "Active");
+      else
+        printf("%-40s %-s \n", "Info: CBMC rigid kinds", "Inactive");
     }
 #endif
 #if ENSEMBLE == GCMC
@@ -906,6 +1059,7 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
         std::stringstream replicaDirectory;
         replicaDirectory << multisim->replicaOutputDirectoryPath << line[1];
         out.statistics.settings.uniqueStr.val = replicaDirectory.str();
+        out.statistics.settings.uniqueStr.replica = true;
         printf("%-40s %-s \n", "Info: Output name", replicaDirectory.str().c_str());
       } else {
         out.statistics.settings.uniqueStr.val = line[1];
@@ -920,6 +1074,53 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
                out.checkpoint.frequency);
       else
         printf("%-40s %-s \n", "Info: Saving checkpoint", "Inactive");
+    } else if(CheckString(line[0], "AsyncCheckpoint")) {
+      out.asyncCheckpoint.enable = checkBool(line[1]);
+      if(line.size() == 3) {
+        if(CheckString(line[2], "SKIP"))
+          out.asyncCheckpoint.skip = true;
+        else if(CheckString(line[2], "BLOCK"))
+          out.asyncCheckpoint.skip = false;
+        else {
+          std::cout << "Error: AsyncCheckpoint takes BLOCK or SKIP!"
+                    << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      }
+      if(out.asyncCheckpoint.enable)
+        printf("%-40s %-s \n", "Info: Asynchronous checkpoint",
+               out.asyncCheckpoint.skip ? "Active, skip if busy" :
+               "Active, wait if busy");
+      else
+        printf("%-40s %-s \n", "Info: Asynchronous checkpoint", "Inactive");
+    } else if(CheckString(line[0], "DeltaCheckpoint")) {
+      out.deltaCheckpoint.enable = checkBool(line[1]);
+      if(line.size() == 3)
+        out.deltaCheckpoint.perBase = stringtoi(line[2]);
+      if(out.deltaCheckpoint.perBase < 1) {
+        std::cout << "Error: DeltaCheckpoint needs at least 1 delta per "
+                  << "full checkpoint!" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      if(out.deltaCheckpoint.enable)
+        printf("%-40s %-u \n", "Info: Delta checkpoints per full one",
+               out.deltaCheckpoint.perBase);
+      else
+        printf("%-40s %-s \n", "Info: Delta checkpoint", "Inactive");
+    } else if(CheckString(line[0], "AsyncOutput")) {
+      out.async.enable = checkBool(line[1]);
+      if(line.size() == 3)
+        out.async.depth = stringtoi(line[2]);
+      if(out.async.depth < 1) {
+        std::cout << "Error: AsyncOutput queue depth must be at least 1!"
+                  << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      if(out.async.enable)
+        printf("%-40s %-u \n", "Info: Asynchronous output queue depth",
+               out.async.depth);
+      else
+        printf("%-40s %-s \n", "Info: Asynchronous output", "Inactive");
     } else if(CheckString(line[0], "CoordinatesFreq")) {
       out.state.settings.enable = checkBool(line[1]);
       if(line.size() == 3)
@@ -933,6 +1134,38 @@ void ConfigSetup::Init(const char *fileName, MultiSim const*const& multisim)
                out.state.settings.frequency);
       } else
         printf("%-40s %-s \n", "Info: Printing coordinate", "Inactive");
+    } else if(CheckString(line[0], "CoordinatesFormat")) {
+      if(CheckString(line[1], "PDB")) {
+        out.state.format.pdb = true;
+        out.state.format.dcd = false;
+      } else if(CheckString(line[1], "DCD")) {
+        out.state.format.pdb = false;
+        out.state.format.dcd = true;
+      } else if(CheckString(line[1], "BOTH")) {
+        out.state.format.pdb = true;
+        out.state.format.dcd = true;
+      } else {
+        std::cout << "Error: CoordinatesFormat must be PDB, DCD or BOTH!"
+                  << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      printf("%-40s %-s \n", "Info: Coordinate format", line[1].c_str());
+    } else if(CheckString(line[0], "StatisticsFormat")) {
+      if(CheckString(line[1], "TEXT")) {
+        out.statistics.format.text = true;
+        out.statistics.format.binary = false;
+      } else if(CheckString(line[1], "BINARY")) {
+        out.statistics.format.text = false;
+        out.statistics.format.binary = true;
+      } else if(CheckString(line[1], "BOTH")) {
+        out.statistics.format.text = true;
+        out.statistics.format.binary = true;
+      } else {
+        std::cout << "Error: StatisticsFormat must be TEXT, BINARY or BOTH!"
+                  << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      printf("%-40s %-s \n", "Info: Statistics format", line[1].c_str());
     } else if(CheckString(line[0], "RestartFreq")) {
       out.restart.settings.enable = checkBool(line[1]);
       if(line.size() == 3)
@@ -1312,6 +1545,8 @@ void ConfigSetup::fillDefaults(void)
     toStr >> numStr;
     out.state.files.pdb.name[i] = out.statistics.settings.uniqueStr.val +
                                   "_BOX_" + numStr + ".pdb";
+    out.state.files.dcd.name[i] = out.statistics.settings.uniqueStr.val +
+                                  "_BOX_" + numStr + ".dcd";
   }
   out.state.files.seed.name = out.statistics.settings.uniqueStr.val + ".dat";
 }
@@ -1369,12 +1604,10 @@ void ConfigSetup::verifyInputs(void)
   }
 #endif
 
-#if GOMC_LIB_MPI
   if(sys.step.parallelTemp && in.prngParallelTempering.kind != "INTSEED") {
     std::cout << "Error: INTSEED required for parallel tempering!" << std::endl;
     exit(EXIT_FAILURE);
   }
-#endif
 
   if(in.prng.kind == "INTSEED" && in.prng.seed == UINT_MAX) {
     std::cout << "Error: Seed value is not specified!" << std::endl;
@@ -1408,6 +1641,22 @@ void ConfigSetup::verifyInputs(void)
     std::cout << "Error: Potential type is not specified!" << std::endl;
     exit(EXIT_FAILURE);
   }
+  if((sys.volSurrogate.kind == sys.volSurrogate.SURR_LJ &&
+      (sys.volSurrogate.cutoff <= 0.0 ||
+       sys.volSurrogate.cutoff > sys.ff.cutoff)) ||
+      (sys.mpSurrogate.kind == sys.mpSurrogate.SURR_LJ &&
+       (sys.mpSurrogate.cutoff <= 0.0 ||
+        sys.mpSurrogate.cutoff > sys.ff.cutoff))) {
+    std::cout << "Error: Delayed acceptance LJ cutoff must be positive and "
+              << "not larger than Rcut!" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if(sys.earlyReject && (in.ffKind.isMARTINI ||
+                         sys.ff.VDW_KIND == sys.ff.VDW_EXP6_KIND)) {
+    std::cout << "Error: Early rejection is not supported for MARTINI or "
+              << "EXP6 potentials!" << std::endl;
+    exit(EXIT_FAILURE);
+  }
   if(((sys.ff.VDW_KIND == sys.ff.VDW_STD_KIND) ||
       (sys.ff.VDW_KIND == sys.ff.VDW_EXP6_KIND)) && (sys.ff.doTailCorr == false)) {
     std::cout << "Warning: Long Range Correction is Inactive for " <<
@@ -1517,6 +1766,21 @@ void ConfigSetup::verifyInputs(void)
       exit(EXIT_FAILURE);
     }
   }
+  if(in.restart.recalcFromDCD) {
+    if(!in.restart.recalcTrajectory) {
+      printf("%-40s \n", "Warning: Trajectory is set but it will be ignored.");
+      in.restart.recalcFromDCD = false;
+    } else {
+      for(i = 0 ; i < BOX_TOTAL ; i++) {
+        if(in.files.dcd.name[i] == "") {
+          std::cout << "Error: DCD trajectory is not specified for box number "
+                    << i << "!" << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      }
+      printf("%-40s %-s \n", "Info: Recalculate Trajectory from", "DCD");
+    }
+  }
   for(i = 0 ; i < BOX_TOTAL ; i++) {
     if(in.files.psf.name[i] == "") {
       std::cout << "Error: PSF file is not specified for box number " <<
@@ -1959,6 +2223,9 @@ const uint config_setup::FFValues::VDW_STD_KIND = 0;
 const uint config_setup::FFValues::VDW_SHIFT_KIND = 1;
 const uint config_setup::FFValues::VDW_SWITCH_KIND = 2;
 const uint config_setup::FFValues::VDW_EXP6_KIND = 3;
+const uint config_setup::Surrogate::SURR_NONE = 0;
+const uint config_setup::Surrogate::SURR_REAL = 1;
+const uint config_setup::Surrogate::SURR_LJ = 2;
 const uint config_setup::Exclude::EXC_ONETWO_KIND = 0;
 const uint config_setup::Exclude::EXC_ONETHREE_KIND = 1;
 const uint config_setup::Exclude::EXC_ONEFOUR_KIND = 2;
@@ -60,6 +60,10 @@ struct RestartSettings {
   bool enable;
   ulong step;
   bool recalcTrajectory;
+  //frames of the recalculated trajectory come from DCD files
+  bool recalcFromDCD;
+  //keep the frame index of a PDB trajectory in <file>.idx
+  bool frameIndexCache;
   bool restartFromCheckpoint;
   bool operator()(void)
   {
@@ -95,8 +99,10 @@ struct FFKind {
 //Files for input.
 struct InFiles {
   FileName param;
-  FileNames<BOX_TOTAL> pdb, psf;
+  FileNames<BOX_TOTAL> pdb, psf, dcd;
   FileName seed;
+  //binary image of the molecule kinds, none if the name is empty
+  FileName image;
 };
 
 //Input section of config file data.
@@ -162,6 +168,14 @@ struct Step {
   ulong total, equil, adjustment, pressureCalcFreq, parallelTempFreq, parallelTemperingAttemptsPerExchange;
   bool pressureCalc;
   bool parallelTemp;
+  //pin the thread team of each replica to its own cores
+  bool replicaPinning;
+  //exchange temperatures and move settings, configurations stay in place
+  bool parallelTempSwapLabels;
+  //replicas exchange with whichever neighbor is ready instead of in
+  //lockstep, waiting at most parallelTempMaxWait milliseconds
+  bool parallelTempAsync;
+  ulong parallelTempMaxWait;
 };
 
 //Holds the percentage of each kind of move for this ensemble.
@@ -177,6 +191,16 @@ struct MovePercents {
 #endif
 };
 
+//Cheap energy used to screen a move before its exact energy is computed
+//(delayed acceptance)
+struct Surrogate {
+  uint kind;
+  double cutoff; //only used by SURR_LJ
+  Surrogate(void) : kind(SURR_NONE), cutoff(0.0) {}
+
+  static const uint SURR_NONE, SURR_REAL, SURR_LJ;
+};
+
 struct ElectroStatic {
   bool readEwald;
   bool readElect;
@@ -235,6 +259,9 @@ struct GrowBond {
 struct CBMC {
   GrowNonbond nonbonded;
   GrowBond bonded;
+  bool library; //precomputed orientation/bend/torsion trial tables
+  uint reservoir; //ideal-gas conformers stored per kind for swaps, 0 is off
+  bool rigid; //rigid-body swaps for kinds without internal DOF
 };
 
 struct MEMCVal {
@@ -311,6 +338,11 @@ struct SystemVals {
   MEMCVal memcVal, intraMemcVal;
   CFCMCVal cfcmcVal;
   FreeEnergy freeEn;
+  bool boxParallel; //evaluate the boxes concurrently
+  bool recipParallel; //evaluate real space and reciprocal concurrently
+  bool earlyReject; //stop displacement/rotation energies once rejected
+  bool intraCacheCheck; //verify the cached intramolecular energies
+  Surrogate volSurrogate, mpSurrogate;
 #if ENSEMBLE == GCMC
   ChemicalPotential chemPot;
 #elif ENSEMBLE == GEMC || ENSEMBLE == NPT
@@ -332,6 +364,8 @@ struct EventSettings { /* : ReadableStepDependentBase*/
 
 struct UniqueStr { /* : ReadableBase*/
   std::string val;
+  //val is prefixed with the output directory of a replica
+  bool replica;
 };
 
 struct HistFiles { /* : ReadableBase*/
@@ -341,7 +375,7 @@ struct HistFiles { /* : ReadableBase*/
 
 //Files for output.
 struct OutFiles {
-  FileNames<BOX_TOTAL> pdb;
+  FileNames<BOX_TOTAL> pdb, dcd;
   FileName psf, seed;
   HistFiles hist;
 };
@@ -367,18 +401,54 @@ struct TrackedVars {
   OutputEnables surfaceTension;
 };
 
+//Formats of the coordinate trajectory
+struct CoordFormat {
+  bool pdb, dcd;
+};
+
 struct SysState {
   EventSettings settings;
+  CoordFormat format;
   OutFiles files;
 };
+//Formats of the block average, free energy and GCMC sample output
+struct StatsFormat {
+  bool text, binary;
+};
+
 struct Statistics {
   Settings settings;
   TrackedVars vars;
+  StatsFormat format;
 };
+//Output formatted and written on its own thread, with at most depth
+//outputs waiting
+struct AsyncOutput {
+  bool enable;
+  uint depth;
+};
+
+//Checkpoints written on their own thread from a snapshot of the state. A
+//checkpoint due while the last one is still being written is skipped, or
+//waits for it
+struct AsyncCheckpoint {
+  bool enable, skip;
+};
+
+//Between full checkpoints, perBase checkpoints that only hold the
+//molecules moved since the checkpoint before
+struct DeltaCheckpoint {
+  bool enable;
+  uint perBase;
+};
+
 struct Output {
   SysState state, restart;
   Statistics statistics;
   EventSettings console, checkpoint;
+  AsyncOutput async;
+  AsyncCheckpoint asyncCheckpoint;
+  DeltaCheckpoint deltaCheckpoint;
 };
 
 }
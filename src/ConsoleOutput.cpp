@@ -19,132 +19,176 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 
 void ConsoleOutput::DoOutput(const ulong step)
 {
-  if (step == 0) {
-    std::cout << std::endl << "################################################################################" << std::endl;
-    std::cout << "########################## INITIAL SIMULATION ENERGY ###########################" << std::endl << std::endl;
+  Snapshot(frame, step);
+  WriteFrame(frame);
+}
+
+void ConsoleOutput::Snapshot(ConsoleFrame & frame, const ulong step)
+{
+  frame.step = step;
+  //mole fractions are only kept with more than one kind
+  if (var->numKinds > 1)
+    frame.molFraction.assign(var->molFractionByKindBox,
+                             var->molFractionByKindBox +
+                             BOX_TOTAL * var->numKinds);
+  frame.molDensity.assign(var->densityByKindBox, var->densityByKindBox +
+                          BOX_TOTAL * var->numKinds);
+  for (uint b = 0; b < BOX_TOTAL; b++) {
+    frame.energy[b] = var->energyRef[b];
+    for (uint m = 0; m < mv::MOVE_KINDS_TOTAL; m++) {
+      frame.tries[b][m] = var->GetTries(b, m);
+      frame.accepted[b][m] = var->GetAccepted(b, m);
+      frame.acceptPercent[b][m] = var->GetAcceptPercent(b, m);
+      frame.scale[b][m] = var->GetScale(b, m);
+    }
+    frame.volume[b] = var->volumeRef[b];
+    frame.densityTot[b] = var->densityTot[b];
+    frame.numByBox[b] = var->numByBox[b];
+    //The pressure is only calculated for boxes with interactions
+    frame.pressure[b] = frame.surfaceTens[b] = 0.0;
+    for (uint i = 0; i < 3; i++)
+      frame.pressureTens[b][i] = 0.0;
+    if (b < BOXES_WITH_U_NB) {
+      frame.pressure[b] = var->pressure[b];
+      frame.surfaceTens[b] = var->surfaceTens[b];
+      for (uint i = 0; i < 3; i++)
+        frame.pressureTens[b][i] = var->pressureTens[b][i][i];
+    }
+  }
+}
+
+void ConsoleOutput::WriteFrame(ConsoleFrame & frame)
+{
+  std::ostringstream & out = frame.text;
+  out.str("");
+  if (frame.step == 0) {
+    out << std::endl << "################################################################################" << std::endl;
+    out << "########################## INITIAL SIMULATION ENERGY ###########################" << std::endl << std::endl;
 
-    PrintEnergyTitle();
-    std::cout << std::endl;
+    PrintEnergyTitle(out);
+    out << std::endl;
 
     for (uint b = 0; b < BOX_TOTAL; b++) {
-      PrintEnergy(b, var->energyRef[b], var->virialRef[b], -1);
-      std::cout <<  std::endl;
+      PrintEnergy(out, b, frame.energy[b], -1);
+      out <<  std::endl;
     }
 
     if(enableStat) {
-      PrintStatisticTitle();
-      std::cout << std::endl;
+      PrintStatisticTitle(out);
+      out << std::endl;
 
       for (uint b = 0; b < BOX_TOTAL; b++) {
-        PrintStatistic(b, -1);
-        std::cout << std::endl;
+        PrintStatistic(out, frame, b, -1);
+        out << std::endl;
       }
     }
 
-    std::cout << "################################################################################" << std::endl;
+    out << "################################################################################" << std::endl;
 
-    std::cout << "############################# STARTING SIMULATION ##############################" << std::endl << std::endl;
+    out << "############################# STARTING SIMULATION ##############################" << std::endl << std::endl;
 
     if(!forceOutput) {
-      PrintMoveTitle();
-      std::cout << std::endl;
+      PrintMoveTitle(out);
+      out << std::endl;
     }
 
     if(enableEnergy) {
-      PrintEnergyTitle();
-      std::cout << std::endl;
+      PrintEnergyTitle(out);
+      out << std::endl;
     }
 
     if(enableStat) {
-      PrintStatisticTitle();
-      std::cout << std::endl;
+      PrintStatisticTitle(out);
+      out << std::endl;
     }
   } else {
     for(uint b = 0; b < BOX_TOTAL; b++) {
       if(!forceOutput) {
-        PrintMove(b, step);
-        std::cout << std::endl;
+        PrintMove(out, frame, b, frame.step);
+        out << std::endl;
       }
 
       if(enableEnergy) {
-        PrintEnergy(b, var->energyRef[b], var->virialRef[b], step);
-        std::cout << std::endl;
+        PrintEnergy(out, b, frame.energy[b], frame.step);
+        out << std::endl;
       }
 
       if(enableStat) {
-        PrintStatistic(b, step);
-        std::cout << std::endl;
+        PrintStatistic(out, frame, b, frame.step);
+        out << std::endl;
       }
 
       if(enablePressure) {
-        PrintPressureTensor(b, step);
-        std::cout << std::endl;
+        PrintPressureTensor(out, frame, b, frame.step);
+        out << std::endl;
       }
 
     }
 
   }
+  std::cout << out.str() << std::flush;
 }
 
-void ConsoleOutput::PrintMove(const uint box, const ulong step) const
+void ConsoleOutput::PrintMove(std::ostream & out, ConsoleFrame const& frame,
+                              const uint box, const ulong step) const
 {
   uint sub;
   std::string title = "MOVE_";
   title += (box ? "1:" : "0:");
-  printElementStep(title, step + 1, elementWidth);
+  printElementStep(out, title, step + 1, elementWidth);
 
 #if ENSEMBLE == GCMC
   if(box == mv::BOX0) {
 #endif
     if(var->Performed(mv::DISPLACE)) {
       sub = mv::DISPLACE;
-      printElement(var->GetTries(box, sub), elementWidth);
-      printElement(var->GetAccepted(box, sub), elementWidth);
-      printElement(var->GetAcceptPercent(box, sub), elementWidth);
-      printElement(var->GetScale(box, sub), elementWidth);
+      printElement(out, frame.tries[box][sub], elementWidth);
+      printElement(out, frame.accepted[box][sub], elementWidth);
+      printElement(out, frame.acceptPercent[box][sub], elementWidth);
+      printElement(out, frame.scale[box][sub], elementWidth);
     }
 
     if(var->Performed(mv::ROTATE)) {
       sub = mv::ROTATE;
-      printElement(var->GetTries(box, sub), elementWidth);
-      printElement(var->GetAccepted(box, sub), elementWidth);
-      printElement(var->GetAcceptPercent(box, sub), elementWidth);
-      printElement(var->GetScale(box, sub), elementWidth);
+      printElement(out, frame.tries[box][sub], elementWidth);
+      printElement(out, frame.accepted[box][sub], elementWidth);
+      printElement(out, frame.acceptPercent[box][sub], elementWidth);
+      printElement(out, frame.scale[box][sub], elementWidth);
     }
 
     if(var->Performed(mv::MULTIPARTICLE)) {
       sub = mv::MULTIPARTICLE;
-      printElement(var->GetTries(box, sub), elementWidth);
-      printElement(var->GetAccepted(box, sub), elementWidth);
-      printElement(var->GetAcceptPercent(box, sub), elementWidth);
+      printElement(out, frame.tries[box][sub], elementWidth);
+      printElement(out, frame.accepted[box][sub], elementWidth);
+      printElement(out, frame.acceptPercent[box][sub], elementWidth);
     }
 
     if(var->Performed(mv::INTRA_SWAP)) {
       sub = mv::INTRA_SWAP;
-      printElement(var->GetTries(box, sub), elementWidth);
-      printElement(var->GetAccepted(box, sub), elementWidth);
-      printElement(var->GetAcceptPercent(box, sub), elementWidth);
+      printElement(out, frame.tries[box][sub], elementWidth);
+      printElement(out, frame.accepted[box][sub], elementWidth);
+      printElement(out, frame.acceptPercent[box][sub], elementWidth);
     }
 
     if(var->Performed(mv::REGROWTH)) {
       sub = mv::REGROWTH;
-      printElement(var->GetTries(box, sub), elementWidth);
-      printElement(var->GetAccepted(box, sub), elementWidth);
-      printElement(var->GetAcceptPercent(box, sub), elementWidth);
+      printElement(out, frame.tries[box][sub], elementWidth);
+      printElement(out, frame.accepted[box][sub], elementWidth);
+      printElement(out, frame.acceptPercent[box][sub], elementWidth);
     }
 
     if(var->Performed(mv::INTRA_MEMC)) {
       sub = mv::INTRA_MEMC;
-      printElement(var->GetTries(box, sub), elementWidth);
-      printElement(var->GetAccepted(box, sub), elementWidth);
-      printElement(var->GetAcceptPercent(box, sub), elementWidth);
+      printElement(out, frame.tries[box][sub], elementWidth);
+      printElement(out, frame.accepted[box][sub], elementWidth);
+      printElement(out, frame.acceptPercent[box][sub], elementWidth);
     }
 
     if(var->Performed(mv::CRANKSHAFT)) {
       sub = mv::CRANKSHAFT;
-      printElement(var->GetTries(box, sub), elementWidth);
-      printElement(var->GetAccepted(box, sub), elementWidth);
-      printElement(var->GetAcceptPercent(box, sub), elementWidth);
+      printElement(out, frame.tries[box][sub], elementWidth);
+      printElement(out, frame.accepted[box][sub], elementWidth);
+      printElement(out, frame.acceptPercent[box][sub], elementWidth);
     }
 
 #if ENSEMBLE == GCMC
@@ -154,40 +198,42 @@ void ConsoleOutput::PrintMove(const uint box, const ulong step) const
 #if ENSEMBLE == GEMC || ENSEMBLE == GCMC
   if(var->Performed(mv::MOL_TRANSFER)) {
     sub = mv::MOL_TRANSFER;
-    printElement(var->GetTries(box, sub), elementWidth);
-    printElement(var->GetAccepted(box, sub), elementWidth);
-    printElement(var->GetAcceptPercent(box, sub), elementWidth);
+    printElement(out, frame.tries[box][sub], elementWidth);
+    printElement(out, frame.accepted[box][sub], elementWidth);
+    printElement(out, frame.acceptPercent[box][sub], elementWidth);
   }
 
   if(var->Performed(mv::MEMC)) {
     sub = mv::MEMC;
-    printElement(var->GetTries(box, sub), elementWidth);
-    printElement(var->GetAccepted(box, sub), elementWidth);
-    printElement(var->GetAcceptPercent(box, sub), elementWidth);
+    printElement(out, frame.tries[box][sub], elementWidth);
+    printElement(out, frame.accepted[box][sub], elementWidth);
+    printElement(out, frame.acceptPercent[box][sub], elementWidth);
   }
 
   if(var->Performed(mv::CFCMC)) {
     sub = mv::CFCMC;
-    printElement(var->GetTries(box, sub), elementWidth);
-    printElement(var->GetAccepted(box, sub), elementWidth);
-    printElement(var->GetAcceptPercent(box, sub), elementWidth);
+    printElement(out, frame.tries[box][sub], elementWidth);
+    printElement(out, frame.accepted[box][sub], elementWidth);
+    printElement(out, frame.acceptPercent[box][sub], elementWidth);
   }
 #endif
 
 #if ENSEMBLE == GEMC || ENSEMBLE == NPT
   if(var->Performed(mv::VOL_TRANSFER)) {
     sub = mv::VOL_TRANSFER;
-    printElement(var->GetTries(box, sub), elementWidth);
-    printElement(var->GetAccepted(box, sub), elementWidth);
-    printElement(var->GetAcceptPercent(box, sub), elementWidth);
-    printElement(var->GetScale(box, sub), elementWidth);
+    printElement(out, frame.tries[box][sub], elementWidth);
+    printElement(out, frame.accepted[box][sub], elementWidth);
+    printElement(out, frame.acceptPercent[box][sub], elementWidth);
+    printElement(out, frame.scale[box][sub], elementWidth);
   }
 #endif
 
-  std::cout << std::endl;
+  out << std::endl;
 }
 
-void ConsoleOutput::PrintStatistic(const uint box, const ulong step) const
+void ConsoleOutput::PrintStatistic(std::ostream & out,
+                                   ConsoleFrame const& frame,
+                                   const uint box, const ulong step) const
 {
   double density = 0.0;
   uint offset = box * var->numKinds;
@@ -198,38 +244,41 @@ void ConsoleOutput::PrintStatistic(const uint box, const ulong step) const
   toStr << box;
   toStr >> numStr;
   title += numStr + ":";
-  printElementStep(title, step + 1, elementWidth);
+  printElementStep(out, title, step + 1, elementWidth);
 
   if(enableVolume)
-    printElement(var->volumeRef[box], elementWidth);
+    printElement(out, frame.volume[box], elementWidth);
 
   if(enablePressure)
-    printElement(var->pressure[box], elementWidth);
+    printElement(out, frame.pressure[box], elementWidth);
 
   if(enableMol) {
-    printElement(var->numByBox[box], elementWidth);
+    printElement(out, frame.numByBox[box], elementWidth);
 
     for(uint k = 0; k < var->numKinds; k++) {
       uint kb = k + offset;
       if(var->numKinds > 1)
-        printElement(var->molFractionByKindBox[kb], elementWidth, 8);
+        printElement(out, frame.molFraction[kb], elementWidth, 8);
     }
     for(uint k = 0; k < var->numKinds; k++) {
       uint kb = k + offset;
       if(var->numKinds > 1)
-        printElement(var->densityByKindBox[kb], elementWidth, 8);
+        printElement(out, frame.molDensity[kb], elementWidth, 8);
     }
   }
 
   if(enableDens)
-    printElement(var->densityTot[box], elementWidth);
+    printElement(out, frame.densityTot[box], elementWidth);
   if(enableSurfTension)
-    printElement(var->surfaceTens[box], elementWidth);
+    printElement(out, frame.surfaceTens[box], elementWidth);
 
-  std::cout << std::endl;
+  out << std::endl;
 }
 
-void ConsoleOutput::PrintPressureTensor(const uint box, const ulong step) const
+void ConsoleOutput::PrintPressureTensor(std::ostream & out,
+                                        ConsoleFrame const& frame,
+                                        const uint box,
+                                        const ulong step) const
 {
   std::string title = "PRES_";
   sstrm::Converter toStr;
@@ -237,25 +286,25 @@ void ConsoleOutput::PrintPressureTensor(const uint box, const ulong step) const
   toStr << box;
   toStr >> numStr;
   title += numStr + ":";
-  printElementStep(title, step + 1, elementWidth);
+  printElementStep(out, title, step + 1, elementWidth);
 
   for(uint i = 0; i < 3; i++) {
     //If you calculate the pressure tensor for W12, W13, W23 we print all 9 values of tensor
     /*
       for(uint j = 0; j < 3; j++)
       {
-         printElement(var->pressureTens[box][i][j], elementWidth);
+         printElement(out, var->pressureTens[box][i][j], elementWidth);
       }
     */
     // Else, just print the diameter of the pressure Tensor, W11, W22, W33
-    printElement(var->pressureTens[box][i][i], elementWidth);
+    printElement(out, frame.pressureTens[box][i], elementWidth);
   }
-  std::cout << std::endl;
+  out << std::endl;
 }
 
 
-void ConsoleOutput::PrintEnergy(const uint box, Energy const& en,
-                                Virial const& vir, const ulong step) const
+void ConsoleOutput::PrintEnergy(std::ostream & out, const uint box,
+                                Energy const& en, const ulong step) const
 {
   std::string title = "ENER_";
   sstrm::Converter toStr;
@@ -263,193 +312,195 @@ void ConsoleOutput::PrintEnergy(const uint box, Energy const& en,
   toStr << box;
   toStr >> numStr;
   title += numStr + ":";
-  printElementStep(title, step + 1, elementWidth);
-
-  printElement(en.total, elementWidth);
-  printElement(en.intraBond, elementWidth);
-  printElement(en.intraNonbond, elementWidth);
-  printElement(en.inter, elementWidth);
-  printElement(en.tc, elementWidth);
-  printElement(en.totalElect, elementWidth);
-  printElement(en.real, elementWidth);
-  printElement(en.recip, elementWidth);
-  printElement(en.self, elementWidth);
-  printElement(en.correction, elementWidth);
-  std::cout << std::endl;
+  printElementStep(out, title, step + 1, elementWidth);
+
+  printElement(out, en.total, elementWidth);
+  printElement(out, en.intraBond, elementWidth);
+  printElement(out, en.intraNonbond, elementWidth);
+  printElement(out, en.inter, elementWidth);
+  printElement(out, en.tc, elementWidth);
+  printElement(out, en.totalElect, elementWidth);
+  printElement(out, en.real, elementWidth);
+  printElement(out, en.recip, elementWidth);
+  printElement(out, en.self, elementWidth);
+  printElement(out, en.correction, elementWidth);
+  out << std::endl;
 }
 
-void ConsoleOutput::PrintEnergyTitle()
+void ConsoleOutput::PrintEnergyTitle(std::ostream & out)
 {
   std::string title = "ETITLE:";
   title += "     STEP";
-  printElement(title, elementWidth);
-
-  printElement("TOTAL", elementWidth);
-  printElement("INTRA(B)", elementWidth);
-  printElement("INTRA(NB)", elementWidth);
-  printElement("INTER(LJ)", elementWidth);
-  printElement("LRC", elementWidth);
-  printElement("TOTAL_ELECT", elementWidth);
-  printElement("REAL", elementWidth);
-  printElement("RECIP", elementWidth);
-  printElement("SELF", elementWidth);
-  printElement("CORR", elementWidth);
-  std::cout << std::endl;
+  printElement(out, title, elementWidth);
+
+  printElement(out, "TOTAL", elementWidth);
+  printElement(out, "INTRA(B)", elementWidth);
+  printElement(out, "INTRA(NB)", elementWidth);
+  printElement(out, "INTER(LJ)", elementWidth);
+  printElement(out, "LRC", elementWidth);
+  printElement(out, "TOTAL_ELECT", elementWidth);
+  printElement(out, "REAL", elementWidth);
+  printElement(out, "RECIP", elementWidth);
+  printElement(out, "SELF", elementWidth);
+  printElement(out, "CORR", elementWidth);
+  out << std::endl;
 }
 
-void ConsoleOutput::PrintStatisticTitle()
+void ConsoleOutput::PrintStatisticTitle(std::ostream & out)
 {
   //uint offset = box * var->numKinds;
   if(enableStat) {
     std::string title = "STITLE:";
     title += "     STEP";
-    printElement(title, elementWidth);
+    printElement(out, title, elementWidth);
   }
 
   if(enableVolume)
-    printElement("VOLUME", elementWidth);
+    printElement(out, "VOLUME", elementWidth);
 
   if(enablePressure)
-    printElement("PRESSURE", elementWidth);
+    printElement(out, "PRESSURE", elementWidth);
 
   if(enableMol) {
-    printElement("TOTALMOL", elementWidth);
+    printElement(out, "TOTALMOL", elementWidth);
 
     for(uint k = 0; k < var->numKinds; k++) {
       if(var->numKinds > 1) {
         std::string molName = "MOLFRAC_" + var->resKindNames[k];
-        printElement(molName, elementWidth);
+        printElement(out, molName, elementWidth);
       }
     }
     for(uint k = 0; k < var->numKinds; k++) {
       if(var->numKinds > 1) {
         std::string molName = "MOLDENS_" + var->resKindNames[k];
-        printElement(molName, elementWidth);
+        printElement(out, molName, elementWidth);
       }
     }
   }
 
   if(enableDens)
-    printElement("TOT_DENSITY", elementWidth);
+    printElement(out, "TOT_DENSITY", elementWidth);
   if(enableSurfTension)
-    printElement("SURF_TENSION", elementWidth);
+    printElement(out, "SURF_TENSION", elementWidth);
 
-  std::cout << std::endl;
+  out << std::endl;
 }
 
 
-void ConsoleOutput::PrintMoveTitle()
+void ConsoleOutput::PrintMoveTitle(std::ostream & out)
 {
   std::string title = "MTITLE:";
   title += "     STEP";
-  printElement(title, elementWidth);
+  printElement(out, title, elementWidth);
   if(var->Performed(mv::DISPLACE)) {
-    printElement("DISTRY", elementWidth);
-    printElement("DISACCEPT", elementWidth);
-    printElement("DISACCEPT%", elementWidth);
-    printElement("DISMAX", elementWidth);
+    printElement(out, "DISTRY", elementWidth);
+    printElement(out, "DISACCEPT", elementWidth);
+    printElement(out, "DISACCEPT%", elementWidth);
+    printElement(out, "DISMAX", elementWidth);
   }
 
   if(var->Performed(mv::ROTATE)) {
-    printElement("ROTATE", elementWidth);
-    printElement("ROTACCEPT", elementWidth);
-    printElement("ROTACCEPT%", elementWidth);
-    printElement("ROTMAX", elementWidth);
+    printElement(out, "ROTATE", elementWidth);
+    printElement(out, "ROTACCEPT", elementWidth);
+    printElement(out, "ROTACCEPT%", elementWidth);
+    printElement(out, "ROTMAX", elementWidth);
   }
 
   if(var->Performed(mv::MULTIPARTICLE)) {
-    printElement("MULTIPARTICLE", elementWidth);
-    printElement("MPACCEPT", elementWidth);
-    printElement("MPACCEPT%", elementWidth);
+    printElement(out, "MULTIPARTICLE", elementWidth);
+    printElement(out, "MPACCEPT", elementWidth);
+    printElement(out, "MPACCEPT%", elementWidth);
   }
 
   if(var->Performed(mv::INTRA_SWAP)) {
-    printElement("INTRASWAP", elementWidth);
-    printElement("INTACCEPT", elementWidth);
-    printElement("INTACCEPT%", elementWidth);
+    printElement(out, "INTRASWAP", elementWidth);
+    printElement(out, "INTACCEPT", elementWidth);
+    printElement(out, "INTACCEPT%", elementWidth);
   }
 
   if(var->Performed(mv::REGROWTH)) {
-    printElement("REGROWTH", elementWidth);
-    printElement("REGROWACCEPT", elementWidth);
-    printElement("REGROWACCEPT%", elementWidth);
+    printElement(out, "REGROWTH", elementWidth);
+    printElement(out, "REGROWACCEPT", elementWidth);
+    printElement(out, "REGROWACCEPT%", elementWidth);
   }
 
   if(var->Performed(mv::INTRA_MEMC)) {
-    printElement("INTRAMOLEXCHANGE", elementWidth);
-    printElement("INTMOLEXCACCEPT", elementWidth);
-    printElement("INTMOLEXACCEPT%", elementWidth);
+    printElement(out, "INTRAMOLEXCHANGE", elementWidth);
+    printElement(out, "INTMOLEXCACCEPT", elementWidth);
+    printElement(out, "INTMOLEXACCEPT%", elementWidth);
   }
 
   if(var->Performed(mv::CRANKSHAFT)) {
-    printElement("CRANKSHAFT", elementWidth);
-    printElement("CRKSHAFTACCEPT", elementWidth);
-    printElement("CRKSHAFTACCEPT%", elementWidth);
+    printElement(out, "CRANKSHAFT", elementWidth);
+    printElement(out, "CRKSHAFTACCEPT", elementWidth);
+    printElement(out, "CRKSHAFTACCEPT%", elementWidth);
   }
 
 #if ENSEMBLE == GEMC || ENSEMBLE == GCMC
   if(var->Performed(mv::MOL_TRANSFER)) {
-    printElement("TRANSFER", elementWidth);
-    printElement("TRANACCEPT", elementWidth);
-    printElement("TRANACCEPT%", elementWidth);
+    printElement(out, "TRANSFER", elementWidth);
+    printElement(out, "TRANACCEPT", elementWidth);
+    printElement(out, "TRANACCEPT%", elementWidth);
   }
 
   if(var->Performed(mv::MEMC)) {
-    printElement("MOLEXCHANGE", elementWidth);
-    printElement("MOLEXACCEPT", elementWidth);
-    printElement("MOLEXACCEPT%", elementWidth);
+    printElement(out, "MOLEXCHANGE", elementWidth);
+    printElement(out, "MOLEXACCEPT", elementWidth);
+    printElement(out, "MOLEXACCEPT%", elementWidth);
   }
 
   if(var->Performed(mv::CFCMC)) {
-    printElement("CFCMCTRANSF", elementWidth);
-    printElement("CFCMCACCEPT", elementWidth);
-    printElement("CFCMCACCEPT%", elementWidth);
+    printElement(out, "CFCMCTRANSF", elementWidth);
+    printElement(out, "CFCMCACCEPT", elementWidth);
+    printElement(out, "CFCMCACCEPT%", elementWidth);
   }
 #endif
 
 #if ENSEMBLE == GEMC || ENSEMBLE == NPT
   if(var->Performed(mv::VOL_TRANSFER)) {
-    printElement("VOLUME", elementWidth);
-    printElement("VOLACCEPT", elementWidth);
-    printElement("VOLACCEPT%", elementWidth);
-    printElement("VOLMAX", elementWidth);
+    printElement(out, "VOLUME", elementWidth);
+    printElement(out, "VOLACCEPT", elementWidth);
+    printElement(out, "VOLACCEPT%", elementWidth);
+    printElement(out, "VOLMAX", elementWidth);
   }
 #endif
 
-  std::cout << std::endl;
+  out << std::endl;
 }
 
-void ConsoleOutput::printElement(const double t, const int width,
-                                 uint percision) const
+void ConsoleOutput::printElement(std::ostream & out, const double t,
+                                 const int width, uint percision) const
 {
   const char separator = ' ';
   if(std::abs(t) > 1e99) {
-    std::cout << std::right << std::scientific << std::setprecision(percision - 1) <<
+    out << std::right << std::scientific << std::setprecision(percision - 1) <<
               std::setw(width) << std::setfill(separator) << t;
   } else {
-    std::cout << std::right << std::scientific << std::setprecision(percision) <<
+    out << std::right << std::scientific << std::setprecision(percision) <<
               std::setw(width) << std::setfill(separator) << t;
   }
 
 }
 
-void ConsoleOutput::printElement(const uint t, const int width) const
+void ConsoleOutput::printElement(std::ostream & out, const uint t,
+                                 const int width) const
 {
   const char separator = ' ';
-  std::cout << std::right << std::scientific  << std::setw(width) <<
+  out << std::right << std::scientific  << std::setw(width) <<
             std::setfill(separator) << t;
 }
 
-void ConsoleOutput::printElement(const std::string t, const int width) const
+void ConsoleOutput::printElement(std::ostream & out, const std::string t,
+                                 const int width) const
 {
   const char separator = ' ';
-  std::cout << std::right << std::scientific << std::setw(width) <<
+  out << std::right << std::scientific << std::setw(width) <<
             std::setfill(separator) << t;
 }
 
 template <typename T>
-void ConsoleOutput::printElementStep( const T t, const ulong step,
-                                      const int width) const
+void ConsoleOutput::printElementStep(std::ostream & out, const T t,
+                                     const ulong step, const int width) const
 {
-  std::cout << t << std::right << std::setw(width - 7) << step;
+  out << t << std::right << std::setw(width - 7) << step;
 }
@@ -16,6 +16,11 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "MoveConst.h"
 #include "OutputVars.h"
 
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
 class System;
 namespace config_setup
 {
@@ -27,6 +32,26 @@ class Virial;
 class MoveSettings;
 class MoleculeLookup;
 
+//Copy of the values a console block prints. The console is written on the
+//simulation thread, not by the output pipeline, so its blocks keep their
+//order with the other messages on stdout.
+struct ConsoleFrame {
+  ulong step;
+  Energy energy[BOX_TOTAL];
+  //tries, accepted moves, acceptance and scale of each move, per box
+  uint tries[BOX_TOTAL][mv::MOVE_KINDS_TOTAL];
+  uint accepted[BOX_TOTAL][mv::MOVE_KINDS_TOTAL];
+  double acceptPercent[BOX_TOTAL][mv::MOVE_KINDS_TOTAL];
+  double scale[BOX_TOTAL][mv::MOVE_KINDS_TOTAL];
+  double volume[BOX_TOTAL], pressure[BOX_TOTAL], densityTot[BOX_TOTAL];
+  double surfaceTens[BOX_TOTAL], pressureTens[BOX_TOTAL][3];
+  uint numByBox[BOX_TOTAL];
+  //per box and kind
+  std::vector<double> molFraction, molDensity;
+  //the block is formatted here and printed at once
+  std::ostringstream text;
+};
+
 struct ConsoleOutput : OutputableBase {
 public:
   ConsoleOutput(OutputVars & v)
@@ -61,6 +86,8 @@ public:
         enableSurfTension) {
       enableStat = true;
     }
+    //Numbers printed on stdout after the console keep its format
+    std::cout << std::right << std::scientific << std::setprecision(4);
     DoOutput(0);
   }
   virtual void DoOutput(const ulong step);
@@ -69,21 +96,31 @@ private:
   const static int elementWidth = 16;
   bool enableEnergy, enablePressure, enableDens, enableVolume, enableMol;
   bool enableSurfTension, enableStat;
-  void PrintMove(const uint box, const ulong step) const;
-  void PrintMoveStat(const uint box, const ulong step) const;
-  void PrintStatistic(const uint box, const ulong step) const;
-  void PrintPressureTensor(const uint box, const ulong step) const;
-  void PrintEnergy(const uint box, Energy const& en, Virial const& vir,
+  ConsoleFrame frame;
+
+  //Copies what the frame prints from the output variables
+  void Snapshot(ConsoleFrame & frame, const ulong step);
+  //Formats and prints a frame
+  void WriteFrame(ConsoleFrame & frame);
+  void PrintMove(std::ostream & out, ConsoleFrame const& frame,
+                 const uint box, const ulong step) const;
+  void PrintStatistic(std::ostream & out, ConsoleFrame const& frame,
+                      const uint box, const ulong step) const;
+  void PrintPressureTensor(std::ostream & out, ConsoleFrame const& frame,
+                           const uint box, const ulong step) const;
+  void PrintEnergy(std::ostream & out, const uint box, Energy const& en,
                    const ulong step) const;
-  void PrintEnergyTitle();
-  void PrintStatisticTitle();
-  void PrintMoveTitle();
-  void printElement (const double t, const int width, uint percision = 4) const;
-  void printElement (const uint t, const int width) const;
-  void printElement (const std::string t, const int width) const;
+  void PrintEnergyTitle(std::ostream & out);
+  void PrintStatisticTitle(std::ostream & out);
+  void PrintMoveTitle(std::ostream & out);
+  void printElement (std::ostream & out, const double t, const int width,
+                     uint percision = 4) const;
+  void printElement (std::ostream & out, const uint t, const int width) const;
+  void printElement (std::ostream & out, const std::string t,
+                     const int width) const;
 
-  template <typename T> void printElementStep ( const T t, const ulong step,
-      const int width) const;
+  template <typename T> void printElementStep (std::ostream & out, const T t,
+      const ulong step, const int width) const;
 };
 
 #endif /*CONSOLE_OUTPUT_H*/
@@ -0,0 +1,48 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef DCD_CONST_H
+#define DCD_CONST_H
+
+#include <stdint.h>
+
+#include "BasicTypes.h" //For uint
+
+//Layout of a CHARMM/NAMD DCD trajectory. Every record is framed by its
+//length in bytes as a 32-bit Fortran record marker, in native byte order.
+namespace dcd
+{
+//length of the first record: "CORD" and 20 control integers
+static const int32_t HEADER_RECORD = 84;
+static const uint CONTROL_COUNT = 20;
+//positions in the control array
+static const uint NSET = 0;
+static const uint ISTART = 1;
+static const uint NSAVC = 2;
+static const uint NSTEP = 3;
+static const uint NAMNF = 8;
+static const uint DELTA = 9;
+static const uint UNIT_CELL = 10;
+static const uint FOUR_DIM = 11;
+static const uint VERSION = 19;
+//the version is what marks the file as CHARMM format
+static const int32_t CHARMM_VERSION = 24;
+//byte offset of NSET, which is rewritten as frames are added
+static const long NSET_OFFSET = 8;
+static const uint TITLE_WIDTH = 80;
+//unit cell record: A, gamma, B, beta, alpha, C
+static const int32_t CELL_RECORD = 6 * sizeof(double);
+static const uint CELL_A = 0;
+static const uint CELL_GAMMA = 1;
+static const uint CELL_B = 2;
+static const uint CELL_BETA = 3;
+static const uint CELL_ALPHA = 4;
+static const uint CELL_C = 5;
+//coordinate blocks of a GOMC frame: x, y, z and the box membership
+static const uint DIMS = 4;
+}
+
+#endif /*DCD_CONST_H*/
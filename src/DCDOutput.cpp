@@ -0,0 +1,219 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "DCDOutput.h"              //For spec;
+#include "DCDConst.h"               //For record layout
+#include "System.h"                 //for init
+#include "StaticVals.h"             //for init
+#include "MoleculeLookup.h"         //for lookup array (to get kind cnts, etc.)
+#include "StrStrmLib.h"             //For conversion from uint to string
+#include <cstdlib>
+
+DCDOutput::DCDOutput(System & sys, StaticVals const& statV,
+                     OutputPipeline & pipe) :
+  molLookupRef(sys.molLookupRef), boxDimRef(sys.boxDimRef),
+  molRef(statV.mol), coordCurrRef(sys.coordinates), comCurrRef(sys.com),
+  pipeline(pipe), nextFrame(0), atomCount(0), frameSize(0),
+  stepClamped(false)
+{
+  for (uint b = 0; b < BOX_TOTAL; ++b) {
+    outF[b] = NULL;
+    frameCount[b] = 0;
+    firstStep[b] = 0;
+  }
+  frames[0].out = frames[1].out = this;
+}
+
+void DCDFrame::Write()
+{
+  out->WriteFrame(*this);
+}
+
+void DCDOutput::Init(pdb_setup::Atoms const& /*atoms*/,
+                     config_setup::Output const& output)
+{
+  enableOut = output.state.settings.enable && output.state.format.dcd;
+  stepsPerOut = output.state.settings.frequency;
+  if (!enableOut)
+    return;
+
+  atomCount = coordCurrRef.Count();
+  frameSize = 2 * sizeof(int32_t) + dcd::CELL_RECORD +
+              dcd::DIMS * (2 * sizeof(int32_t) + atomCount * sizeof(float));
+  for (uint b = 0; b < BOX_TOTAL; ++b) {
+    fileName[b] = output.state.files.dcd.name[b];
+    outF[b] = fopen(fileName[b].c_str(), "wb");
+    if (outF[b] == NULL) {
+      fprintf(stderr, "Error opening DCD output file %s\n",
+              fileName[b].c_str());
+      exit(EXIT_FAILURE);
+    }
+    WriteHeader(b);
+  }
+}
+
+void DCDOutput::WriteHeader(const uint b)
+{
+  std::vector<char> header;
+  int32_t control[dcd::CONTROL_COUNT] = {0};
+  float delta = 1.0f;
+  control[dcd::NSAVC] = StepField(stepsPerOut);
+  memcpy(&control[dcd::DELTA], &delta, sizeof(float));
+  control[dcd::UNIT_CELL] = 1;
+  control[dcd::FOUR_DIM] = 1;
+  control[dcd::VERSION] = dcd::CHARMM_VERSION;
+
+  sstrm::Converter toStr;
+  std::string numStr = "";
+  toStr << b;
+  toStr >> numStr;
+  std::string title[2];
+  title[0] = "REMARKS FILENAME=" + fileName[b] + " CREATED BY GOMC";
+  title[1] = "REMARKS BOX " + numStr + ", STEP OF FRAME I IS ISTART + I * NSAVC";
+  const int32_t titleCount = 2;
+  const int32_t titleRecord = sizeof(int32_t) + titleCount * dcd::TITLE_WIDTH;
+  const int32_t atomRecord = sizeof(int32_t);
+
+  header.resize(3 * 2 * sizeof(int32_t) + dcd::HEADER_RECORD + titleRecord +
+                atomRecord);
+  char * pos = &header[0];
+  pos = Put(pos, dcd::HEADER_RECORD);
+  memcpy(pos, "CORD", 4);
+  pos += 4;
+  memcpy(pos, control, sizeof(control));
+  pos += sizeof(control);
+  pos = Put(pos, dcd::HEADER_RECORD);
+
+  pos = Put(pos, titleRecord);
+  pos = Put(pos, titleCount);
+  for (int t = 0; t < titleCount; ++t) {
+    title[t].resize(dcd::TITLE_WIDTH, ' ');
+    memcpy(pos, title[t].c_str(), dcd::TITLE_WIDTH);
+    pos += dcd::TITLE_WIDTH;
+  }
+  pos = Put(pos, titleRecord);
+
+  pos = Put(pos, atomRecord);
+  pos = Put(pos, (int32_t)atomCount);
+  pos = Put(pos, atomRecord);
+  fwrite(&header[0], 1, header.size(), outF[b]);
+  fflush(outF[b]);
+}
+
+void DCDOutput::UpdateHeader(const uint b, const ulong step)
+{
+  if (frameCount[b] == 0)
+    firstStep[b] = step + 1;
+  frameCount[b]++;
+  int32_t control[dcd::NSTEP + 1];
+  control[dcd::NSET] = frameCount[b];
+  control[dcd::ISTART] = StepField(firstStep[b]);
+  control[dcd::NSAVC] = StepField(stepsPerOut);
+  control[dcd::NSTEP] = StepField(step + 1);
+  fseek(outF[b], dcd::NSET_OFFSET, SEEK_SET);
+  fwrite(control, sizeof(int32_t), dcd::NSTEP + 1, outF[b]);
+  fseek(outF[b], 0, SEEK_END);
+}
+
+int32_t DCDOutput::StepField(const ulong step)
+{
+  if (step <= (ulong)INT32_MAX)
+    return (int32_t)step;
+  if (!stepClamped) {
+    printf("Warning: Step %lu does not fit in the 32-bit DCD header, step "
+           "fields past %d are clamped.\n", step, INT32_MAX);
+    stepClamped = true;
+  }
+  return INT32_MAX;
+}
+
+void DCDOutput::DoOutput(const ulong step)
+{
+  DCDFrame & frame = frames[nextFrame];
+  nextFrame = 1 - nextFrame;
+  pipeline.Acquire(frame);
+  frame.step = step;
+  std::vector<uint> mBox(molRef.count);
+  SetMolBoxVec(mBox);
+  for (uint b = 0; b < BOX_TOTAL; ++b) {
+    frame.data[b].resize(frameSize);
+    FillFrame(b, mBox, frame.data[b]);
+  }
+  pipeline.Submit(frame);
+}
+
+void DCDOutput::WriteFrame(DCDFrame const& frame)
+{
+  for (uint b = 0; b < BOX_TOTAL; ++b) {
+    UpdateHeader(b, frame.step);
+    if (fwrite(&frame.data[b][0], 1, frameSize, outF[b]) != frameSize) {
+      fprintf(stderr, "Error writing DCD output file %s\n",
+              fileName[b].c_str());
+      exit(EXIT_FAILURE);
+    }
+    fflush(outF[b]);
+  }
+}
+
+void DCDOutput::SetMolBoxVec(std::vector<uint> & mBox)
+{
+  for (uint b = 0; b < BOX_TOTAL; ++b) {
+    MoleculeLookup::box_iterator m = molLookupRef.BoxBegin(b),
+                                 end = molLookupRef.BoxEnd(b);
+    while (m != end) {
+      mBox[*m] = b;
+      ++m;
+    }
+  }
+}
+
+void DCDOutput::FillFrame(const uint b, std::vector<uint> const& mBox,
+                          std::vector<char> & data)
+{
+  const int32_t block = atomCount * sizeof(float);
+  XYZ axis = boxDimRef.axis.Get(b);
+  char * pos = &data[0];
+  pos = Put(pos, dcd::CELL_RECORD);
+  pos = Put(pos, axis.x);
+  pos = Put(pos, ConvAng(boxDimRef.cosAngle[b][2]));
+  pos = Put(pos, axis.y);
+  pos = Put(pos, ConvAng(boxDimRef.cosAngle[b][1]));
+  pos = Put(pos, ConvAng(boxDimRef.cosAngle[b][0]));
+  pos = Put(pos, axis.z);
+  pos = Put(pos, dcd::CELL_RECORD);
+
+  //Markers around the x, y, z and box blocks
+  char * x = pos + sizeof(int32_t);
+  char * y = x + block + 2 * sizeof(int32_t);
+  char * z = y + block + 2 * sizeof(int32_t);
+  char * w = z + block + 2 * sizeof(int32_t);
+  Put(x - sizeof(int32_t), block);
+  Put(x + block, block);
+  Put(y - sizeof(int32_t), block);
+  Put(y + block, block);
+  Put(z - sizeof(int32_t), block);
+  Put(z + block, block);
+  Put(w - sizeof(int32_t), block);
+  Put(w + block, block);
+
+  uint pStart = 0, pEnd = 0;
+  for (uint m = 0; m < molRef.count; ++m) {
+    molRef.GetRangeStartStop(pStart, pEnd, m);
+    XYZ ref = comCurrRef.Get(m);
+    bool inThisBox = (mBox[m] == b);
+    for (uint p = pStart; p < pEnd; ++p) {
+      XYZ coor;
+      if (inThisBox) {
+        coor = coordCurrRef.Get(p);
+        boxDimRef.UnwrapPBC(coor, b, ref);
+      }
+      x = Put(x, (float)coor.x);
+      y = Put(y, (float)coor.y);
+      z = Put(z, (float)coor.z);
+      w = Put(w, inThisBox ? 1.0f : 0.0f);
+    }
+  }
+}
@@ -0,0 +1,123 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef DCD_OUTPUT_H
+#define DCD_OUTPUT_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+#include "BasicTypes.h" //For uint
+#include "OutputAbstracts.h"
+#include "EnsemblePreprocessor.h" //For BOX_TOTAL
+#include "PDBSetup.h" //For atoms class
+#include "OutputPipeline.h"
+
+class System;
+class StaticVals;
+namespace config_setup
+{
+struct Output;
+}
+class MoleculeLookup;
+class BoxDimensions;
+class Molecules;
+class Coordinates;
+class COM;
+struct DCDOutput;
+
+//A frame of every box, assembled on the simulation thread
+struct DCDFrame : OutputJob {
+  DCDFrame() : out(NULL) {}
+  virtual void Write();
+
+  DCDOutput * out;
+  ulong step;
+  std::vector<char> data[BOX_TOTAL];
+};
+
+//Binary trajectory in the CHARMM/NAMD DCD format, one file per box, with a
+//unit cell record and float coordinates for every atom of the system, as
+//in the PDB trajectory atoms outside the box are written at the origin.
+//The fourth dimension record of the format holds the box membership, 1 for
+//the atoms in the box and 0 for the others, as the PDB occupancy does.
+//Each frame is assembled in memory on the simulation thread and written
+//with a single fwrite by the output pipeline.
+struct DCDOutput : OutputableBase {
+public:
+  DCDOutput(System & sys, StaticVals const& statV, OutputPipeline & pipe);
+
+  ~DCDOutput()
+  {
+    for (uint b = 0; b < BOX_TOTAL; ++b) {
+      if (outF[b] != NULL)
+        fclose(outF[b]);
+    }
+  }
+
+  //DCD does not need to sample on every step, so does nothing.
+  virtual void Sample(const ulong /*step*/) {}
+
+  virtual void Init(pdb_setup::Atoms const& atoms,
+                    config_setup::Output const& output);
+
+  virtual void DoOutput(const ulong step);
+private:
+  friend struct DCDFrame;
+
+  void WriteHeader(const uint b);
+
+  //Writes a frame, on the pipeline thread
+  void WriteFrame(DCDFrame const& frame);
+
+  //Rewrites the frame count and step range at the start of the file
+  void UpdateHeader(const uint b, const ulong step);
+
+  //Step fields of the header are 32-bit, larger steps are clamped with a
+  //warning
+  int32_t StepField(const ulong step);
+
+  void SetMolBoxVec(std::vector<uint> & mBox);
+
+  void FillFrame(const uint b, std::vector<uint> const& mBox,
+                 std::vector<char> & data);
+
+  template <typename T>
+  char * Put(char * dest, const T value)
+  {
+    memcpy(dest, &value, sizeof(T));
+    return dest + sizeof(T);
+  }
+
+  double ConvAng(const double t)
+  {
+    return acos(t) * 180.0 / M_PI;
+  }
+
+  MoleculeLookup & molLookupRef;
+  BoxDimensions & boxDimRef;
+  Molecules const& molRef;
+  Coordinates & coordCurrRef;
+  COM & comCurrRef;
+  OutputPipeline & pipeline;
+  //double buffer, one frame is filled while the other is written
+  DCDFrame frames[2];
+  uint nextFrame;
+
+  FILE * outF[BOX_TOTAL];
+  std::string fileName[BOX_TOTAL];
+  //frames written and step (counted from 1) of the first one
+  int32_t frameCount[BOX_TOTAL];
+  ulong firstStep[BOX_TOTAL];
+  uint atomCount;
+  size_t frameSize;
+  bool stepClamped;
+};
+
+#endif /*DCD_OUTPUT_H*/
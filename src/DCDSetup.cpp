@@ -0,0 +1,220 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "DCDSetup.h"
+#include "DCDConst.h"
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+
+DCDSetup::DCDSetup(void) : firstStep(0), stepsPerFrame(0), atomCount(0)
+{
+  for (uint b = 0; b < BOX_TOTAL; b++) {
+    file[b] = NULL;
+    headerSize[b] = 0;
+    hasCell[b] = false;
+    hasBox[b] = false;
+    frameCount[b] = 0;
+  }
+}
+
+DCDSetup::~DCDSetup(void)
+{
+  for (uint b = 0; b < BOX_TOTAL; b++) {
+    if (file[b] != NULL)
+      fclose(file[b]);
+  }
+}
+
+void DCDSetup::Init(std::string const*const name,
+                    pdb_setup::Atoms const& atoms)
+{
+  topology = atoms;
+  atomCount = topology.x.size();
+  molBox.resize(topology.startIdxRes.size());
+  for (uint m = 0; m < molBox.size(); m++)
+    molBox[m] = topology.box[topology.startIdxRes[m]];
+
+  for (uint b = 0; b < BOX_TOTAL; b++) {
+    fileName[b] = name[b];
+    file[b] = fopen(fileName[b].c_str(), "rb");
+    if (file[b] == NULL) {
+      std::cerr << "Error: Could not open DCD file " << fileName[b]
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    ReadHeader(b);
+    if (frameCount[b] != frameCount[0]) {
+      std::cerr << "Error: DCD file " << fileName[b] << " has "
+                << frameCount[b] << " frames, " << fileName[0] << " has "
+                << frameCount[0] << "!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+  printf("%-40s %-u \n", "Info: DCD trajectory frames", frameCount[0]);
+}
+
+void DCDSetup::ReadRecord(const uint b, void * data, const int32_t size)
+{
+  int32_t begin = 0, end = 0;
+  bool good = fread(&begin, sizeof(int32_t), 1, file[b]) == 1 &&
+              begin == size && fread(data, 1, size, file[b]) == (size_t)size &&
+              fread(&end, sizeof(int32_t), 1, file[b]) == 1 && end == size;
+  if (!good) {
+    std::cerr << "Error: " << fileName[b] << " is not a DCD file written "
+              << "in the byte order of this machine!" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+void DCDSetup::ReadHeader(const uint b)
+{
+  char record[dcd::HEADER_RECORD];
+  int32_t control[dcd::CONTROL_COUNT];
+  ReadRecord(b, record, dcd::HEADER_RECORD);
+  memcpy(control, record + 4, sizeof(control));
+  if (strncmp(record, "CORD", 4) != 0) {
+    std::cerr << "Error: " << fileName[b] << " is not a DCD coordinate file!"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  if (control[dcd::NAMNF] != 0) {
+    std::cerr << "Error: DCD files with fixed atoms are not supported!"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  //X-PLOR files carry no version and no unit cell
+  hasCell[b] = control[dcd::VERSION] != 0 && control[dcd::UNIT_CELL] != 0;
+  //GOMC writes the box membership as the fourth dimension
+  hasBox[b] = control[dcd::VERSION] != 0 && control[dcd::FOUR_DIM] != 0;
+#ifdef VARIABLE_PARTICLE_NUMBER
+  if (!hasBox[b]) {
+    std::cerr << "Error: DCD file " << fileName[b] << " has no box "
+              << "membership record, molecules cannot be assigned to the "
+              << "boxes they were in!" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+#endif
+  if (b == 0) {
+    stepsPerFrame = control[dcd::NSAVC] > 0 ? control[dcd::NSAVC] : 1;
+    //steps are counted from 1, as in the PDB remarks
+    firstStep = control[dcd::ISTART] > 0 ? control[dcd::ISTART] :
+                stepsPerFrame;
+  }
+
+  int32_t titleRecord = 0;
+  if (fread(&titleRecord, sizeof(int32_t), 1, file[b]) != 1 ||
+      titleRecord < 0) {
+    std::cerr << "Error: Could not read the title of " << fileName[b] << "!"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  fseek(file[b], titleRecord + sizeof(int32_t), SEEK_CUR);
+
+  int32_t natom = 0;
+  ReadRecord(b, &natom, sizeof(int32_t));
+  if ((uint)natom != atomCount) {
+    std::cerr << "Error: DCD file " << fileName[b] << " has " << natom
+              << " atoms, the PDB files have " << atomCount << "!"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  headerSize[b] = ftell(file[b]);
+  long frameSize = (hasBox[b] ? dcd::DIMS : 3) *
+                   (2 * sizeof(int32_t) + atomCount * sizeof(float));
+  if (hasCell[b])
+    frameSize += 2 * sizeof(int32_t) + dcd::CELL_RECORD;
+  frame[b].resize(frameSize);
+  fseek(file[b], 0, SEEK_END);
+  //Count complete frames, NSET is not updated by every writer
+  frameCount[b] = (ftell(file[b]) - headerSize[b]) / frameSize;
+}
+
+std::vector<ulong> DCDSetup::GetFrameSteps(void) const
+{
+  std::vector<ulong> frameSteps(frameCount[0]);
+  for (uint f = 0; f < frameCount[0]; f++)
+    frameSteps[f] = firstStep + f * stepsPerFrame;
+  return frameSteps;
+}
+
+float DCDSetup::Coord(const uint b, const uint dim, const uint p) const
+{
+  size_t offset = (hasCell[b] ? 2 * sizeof(int32_t) + dcd::CELL_RECORD : 0) +
+                  dim * (2 * sizeof(int32_t) + atomCount * sizeof(float)) +
+                  sizeof(int32_t) + p * sizeof(float);
+  float value;
+  memcpy(&value, &frame[b][offset], sizeof(float));
+  return value;
+}
+
+double DCDSetup::Angle(const double value) const
+{
+  //CHARMM (c30 and later) and NAMD store the cosine, GOMC and older
+  //writers the angle in degrees
+  if (std::abs(value) <= 1.0)
+    return acos(value) * 180.0 / M_PI;
+  return value;
+}
+
+void DCDSetup::ReadFrame(const uint frameNum, PDBSetup & pdb)
+{
+  for (uint b = 0; b < BOX_TOTAL; b++) {
+    long offset = headerSize[b] + (long)(frameNum - 1) * frame[b].size();
+    if (frameNum == 0 || frameNum > frameCount[b] ||
+        fseek(file[b], offset, SEEK_SET) != 0 ||
+        fread(&frame[b][0], 1, frame[b].size(), file[b]) != frame[b].size()) {
+      std::cerr << "Error: Could not read frame " << frameNum << " of "
+                << fileName[b] << "!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (hasCell[b]) {
+      double cell[6];
+      memcpy(cell, &frame[b][sizeof(int32_t)], sizeof(cell));
+      pdb.cryst.axis.Set(b, cell[dcd::CELL_A], cell[dcd::CELL_B],
+                         cell[dcd::CELL_C]);
+      pdb.cryst.cellAngle[b][0] = Angle(cell[dcd::CELL_ALPHA]);
+      pdb.cryst.cellAngle[b][1] = Angle(cell[dcd::CELL_BETA]);
+      pdb.cryst.cellAngle[b][2] = Angle(cell[dcd::CELL_GAMMA]);
+      pdb.cryst.hasVolume = true;
+    }
+    std::cout.width(40);
+    std::cout << std::left << "Finished reading: ";
+    std::cout << "\t" << fileName[b] << " frame " << frameNum << std::endl;
+  }
+
+  //A molecule is in the box whose record marks its first atom, without
+  //the record it stays in its box of the PDB files
+  for (uint m = 0; m < molBox.size(); m++) {
+    for (uint b = 0; b < BOX_TOTAL; b++) {
+      if (hasBox[b] &&
+          Coord(b, dcd::DIMS - 1, topology.startIdxRes[m]) != 0.0f) {
+        molBox[m] = b;
+        break;
+      }
+    }
+  }
+
+  //Molecules grouped by box, as read from a multi-frame PDB
+  pdb.atoms.Clear();
+  for (uint b = 0; b < BOX_TOTAL; b++) {
+    pdb.atoms.SetBox(b);
+    for (uint m = 0; m < molBox.size(); m++) {
+      if (molBox[m] != b)
+        continue;
+      uint pStart = topology.startIdxRes[m];
+      uint pEnd = (m + 1 < molBox.size() ? topology.startIdxRes[m + 1] :
+                   atomCount);
+      for (uint p = pStart; p < pEnd; p++) {
+        pdb.atoms.Assign(topology.atomAliases[p], topology.resNamesFull[p], m,
+                         topology.chainLetter[m], Coord(b, 0, p),
+                         Coord(b, 1, p), Coord(b, 2, p), b, topology.beta[p]);
+      }
+    }
+  }
+}
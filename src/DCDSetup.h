@@ -0,0 +1,60 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef DCD_SETUP_H
+#define DCD_SETUP_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <stdint.h>
+
+#include "BasicTypes.h" //For uint
+#include "EnsemblePreprocessor.h" //For BOX_TOTAL
+#include "PDBSetup.h" //For atoms class
+
+//Reads the DCD trajectories written by DCDOutput back for the trajectory
+//recalculation. The PDB files give the topology, in the atom order of the
+//run that wrote the trajectory. A molecule belongs to the box whose file
+//marks it in the box membership record (the fourth dimension) of the
+//frame. Files without that record, from other writers, keep every molecule
+//in its box of the PDB files, which ensembles that transfer molecules
+//between boxes do not accept. Each frame is rebuilt into the atoms of
+//PDBSetup in the order the multi-frame PDB reader would produce.
+class DCDSetup
+{
+public:
+  DCDSetup(void);
+  ~DCDSetup(void);
+
+  void Init(std::string const*const name, pdb_setup::Atoms const& atoms);
+  //Step (counted from 1) of each frame
+  std::vector<ulong> GetFrameSteps(void) const;
+  //Loads frame frameNum (counted from 1) into the atoms and cell of pdb
+  void ReadFrame(const uint frameNum, PDBSetup & pdb);
+
+private:
+  void ReadHeader(const uint b);
+  void ReadRecord(const uint b, void * data, const int32_t size);
+  float Coord(const uint b, const uint dim, const uint p) const;
+  double Angle(const double value) const;
+
+  FILE * file[BOX_TOTAL];
+  std::string fileName[BOX_TOTAL];
+  long headerSize[BOX_TOTAL];
+  bool hasCell[BOX_TOTAL];
+  //frames carry the box membership record
+  bool hasBox[BOX_TOTAL];
+  uint frameCount[BOX_TOTAL];
+  ulong firstStep, stepsPerFrame;
+  uint atomCount;
+  //raw bytes of the current frame of each box
+  std::vector<char> frame[BOX_TOTAL];
+  pdb_setup::Atoms topology;
+  std::vector<uint> molBox;
+};
+
+#endif /*DCD_SETUP_H*/
@@ -0,0 +1,68 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef DIRTY_MOLECULES_H
+#define DIRTY_MOLECULES_H
+
+#include "BasicTypes.h" //For uint
+#include <vector>
+
+//Molecules whose coordinates were written since the last checkpoint, for
+//the delta checkpoints. The moves mark every molecule they copy into the
+//current coordinates, moves that change the whole box mark all of them.
+//Does nothing unless delta checkpoints are enabled.
+class DirtyMolecules
+{
+public:
+  DirtyMolecules() : enable(false), all(false) {}
+
+  void Init(const uint molCount, const bool on)
+  {
+    enable = on;
+    all = false;
+    dirty.assign(enable ? molCount : 0, false);
+    list.clear();
+  }
+
+  void Mark(const uint m)
+  {
+    if(enable && !dirty[m]) {
+      dirty[m] = true;
+      list.push_back(m);
+    }
+  }
+
+  void MarkAll()
+  {
+    all = enable;
+  }
+
+  bool All() const
+  {
+    return all;
+  }
+
+  //Marked molecules, in the order they were first marked
+  std::vector<uint> const& List() const
+  {
+    return list;
+  }
+
+  void Clear()
+  {
+    for(uint i = 0; i < list.size(); i++)
+      dirty[list[i]] = false;
+    list.clear();
+    all = false;
+  }
+
+private:
+  bool enable, all;
+  std::vector<bool> dirty;
+  std::vector<uint> list;
+};
+
+#endif /*DIRTY_MOLECULES_H*/
@@ -19,12 +19,6 @@ EnPartCntSample::~EnPartCntSample()
 {
   for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
     if (outF[b].is_open()) outF[b].close();
-    if (samplesE[b] != NULL) delete[] samplesE[b];
-    if(samplesN[b] != NULL) {
-      for (uint k = 0; k < var->numKinds; ++k)
-        if (samplesN[b][k] != NULL) delete[] samplesN[b][k];
-    }
-    if (samplesN[b] != NULL) delete[] samplesN[b];
   }
 }
 
@@ -36,25 +30,19 @@ void EnPartCntSample::Init(pdb_setup::Atoms const& atoms,
     stepsPerSample = output.state.files.hist.stepsPerHistSample;
     uint samplesPerFrame =
       output.statistics.settings.hist.frequency / stepsPerSample + 1;
-    samplesCollectedInFrame = 0;
     for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
-#if GOMC_LIB_MPI
       name[b] = pathToReplicaOutputDirectory + GetFName(output.state.files.hist.sampleName,
                 output.state.files.hist.number,
                 output.state.files.hist.letter,
                 b);
-#else
-      name[b] = GetFName(output.state.files.hist.sampleName,
-                         output.state.files.hist.number,
-                         output.state.files.hist.letter,
-                         b);
-#endif
-      samplesE[b] = new double [samplesPerFrame];
-      samplesN[b] = new uint * [var->numKinds];
-      for (uint k = 0; k < var->numKinds; ++k) {
-        samplesN[b][k] = new uint [samplesPerFrame];
+      for (uint f = 0; f < 2; ++f) {
+        frames[f].samplesE[b].resize(samplesPerFrame);
+        frames[f].samplesN[b].resize(samplesPerFrame * var->numKinds);
       }
-      outF[b].open(name[b].c_str(), std::ofstream::out);
+      if (output.statistics.format.binary)
+        series[b].Open(name[b].substr(0, name[b].size() - 4) + ".bin");
+      if (output.statistics.format.text)
+        outF[b].open(name[b].c_str(), std::ofstream::out);
     }
     WriteHeader();
   }
@@ -66,23 +54,48 @@ void EnPartCntSample::Sample(const ulong step)
   if ((step) < stepsTillEquil) return;
   //Only sample on specified interval.
   if ((step + 1) % stepsPerSample == 0) {
+    EnPartCntFrame & frame = frames[current];
     for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
-      samplesE[b][samplesCollectedInFrame] =
+      frame.samplesE[b][frame.count] =
         var->energyRef[b].inter + var->energyRef[b].tc +
         var->energyRef[b].totalElect;
 
       for (uint k = 0; k < var->numKinds; ++k) {
-        samplesN[b][k][samplesCollectedInFrame] =
+        frame.samplesN[b][frame.count * var->numKinds + k] =
           var->numByKindBox[k + var->numKinds * b];
       }
     }
-    ++samplesCollectedInFrame;
+    ++frame.count;
   }
 }
 
 void EnPartCntSample::WriteHeader(void)
 {
+  std::ostringstream value;
+  value << std::setprecision(std::numeric_limits<double>::digits10 + 2);
+  XYZ bAx = var->axisRef->Get(0);
   for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    //The binary file keeps the text header as metadata, and a column per
+    //kind count and the energy
+    value.str("");
+    value << var->T_in_K;
+    series[b].AddMetadata("T(K)", value.str());
+    for (uint k = 0; k < var->numKinds; k++) {
+      value.str("");
+      value << var->kindsRef[k].chemPot;
+      series[b].AddMetadata("ChemPot(" + var->kindsRef[k].name + ")",
+                            value.str());
+    }
+    const double axis[3] = {bAx.x, bAx.y, bAx.z};
+    const char * axisName[3] = {"BoxX(A)", "BoxY(A)", "BoxZ(A)"};
+    for (uint a = 0; a < 3; a++) {
+      value.str("");
+      value << axis[a];
+      series[b].AddMetadata(axisName[a], value.str());
+    }
+    for (uint k = 0; k < var->numKinds; k++)
+      series[b].AddColumn("N(" + var->kindsRef[k].name + ")");
+    series[b].AddColumn("E(K)");
     if (outF[b].is_open()) {
       outF[b] << var->T_in_K << " " << var->numKinds << " ";
 #if ENSEMBLE == GCMC
@@ -90,11 +103,10 @@ void EnPartCntSample::WriteHeader(void)
         outF[b] << var->kindsRef[k].chemPot << " ";
       }
 #endif
-      XYZ bAx = var->axisRef->Get(0);
       outF[b] << bAx.x << " " << bAx.y << " " << bAx.z << std::endl;
       outF[b] << std::setprecision(std::numeric_limits<double>::digits10 + 2);
       outF[b].setf(std::ios_base::left, std::ios_base::adjustfield);
-    } else
+    } else if (!series[b].IsOpen())
       std::cerr << "Unable to write to file \"" <<  name[b] << "\" "
                 << "(energy and part. num samples file)" << std::endl;
   }
@@ -106,21 +118,53 @@ void EnPartCntSample::DoOutput(const ulong step)
   if ((step) < stepsTillEquil) return;
   //Output a sample in the form <N1,... Nk, E_total>
   //Only sample on specified interval.
-  if ((step + 1) % stepsPerOut == 0) {
-    for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
-      if (outF[b].is_open()) {
-        for (uint n = 0; n < samplesCollectedInFrame; ++n) {
-          for (uint k = 0; k < var->numKinds; k++) {
-            outF[b] << std::setw(11) << samplesN[b][k][n] << " ";
-          }
-          outF[b] << std::setw(25) << samplesE[b][n] << std::endl;
-        }
-      } else
-        std::cerr << "Unable to write to file \"" <<  name[b] << "\" "
-                  << "(energy and part. num samples file)" << std::endl;
+  if ((step + 1) % stepsPerOut != 0) {
+    frames[current].count = 0;
+    return;
+  }
+  pipeline.Submit(frames[current]);
+  current = 1 - current;
+  //The frame is refilled once its samples are written
+  pipeline.Acquire(frames[current]);
+  frames[current].count = 0;
+}
+
+void EnPartCntSample::FlushSeries(void)
+{
+  pipeline.Acquire(flushFrame);
+  pipeline.Submit(flushFrame);
+}
+
+void EnPartCntFrame::Write()
+{
+  out->WriteFrame(*this);
+}
+
+void EnPartCntSample::WriteFrame(EnPartCntFrame const& frame)
+{
+  for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    if (frame.flush) {
+      series[b].Flush();
+      continue;
     }
+    for (uint n = 0; n < frame.count; ++n) {
+      for (uint k = 0; k < var->numKinds; k++)
+        series[b].Add(frame.samplesN[b][n * var->numKinds + k]);
+      series[b].Add(frame.samplesE[b][n]);
+      series[b].EndRow();
+    }
+    if (outF[b].is_open()) {
+      for (uint n = 0; n < frame.count; ++n) {
+        for (uint k = 0; k < var->numKinds; k++) {
+          outF[b] << std::setw(11) << frame.samplesN[b][n * var->numKinds + k]
+                  << " ";
+        }
+        outF[b] << std::setw(25) << frame.samplesE[b][n] << std::endl;
+      }
+    } else if (!series[b].IsOpen())
+      std::cerr << "Unable to write to file \"" <<  name[b] << "\" "
+                << "(energy and part. num samples file)" << std::endl;
   }
-  samplesCollectedInFrame = 0;
 }
 
 
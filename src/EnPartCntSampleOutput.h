@@ -18,6 +18,10 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "StrLib.h"
 #include "PDBSetup.h" //For atoms class.
 #include "EnergyTypes.h"
+#include "TimeSeriesWriter.h"
+#include "OutputPipeline.h"
+
+#include <vector>
 
 #if ENSEMBLE == GCMC
 
@@ -25,16 +29,31 @@ namespace config_setup
 {
 class Output;
 }
+struct EnPartCntSample;
+
+//Samples collected between two outputs. Filled on the simulation thread
+//and written by the output pipeline.
+struct EnPartCntFrame : OutputJob {
+  EnPartCntFrame() : out(NULL), count(0), flush(false) {}
+  virtual void Write();
+
+  EnPartCntSample * out;
+  uint count;
+  //no samples, only writes the rows buffered for the binary files
+  bool flush;
+  //energy of each sample, and the molecules of each kind in each sample,
+  //per box
+  std::vector<double> samplesE[BOXES_WITH_U_NB];
+  std::vector<uint> samplesN[BOXES_WITH_U_NB];
+};
 
 struct EnPartCntSample : OutputableBase {
-  EnPartCntSample(OutputVars & v)
+  EnPartCntSample(OutputVars & v, OutputPipeline & pipe) : pipeline(pipe),
+    current(0)
   {
     this->var = &v;
-    for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
-      samplesE[b] = NULL;;
-      samplesN[b] = NULL;
-    }
-
+    frames[0].out = frames[1].out = flushFrame.out = this;
+    flushFrame.flush = true;
   }
 
   ~EnPartCntSample();
@@ -46,9 +65,16 @@ struct EnPartCntSample : OutputableBase {
                     config_setup::Output const& output);
 
   virtual void DoOutput(const ulong step);
+  //Writes the rows buffered for the binary files, after the samples queued
+  //before
+  void FlushSeries(void);
 
 private:
+  friend struct EnPartCntFrame;
+
   void WriteHeader(void);
+  //Writes the samples of a frame, on the pipeline thread
+  void WriteFrame(EnPartCntFrame const& frame);
 
   void InitVals(config_setup::EventSettings const& event)
   {
@@ -61,10 +87,16 @@ private:
                        std::string const& histLetter,
                        const uint b);
 
-  //samplesE --> per box; samplesN --> per kind, per box
-  double * samplesE [BOXES_WITH_U_NB];
-  uint ** samplesN [BOXES_WITH_U_NB], stepsPerSample, samplesCollectedInFrame;
+  uint stepsPerSample;
+  OutputPipeline & pipeline;
+  //double buffer, samples are collected in the current frame while the
+  //other is written
+  EnPartCntFrame frames[2];
+  EnPartCntFrame flushFrame;
+  uint current;
   std::ofstream outF[BOXES_WITH_U_NB];
+  //Binary copies of the files, for StatisticsFormat BINARY or BOTH
+  TimeSeriesWriter series[BOXES_WITH_U_NB];
   std::string name [BOXES_WITH_U_NB];
 };
 
@@ -18,6 +18,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "TrialMol.h"
 #include "GeomLib.h"
 #include "NumLib.h"
+#include "../lib/Lambda.h"
 #include <cassert>
 #ifdef GOMC_CUDA
 #include "CalculateEwaldCUDAKernel.cuh"
@@ -502,18 +503,26 @@ void Ewald::ChangeRecip(Energy *energyDiff, Energy &dUdL_Coul,
   uint length = mols.GetKind(molIndex).NumAtoms();
   uint startAtom = mols.MolStart(molIndex);
   uint lambdaSize = lambda_Coul.size();
-  double *energyRecip = new double [lambdaSize];
-  std::fill_n(energyRecip, lambdaSize, 0.0);
+  //The sums only depend on lambda through coefDiff, so each distinct
+  //lambda value is evaluated once
+  LambdaUnique uCoul(lambda_Coul);
+  uint uniqueSize = uCoul.Size();
+  double *coefDiff = new double [uniqueSize];
+  double *energyRecip = new double [uniqueSize];
+  std::fill_n(energyRecip, uniqueSize, 0.0);
+  for(uint u = 0; u < uniqueSize; u++) {
+    coefDiff[u] = sqrt(uCoul.value[u]) - sqrt(lambda_Coul[iState]);
+  }
 
 #if defined _OPENMP && _OPENMP >= 201511 // check if OpenMP version is 4.5
 #if GCC_VERSION >= 90000
-  #pragma omp parallel for default(none) shared(lambda_Coul, lambdaSize, \
-  length, startAtom, box, iState) \
-reduction(+:energyRecip[:lambdaSize])
+  #pragma omp parallel for default(none) shared(coefDiff, uniqueSize, \
+  length, startAtom, box) \
+reduction(+:energyRecip[:uniqueSize])
 #else
-  #pragma omp parallel for default(none) shared(lambda_Coul, lambdaSize, \
+  #pragma omp parallel for default(none) shared(coefDiff, uniqueSize, \
   length, startAtom) \
-reduction(+:energyRecip[:lambdaSize])
+reduction(+:energyRecip[:uniqueSize])
 #endif
 #endif
   for (uint i = 0; i < imageSizeRef[box]; i++) {
@@ -530,25 +539,25 @@ reduction(+:energyRecip[:lambdaSize])
       sumReal += particleCharge[currentAtom] * cos(dotProduct);
       sumImaginary += particleCharge[currentAtom] * sin(dotProduct);
     }
-    for(uint s = 0; s < lambdaSize; s++) {
+    for(uint u = 0; u < uniqueSize; u++) {
       //Calculate the energy of other state
-      double coefDiff = sqrt(lambda_Coul[s]) - sqrt(lambda_Coul[iState]);
-      energyRecip[s] += prefactRef[box][i] *
-                        ((sumRref[box][i] + coefDiff * sumReal) *
-                         (sumRref[box][i] + coefDiff * sumReal) +
-                         (sumIref[box][i] + coefDiff * sumImaginary) *
-                         (sumIref[box][i] + coefDiff * sumImaginary));
+      energyRecip[u] += prefactRef[box][i] *
+                        ((sumRref[box][i] + coefDiff[u] * sumReal) *
+                         (sumRref[box][i] + coefDiff[u] * sumReal) +
+                         (sumIref[box][i] + coefDiff[u] * sumImaginary) *
+                         (sumIref[box][i] + coefDiff[u] * sumImaginary));
     }
   }
 
   double energyRecipOld = sysPotRef.boxEnergy[box].recip;
   for(uint s = 0; s < lambdaSize; s++) {
-  energyDiff[s].recip = energyRecip[s] - energyRecipOld;
+    energyDiff[s].recip = energyRecip[uCoul.index[s]] - energyRecipOld;
   }
   //Calculate du/dl of Reciprocal for current state  with linear scaling
   //energy difference E(lambda =1) - E(lambda = 0)
   dUdL_Coul.recip += energyDiff[lambdaSize - 1].recip - energyDiff[0].recip;
   delete [] energyRecip;
+  delete [] coefDiff;
 }
 
 void Ewald::RecipInit(uint box, BoxDimensions const& boxAxes)
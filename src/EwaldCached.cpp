@@ -6,6 +6,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 ********************************************************************************/
 #include "EwaldCached.h"
 #include "StaticVals.h"
+#include "../lib/Lambda.h"
 
 using namespace geom;
 
@@ -354,39 +355,46 @@ void EwaldCached::ChangeRecip(Energy *energyDiff, Energy &dUdL_Coul,
 {
   //Need to implement GPU
   uint lambdaSize = lambda_Coul.size();
-  double *energyRecip = new double [lambdaSize];
-  std::fill_n(energyRecip, lambdaSize, 0.0);
+  //each distinct lambda value is evaluated once
+  LambdaUnique uCoul(lambda_Coul);
+  uint uniqueSize = uCoul.Size();
+  double *coefDiff = new double [uniqueSize];
+  double *energyRecip = new double [uniqueSize];
+  std::fill_n(energyRecip, uniqueSize, 0.0);
+  for(uint u = 0; u < uniqueSize; u++) {
+    coefDiff[u] = sqrt(uCoul.value[u]) - sqrt(lambda_Coul[iState]);
+  }
 
 #if defined _OPENMP && _OPENMP >= 201511 // check if OpenMP version is 4.5
 #if GCC_VERSION >= 90000
-  #pragma omp parallel for default(none) shared(lambda_Coul, lambdaSize, box, \
-  iState, molIndex) \
-reduction(+:energyRecip[:lambdaSize])
+  #pragma omp parallel for default(none) shared(coefDiff, uniqueSize, box, \
+  molIndex) \
+reduction(+:energyRecip[:uniqueSize])
 #else
-  #pragma omp parallel for default(none) shared(lambda_Coul, lambdaSize) \
-  reduction(+:energyRecip[:lambdaSize])
+  #pragma omp parallel for default(none) shared(coefDiff, uniqueSize) \
+  reduction(+:energyRecip[:uniqueSize])
 #endif
 #endif
   for (uint i = 0; i < imageSizeRef[box]; i++) {
-    for(uint s = 0; s < lambdaSize; s++) {
+    for(uint u = 0; u < uniqueSize; u++) {
       //Calculate the energy of other state
-      double coefDiff = sqrt(lambda_Coul[s]) - sqrt(lambda_Coul[iState]);
-      energyRecip[s] += prefactRef[box][i] *
-                        ((sumRref[box][i] + coefDiff * cosMolRef[molIndex][i]) *
-                         (sumRref[box][i] + coefDiff * cosMolRef[molIndex][i]) +
-                         (sumIref[box][i] + coefDiff * sinMolRef[molIndex][i]) *
-                         (sumIref[box][i] + coefDiff * sinMolRef[molIndex][i]));
+      energyRecip[u] += prefactRef[box][i] *
+                        ((sumRref[box][i] + coefDiff[u] * cosMolRef[molIndex][i]) *
+                         (sumRref[box][i] + coefDiff[u] * cosMolRef[molIndex][i]) +
+                         (sumIref[box][i] + coefDiff[u] * sinMolRef[molIndex][i]) *
+                         (sumIref[box][i] + coefDiff[u] * sinMolRef[molIndex][i]));
     }
   }
 
   double energyRecipOld = sysPotRef.boxEnergy[box].recip;
   for(uint s = 0; s < lambdaSize; s++) {
-  energyDiff[s].recip = energyRecip[s] - energyRecipOld;
+    energyDiff[s].recip = energyRecip[uCoul.index[s]] - energyRecipOld;
   }
   //Calculate du/dl of Reciprocal for current state
   //energy difference E(lambda =1) - E(lambda = 0)
   dUdL_Coul.recip += energyDiff[lambdaSize - 1].recip - energyDiff[0].recip;
   delete [] energyRecip;
+  delete [] coefDiff;
 }
 
 //restore cosMol and sinMol
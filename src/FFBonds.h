@@ -33,6 +33,11 @@ public:
     return b0[kind];
   }
 
+  bool BondFixed(const uint kind) const
+  {
+    return fixed[kind];
+  }
+
   void Init(ff_setup::Bond const& bond)
   {
     count = bond.getKbcnt();
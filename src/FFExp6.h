@@ -87,6 +87,10 @@ public:
   virtual double CalcCoulombdEndL(const double distSq, const uint kind1,
                                   const uint kind2, const double qi_qj_Fact,
                                   const double lambda, uint b) const;
+  virtual void CalcEnLambda(double *en, const double distSq,
+                            const uint kind1, const uint kind2,
+                            const std::vector<double> &lambda,
+                            const std::vector<double> &lambdaCoef) const;
 
   double *expConst, *expConst_1_4, *rMaxSq, *rMin, *rMaxSq_1_4, *rMin_1_4;
 
@@ -206,6 +210,18 @@ inline double FF_EXP6::CalcEn(const double distSq, const uint kind1,
   return en;
 }
 
+inline void FF_EXP6::CalcEnLambda(double *en, const double distSq,
+                                  const uint kind1, const uint kind2,
+                                  const std::vector<double> &lambda,
+                                  const std::vector<double> &lambdaCoef) const
+{
+  if(forcefield.rCutSq >= distSq &&
+      distSq < rMaxSq[FlatIndex(kind1, kind2)]) {
+    std::fill_n(en, lambda.size(), num::BIGNUM);
+    return;
+  }
+  FFParticle::CalcEnLambda(en, distSq, kind1, kind2, lambda, lambdaCoef);
+}
 
 inline double FF_EXP6::CalcEn(const double distSq, const uint idx) const
 {
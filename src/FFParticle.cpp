@@ -501,4 +501,75 @@ inline double FFParticle::CalcCoulombdEndL(const double distSq,
     dhdl = CalcCoulomb(distSq, qi_qj_Fact, b);
   }
   return dhdl;
-}
\ No newline at end of file
+}
+
+double FFParticle::LambdaCoef(const double lambda) const
+{
+  return forcefield.sc_alpha * pow((1.0 - lambda), forcefield.sc_power);
+}
+
+void FFParticle::CalcEnLambda(double *en, const double distSq,
+                              const uint kind1, const uint kind2,
+                              const std::vector<double> &lambda,
+                              const std::vector<double> &lambdaCoef) const
+{
+  if(forcefield.rCutSq < distSq) {
+    std::fill_n(en, lambda.size(), 0.0);
+    return;
+  }
+
+  uint index = FlatIndex(kind1, kind2);
+  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
+  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double dist6 = distSq * distSq * distSq;
+  double full = 0.0;
+  bool fullDone = false;
+  for(uint l = 0; l < lambda.size(); l++) {
+    if(lambda[l] >= 0.999999) {
+      if(!fullDone) {
+        full = CalcEn(distSq, index);
+        fullDone = true;
+      }
+      en[l] = full;
+    } else {
+      double softDist6 = lambdaCoef[l] * sigma6 + dist6;
+      double softRsq = pow(softDist6, 1.0 / 3.0);
+      en[l] = lambda[l] * CalcEn(softRsq, index);
+    }
+  }
+}
+
+void FFParticle::CalcCoulombLambda(double *en, const double distSq,
+                                   const uint kind1, const uint kind2,
+                                   const double qi_qj_Fact,
+                                   const std::vector<double> &lambda,
+                                   const std::vector<double> &lambdaCoef,
+                                   const uint b) const
+{
+  if(forcefield.rCutCoulombSq[b] < distSq) {
+    std::fill_n(en, lambda.size(), 0.0);
+    return;
+  }
+
+  //without soft-core the pair term only scales with lambda
+  double full = CalcCoulomb(distSq, qi_qj_Fact, b);
+  if(!forcefield.sc_coul) {
+    for(uint l = 0; l < lambda.size(); l++)
+      en[l] = (lambda[l] >= 0.999999 ? full : lambda[l] * full);
+    return;
+  }
+
+  uint index = FlatIndex(kind1, kind2);
+  double sigma6 = sigmaSq[index] * sigmaSq[index] * sigmaSq[index];
+  sigma6 = std::max(sigma6, forcefield.sc_sigma_6);
+  double dist6 = distSq * distSq * distSq;
+  for(uint l = 0; l < lambda.size(); l++) {
+    if(lambda[l] >= 0.999999) {
+      en[l] = full;
+    } else {
+      double softDist6 = lambdaCoef[l] * sigma6 + dist6;
+      double softRsq = pow(softDist6, 1.0 / 3.0);
+      en[l] = lambda[l] * CalcCoulomb(softRsq, qi_qj_Fact, b);
+    }
+  }
+}
@@ -13,6 +13,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "BasicTypes.h" //for uint
 #include "NumLib.h" //For Cb, Sq
 #include "Setup.h"
+#include <vector>
 #ifdef GOMC_CUDA
 #include "VariablesCUDA.cuh"
 #endif
@@ -95,6 +96,22 @@ public:
                                   const uint kind2, const double qi_qj_Fact,
                                   const double lambda, uint b) const;
 
+  //Soft-core coefficient alpha * (1 - lambda)^p of a lambda value
+  double LambdaCoef(const double lambda) const;
+  //Energy of a pair at each of the given lambda values in one pass. The
+  //lambda independent terms are computed once; en[l] matches CalcEn at
+  //lambda[l]. lambdaCoef holds LambdaCoef of each lambda.
+  virtual void CalcEnLambda(double *en, const double distSq,
+                            const uint kind1, const uint kind2,
+                            const std::vector<double> &lambda,
+                            const std::vector<double> &lambdaCoef) const;
+  virtual void CalcCoulombLambda(double *en, const double distSq,
+                                 const uint kind1, const uint kind2,
+                                 const double qi_qj_Fact,
+                                 const std::vector<double> &lambda,
+                                 const std::vector<double> &lambdaCoef,
+                                 const uint b) const;
+
   uint NumKinds() const
   {
     return count;
@@ -12,6 +12,9 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "ConstField.h" //For ConstField kind.
 #include "StrLib.h" //FromStr, StripWS
 #include "StrStrmLib.h" //For stringstream operators
+#include <cstdlib> //For strtod, strtoul
+#include <cstring> //For memcpy
+#include <algorithm> //For min
 
 
 class FixedWidthReader : public Reader
@@ -27,24 +30,26 @@ public:
     Reader("", "", false, NULL, false, NULL, true, true), line("") {}
 
   //Functions to get values from file, using fields.
+  //Numbers are parsed with the C library, a string stream per field is
+  //most of the time spent reading a large PDB file
   FixedWidthReader & Get(double & d, ConstField const& field)
   {
-    sstrm::FromStr(d, Str(field));
+    d = strtod(Num(field), NULL);
     return *this;
   }
   FixedWidthReader & Get(float & f, ConstField const& field)
   {
-    sstrm::FromStr(f, Str(field));
+    f = strtof(Num(field), NULL);
     return *this;
   }
   FixedWidthReader & Get(uint & ui, ConstField const& field)
   {
-    sstrm::FromStr(ui, Str(field));
+    ui = strtoul(Num(field), NULL, 10);
     return *this;
   }
   FixedWidthReader & Get(ulong & ul, ConstField const& field)
   {
-    sstrm::FromStr(ul, Str(field));
+    ul = strtoul(Num(field), NULL, 10);
     return *this;
   }
   FixedWidthReader & Get(std::string & s, ConstField const& field)
@@ -85,7 +90,19 @@ protected:
   {
     return line.substr(field.START, field.LENGTH);
   }
+  //Null terminated copy of field, empty past the end of the line
+  const char * Num(ConstField const& field)
+  {
+    size_t length = 0;
+    if (field.START < line.size())
+      length = std::min<size_t>(field.LENGTH, line.size() - field.START);
+    length = std::min<size_t>(length, sizeof(number) - 1);
+    memcpy(number, line.data() + field.START, length);
+    number[length] = '\0';
+    return number;
+  }
   std::string line;
+  char number[32];
 };
 
 #endif /*FIXED_WIDTH_READER_H*/
@@ -12,11 +12,13 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 
 #include <sstream>
 
-FreeEnergyOutput::FreeEnergyOutput(OutputVars & v, System & sys) :
+FreeEnergyOutput::FreeEnergyOutput(OutputVars & v, System & sys,
+                                   OutputPipeline & pipe) :
   calcEn(sys.calcEnergy), freeEnVal(sys.statV.freeEnVal),
-  lambdaRef(sys.lambdaRef)
+  lambdaRef(sys.lambdaRef), pipeline(pipe), nextRow(0)
 {
   this->var = &v;
+  rows[0].out = rows[1].out = this;
   for (uint b = 0; b < BOXES_WITH_U_NB; b++) {
     energyDiff[b] = NULL;
   }
@@ -45,13 +47,12 @@ void FreeEnergyOutput::Init(pdb_setup::Atoms const& atoms,
       fileName += strKind;
       fileName += "_";
       fileName += uniqueName;
-      fileName += ".dat";
-#if GOMC_LIB_MPI
       name[b] = pathToReplicaOutputDirectory + fileName;
-#else
-      name[b] = fileName;
-#endif
-      outF[b].open(name[b].c_str(), std::ofstream::out);
+      if(output.statistics.format.binary)
+        series[b].Open(name[b] + ".bin");
+      name[b] += ".dat";
+      if(output.statistics.format.text)
+        outF[b].open(name[b].c_str(), std::ofstream::out);
       energyDiff[b] = new Energy[lambdaSize];
     }
     WriteHeader();
@@ -94,42 +95,127 @@ void FreeEnergyOutput::Sample(const ulong step)
 void FreeEnergyOutput::DoOutput(const ulong step)
 {
   //Write to histogram file, We dont check the equilibrium.
-  if ((step + 1) % stepsPerOut == 0) {
-    for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
-      if (outF[b].is_open()) {
-        PrintData(b, step + 1);
-      } else {
+  if ((step + 1) % stepsPerOut != 0)
+    return;
+  FreeEnergyRow & row = rows[nextRow];
+  nextRow = 1 - nextRow;
+  pipeline.Acquire(row);
+  row.step = step + 1;
+  row.flush = false;
+  for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    std::vector<double> & values = row.values[b];
+    values.clear();
+    values.push_back(Etotal);
+    values.push_back(dUdL_Coulomb[b].Total());
+    values.push_back(dUdL_VDW[b].Total());
+    for(uint i = 0; i < lambdaSize; i++) {
+      values.push_back(energyDiff[b][i].Total());
+    }
+#if ENSEMBLE == NVT
+    if(var->pressureCalc) {
+      values.push_back(PV);
+    }
+#elif ENSEMBLE == NPT
+    values.push_back(PV);
+#endif
+  }
+  pipeline.Submit(row);
+}
+
+void FreeEnergyOutput::FlushSeries(void)
+{
+  FreeEnergyRow & row = rows[nextRow];
+  nextRow = 1 - nextRow;
+  pipeline.Acquire(row);
+  row.flush = true;
+  pipeline.Submit(row);
+}
+
+void FreeEnergyRow::Write()
+{
+  out->WriteRow(*this);
+}
+
+void FreeEnergyOutput::WriteRow(FreeEnergyRow const& row)
+{
+  //Every column but PV is followed by a space
+  const uint spaced = 3 + lambdaSize;
+  for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    if (row.flush) {
+      series[b].Flush();
+      continue;
+    }
+    std::vector<double> const& values = row.values[b];
+    series[b].Add(row.step);
+    for (uint v = 0; v < values.size(); ++v)
+      series[b].Add(values[v]);
+    series[b].EndRow();
+    if (!outF[b].is_open()) {
+      if (!series[b].IsOpen())
         std::cerr << "Unable to write to file \"" <<  name[b] << "\" "
                   << "(Free Energy file)" << std::endl;
-        outF[b].close();
-      }
+      continue;
     }
+    outF[b] << std::setw(11) << std::left << row.step << " ";
+    outF[b] << std::right << std::fixed;
+    for (uint v = 0; v < values.size(); ++v) {
+      outF[b] << std::setw(25) << values[v];
+      if (v < spaced)
+        outF[b] << " ";
+    }
+    outF[b] << std::endl;
   }
 }
 
-void FreeEnergyOutput::PrintData(const uint b, const uint step)
+std::vector<std::string> FreeEnergyOutput::ColumnNames(void)
 {
-  outF[b] << std::setw(11) << std::left << step << " ";
-  outF[b] << std::setw(25) << std::right << std::fixed << Etotal << " ";
-  outF[b] << std::setw(25) << dUdL_Coulomb[b].Total() << " ";
-  outF[b] << std::setw(25) << dUdL_VDW[b].Total() << " ";
+  std::vector<std::string> columns;
+  std::string toPrint;
+  columns.push_back("Steps");
+  columns.push_back("Total_En(kJ/mol)");
+  toPrint = "dU/dL(Coulomb=";
+  toPrint += GetString(freeEnVal.lambdaCoulomb[iState], 4);
+  toPrint += ")";
+  columns.push_back(toPrint);
+  toPrint = "dU/dL(VDW=";
+  toPrint += GetString(freeEnVal.lambdaVDW[iState], 4);
+  toPrint += ")";
+  columns.push_back(toPrint);
 
+  std::string fixStr = "DelE(L->(";
   for(uint i = 0; i < lambdaSize; i++) {
-    outF[b] << std::setw(25) << energyDiff[b][i].Total() << " ";
+    toPrint = fixStr;
+    toPrint += GetString(freeEnVal.lambdaCoulomb[i], 4);
+    toPrint += ",";
+    toPrint += GetString(freeEnVal.lambdaVDW[i], 4);
+    toPrint += "))";
+    columns.push_back(toPrint);
   }
 #if ENSEMBLE == NVT
   if(var->pressureCalc) {
-    outF[b] << std::setw(25) << PV;
+    columns.push_back("PV(kJ/mol)");
   }
 #elif ENSEMBLE == NPT
-  outF[b] << std::setw(25) << PV;
+  columns.push_back("PV(kJ/mol)");
 #endif
-  outF[b] << std::endl;
+  return columns;
 }
 
 void FreeEnergyOutput::WriteHeader(void)
 {
+  std::vector<std::string> columns = ColumnNames();
+  //Every column but PV is followed by a space
+  const uint spaced = 4 + lambdaSize;
   for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    for (uint c = 0; c < columns.size(); ++c)
+      series[b].AddColumn(columns[c]);
+    //The binary file keeps the state of the text header as metadata
+    series[b].AddMetadata("T(K)", GetString(var->T_in_K, 4));
+    series[b].AddMetadata("LambdaState", GetString(iState, 0));
+    series[b].AddMetadata("LambdaCoulomb",
+                          GetString(freeEnVal.lambdaCoulomb[iState], 4));
+    series[b].AddMetadata("LambdaVDW",
+                          GetString(freeEnVal.lambdaVDW[iState], 4));
     if (outF[b].is_open()) {
       std::string toPrint = "";
       toPrint += "#T = ";
@@ -144,37 +230,15 @@ void FreeEnergyOutput::WriteHeader(void)
       outF[b] << toPrint;
 
       //We care about format
-      outF[b] << std::setw(11) << std::left << "#Steps" << " ";
-      outF[b] << std::setw(25) << std::right << "Total_En(kJ/mol)" << " ";
-      toPrint = "dU/dL(Coulomb=";
-      toPrint += GetString(freeEnVal.lambdaCoulomb[iState], 4);
-      toPrint += ")";
-      outF[b] << std::setw(25) << std::right << toPrint << " ";
-      toPrint = "dU/dL(VDW=";
-      toPrint += GetString(freeEnVal.lambdaVDW[iState], 4);
-      toPrint += ")";
-      outF[b] << std::setw(25) << std::right << toPrint << " ";
-
-      std::string fixStr = "DelE(L->(";
-      for(uint i = 0; i < lambdaSize; i++) {
-        toPrint = fixStr;
-        toPrint += GetString(freeEnVal.lambdaCoulomb[i], 4);
-        toPrint += ",";
-        toPrint += GetString(freeEnVal.lambdaVDW[i], 4);
-        toPrint += "))";
-        outF[b] << std::setw(25) << std::right << toPrint << " ";
-      }
-#if ENSEMBLE == NVT
-      if(var->pressureCalc) {
-        outF[b] << std::setw(25) << std::right << "PV(kJ/mol)";
-      }
-#elif ENSEMBLE == NPT
-      outF[b] << std::setw(25) << std::right << "PV(kJ/mol)";
-#endif
+      outF[b] << std::setw(11) << std::left << "#" + columns[0] << " ";
+      for (uint c = 1; c < spaced; ++c)
+        outF[b] << std::setw(25) << std::right << columns[c] << " ";
+      if (columns.size() > spaced)
+        outF[b] << std::setw(25) << std::right << columns.back();
       outF[b] << std::endl;
       outF[b] << std::setprecision(10);
       outF[b].setf(std::ios_base::right, std::ios_base::adjustfield);
-    } else
+    } else if (!series[b].IsOpen())
       std::cerr << "Unable to write to file \"" <<  name[b] << "\" "
                 << "(Free Energy file)" << std::endl;
   }
@@ -20,10 +20,28 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "EnergyTypes.h"
 #include "CalculateEnergy.h"
 #include "UnitConst.h" //For unit conversion factors
+#include "TimeSeriesWriter.h"
+#include "OutputPipeline.h"
+
+struct FreeEnergyOutput;
+
+//Free energy values of one output step. They are taken on the simulation
+//thread and formatted by the output pipeline.
+struct FreeEnergyRow : OutputJob {
+  FreeEnergyRow() : out(NULL), flush(false) {}
+  virtual void Write();
+
+  FreeEnergyOutput * out;
+  uint step;
+  //no values, only writes the rows buffered for the binary files
+  bool flush;
+  //the columns after the step, for each box
+  std::vector<double> values[BOXES_WITH_U_NB];
+};
 
 struct FreeEnergyOutput : OutputableBase {
 
-  FreeEnergyOutput(OutputVars & v, System & sys);
+  FreeEnergyOutput(OutputVars & v, System & sys, OutputPipeline & pipe);
 
   ~FreeEnergyOutput();
 
@@ -34,11 +52,18 @@ struct FreeEnergyOutput : OutputableBase {
                     config_setup::Output const& output);
 
   virtual void DoOutput(const ulong step);
+  //Writes the rows buffered for the binary files, after the rows queued
+  //before
+  void FlushSeries(void);
 
 private:
-  void PrintData(const uint b, const uint step);
+  friend struct FreeEnergyRow;
+
+  //Formats and writes a row, on the pipeline thread
+  void WriteRow(FreeEnergyRow const& row);
   void CalculateFreeEnergy(const uint b);
   void WriteHeader(void);
+  std::vector<std::string> ColumnNames(void);
   std::string GetString(double a, uint p);
 
   uint stepsPerSample;
@@ -52,7 +77,12 @@ private:
   uint lambdaSize, iState;
 
   std::ofstream outF[BOXES_WITH_U_NB];
+  TimeSeriesWriter series[BOXES_WITH_U_NB];
   std::string name[BOXES_WITH_U_NB];
+  OutputPipeline & pipeline;
+  //double buffer, one row is filled while the other is written
+  FreeEnergyRow rows[2];
+  uint nextRow;
 #if ENSEMBLE == NPT
   double imposedP; //imposed pressure in NPT
 #endif
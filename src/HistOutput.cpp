@@ -11,9 +11,11 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 
 #include <sstream>
 
-Histogram::Histogram(OutputVars & v)
+Histogram::Histogram(OutputVars & v, OutputPipeline & pipe) :
+  pipeline(pipe), nextFrame(0)
 {
   this->var = &v;
+  frames[0].out = frames[1].out = this;
   total = NULL;
   for (uint b = 0; b < BOXES_WITH_U_NB; b++) {
     molCount[b] = NULL;
@@ -40,17 +42,10 @@ void Histogram::Init(pdb_setup::Atoms const& atoms,
       molCount[b] = new uint *[var->numKinds];
       outF[b] = new std::ofstream[var->numKinds];
       for (uint k = 0; k < var->numKinds; ++k) {
-#if GOMC_LIB_MPI
         name[b][k] = pathToReplicaOutputDirectory + GetFName( output.state.files.hist.histName,
                      output.state.files.hist.number,
                      output.state.files.hist.letter,
                      b, k);
-#else
-        name[b][k] = GetFName(output.state.files.hist.histName,
-                              output.state.files.hist.number,
-                              output.state.files.hist.letter,
-                              b, k);
-#endif
       }
     }
     //Figure out total of each kind of molecule in ALL boxes, including
@@ -110,24 +105,46 @@ void Histogram::DoOutput(const ulong step)
   if ((step) < stepsTillEquil) return;
   //Write to histogram file, if equilibrated.
   if ((step + 1) % stepsPerOut == 0) {
+    HistogramFrame & frame = frames[nextFrame];
+    nextFrame = 1 - nextFrame;
+    pipeline.Acquire(frame);
     for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
-      for (uint k = 0; k < var->numKinds; ++k) {
-        outF[b][k].open(name[b][k].c_str(), std::ofstream::out);
-        if (outF[b][k].is_open())
-          PrintKindHist(b, k);
-        else
-          std::cerr << "Unable to write to file \"" <<  name[b][k] << "\" "
-                    << "(histogram file)" << std::endl;
-        outF[b][k].close();
-      }
+      frame.molCount[b].resize(var->numKinds);
+      for (uint k = 0; k < var->numKinds; ++k)
+        frame.molCount[b][k].assign(molCount[b][k],
+                                    molCount[b][k] + total[k] + 1);
     }
+    pipeline.Submit(frame);
   }
 }
-void Histogram::PrintKindHist(const uint b, const uint k)
+
+void HistogramFrame::Write()
+{
+  out->WriteFrame(*this);
+}
+
+void Histogram::WriteFrame(HistogramFrame const& frame)
+{
+  for (uint b = 0; b < BOXES_WITH_U_NB; ++b) {
+    for (uint k = 0; k < var->numKinds; ++k) {
+      outF[b][k].open(name[b][k].c_str(), std::ofstream::out);
+      if (outF[b][k].is_open())
+        PrintKindHist(b, k, frame);
+      else
+        std::cerr << "Unable to write to file \"" <<  name[b][k] << "\" "
+                  << "(histogram file)" << std::endl;
+      outF[b][k].close();
+    }
+  }
+}
+
+void Histogram::PrintKindHist(const uint b, const uint k,
+                              HistogramFrame const& frame)
 {
-  for (uint n = 0; n < total[k] + 1; ++n) {
-    if ( molCount[b][k][n] != 0 )
-      outF[b][k] << n << " " << molCount[b][k][n] << std::endl;;
+  std::vector<uint> const& count = frame.molCount[b][k];
+  for (uint n = 0; n < count.size(); ++n) {
+    if ( count[n] != 0 )
+      outF[b][k] << n << " " << count[n] << '\n';
   }
 }
 
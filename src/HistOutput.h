@@ -16,10 +16,26 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "../lib/StrLib.h"
 #include "PDBSetup.h" //For atoms class.
 #include "EnergyTypes.h"
+#include "OutputPipeline.h"
+
+#include <vector>
+
+struct Histogram;
+
+//Copy of the histograms at an output step. It is taken on the simulation
+//thread and written by the output pipeline.
+struct HistogramFrame : OutputJob {
+  HistogramFrame() : out(NULL) {}
+  virtual void Write();
+
+  Histogram * out;
+  //Indices 1: boxes 2: kinds 3: count bins up to N_total
+  std::vector< std::vector<uint> > molCount[BOXES_WITH_U_NB];
+};
 
 struct Histogram : OutputableBase {
 
-  Histogram(OutputVars & v);
+  Histogram(OutputVars & v, OutputPipeline & pipe);
 
   ~Histogram();
 
@@ -32,7 +48,11 @@ struct Histogram : OutputableBase {
   virtual void DoOutput(const ulong step);
 
 private:
-  void PrintKindHist(const uint b, const uint k);
+  friend struct HistogramFrame;
+
+  //Writes the histogram files, on the pipeline thread
+  void WriteFrame(HistogramFrame const& frame);
+  void PrintKindHist(const uint b, const uint k, HistogramFrame const& frame);
 
   std::string GetFName(std::string const& histName,
                        std::string const& histNum,
@@ -44,6 +64,11 @@ private:
   uint * total;
   uint stepsPerSample;
 
+  OutputPipeline & pipeline;
+  //double buffer, one frame is filled while the other is written
+  HistogramFrame frames[2];
+  uint nextFrame;
+
   std::ofstream * outF [BOXES_WITH_U_NB];
   std::string * name [BOXES_WITH_U_NB];
 };
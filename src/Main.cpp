@@ -6,9 +6,11 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 ********************************************************************************/
 #include "Simulation.h"
 #include "GOMC_Config.h"    //For version number
+#include "ParallelTemperingPreprocessor.h"
 #if GOMC_LIB_MPI
 #include <mpi.h>
-#include "ParallelTemperingPreprocessor.h"
+#else
+#include "ReplicaExchange.h"
 #endif
 #ifdef GOMC_CUDA
 #include "cuda.h"
@@ -148,8 +150,17 @@ int main(int argc, char *argv[])
       MPI_Finalize();
     }
 #else
-    Simulation sim(inputFileString.c_str());
-    sim.RunSimulation();
+    //Without MPI the replicas of a parallel tempering run share this
+    //process, each on its own team of threads
+    ParallelTemperingPreprocessor pt(inputFileString.c_str());
+    if(pt.checkIfParallelTemperingEnabled(inputFileString.c_str()) &&
+        pt.checkIfExpandedEnsemble(inputFileString.c_str())) {
+      ReplicaExchange replicas(inputFileString.c_str(), numThreads);
+      replicas.RunSimulation();
+    } else {
+      Simulation sim(inputFileString.c_str());
+      sim.RunSimulation();
+    }
     PrintSimulationFooter();
 #endif
   }
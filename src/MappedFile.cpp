@@ -0,0 +1,79 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "MappedFile.h"
+#include <cstdio>
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(void) : data(NULL), size(0), mapped(false) {}
+
+MappedFile::~MappedFile(void)
+{
+  Close();
+}
+
+bool MappedFile::Open(std::string const& name)
+{
+  Close();
+#if defined(__linux__) || defined(__APPLE__)
+  int fd = open(name.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    return false;
+  }
+  size = info.st_size;
+  //mmap does not take empty files, they need no data anyway
+  if (size != 0) {
+    void * view = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view != MAP_FAILED) {
+      madvise(view, size, MADV_SEQUENTIAL);
+      data = (const char *)view;
+      mapped = true;
+    }
+  }
+  close(fd);
+  if (mapped || size == 0)
+    return true;
+#endif
+  FILE * file = fopen(name.c_str(), "rb");
+  if (file == NULL)
+    return false;
+  fseek(file, 0, SEEK_END);
+  long length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (length < 0) {
+    fclose(file);
+    return false;
+  }
+  buffer.resize(length);
+  size = length;
+  bool good = size == 0 || fread(&buffer[0], 1, size, file) == size;
+  fclose(file);
+  data = size == 0 ? NULL : &buffer[0];
+  if (!good)
+    Close();
+  return good;
+}
+
+void MappedFile::Close(void)
+{
+#if defined(__linux__) || defined(__APPLE__)
+  if (mapped)
+    munmap((void *)data, size);
+#endif
+  mapped = false;
+  data = NULL;
+  size = 0;
+  buffer.clear();
+}
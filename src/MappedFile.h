@@ -0,0 +1,46 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+//Read-only view of a whole input file, for the readers that parse large
+//files in place. On Linux and macOS the file is mapped into memory, on
+//other systems it is read into a buffer with one fread. The view is not
+//null terminated.
+class MappedFile
+{
+public:
+  MappedFile(void);
+  ~MappedFile(void);
+
+  //False if the file could not be opened or read
+  bool Open(std::string const& name);
+  void Close(void);
+  const char * Begin(void) const
+  {
+    return data;
+  }
+  const char * End(void) const
+  {
+    return data + size;
+  }
+
+private:
+  MappedFile(MappedFile const&);
+  MappedFile & operator=(MappedFile const&);
+
+  const char * data;
+  size_t size;
+  bool mapped;
+  std::vector<char> buffer;
+};
+
+#endif /*MAPPED_FILE_H*/
@@ -12,8 +12,11 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "FFSetup.h"        //For geometry kinds
 #include "BasicTypes.h"
 #include "GeomLib.h"
+#include "MappedFile.h"     //For PSF file in memory
 
 #include <cstdio>
+#include <cstdlib>          //strtod
+#include <cctype>
 #include <utility>      //for swap (most modern compilers)
 #include <algorithm>      //for swap pre-c++11 compilers
 #include <cstring>          //strstr
@@ -58,30 +61,33 @@ void BriefBondKinds(MolKind& kind, const FFSetup& ffData);
 void BriefAngleKinds(MolKind& kind, const FFSetup& ffData);
 void BriefDihKinds(MolKind& kind, const FFSetup& ffData);
 
+//Position in a PSF file read into memory
+struct PSFCursor {
+  const char * pos;
+  const char * end;
+};
+
 //Builds kindMap from PSF file (does not include coordinates) kindMap
 // should be empty returns number of atoms in the file, or READERROR if
 // the read failed somehow
 int ReadPSF(const char* psfFilename, MolMap& kindMap);
 //adds atoms and molecule data in psf to kindMap
-//pre: stream is at !NATOMS   post: stream is at end of atom section
-int ReadPSFAtoms(FILE* psf,
+//pre: cursor is at !NATOMS   post: cursor is at end of atom section
+int ReadPSFAtoms(PSFCursor& psf,
                  MolMap& kindMap, uint nAtoms);
 //adds bonds in psf to kindMap
-//pre: stream is before !BONDS   post: stream is in bond section just after
-//the first appearance of the last molecule
-int ReadPSFBonds(FILE* psf, MolMap& kindMap,
+//pre: cursor is after !NBOND   post: cursor is after the last bond
+int ReadPSFBonds(PSFCursor& psf, MolMap& kindMap,
                  std::vector<std::pair<uint, std::string> >& firstAtom,
                  const uint nbonds);
 //adds angles in psf to kindMap
-//pre: stream is before !NTHETA   post: stream is in angle section just
-//after the first appearance of the last molecule
-int ReadPSFAngles(FILE* psf, MolMap& kindMap,
+//pre: cursor is after !NTHETA   post: cursor is after the last angle
+int ReadPSFAngles(PSFCursor& psf, MolMap& kindMap,
                   std::vector<std::pair<uint, std::string> >& firstAtom,
                   const uint nangles);
 //adds dihedrals in psf to kindMap
-//pre: stream is before !NPHI   post: stream is in dihedral section just
-//after the first appearance of the last molecule
-int ReadPSFDihedrals(FILE* psf, MolMap& kindMap,
+//pre: cursor is after !NPHI   post: cursor is after the last dihedral
+int ReadPSFDihedrals(PSFCursor& psf, MolMap& kindMap,
                      std::vector<std::pair<uint, std::string> >& firstAtom,
                      const uint ndihedrals);
 
@@ -257,7 +263,12 @@ void MolSetup::AssignKinds(const pdb_setup::Atoms& pdbAtoms, const FFSetup& ffDa
     AssignAngleKinds(it->second, ffData);
     AssignDihKinds(it->second, ffData);
   }
+  PrintKinds(ffData);
+}
 
+void MolSetup::PrintKinds(const FFSetup& ffData)
+{
+  typedef MolMap::iterator MapIt;
   //Print bonded Information
   printf("Bonds parameter:\n");
   printf("%s %33s %15s \n", "Atom Types", "Kb(K)", "b0(A)");
@@ -542,31 +553,181 @@ void mol_setup::PrintMolMapBrief(const MolMap& kindMap)
 
 namespace
 {
+//Moves the cursor past the next line, begin and lineEnd bound the line
+//without its line end. False at the end of the file.
+bool NextLine(PSFCursor& psf, const char*& begin, const char*& lineEnd)
+{
+  if (psf.pos == psf.end)
+    return false;
+  begin = psf.pos;
+  lineEnd = (const char*)memchr(begin, '\n', psf.end - begin);
+  if (lineEnd == NULL)
+    lineEnd = psf.end;
+  psf.pos = (lineEnd == psf.end) ? psf.end : lineEnd + 1;
+  return true;
+}
+
+//Next whitespace separated item of [pos, end), false if there is none
+bool NextToken(const char*& pos, const char* end,
+               const char*& begin, const char*& tokenEnd)
+{
+  while (pos != end && isspace((unsigned char)*pos))
+    ++pos;
+  if (pos == end)
+    return false;
+  begin = pos;
+  while (pos != end && !isspace((unsigned char)*pos))
+    ++pos;
+  tokenEnd = pos;
+  return true;
+}
+
+//Unsigned number at the start of [begin, end), false if there is none
+bool ToUint(const char* begin, const char* end, uint& value)
+{
+  if (begin == end || !isdigit((unsigned char)*begin))
+    return false;
+  value = 0;
+  for (; begin != end && isdigit((unsigned char)*begin); ++begin)
+    value = 10 * value + (*begin - '0');
+  return true;
+}
+
+double ToDouble(const char* begin, const char* end)
+{
+  char number[64];
+  size_t length = std::min<size_t>(end - begin, sizeof(number) - 1);
+  memcpy(number, begin, length);
+  number[length] = '\0';
+  return strtod(number, NULL);
+}
+
+//Next whitespace separated unsigned number, as fscanf's %u
+bool NextUint(PSFCursor& psf, uint& value)
+{
+  const char *begin, *end;
+  const char* pos = psf.pos;
+  if (!NextToken(pos, psf.end, begin, end) || !ToUint(begin, end, value))
+    return false;
+  //the number ends at the first non-digit, like fscanf
+  for (psf.pos = begin; psf.pos != end && isdigit((unsigned char)*psf.pos);)
+    ++psf.pos;
+  return true;
+}
+
+//Moves the cursor past the first line containing tag, false if none does
+bool FindLine(MappedFile const& file, PSFCursor& psf, const char* tag,
+              const char*& begin, const char*& lineEnd)
+{
+  const char* tagEnd = tag + strlen(tag);
+  psf.pos = file.Begin();
+  psf.end = file.End();
+  while (NextLine(psf, begin, lineEnd)) {
+    if (std::search(begin, lineEnd, tag, tagEnd) != lineEnd)
+      return true;
+  }
+  return false;
+}
+
+//Leading number of a header line, 0 if there is none, as atoi
+uint HeaderCount(const char* begin, const char* lineEnd)
+{
+  const char *token, *tokenEnd;
+  uint count = 0;
+  if (NextToken(begin, lineEnd, token, tokenEnd))
+    ToUint(token, tokenEnd, count);
+  return count;
+}
+
+//One line of the atom section
+struct PSFAtomLine {
+  uint atomID, molID;
+  std::string moleculeName, atomName, atomType;
+  double charge, mass;
+};
+
+//Parses " %u %s %u %s %s %s %lf %lf "
+void ParseAtomLine(const char* pos, const char* end, PSFAtomLine& atom)
+{
+  const char *begin, *tokenEnd;
+  atom.atomID = atom.molID = 0;
+  atom.charge = atom.mass = 0.0;
+  if (NextToken(pos, end, begin, tokenEnd))
+    ToUint(begin, tokenEnd, atom.atomID);
+  NextToken(pos, end, begin, tokenEnd);  //segment
+  if (NextToken(pos, end, begin, tokenEnd))
+    ToUint(begin, tokenEnd, atom.molID);
+  if (NextToken(pos, end, begin, tokenEnd))
+    atom.moleculeName.assign(begin, tokenEnd);
+  if (NextToken(pos, end, begin, tokenEnd))
+    atom.atomName.assign(begin, tokenEnd);
+  if (NextToken(pos, end, begin, tokenEnd))
+    atom.atomType.assign(begin, tokenEnd);
+  if (NextToken(pos, end, begin, tokenEnd))
+    atom.charge = ToDouble(begin, tokenEnd);
+  if (NextToken(pos, end, begin, tokenEnd))
+    atom.mass = ToDouble(begin, tokenEnd);
+}
+
+//First molecule of each kind, sorted by first atom, to find the kind a
+//bond, angle or dihedral belongs to with a binary search
+struct FirstMolecule {
+  uint begin, end, index;
+  MolKind* kind;
+  bool operator<(const uint atom) const
+  {
+    return begin <= atom;
+  }
+};
+
+std::vector<FirstMolecule> FirstMolecules(MolMap& kindMap,
+    std::vector<std::pair<unsigned int, std::string> >& firstAtom)
+{
+  std::vector<FirstMolecule> first(firstAtom.size());
+  for (unsigned int i = 0; i < firstAtom.size(); ++i) {
+    first[i].kind = &kindMap[firstAtom[i].second];
+    first[i].begin = firstAtom[i].first;
+    first[i].end = first[i].begin + first[i].kind->atoms.size();
+    first[i].index = i;
+  }
+  return first;
+}
+
+//First molecule holding atom, NULL if atom is in none of them
+FirstMolecule* FindFirstMolecule(std::vector<FirstMolecule>& first,
+                                 const uint atom)
+{
+  std::vector<FirstMolecule>::iterator it =
+    std::lower_bound(first.begin(), first.end(), atom);
+  //it is the first molecule starting after atom
+  if (it == first.begin())
+    return NULL;
+  --it;
+  return (atom < it->end) ? &(*it) : NULL;
+}
+
 //Initializes system from PSF file (does not include coordinates)
 //returns number of atoms in the file, or READERROR if the read failed somehow
 int ReadPSF(const char* psfFilename, MolMap& kindMap)
 {
-  FILE* psf = fopen(psfFilename, "r");
-  char* check;		//return value of fgets
+  MappedFile file;
+  PSFCursor psf;
+  const char *begin, *lineEnd;
   int count;		//for number of bonds/angles/dihs
-  if (psf == NULL) {
+  if (!file.Open(psfFilename)) {
     fprintf(stderr, "ERROR: Failed to open PSF file %s for molecule data.\nExiting...\n", psfFilename);
     return READERROR;
   }
-  char input[512];
   unsigned int nAtoms;
   //find atom header+count
-  do {
-    check = fgets(input, 511, psf);
-    if (check == NULL) {
-      fprintf(stderr, "ERROR: Unable to read atoms from PSF file %s",
-              psfFilename);
-      fclose(psf);
-      return READERROR;
-    }
-  } while (strstr(input, "!NATOM") == NULL);
-  sscanf(input, " %u", &nAtoms);
-  ReadPSFAtoms(psf, kindMap, nAtoms);
+  if (!FindLine(file, psf, "!NATOM", begin, lineEnd)) {
+    fprintf(stderr, "ERROR: Unable to read atoms from PSF file %s",
+            psfFilename);
+    return READERROR;
+  }
+  nAtoms = HeaderCount(begin, lineEnd);
+  if (ReadPSFAtoms(psf, kindMap, nAtoms) == READERROR)
+    return READERROR;
   //build list of start particles for each type, so we can find it and skip
   //everything else
   std::vector<std::pair<unsigned int, std::string> > firstAtomLookup;
@@ -575,142 +736,122 @@ int ReadPSF(const char* psfFilename, MolMap& kindMap)
   }
   std::sort(firstAtomLookup.begin(), firstAtomLookup.end());
   //find bond header+count
-  while (strstr(input, "!NBOND") == NULL) {
-    check = fgets(input, 511, psf);
-    if (check == NULL) {
-      fprintf(stderr, "ERROR: Unable to read bonds from PSF file %s",
-              psfFilename);
-      fclose(psf);
-      return  READERROR;
-    }
+  if (!FindLine(file, psf, "!NBOND", begin, lineEnd)) {
+    fprintf(stderr, "ERROR: Unable to read bonds from PSF file %s",
+            psfFilename);
+    return  READERROR;
   }
   //make sure molecule has bonds, appears before !NBOND
-  count = atoi(input);
+  count = HeaderCount(begin, lineEnd);
   if (ReadPSFBonds(psf, kindMap, firstAtomLookup, count) == READERROR) {
-    fclose(psf);
     return READERROR;
   }
   //find angle header+count
-  fseek(psf, 0, SEEK_SET);
-  while (strstr(input, "!NTHETA") == NULL) {
-    check = fgets(input, 511, psf);
-    if (check == NULL) {
-      fprintf(stderr, "ERROR: Unable to read angles from PSF file %s",
-              psfFilename);
-      fclose(psf);
-      return READERROR;
-    }
+  if (!FindLine(file, psf, "!NTHETA", begin, lineEnd)) {
+    fprintf(stderr, "ERROR: Unable to read angles from PSF file %s",
+            psfFilename);
+    return READERROR;
   }
   //make sure molecule has angles, count appears before !NTHETA
-  count = atoi(input);
+  count = HeaderCount(begin, lineEnd);
   if (ReadPSFAngles(psf, kindMap, firstAtomLookup, count) == READERROR) {
-    fclose(psf);
     return READERROR;
   }
   //find dihedrals header+count
-  fseek(psf, 0, SEEK_SET);
-  while (strstr(input, "!NPHI") == NULL) {
-    check = fgets(input, 511, psf);
-    if (check == NULL) {
-      fprintf(stderr, "ERROR: Unable to read dihedrals from PSF file %s",
-              psfFilename);
-      fclose(psf);
-      return READERROR;
-    }
+  if (!FindLine(file, psf, "!NPHI", begin, lineEnd)) {
+    fprintf(stderr, "ERROR: Unable to read dihedrals from PSF file %s",
+            psfFilename);
+    return READERROR;
   }
   //make sure molecule has dihs, count appears before !NPHI
-  count = atoi(input);
+  count = HeaderCount(begin, lineEnd);
   if (ReadPSFDihedrals(psf, kindMap, firstAtomLookup, count) == READERROR) {
-    fclose(psf);
     return READERROR;
   }
 
-  fclose(psf);
-
   return nAtoms;
 }
 
 //adds atoms and molecule data in psf to kindMap
-//pre: stream is at !NATOMS   post: stream is at end of atom section
-int ReadPSFAtoms(FILE* psf, MolMap& kindMap, unsigned int nAtoms)
+//pre: cursor is at !NATOMS   post: cursor is at end of atom section
+int ReadPSFAtoms(PSFCursor& psf, MolMap& kindMap, unsigned int nAtoms)
 {
-  char input[512];
   unsigned int atomID = 0;
-  unsigned int molID;
-  char segment[11], moleculeName[11], atomName[11], atomType[11];
-  double charge, mass;
+  const char *begin, *lineEnd, *token, *tokenEnd;
+  std::vector<const char*> lineBegin, lineStop;
 
+  //find the lines of the atoms, the section ends at atom nAtoms
   while (atomID < nAtoms) {
-    char* check = fgets(input, 511, psf);
-    if (check == NULL) {
+    if (!NextLine(psf, begin, lineEnd)) {
       fprintf(stderr, "ERROR: Could not find all atoms in PSF file ");
       return READERROR;
     }
     //skip comment/blank lines
-    if (input[0] == '!' || str::AllWS(input))
+    const char* pos = begin;
+    if (!NextToken(pos, lineEnd, token, tokenEnd) || *begin == '!')
       continue;
-    //parse line
-    sscanf(input, " %u %s %u %s %s %s %lf %lf ",
-           &atomID, segment, &molID,
-           moleculeName, atomName, atomType, &charge, &mass);
-    MolMap::iterator it = kindMap.find(moleculeName);
+    ToUint(token, tokenEnd, atomID);
+    lineBegin.push_back(begin);
+    lineStop.push_back(lineEnd);
+  }
+
+  //parse the lines in parallel, the kinds are built in file order below
+  std::vector<PSFAtomLine> atoms(lineBegin.size());
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < (int)atoms.size(); i++)
+    ParseAtomLine(lineBegin[i], lineStop[i], atoms[i]);
+
+  for (uint i = 0; i < atoms.size(); i++) {
+    PSFAtomLine const& atom = atoms[i];
+    MolMap::iterator it = kindMap.find(atom.moleculeName);
     //found new molecule kind...
     if (it == kindMap.end()) {
-      it = kindMap.insert(std::make_pair(std::string(moleculeName), MolKind())).first;
-      it->second.firstAtomID = atomID;
-      it->second.firstMolID = molID;
-      it->second.atoms.push_back(Atom(atomName, atomType, charge, mass));
+      it = kindMap.insert(std::make_pair(atom.moleculeName, MolKind())).first;
+      it->second.firstAtomID = atom.atomID;
+      it->second.firstMolID = atom.molID;
+      it->second.atoms.push_back(Atom(atom.atomName, atom.atomType,
+                                      atom.charge, atom.mass));
     }
     //still building a molecule...
     else if (it->second.incomplete) {
-      if (molID != it->second.firstMolID)
+      if (atom.molID != it->second.firstMolID)
         it->second.incomplete = false;
       else
-        it->second.atoms.push_back(Atom(atomName, atomType, charge, mass));
+        it->second.atoms.push_back(Atom(atom.atomName, atom.atomType,
+                                        atom.charge, atom.mass));
     }
   }
   //Fix for one molecule fringe case.
-  if (molID == 1) {
-    MolMap::iterator it = kindMap.find(moleculeName);
+  if (!atoms.empty() && atoms.back().molID == 1) {
+    MolMap::iterator it = kindMap.find(atoms.back().moleculeName);
     it->second.incomplete = false;
   }
   return 0;
 }
 
 //adds bonds in psf to kindMap
-//pre: stream is before !BONDS   post: stream is in bond section just after
-//the first appearance of the last molecule
-int ReadPSFBonds(FILE* psf, MolMap& kindMap,
+//pre: cursor is after !NBOND   post: cursor is after the last bond
+int ReadPSFBonds(PSFCursor& psf, MolMap& kindMap,
                  std::vector<std::pair<unsigned int, std::string> >& firstAtom,
                  const uint nbonds)
 {
   unsigned int atom0, atom1;
-  int dummy;
   std::vector<bool> defined(firstAtom.size(), false);
+  std::vector<FirstMolecule> first = FirstMolecules(kindMap, firstAtom);
   for (uint n = 0; n < nbonds; n++) {
-    dummy = fscanf(psf, "%u %u", &atom0, &atom1);
-    if(dummy != 2) {
+    if (!NextUint(psf, atom0) || !NextUint(psf, atom1)) {
       fprintf(stderr, "ERROR: Incorrect Number of bonds in PSF file ");
       return READERROR;
-    } else if (feof(psf) || ferror(psf)) {
-      fprintf(stderr, "ERROR: Could not find all bonds in PSF file ");
-      return READERROR;
     }
 
-    //loop to find the molecule kind with this bond
-    for (unsigned int i = 0; i < firstAtom.size(); ++i) {
-      MolKind& currentMol = kindMap[firstAtom[i].second];
-      //index of first atom in molecule
-      unsigned int molBegin = firstAtom[i].first;
-      //index AFTER last atom in molecule
-      unsigned int molEnd = molBegin + currentMol.atoms.size();
-      //assign the bond
-      if (atom0 >= molBegin && atom0 < molEnd) {
-        currentMol.bonds.push_back(Bond(atom0 - molBegin, atom1 - molBegin));
-        //once we found the molecule kind, break from the loop
-        defined[i] = true;
-        break;
-      }
+    //find the molecule kind with this bond
+    FirstMolecule* mol = FindFirstMolecule(first, atom0);
+    //assign the bond
+    if (mol != NULL) {
+      mol->kind->bonds.push_back(Bond(atom0 - mol->begin, atom1 - mol->begin));
+      defined[mol->index] = true;
     }
   }
   //Check if we defined all bonds
@@ -725,40 +866,28 @@ int ReadPSFBonds(FILE* psf, MolMap& kindMap,
 }
 
 //adds angles in psf to kindMap
-//pre: stream is before !NTHETA   post: stream is in angle section just after
-//the first appearance of the last molecule
-int ReadPSFAngles(FILE* psf, MolMap& kindMap,
+//pre: cursor is after !NTHETA   post: cursor is after the last angle
+int ReadPSFAngles(PSFCursor& psf, MolMap& kindMap,
                   std::vector<std::pair<unsigned int, std::string> >& firstAtom,
                   const uint nangles)
 {
   unsigned int atom0, atom1, atom2;
-  int dummy;
   std::vector<bool> defined(firstAtom.size(), false);
+  std::vector<FirstMolecule> first = FirstMolecules(kindMap, firstAtom);
   for (uint n = 0; n < nangles; n++) {
-    dummy = fscanf(psf, "%u %u %u", &atom0, &atom1, &atom2);
-    if(dummy != 3) {
+    if (!NextUint(psf, atom0) || !NextUint(psf, atom1) ||
+        !NextUint(psf, atom2)) {
       fprintf(stderr, "ERROR: Incorrect Number of angles in PSF file ");
       return READERROR;
-    } else if (feof(psf) || ferror(psf)) {
-      fprintf(stderr, "ERROR: Could not find all angles in PSF file ");
-      return READERROR;
     }
 
-    //loop to find the molecule kind with this angles
-    for (unsigned int i = 0; i < firstAtom.size(); ++i) {
-      MolKind& currentMol = kindMap[firstAtom[i].second];
-      //index of first atom in moleule
-      unsigned int molBegin = firstAtom[i].first;
-      //index AFTER last atom in molecule
-      unsigned int molEnd = molBegin + currentMol.atoms.size();
-      //assign the angle
-      if (atom0 >= molBegin && atom0 < molEnd) {
-        currentMol.angles.push_back(Angle(atom0 - molBegin, atom1 - molBegin,
-                                          atom2 - molBegin));
-        //once we found the molecule kind, break from the loop
-        defined[i] = true;
-        break;
-      }
+    //find the molecule kind with this angle
+    FirstMolecule* mol = FindFirstMolecule(first, atom0);
+    //assign the angle
+    if (mol != NULL) {
+      mol->kind->angles.push_back(Angle(atom0 - mol->begin, atom1 - mol->begin,
+                                        atom2 - mol->begin));
+      defined[mol->index] = true;
     }
   }
   //Check if we defined all angles
@@ -789,47 +918,36 @@ bool ContainsDihedral(const std::vector<uint>& vec, const int dih[])
 
 
 //adds dihedrals in psf to kindMap
-//pre: stream is before !NPHI   post: stream is in dihedral section just after
-//the first appearance of the last molecule
+//pre: cursor is after !NPHI   post: cursor is after the last dihedral
 //
-int ReadPSFDihedrals(FILE* psf, MolMap& kindMap,
+int ReadPSFDihedrals(PSFCursor& psf, MolMap& kindMap,
                      std::vector<std::pair<unsigned int, std::string> >& firstAtom, const uint ndihedrals)
 {
   Dihedral dih(0, 0, 0, 0);
-  int dummy;
   std::vector<bool> defined(firstAtom.size(), false);
+  std::vector<FirstMolecule> first = FirstMolecules(kindMap, firstAtom);
   for (uint n = 0; n < ndihedrals; n++) {
-    dummy = fscanf(psf, "%u %u %u %u", &dih.a0, &dih.a1, &dih.a2, &dih.a3);
-    if(dummy != 4) {
+    if (!NextUint(psf, dih.a0) || !NextUint(psf, dih.a1) ||
+        !NextUint(psf, dih.a2) || !NextUint(psf, dih.a3)) {
       fprintf(stderr, "ERROR: Incorrect Number of dihedrals in PSF file ");
       return READERROR;
-    } else if (feof(psf) || ferror(psf)) {
-      fprintf(stderr, "ERROR: Could not find all dihedrals in PSF file ");
-      return READERROR;
     }
 
-    //loop to find the molecule kind with this dihedral
-    for (unsigned int i = 0; i < firstAtom.size(); ++i) {
-      MolKind& currentMol = kindMap[firstAtom[i].second];
-      //index of first atom in moleule
-      unsigned int molBegin = firstAtom[i].first;
-      //index AFTER last atom in molecule
-      unsigned int molEnd = molBegin + currentMol.atoms.size();
-      //assign dihedral
-      if (dih.a0 >= molBegin && dih.a0 < molEnd) {
-        dih.a0 -= molBegin;
-        dih.a1 -= molBegin;
-        dih.a2 -= molBegin;
-        dih.a3 -= molBegin;
-        //some xplor PSF files have duplicate dihedrals, we need to ignore these
-        if (std::find(currentMol.dihedrals.begin(), currentMol.dihedrals.end(),
-                      dih) == currentMol.dihedrals.end()) {
-          currentMol.dihedrals.push_back(dih);
-        }
-        //once we found the molecule kind, break from the loop
-        defined[i] = true;
-        break;
+    //find the molecule kind with this dihedral
+    FirstMolecule* mol = FindFirstMolecule(first, dih.a0);
+    //assign dihedral
+    if (mol != NULL) {
+      MolKind& currentMol = *mol->kind;
+      dih.a0 -= mol->begin;
+      dih.a1 -= mol->begin;
+      dih.a2 -= mol->begin;
+      dih.a3 -= mol->begin;
+      //some xplor PSF files have duplicate dihedrals, we need to ignore these
+      if (std::find(currentMol.dihedrals.begin(), currentMol.dihedrals.end(),
+                    dih) == currentMol.dihedrals.end()) {
+        currentMol.dihedrals.push_back(dih);
       }
+      defined[mol->index] = true;
     }
   }
   //Check if we defined all dihedrals
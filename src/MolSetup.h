@@ -143,6 +143,8 @@ public:
            const std::string* psfFilename);
 
   void AssignKinds(const pdb_setup::Atoms& pdbAtoms, const FFSetup& ffData);
+  //Prints the parameters of the bonded kinds assigned
+  void PrintKinds(const FFSetup& ffData);
 
 //private:
   mol_setup::MolMap kindMap;
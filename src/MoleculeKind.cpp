@@ -11,6 +11,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "PDBConst.h" //For resname length.
 #include "PRNG.h"
 #include "Geometry.h"
+#include "GeomLib.h"
 #include "Setup.h"
 #include "CBMC.h"
 
@@ -22,6 +23,8 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include <utility>
 #include <cstdio>
 #include <cstdlib>      //for exit
+#include <cmath>
+#include <random>
 
 
 
@@ -97,6 +100,10 @@ void MoleculeKind::Init
   angles.Init(molData.angles, bondList);
   dihedrals.Init(molData.dihedrals, bondList);
 
+  rigid = false;
+  if(setup.config.sys.cbmcTrials.rigid)
+    InitRigid(molData, forcefield);
+
 #ifdef VARIABLE_PARTICLE_NUMBER
   builder = cbmc::MakeCBMC(sys, forcefield, *this, setup);
   //builder = new cbmc::LinearVlugt(sys, forcefield, *this, setup);
@@ -119,6 +126,221 @@ MoleculeKind::~MoleculeKind()
 
 
 
+void MoleculeKind::InitRigid(mol_setup::MolKind const& molData,
+                             Forcefield const& forcefield)
+{
+  //A kind is rigid when the distances pinned by its fixed bonds and angles
+  //leave no internal motion. Each fixed bond pins its length, each fixed
+  //angle between fixed bonds pins the distance of its end atoms, and the
+  //atoms on a line of fixed 180 degree angles pin every distance between
+  //them. The test below is on the graph of pinned distances, so it covers
+  //branches and rings as well as chains. A monatomic kind has no
+  //orientation.
+  rigidPair.clear();
+  rigidLength.clear();
+  if(numAtoms < 2)
+    return;
+  std::vector<double> dist(numAtoms * numAtoms, -1.0);
+  for(uint b = 0; b < molData.bonds.size(); ++b) {
+    const mol_setup::Bond& bond = molData.bonds[b];
+    if(!forcefield.bonds.BondFixed(bond.kind))
+      return;
+    dist[bond.a0 * numAtoms + bond.a1] = dist[bond.a1 * numAtoms + bond.a0] =
+                                           forcefield.bonds.Length(bond.kind);
+  }
+
+  //atoms of fixed straight angles, end, middle, end
+  std::vector<uint> straight;
+  for(uint i = 0; i < molData.angles.size(); ++i) {
+    const mol_setup::Angle& ang = molData.angles[i];
+    double b1 = dist[ang.a0 * numAtoms + ang.a1];
+    double b2 = dist[ang.a1 * numAtoms + ang.a2];
+    if(!forcefield.angles->AngleFixed(ang.kind) || b1 < 0.0 || b2 < 0.0)
+      continue;
+    double theta = forcefield.angles->Angle(ang.kind);
+    dist[ang.a0 * numAtoms + ang.a2] = dist[ang.a2 * numAtoms + ang.a0] =
+                                         sqrt(b1 * b1 + b2 * b2 -
+                                              2.0 * b1 * b2 * cos(theta));
+    if(std::abs(theta - M_PI) < 1e-6) {
+      straight.push_back(ang.a0);
+      straight.push_back(ang.a1);
+      straight.push_back(ang.a2);
+    }
+  }
+
+  //Place the atoms of each line at their offset along it, starting from a
+  //straight angle, and pin the distances between them
+  std::vector<bool> inLine(straight.size() / 3, false);
+  for(uint first = 0; first < inLine.size(); ++first) {
+    if(inLine[first])
+      continue;
+    std::vector<double> offset(numAtoms, 0.0);
+    std::vector<bool> placed(numAtoms, false);
+    const uint* abc = &straight[3 * first];
+    offset[abc[1]] = dist[abc[0] * numAtoms + abc[1]];
+    offset[abc[2]] = offset[abc[1]] + dist[abc[1] * numAtoms + abc[2]];
+    placed[abc[0]] = placed[abc[1]] = placed[abc[2]] = true;
+    inLine[first] = true;
+    bool grown = true;
+    while(grown) {
+      grown = false;
+      for(uint t = 0; t < inLine.size(); ++t) {
+        const uint* e = &straight[3 * t];
+        if(inLine[t] || placed[e[0]] + placed[e[1]] + placed[e[2]] < 2)
+          continue;
+        //the middle atom lies between the two ends
+        if(!placed[e[1]]) {
+          double dir = offset[e[2]] > offset[e[0]] ? 1.0 : -1.0;
+          offset[e[1]] = offset[e[0]] + dir * dist[e[0] * numAtoms + e[1]];
+          placed[e[1]] = true;
+        } else {
+          for(uint end = 0; end < 3; end += 2) {
+            const uint known = e[2 - end], other = e[end];
+            if(!placed[other]) {
+              double dir = offset[e[1]] > offset[known] ? 1.0 : -1.0;
+              offset[other] = offset[e[1]] +
+                              dir * dist[e[1] * numAtoms + other];
+              placed[other] = true;
+            }
+          }
+        }
+        inLine[t] = grown = true;
+      }
+    }
+    for(uint a = 0; a < numAtoms; ++a) {
+      for(uint b = a + 1; b < numAtoms; ++b) {
+        if(placed[a] && placed[b])
+          dist[a * numAtoms + b] = dist[b * numAtoms + a] =
+                                     std::abs(offset[a] - offset[b]);
+      }
+    }
+  }
+
+  for(uint a = 0; a < numAtoms; ++a) {
+    for(uint b = a + 1; b < numAtoms; ++b) {
+      if(dist[a * numAtoms + b] >= 0.0) {
+        rigidPair.push_back(a);
+        rigidPair.push_back(b);
+        rigidLength.push_back(dist[a * numAtoms + b]);
+      }
+    }
+  }
+
+  //The pinned distances leave no internal motion if their rigidity
+  //matrix, at atom positions in general position, has rank 3N - 6 (1 for
+  //two atoms). Each row is the derivative of one distance by the 3N atom
+  //coordinates.
+  const uint cols = 3 * numAtoms;
+  const uint pairs = rigidLength.size();
+  std::mt19937 gen(numAtoms);
+  std::uniform_real_distribution<double> coord(-1.0, 1.0);
+  std::vector<XYZ> at(numAtoms);
+  for(uint a = 0; a < numAtoms; ++a)
+    at[a] = XYZ(coord(gen), coord(gen), coord(gen));
+  std::vector<double> matrix(pairs * cols, 0.0);
+  for(uint r = 0; r < pairs; ++r) {
+    const uint a = rigidPair[2 * r], b = rigidPair[2 * r + 1];
+    XYZ d = at[a] - at[b];
+    double* row = &matrix[r * cols];
+    row[3 * a] = d.x;
+    row[3 * a + 1] = d.y;
+    row[3 * a + 2] = d.z;
+    row[3 * b] = -d.x;
+    row[3 * b + 1] = -d.y;
+    row[3 * b + 2] = -d.z;
+  }
+  uint rank = 0;
+  for(uint c = 0; c < cols && rank < pairs; ++c) {
+    uint pivot = rank;
+    for(uint r = rank + 1; r < pairs; ++r) {
+      if(std::abs(matrix[r * cols + c]) > std::abs(matrix[pivot * cols + c]))
+        pivot = r;
+    }
+    if(std::abs(matrix[pivot * cols + c]) < 1e-9)
+      continue;
+    for(uint k = 0; k < cols; ++k)
+      std::swap(matrix[pivot * cols + k], matrix[rank * cols + k]);
+    for(uint r = rank + 1; r < pairs; ++r) {
+      double factor = matrix[r * cols + c] / matrix[rank * cols + c];
+      for(uint k = c; k < cols; ++k)
+        matrix[r * cols + k] -= factor * matrix[rank * cols + k];
+    }
+    ++rank;
+  }
+  rigid = rank == (numAtoms == 2 ? 1 : cols - 6);
+}
+
+double MoleculeKind::SetBodyFrame(XYZArray const& pos, const uint start)
+{
+  //centered on the unweighted mean of the atoms, as the COM is
+  bodyFrame.Uninit();
+  bodyFrame.Init(numAtoms);
+  XYZ center;
+  for(uint a = 0; a < numAtoms; ++a)
+    center += pos.Get(start + a);
+  center *= 1.0 / numAtoms;
+  for(uint a = 0; a < numAtoms; ++a)
+    bodyFrame.Set(a, pos.Get(start + a) - center);
+
+  //the frame axis runs from the first atom to the one farthest from it,
+  //the third frame atom is the one farthest off that axis
+  frameAtom[0] = frameAtom[1] = frameAtom[2] = 0;
+  double far = 0.0;
+  for(uint a = 1; a < numAtoms; ++a) {
+    double d = bodyFrame.Difference(a, 0).LengthSq();
+    if(d > far) {
+      far = d;
+      frameAtom[1] = a;
+    }
+  }
+  XYZ axis = bodyFrame.Difference(frameAtom[1], 0);
+  axis.Normalize();
+  far = 0.0;
+  for(uint a = 1; a < numAtoms; ++a) {
+    double d = geom::Cross(axis, bodyFrame.Difference(a, 0)).LengthSq();
+    if(d > far) {
+      far = d;
+      frameAtom[2] = a;
+    }
+  }
+  //within 0.01 A of the axis, as read from a PDB file
+  linear = far < 1e-4;
+  bodyBasisInv = FrameBasis(bodyFrame, 0).Inverse();
+
+  double sumSq = 0.0;
+  for(uint r = 0; r < rigidLength.size(); ++r) {
+    double d = bodyFrame.Difference(rigidPair[2 * r],
+                                    rigidPair[2 * r + 1]).Length();
+    sumSq += num::Sq(d - rigidLength[r]);
+  }
+  return rigidLength.empty() ? 0.0 : sqrt(sumSq / rigidLength.size());
+}
+
+RotationMatrix MoleculeKind::FrameBasis(XYZArray const& pos,
+                                        const uint start) const
+{
+  XYZ e1 = pos.Difference(start + frameAtom[1], start + frameAtom[0]);
+  e1.Normalize();
+  XYZ e2;
+  if(linear) {
+    //any direction perpendicular to the axis, as TrialMol::SetBasis does
+    e2 = std::abs(e1.x) < 0.8 ? XYZ(1.0, 0.0, 0.0) : XYZ(0.0, 1.0, 0.0);
+  } else {
+    e2 = pos.Difference(start + frameAtom[2], start + frameAtom[0]);
+  }
+  e2 -= e1 * geom::Dot(e1, e2);
+  e2.Normalize();
+  RotationMatrix basis;
+  basis.BasisRotation(e1, e2, geom::Cross(e1, e2));
+  return basis;
+}
+
+RotationMatrix MoleculeKind::BodyRotation(XYZArray const& pos,
+    const uint start) const
+{
+  return FrameBasis(pos, start) * bodyBasisInv;
+}
+
 void MoleculeKind::InitAtoms(mol_setup::MolKind const& molData)
 {
   numAtoms = molData.atoms.size();
@@ -12,6 +12,8 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "SubdividedArray.h"
 #include "Geometry.h"            //members
 #include "CBMC.h"
+#include "XYZArray.h"            //body frame
+#include "TransformMatrix.h"
 
 #include <string>
 #include <vector>
@@ -68,6 +70,25 @@ public:
   {
     return atomKind[a];
   }
+  //True if rigid kinds are enabled and the fixed bonds and angles of the
+  //kind pin every distance between its atoms
+  bool IsRigid() const
+  {
+    return rigid;
+  }
+  //Atom positions of a rigid kind relative to its center, in the body
+  //frame, see SetBodyFrame
+  XYZArray const& BodyFrame() const
+  {
+    return bodyFrame;
+  }
+  //Takes the body frame of a rigid kind from the unwrapped atoms of one of
+  //its molecules, pos[start] being its first atom. Returns the RMS
+  //deviation (A) of its fixed distances from the force field.
+  double SetBodyFrame(XYZArray const& pos, const uint start);
+  //Rotation taking the body frame to the unwrapped atoms of a molecule of
+  //the kind, pos[start] being its first atom
+  RotationMatrix BodyRotation(XYZArray const& pos, const uint start) const;
   double AtomCharge(const uint a) const
   {
     return atomCharge[a];
@@ -149,6 +170,7 @@ public:
   GeomFeature angles;
   GeomFeature dihedrals;
   bool oneThree, oneFour;
+  bool rigid;
 
   std::string name;
   std::vector<std::string> atomNames, atomTypeNames;
@@ -164,6 +186,11 @@ public:
 private:
 
   void InitAtoms(mol_setup::MolKind const& molData);
+  void InitRigid(mol_setup::MolKind const& molData,
+                 Forcefield const& forcefield);
+  //orthonormal basis from the atoms in frameAtom, the second one seen
+  //from the first and for a bent kind the third one
+  RotationMatrix FrameBasis(XYZArray const& pos, const uint start) const;
 
   //uses buildBonds to check if molecule is branched
   //bool CheckBranches();
@@ -175,6 +202,16 @@ private:
   uint numAtoms;
   uint * atomKind;
   double * atomCharge;
+
+  //atom pairs whose distance the fixed bonds and angles pin, and that
+  //distance
+  std::vector<uint> rigidPair;
+  std::vector<double> rigidLength;
+  XYZArray bodyFrame;
+  //FrameBasis of the body frame, transposed
+  RotationMatrix bodyBasisInv;
+  uint frameAtom[3];
+  bool linear;
 };
 
 
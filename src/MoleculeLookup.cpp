@@ -68,6 +68,14 @@ void MoleculeLookup::Init(const Molecules& mols,
     }
   }
   boxAndKindStart[numKinds * BOX_TOTAL] = mols.count;
+  InitPosition();
+}
+
+void MoleculeLookup::InitPosition()
+{
+  molPosition.resize(molLookupCount);
+  for(uint i = 0; i < molLookupCount; ++i)
+    molPosition[molLookup[i]] = i;
 }
 
 uint MoleculeLookup::NumInBox(const uint box) const
@@ -113,11 +121,9 @@ void MoleculeLookup::TotalAndDensity
 bool MoleculeLookup::ShiftMolBox(const uint mol, const uint currentBox,
                                  const uint intoBox, const uint kind)
 {
-  uint index = std::find(
-                 molLookup + boxAndKindStart[currentBox * numKinds + kind],
-                 molLookup + boxAndKindStart[currentBox * numKinds + kind + 1], mol)
-               - molLookup;
-  assert(index != boxAndKindStart[currentBox * numKinds + kind + 1]);
+  uint index = molPosition[mol];
+  assert(index >= boxAndKindStart[currentBox * numKinds + kind]);
+  assert(index < boxAndKindStart[currentBox * numKinds + kind + 1]);
   assert(molLookup[index] == mol);
   Shift(index, currentBox, intoBox, kind);
   return true;
@@ -135,6 +141,8 @@ void MoleculeLookup::Shift(const uint index, const uint currentBox,
       uint temp = molLookup[oldIndex];
       molLookup[oldIndex] = molLookup[newIndex];
       molLookup[newIndex] = temp;
+      molPosition[molLookup[oldIndex]] = oldIndex;
+      molPosition[temp] = newIndex;
       oldIndex = newIndex;
       --section;
     }
@@ -144,6 +152,8 @@ void MoleculeLookup::Shift(const uint index, const uint currentBox,
       uint temp = molLookup[oldIndex];
       molLookup[oldIndex] = molLookup[newIndex];
       molLookup[newIndex] = temp;
+      molPosition[molLookup[oldIndex]] = oldIndex;
+      molPosition[temp] = newIndex;
       oldIndex = newIndex;
     }
   }
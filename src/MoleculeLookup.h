@@ -110,6 +110,9 @@ public:
 
 private:
 
+  //Rebuild molPosition from molLookup
+  void InitPosition();
+
 #ifdef VARIABLE_PARTICLE_NUMBER
   void Shift(const uint index, const uint currentBox,
              const uint intoBox, const uint kind);
@@ -126,6 +129,8 @@ private:
   //of that kind/box
   uint* boxAndKindStart;
   uint boxAndKindStartCount;
+  //index [mol] is the position of that molecule in molLookup
+  std::vector <uint> molPosition;
   uint numKinds;
   std::vector <uint> fixedAtom;
   std::vector <uint> canSwapKind; //Kinds that can move intra and inter box
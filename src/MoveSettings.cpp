@@ -281,3 +281,49 @@ uint MoveSettings::GetTrialTot(const uint box, const uint move) const
 
   return sum;
 }
+
+void MoveSettings::Pack(std::vector<double> & buffer) const
+{
+  buffer.clear();
+  for(uint b = 0; b < BOX_TOTAL; b++) {
+    for(uint m = 0; m < mv::MOVE_KINDS_TOTAL; m++) {
+      for(uint k = 0; k < totKind; k++) {
+        buffer.push_back(scale[b][m][k]);
+        buffer.push_back(acceptPercent[b][m][k]);
+        buffer.push_back(accepted[b][m][k]);
+        buffer.push_back(tries[b][m][k]);
+        buffer.push_back(tempAccepted[b][m][k]);
+        buffer.push_back(tempTries[b][m][k]);
+      }
+    }
+    for(uint t = 0; t < mp::MPTOTALTYPES; t++) {
+      buffer.push_back(mp_accepted[b][t]);
+      buffer.push_back(mp_tries[b][t]);
+    }
+    buffer.push_back(mp_r_max[b]);
+    buffer.push_back(mp_t_max[b]);
+  }
+}
+
+void MoveSettings::Unpack(std::vector<double> const& buffer)
+{
+  uint i = 0;
+  for(uint b = 0; b < BOX_TOTAL; b++) {
+    for(uint m = 0; m < mv::MOVE_KINDS_TOTAL; m++) {
+      for(uint k = 0; k < totKind; k++) {
+        scale[b][m][k] = buffer[i++];
+        acceptPercent[b][m][k] = buffer[i++];
+        accepted[b][m][k] = (uint)buffer[i++];
+        tries[b][m][k] = (uint)buffer[i++];
+        tempAccepted[b][m][k] = (uint)buffer[i++];
+        tempTries[b][m][k] = (uint)buffer[i++];
+      }
+    }
+    for(uint t = 0; t < mp::MPTOTALTYPES; t++) {
+      mp_accepted[b][t] = (uint)buffer[i++];
+      mp_tries[b][t] = (uint)buffer[i++];
+    }
+    mp_r_max[b] = buffer[i++];
+    mp_t_max[b] = buffer[i++];
+  }
+}
@@ -72,6 +72,11 @@ public:
 
   void UpdateMoveSettingMultiParticle(uint box, bool isAccept, uint typePick);
 
+  //Step sizes and their acceptance counters as a flat buffer, so replicas
+  //that exchange temperatures can take the settings along
+  void Pack(std::vector<double> & buffer) const;
+  void Unpack(std::vector<double> const& buffer);
+
   double Scale(const uint box, const uint move, const uint kind = 0) const
   {
     return scale[box][move][kind];
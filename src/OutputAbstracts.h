@@ -61,36 +61,25 @@ public:
             const ulong tillEquil,
             const ulong totSteps)
   {
-    Init(tillEquil, totSteps, output.statistics.settings.uniqueStr.val);
+    Init(tillEquil, totSteps, output.statistics.settings.uniqueStr.val,
+         output.statistics.settings.uniqueStr.replica);
     Init(atoms, output);
   }
 
   void Init(const ulong tillEquil, const ulong totSteps,
-            std::string const& uniqueForFileIO)
+            std::string const& uniqueForFileIO, const bool replica = false)
   {
-#if GOMC_LIB_MPI
-    // For some reason, whether or not split passes by reference or value changes per OS.
-    // Hence the need for a disposable copy of the string
-    std::string copyOfUniqueForFileIO = uniqueForFileIO.c_str();
-#ifdef WIN32
-    std::vector<std::string> tokens = OutputableBase::split(copyOfUniqueForFileIO, std::string(2, OS_SEP));
-#else
-    std::vector<std::string> tokens = OutputableBase::split(copyOfUniqueForFileIO, std::string(1, OS_SEP));
-#endif
-    std::stringstream replicaDirectory;
-    // Loop terminates before last entry to remove the value that
-    // The user gets passes as "OutputName", which we have prefixed w a path
-    // In the ParallelTemperingPreproccessing in Main.cpp.
-    // This leaves only the path, which we store as "pathToReplicaOutputDirectory"
-    for(int i = 0; i < tokens.size() - 1; ++i) {
-      replicaDirectory << tokens[i] << OS_SEP;
+    // Replica runs prefix the output name with the replica directory.
+    // Keep the directory apart, since some outputs prefix the file name
+    // itself, e.g. Blk_. Other runs use the output name as given.
+    std::string::size_type sep = uniqueForFileIO.rfind(OS_SEP);
+    if(!replica || sep == std::string::npos) {
+      pathToReplicaOutputDirectory = "";
+      uniqueName = uniqueForFileIO;
+    } else {
+      pathToReplicaOutputDirectory = uniqueForFileIO.substr(0, sep + 1);
+      uniqueName = uniqueForFileIO.substr(sep + 1);
     }
-    pathToReplicaOutputDirectory = replicaDirectory.str();
-
-    uniqueName = tokens[tokens.size() - 1];
-#else
-    uniqueName = uniqueForFileIO;
-#endif
     stepsTillEquil = tillEquil;
     totSimSteps = totSteps;
     firstPrint = true;
@@ -106,26 +95,9 @@ public:
       forceOutput = false;
   }
 
-#if GOMC_LIB_MPI
-  std::vector<std::string> split(std::string str, std::string sep)
-  {
-    char* cstr = const_cast<char*>(str.c_str());
-    char* current;
-    std::vector<std::string> arr;
-    current = strtok(cstr, sep.c_str());
-    while(current != NULL) {
-      arr.push_back(current);
-      current = strtok(NULL, sep.c_str());
-    }
-    return arr;
-  }
-#endif
-
 //private:
   std::string uniqueName;
-#if GOMC_LIB_MPI
   std::string pathToReplicaOutputDirectory;
-#endif
   ulong stepsPerOut, stepsTillEquil, totSimSteps;
   bool enableOut, firstPrint;
   bool forceOutput;
@@ -0,0 +1,94 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "OutputPipeline.h"
+#include "ConfigSetup.h"
+
+OutputPipeline::OutputPipeline(void) : enable(false), stop(false), depth(0)
+{}
+
+OutputPipeline::~OutputPipeline(void)
+{
+  if (!enable)
+    return;
+  Flush();
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    stop = true;
+  }
+  changed.notify_all();
+  writer.join();
+}
+
+void OutputPipeline::Init(config_setup::AsyncOutput const& async)
+{
+  enable = async.enable;
+  depth = async.depth;
+  if (enable)
+    writer = std::thread(&OutputPipeline::Run, this);
+}
+
+void OutputPipeline::Acquire(OutputJob & job)
+{
+  if (!enable)
+    return;
+  std::unique_lock<std::mutex> guard(lock);
+  while (job.pending)
+    changed.wait(guard);
+}
+
+bool OutputPipeline::Busy(OutputJob & job)
+{
+  if (!enable)
+    return false;
+  std::unique_lock<std::mutex> guard(lock);
+  return job.pending;
+}
+
+void OutputPipeline::Submit(OutputJob & job)
+{
+  if (!enable) {
+    job.Write();
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    while (queue.size() >= depth)
+      changed.wait(guard);
+    job.pending = true;
+    queue.push_back(&job);
+  }
+  changed.notify_all();
+}
+
+void OutputPipeline::Flush(void)
+{
+  if (!enable)
+    return;
+  std::unique_lock<std::mutex> guard(lock);
+  while (!queue.empty())
+    changed.wait(guard);
+}
+
+void OutputPipeline::Run(void)
+{
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    while (queue.empty() && !stop)
+      changed.wait(guard);
+    if (queue.empty())
+      return;
+    //The job stays at the front while it is written, so Flush and a full
+    //queue keep waiting for it
+    OutputJob * job = queue.front();
+    guard.unlock();
+    job->Write();
+    guard.lock();
+    queue.pop_front();
+    job->pending = false;
+    changed.notify_all();
+  }
+}
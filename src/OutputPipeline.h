@@ -0,0 +1,68 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef OUTPUT_PIPELINE_H
+#define OUTPUT_PIPELINE_H
+
+#include "BasicTypes.h" //For uint
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace config_setup
+{
+struct AsyncOutput;
+}
+
+//One piece of output. The writer fills the job's buffers from the live
+//state on the simulation thread, Write formats and stores them.
+class OutputJob
+{
+public:
+  OutputJob() : pending(false) {}
+  virtual ~OutputJob() {}
+  virtual void Write() = 0;
+private:
+  friend class OutputPipeline;
+  bool pending;
+};
+
+//Runs output jobs on a writer thread, in the order they were submitted,
+//so the simulation does not wait for formatting and disk. At most depth
+//jobs wait in the queue, a writer that gets ahead of the disk blocks on
+//Submit. Jobs are reused: Acquire waits until the last write of a job
+//is done before its buffers are refilled. Without AsyncOutput, Submit
+//writes the job right away.
+class OutputPipeline
+{
+public:
+  OutputPipeline(void);
+  ~OutputPipeline(void);
+
+  void Init(config_setup::AsyncOutput const& async);
+  //Blocks until job may be refilled
+  void Acquire(OutputJob & job);
+  //True while job is queued or being written
+  bool Busy(OutputJob & job);
+  //Queues job, blocking while the queue is full
+  void Submit(OutputJob & job);
+  //Blocks until every submitted job is written
+  void Flush(void);
+
+private:
+  void Run(void);
+
+  bool enable, stop;
+  uint depth;
+  //jobs submitted and not yet written, the front one may be in progress
+  std::deque<OutputJob *> queue;
+  std::mutex lock;
+  std::condition_variable changed;
+  std::thread writer;
+};
+
+#endif /*OUTPUT_PIPELINE_H*/
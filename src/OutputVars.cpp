@@ -115,6 +115,10 @@ void OutputVars::CalcAndConvert(ulong step)
   }
 #endif
 
+  if (pressureCalc && (step + 1) % pCalcFreq == 0 && step != 0) {
+    calc.VirialCalc(virialRef);
+  }
+
   for (uint b = 0; b < BOXES_WITH_U_NB; b++) {
     //Account for dimensionality of virial (raw "virial" is actually a
     //multiple of the true virial, based on the dimensions stress is exerted
@@ -123,7 +127,6 @@ void OutputVars::CalcAndConvert(ulong step)
     if (pressureCalc) {
       if((step + 1) % pCalcFreq == 0 || step == 0) {
         if(step != 0) {
-          virialRef[b] = calc.VirialCalc(b);
           *virialTotRef += virialRef[b];
         }
         //calculate surface tension in mN/M
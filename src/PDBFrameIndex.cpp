@@ -0,0 +1,151 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "PDBFrameIndex.h"
+#include "PDBConst.h" //For remark fields
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace
+{
+const char INDEX_MAGIC[8] = {'G', 'O', 'M', 'C', 'P', 'D', 'B', 'I'};
+const uint32_t INDEX_VERSION = 1;
+
+//Number in a fixed width field, 0 if the line is too short
+ulong Field(std::string const& line, ConstField const& field)
+{
+  if(line.size() <= field.START)
+    return 0;
+  return strtoul(line.substr(field.START, field.LENGTH).c_str(), NULL, 10);
+}
+}
+
+void PDBFrameIndex::Build(std::string const& name, const bool useCache)
+{
+  offset.clear();
+  frame.clear();
+  steps.clear();
+
+  struct stat info;
+  if(stat(name.c_str(), &info) != 0) {
+    std::cerr << "Error: Could not open PDB file " << name << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  fileSize = info.st_size;
+  fileTime = info.st_mtime;
+
+  std::string cacheName = name + ".idx";
+  if(useCache && ReadCache(cacheName))
+    return;
+  Scan(name);
+  if(useCache)
+    WriteCache(cacheName);
+}
+
+int64_t PDBFrameIndex::Find(const uint frameNum) const
+{
+  //Frames are numbered from 1 in file order, unless the file was edited
+  if(frameNum >= 1 && frameNum <= frame.size() &&
+      frame[frameNum - 1] == frameNum)
+    return offset[frameNum - 1];
+  for(uint f = 0; f < frame.size(); f++) {
+    if(frame[f] == frameNum)
+      return offset[f];
+  }
+  return -1;
+}
+
+void PDBFrameIndex::Scan(std::string const& name)
+{
+  using namespace pdb_entry::cryst1::field;
+  //Binary, so the offsets count every byte of the line ends
+  std::ifstream file(name.c_str(), std::ios::in | std::ios::binary);
+  if(!file.is_open()) {
+    std::cerr << "Error: Could not open PDB file " << name << std::endl;
+    exit(EXIT_FAILURE);
+  }
+  std::string line;
+  uint64_t pos = 0;
+  while(std::getline(file, line)) {
+    if(line.compare(0, pdb_entry::label::REMARK.size(),
+                    pdb_entry::label::REMARK) == 0) {
+      offset.push_back(pos);
+      frame.push_back(Field(line, frameNum::POS));
+      steps.push_back(Field(line, stepsNum::POS));
+    }
+    pos += line.size() + 1;
+  }
+}
+
+bool PDBFrameIndex::ReadCache(std::string const& cacheName)
+{
+  FILE * cache = fopen(cacheName.c_str(), "rb");
+  if(cache == NULL)
+    return false;
+  char magic[sizeof(INDEX_MAGIC)];
+  uint32_t version = 0;
+  uint64_t size = 0, count = 0;
+  int64_t time = 0;
+  bool good = fread(magic, 1, sizeof(magic), cache) == sizeof(magic) &&
+              memcmp(magic, INDEX_MAGIC, sizeof(magic)) == 0 &&
+              fread(&version, sizeof(version), 1, cache) == 1 &&
+              version == INDEX_VERSION &&
+              fread(&size, sizeof(size), 1, cache) == 1 && size == fileSize &&
+              fread(&time, sizeof(time), 1, cache) == 1 && time == fileTime &&
+              fread(&count, sizeof(count), 1, cache) == 1;
+  if(good) {
+    std::vector<uint64_t> frames(count), frameSteps(count);
+    offset.resize(count);
+    good = count == 0 ||
+           (fread(&offset[0], sizeof(uint64_t), count, cache) == count &&
+            fread(&frames[0], sizeof(uint64_t), count, cache) == count &&
+            fread(&frameSteps[0], sizeof(uint64_t), count, cache) == count);
+    frame.assign(frames.begin(), frames.end());
+    steps.assign(frameSteps.begin(), frameSteps.end());
+  }
+  fclose(cache);
+  if(!good) {
+    offset.clear();
+    frame.clear();
+    steps.clear();
+    return false;
+  }
+  printf("%-40s %-s \n", "Info: Read PDB frame index", cacheName.c_str());
+  return true;
+}
+
+void PDBFrameIndex::WriteCache(std::string const& cacheName) const
+{
+  FILE * cache = fopen(cacheName.c_str(), "wb");
+  if(cache == NULL) {
+    printf("%-40s %-s \n", "Warning: Could not write PDB frame index",
+           cacheName.c_str());
+    return;
+  }
+  uint64_t count = offset.size();
+  std::vector<uint64_t> frames(frame.begin(), frame.end());
+  std::vector<uint64_t> frameSteps(steps.begin(), steps.end());
+  fwrite(INDEX_MAGIC, 1, sizeof(INDEX_MAGIC), cache);
+  fwrite(&INDEX_VERSION, sizeof(INDEX_VERSION), 1, cache);
+  fwrite(&fileSize, sizeof(fileSize), 1, cache);
+  fwrite(&fileTime, sizeof(fileTime), 1, cache);
+  fwrite(&count, sizeof(count), 1, cache);
+  if(count != 0) {
+    fwrite(&offset[0], sizeof(uint64_t), count, cache);
+    fwrite(&frames[0], sizeof(uint64_t), count, cache);
+    fwrite(&frameSteps[0], sizeof(uint64_t), count, cache);
+  }
+  if(fclose(cache) != 0) {
+    printf("%-40s %-s \n", "Warning: Could not write PDB frame index",
+           cacheName.c_str());
+    remove(cacheName.c_str());
+  }
+}
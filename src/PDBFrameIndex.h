@@ -0,0 +1,51 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef PDB_FRAME_INDEX_H
+#define PDB_FRAME_INDEX_H
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include "BasicTypes.h" //For uint, ulong
+
+//Byte offsets of the frames of a multi-frame PDB file, for the trajectory
+//recalculation. A frame starts at its REMARK line, which holds the frame
+//number and the step. The index is built in one pass over the file, so
+//each frame can be read with a seek instead of scanning from the start.
+//With FrameIndexCache the index is kept in <file>.idx and reused while the
+//size and modification time of the PDB file match.
+class PDBFrameIndex
+{
+public:
+  void Build(std::string const& name, const bool useCache);
+  uint Count() const
+  {
+    return offset.size();
+  }
+  //Offset of the remark of frame frameNum, -1 if the file has none
+  int64_t Find(const uint frameNum) const;
+  //Step of each frame, in file order
+  std::vector<ulong> const& Steps() const
+  {
+    return steps;
+  }
+
+private:
+  void Scan(std::string const& name);
+  bool ReadCache(std::string const& cacheName);
+  void WriteCache(std::string const& cacheName) const;
+
+  //size and modification time of the PDB file the index was built from
+  uint64_t fileSize;
+  int64_t fileTime;
+  std::vector<uint64_t> offset;
+  std::vector<uint> frame;
+  std::vector<ulong> steps;
+};
+
+#endif /*PDB_FRAME_INDEX_H*/
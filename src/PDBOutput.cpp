@@ -15,14 +15,21 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "StrStrmLib.h"             //For conversion from uint to string
 #include <iostream>                 //for cout;
 
-PDBOutput::PDBOutput(System  & sys, StaticVals const& statV) :
+PDBOutput::PDBOutput(System  & sys, StaticVals const& statV,
+                     OutputPipeline & pipe) :
   moveSetRef(sys.moveSettings), molLookupRef(sys.molLookupRef),
   coordCurrRef(sys.coordinates), comCurrRef(sys.com),
   pStr(coordCurrRef.Count(), GetDefaultAtomStr()),
-  boxDimRef(sys.boxDimRef), molRef(statV.mol)
+  boxDimRef(sys.boxDimRef), molRef(statV.mol), pipeline(pipe), nextFrame(0)
 {
   for(int i = 0; i < BOX_TOTAL; i++)
     frameNumber[i] = 0;
+  frames[0].out = frames[1].out = this;
+}
+
+void PDBFrame::Write()
+{
+  out->WriteFrame(*this);
 }
 
 std::string PDBOutput::GetDefaultAtomStr()
@@ -40,7 +47,7 @@ void PDBOutput::Init(pdb_setup::Atoms const& atoms,
 {
   std::string bStr = "", aliasStr = "", numStr = "";
   sstrm::Converter toStr;
-  enableOutState = output.state.settings.enable;
+  enableOutState = output.state.settings.enable && output.state.format.pdb;
   enableRestOut = output.restart.settings.enable;
   enableOut = enableOutState | enableRestOut;
   stepsCoordPerOut = output.state.settings.frequency;
@@ -158,32 +165,91 @@ void PDBOutput::FormatAtom
 
 void PDBOutput::DoOutput(const ulong step)
 {
-  if(enableOutState) {
-    std::vector<uint> mBox(molRef.count);
-    SetMolBoxVec(mBox);
+  //NEW_RESTART_CODE
+  bool restart = ((step + 1) % stepsRestPerOut == 0) && enableRestOut;
+  //NEW_RESTART_CODE
+  if (!enableOutState && !restart)
+    return;
+
+  PDBFrame & frame = frames[nextFrame];
+  nextFrame = 1 - nextFrame;
+  pipeline.Acquire(frame);
+  frame.state = enableOutState;
+  frame.restart = restart;
+  Snapshot(frame, step);
+  pipeline.Submit(frame);
+}
+
+void PDBOutput::Snapshot(PDBFrame & frame, const ulong step)
+{
+  frame.step = step;
+  frame.mBox.resize(molRef.count);
+  frame.beta.resize(molRef.count);
+  if (frame.coor.Count() != coordCurrRef.Count())
+    frame.coor.Init(coordCurrRef.Count());
+  SetMolBoxVec(frame.mBox);
+
+  uint pStart = 0, pEnd = 0;
+  for (uint m = 0; m < molRef.count; ++m) {
+    frame.beta[m] = molLookupRef.GetBeta(m);
+    molRef.GetRangeStartStop(pStart, pEnd, m);
+    XYZ ref = comCurrRef.Get(m);
+    for (uint p = pStart; p < pEnd; ++p) {
+      XYZ coor = coordCurrRef.Get(p);
+      boxDimRef.UnwrapPBC(coor, frame.mBox[m], ref);
+      frame.coor.Set(p, coor);
+    }
+  }
+
+  for (uint b = 0; b < BOX_TOTAL; ++b) {
+    frame.axis.Set(b, boxDimRef.axis.Get(b));
+    for (uint i = 0; i < 3; ++i)
+      frame.cosAngle[b][i] = boxDimRef.cosAngle[b][i];
+  }
+
+  if (!frame.restart)
+    return;
+  for (uint b = 0; b < BOX_TOTAL; ++b) {
+    frame.scale[b][0] = moveSetRef.GetScaleTot(b, mv::DISPLACE);
+    frame.scale[b][1] = moveSetRef.GetScaleTot(b, mv::ROTATE);
+    frame.scale[b][2] = 0.0;
+#if ENSEMBLE == GEMC || ENSEMBLE == NPT
+    frame.scale[b][2] = moveSetRef.GetScaleTot(b, mv::VOL_TRANSFER);
+#endif
+    frame.kindMols[b].clear();
+    frame.kindCount[b].resize(molRef.kindsCount);
+    for (uint k = 0; k < molRef.kindsCount; ++k) {
+      frame.kindCount[b][k] = molLookupRef.NumKindInBox(k, b);
+      for (uint kI = 0; kI < frame.kindCount[b][k]; ++kI)
+        frame.kindMols[b].push_back(molLookupRef.GetMolNum(kI, k, b));
+    }
+  }
+}
+
+void PDBOutput::WriteFrame(PDBFrame const& frame)
+{
+  if (frame.state) {
     for (uint b = 0; b < BOX_TOTAL; ++b) {
-      PrintRemark(b, step, outF[b]);
-      PrintCryst1(b, outF[b]);
-      PrintAtoms(b, mBox);
+      PrintRemark(b, frame.step, outF[b]);
+      PrintCryst1(b, frame, outF[b]);
+      PrintAtoms(b, frame);
       PrintEnd(b, outF[b]);
     }
   }
   //NEW_RESTART_CODE
-
-  if (((step + 1) % stepsRestPerOut == 0) && enableRestOut) {
-    DoOutputRebuildRestart(step + 1);
-  }
+  if (frame.restart)
+    DoOutputRebuildRestart(frame);
   //NEW_RESTART_CODE
 }
 
 //NEW_RESTART_CODE
-void PDBOutput::DoOutputRebuildRestart(const uint step)
+void PDBOutput::DoOutputRebuildRestart(PDBFrame const& frame)
 {
   for (uint b = 0; b < BOX_TOTAL; ++b) {
     outRebuildRestart[b].openOverwrite();
-    PrintCrystRest(b, step, outRebuildRestart[b]);
-    PrintCryst1(b, outRebuildRestart[b]);
-    PrintAtomsRebuildRestart(b);
+    PrintCrystRest(b, frame, outRebuildRestart[b]);
+    PrintCryst1(b, frame, outRebuildRestart[b]);
+    PrintAtomsRebuildRestart(b, frame);
     PrintEnd(b, outRebuildRestart[b]);
     outRebuildRestart[b].close();
   }
@@ -202,13 +268,14 @@ void PDBOutput::SetMolBoxVec(std::vector<uint> & mBox)
   }
 }
 
-void PDBOutput::PrintCryst1(const uint b, Writer & out)
+void PDBOutput::PrintCryst1(const uint b, PDBFrame const& frame,
+                            Writer & out)
 {
   using namespace pdb_entry::cryst1::field;
   using namespace pdb_entry;
   sstrm::Converter toStr;
   std::string outStr(pdb_entry::LINE_WIDTH, ' ');
-  XYZ axis = boxDimRef.axis.Get(b);
+  XYZ axis = frame.axis.Get(b);
   //Tag for crystallography -- cell dimensions.
   outStr.replace(label::POS.START, label::POS.LENGTH, label::CRYST1);
   //Add box dimensions
@@ -220,32 +287,30 @@ void PDBOutput::PrintCryst1(const uint b, Writer & out)
   toStr.Replace(outStr, axis.z, z::POS);
   //Add facet angles.
   toStr.Fixed().Align(ang_alpha::ALIGN).Precision(ang_alpha::PRECISION);
-  toStr.Replace(outStr, ConvAng(boxDimRef.cosAngle[b][0]), ang_alpha::POS);
+  toStr.Replace(outStr, ConvAng(frame.cosAngle[b][0]), ang_alpha::POS);
   toStr.Fixed().Align(ang_beta::ALIGN).Precision(ang_beta::PRECISION);
-  toStr.Replace(outStr, ConvAng(boxDimRef.cosAngle[b][1]), ang_beta::POS);
+  toStr.Replace(outStr, ConvAng(frame.cosAngle[b][1]), ang_beta::POS);
   toStr.Fixed().Align(ang_gamma::ALIGN).Precision(ang_gamma::PRECISION);
-  toStr.Replace(outStr, ConvAng(boxDimRef.cosAngle[b][2]), ang_gamma::POS);
+  toStr.Replace(outStr, ConvAng(frame.cosAngle[b][2]), ang_gamma::POS);
   //Add extra text junk.
   outStr.replace(space::POS.START, space::POS.LENGTH, space::DEFAULT);
   outStr.replace(zvalue::POS.START, zvalue::POS.LENGTH, zvalue::DEFAULT);
   //Write cell line
-  out.file << outStr << std::endl;
+  out.file << outStr << '\n';
 }
 
-void PDBOutput::PrintCrystRest(const uint b, const uint step, Writer & out)
+void PDBOutput::PrintCrystRest(const uint b, PDBFrame const& frame,
+                               Writer & out)
 {
   using namespace pdb_entry::cryst1::field;
   using namespace pdb_entry;
   using namespace pdb_entry::remark::field;
-  double displace = moveSetRef.GetScaleTot(b, mv::DISPLACE);
-  double rotate = moveSetRef.GetScaleTot(b, mv::ROTATE);
-  double volume = 0.0;
-#if ENSEMBLE == GEMC || ENSEMBLE == NPT
-  volume = moveSetRef.GetScaleTot(b, mv::VOL_TRANSFER);
-#endif
+  double displace = frame.scale[b][0];
+  double rotate = frame.scale[b][1];
+  double volume = frame.scale[b][2];
+  uint step = frame.step + 1;
   sstrm::Converter toStr;
   std::string outStr(pdb_entry::LINE_WIDTH, ' ');
-  XYZ axis = boxDimRef.axis.Get(b);
   //Tag for remark
   outStr.replace(label::POS.START, label::POS.LENGTH, label::REMARK);
   //Tag GOMC
@@ -261,7 +326,7 @@ void PDBOutput::PrintCrystRest(const uint b, const uint step, Writer & out)
   toStr.Fixed().Align(stepsNum::ALIGN).Precision(stepsNum::PRECISION);
   toStr.Replace(outStr, step, stepsNum::POS);
   //Write cell line
-  out.file << outStr << std::endl;
+  out.file << outStr << '\n';
 }
 
 
@@ -285,7 +350,7 @@ void PDBOutput::InsertAtomInLine(std::string & line, XYZ const& coor,
   toStr.Replace(line, beta, beta::POS);
 }
 
-void PDBOutput::PrintAtoms(const uint b, std::vector<uint> & mBox)
+void PDBOutput::PrintAtoms(const uint b, PDBFrame const& frame)
 {
   using namespace pdb_entry::atom::field;
   using namespace pdb_entry;
@@ -294,48 +359,44 @@ void PDBOutput::PrintAtoms(const uint b, std::vector<uint> & mBox)
   //Loop through all molecules
   for (uint m = 0; m < molRef.count; ++m) {
     //Loop through particles in mol.
-    uint beta = molLookupRef.GetBeta(m);
+    uint beta = frame.beta[m];
     molRef.GetRangeStartStop(pStart, pEnd, m);
-    XYZ ref = comCurrRef.Get(m);
-    inThisBox = (mBox[m] == b);
+    inThisBox = (frame.mBox[m] == b);
     for (uint p = pStart; p < pEnd; ++p) {
       XYZ coor;
-      if (inThisBox) {
-        coor = coordCurrRef.Get(p);
-        boxDimRef.UnwrapPBC(coor, b, ref);
-      }
-      InsertAtomInLine(pStr[p], coor, occupancy::BOX[mBox[m]], beta::FIX[beta]);
-      //Write finished string out.
-      outF[b].file << pStr[p] << std::endl;
+      if (inThisBox)
+        coor = frame.coor.Get(p);
+      InsertAtomInLine(pStr[p], coor, occupancy::BOX[frame.mBox[m]],
+                       beta::FIX[beta]);
+      //Write finished string out, PrintEnd flushes the frame.
+      outF[b].file << pStr[p] << '\n';
     }
   }
 }
 
-void PDBOutput::PrintAtomsRebuildRestart(const uint b)
+void PDBOutput::PrintAtomsRebuildRestart(const uint b, PDBFrame const& frame)
 {
   using namespace pdb_entry::atom::field;
   using namespace pdb_entry;
   char segname = 'A';
-  uint molecule = 0, atom = 0, pStart = 0, pEnd = 0;
+  uint molecule = 0, atom = 0, pStart = 0, pEnd = 0, kI = 0;
   for (uint k = 0; k < molRef.kindsCount; ++k) {
-    uint countByKind = molLookupRef.NumKindInBox(k, b);
+    uint countByKind = frame.kindCount[b][k];
     std::string resName = molRef.kinds[k].name;
-    for (uint kI = 0; kI < countByKind; ++kI) {
-      uint molI = molLookupRef.GetMolNum(kI, k, b);
-      uint beta = molLookupRef.GetBeta(molI);
+    for (uint i = 0; i < countByKind; ++i, ++kI) {
+      uint molI = frame.kindMols[b][kI];
+      uint beta = frame.beta[molI];
       molRef.GetRangeStartStop(pStart, pEnd, molI);
-      XYZ ref = comCurrRef.Get(molI);
       for (uint p = pStart; p < pEnd; ++p) {
         std::string line = GetDefaultAtomStr();
-        XYZ coor = coordCurrRef.Get(p);
-        boxDimRef.UnwrapPBC(coor, b, ref);
+        XYZ coor = frame.coor.Get(p);
         FormatAtom(line, atom, molecule, segname,
                    molRef.kinds[k].atomNames[p - pStart], resName);
 
         //Fill in particle's stock string with new x, y, z, and occupancy
         InsertAtomInLine(line, coor, occupancy::BOX[0], beta::FIX[beta]);
         //Write finished string out.
-        outRebuildRestart[b].file << line << std::endl;
+        outRebuildRestart[b].file << line << '\n';
         ++atom;
       }
       ++molecule;
@@ -371,5 +432,5 @@ void PDBOutput::PrintRemark(const uint b, const uint step, Writer & out)
   toStr.Replace(outStr, step + 1, stepsNum::POS);
 
   //Write cell line
-  out.file << outStr << std::endl;
+  out.file << outStr << '\n';
 }
@@ -19,6 +19,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "Coordinates.h"
 #include "Writer.h"
 #include "PDBSetup.h" //For atoms class
+#include "OutputPipeline.h"
 
 class System;
 namespace config_setup
@@ -27,10 +28,31 @@ struct Output;
 }
 class MoveSettings;
 class MoleculeLookup;
+struct PDBOutput;
+
+//Copy of the state a PDB frame is written from. It is taken on the
+//simulation thread and formatted by the output pipeline.
+struct PDBFrame : OutputJob {
+  PDBFrame() : out(NULL), axis(BOX_TOTAL) {}
+  virtual void Write();
+
+  PDBOutput * out;
+  ulong step;
+  //Which of the trajectory and the restart files the frame goes to
+  bool state, restart;
+  //box and beta of each molecule, unwrapped coordinates of each atom
+  std::vector<uint> mBox, beta;
+  XYZArray coor, axis;
+  double cosAngle[BOX_TOTAL][3];
+  //restart only: displacement, rotation and volume scales, and the
+  //molecules of each box in kind order with their count per kind
+  double scale[BOX_TOTAL][3];
+  std::vector<uint> kindMols[BOX_TOTAL], kindCount[BOX_TOTAL];
+};
 
 struct PDBOutput : OutputableBase {
 public:
-  PDBOutput(System & sys, StaticVals const& statV);
+  PDBOutput(System & sys, StaticVals const& statV, OutputPipeline & pipe);
 
   ~PDBOutput()
   {
@@ -47,20 +69,28 @@ public:
 
   virtual void DoOutput(const ulong step);
 private:
+  friend struct PDBFrame;
+
   std::string GetDefaultAtomStr();
 
   void InitPartVec(pdb_setup::Atoms const& atoms);
 
   void SetMolBoxVec(std::vector<uint> & mBox);
 
-  void PrintCryst1(const uint b, Writer & out);
+  //Copies what the frame needs from the system
+  void Snapshot(PDBFrame & frame, const ulong step);
+
+  //Formats and writes a frame, on the pipeline thread
+  void WriteFrame(PDBFrame const& frame);
+
+  void PrintCryst1(const uint b, PDBFrame const& frame, Writer & out);
 
-  void PrintAtoms(const uint b, std::vector<uint> & mBox);
+  void PrintAtoms(const uint b, PDBFrame const& frame);
 
   //NEW_RESTART_CODE
-  void DoOutputRebuildRestart(const uint step);
-  void PrintAtomsRebuildRestart(const uint b);
-  void PrintCrystRest(const uint b, const uint step, Writer & out);
+  void DoOutputRebuildRestart(PDBFrame const& frame);
+  void PrintAtomsRebuildRestart(const uint b, PDBFrame const& frame);
+  void PrintCrystRest(const uint b, PDBFrame const& frame, Writer & out);
   void PrintRemark(const uint b, const uint step, Writer & out);
   //NEW_RESTART_CODE
 
@@ -71,9 +101,10 @@ private:
   void InsertAtomInLine(std::string & line, XYZ const& coor,
                         std::string const& occ, std::string const& beta);
 
+  //Ends the frame, which is flushed once here
   void PrintEnd(const uint b, Writer & out)
   {
-    out.file << "END" << std::endl;
+    out.file << "END\n" << std::flush;
   }
 
   double ConvAng(const double t)
@@ -87,6 +118,10 @@ private:
   Molecules const& molRef;
   Coordinates & coordCurrRef;
   COM & comCurrRef;
+  OutputPipeline & pipeline;
+  //double buffer, one frame is filled while the other is written
+  PDBFrame frames[2];
+  uint nextFrame;
 
   Writer outF[BOX_TOTAL];
   //NEW_RESTART_CODE
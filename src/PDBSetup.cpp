@@ -28,7 +28,8 @@ namespace pdb_setup
 void Remarks::SetRestart(config_setup::RestartSettings const& r )
 {
   restart = r.enable;
-  recalcTrajectory = r.recalcTrajectory;
+  //With a DCD trajectory the PDB only holds the topology
+  recalcTrajectory = r.recalcTrajectory && !r.recalcFromDCD;
   for(uint b = 0; b < BOX_TOTAL; b++) {
     if(recalcTrajectory)
       reached[b] = false;
@@ -98,7 +99,7 @@ void Cryst1::Read(FixedWidthReader & pdb)
 void Atoms::SetRestart(config_setup::RestartSettings const& r )
 {
   restart = r.enable;
-  recalcTrajectory = r.recalcTrajectory;
+  recalcTrajectory = r.recalcTrajectory && !r.recalcFromDCD;
 }
 
 void Atoms::Assign(std::string const& atomName,
@@ -217,6 +218,15 @@ void PDBSetup::Init(config_setup::RestartSettings const& restart,
     if(frameNum == 1)
       pdb[b].open();
 
+    // Once the frames are indexed, go straight to the remark of the frame
+    if(remarks.recalcTrajectory && frameIndex[b].Count() != 0) {
+      int64_t offset = frameIndex[b].Find(frameNum);
+      if(offset >= 0) {
+        pdb[b].open();
+        pdb[b].FileSeek(offset);
+      }
+    }
+
     while (pdb[b].Read(varName, pdb_entry::label::POS)) {
       //If end of frame, and this is the frame we wanted,
       //end read on this file
@@ -246,21 +256,13 @@ void PDBSetup::Init(config_setup::RestartSettings const& restart,
   }
 }
 
-std::vector<ulong> PDBSetup::GetFrameSteps(std::string const*const name)
+std::vector<ulong> PDBSetup::GetFrameSteps(
+  config_setup::RestartSettings const& restart, std::string const*const name)
 {
-  std::map<std::string, FWReadableBase *>::const_iterator dataKind;
-  remarks.SetBox(mv::BOX0);
-  FixedWidthReader pdb(name[mv::BOX0], pdbAlias[mv::BOX0]);
-  pdb.open();
-  std::string varName;
-  uint count = 0;
-  while (pdb.Read(varName, pdb_entry::label::POS)) {
-    if(varName == pdb_entry::label::REMARK) {
-      dataKind = dataKinds.find(varName);
-      dataKind->second->Read(pdb);
-      remarks.frameSteps.push_back(remarks.step[mv::BOX0]);
-      count++;
-    }
-  }
+  for (uint b = 0; b < BOX_TOTAL; b++)
+    frameIndex[b].Build(name[b], restart.frameIndexCache);
+  printf("%-40s %-u \n", "Info: PDB trajectory frames",
+         frameIndex[mv::BOX0].Count());
+  remarks.frameSteps = frameIndex[mv::BOX0].Steps();
   return remarks.frameSteps;
 }
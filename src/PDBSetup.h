@@ -15,6 +15,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "EnsemblePreprocessor.h" //For BOX_TOTAL, etc.
 #include "PDBConst.h" //For fields positions, etc.
 #include "XYZArray.h" //For box dimensions.
+#include "PDBFrameIndex.h" //For frame offsets of trajectories
 
 namespace config_setup
 {
@@ -112,10 +113,14 @@ struct PDBSetup {
   pdb_setup::Cryst1 cryst;
   pdb_setup::Remarks remarks;
   FixedWidthReader pdb[BOX_TOTAL];
+  //frames of each box file, built by GetFrameSteps
+  PDBFrameIndex frameIndex[BOX_TOTAL];
   PDBSetup(void) : dataKinds(SetReadFunctions()) {}
   void Init(config_setup::RestartSettings const& restart,
             std::string const*const name, uint frameNumber = 1);
-  std::vector<ulong> GetFrameSteps(std::string const*const name);
+  //Indexes the frames of the trajectory, returns the step of each frame
+  std::vector<ulong> GetFrameSteps(config_setup::RestartSettings const& restart,
+                                   std::string const*const name);
 private:
   //Map variable names to functions
   std::map<std::string, FWReadableBase *>  SetReadFunctions(void)
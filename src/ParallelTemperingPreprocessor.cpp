@@ -91,6 +91,32 @@ bool ParallelTemperingPreprocessor::checkIfValidRank()
     return true;
   }
 }
+#endif
+
+ParallelTemperingPreprocessor::ParallelTemperingPreprocessor(const char *fileName) :
+  inputFileStringMPI(fileName), worldSize(1), worldRank(0), stdOut(NULL),
+  stdErr(NULL)
+{
+}
+
+void ParallelTemperingPreprocessor::setupThreadedReplica(int numberOfReplicas,
+    int replica)
+{
+  worldSize = numberOfReplicas;
+  worldRank = replica;
+  threadedReplicas = true;
+
+  std::stringstream replicaTemp;
+  replicaTemp << "temp_" << getTemperature(inputFileStringMPI.c_str(), worldRank);
+#if ENSEMBLE == GCMC
+  replicaTemp << getChemicalPotential(inputFileStringMPI.c_str(), worldRank);
+#endif
+  // Same directory tree as an MPI run, but stdout stays with the process
+  mkdirWrapper(inputFileStringMPI, replicaTemp.str());
+  restart = checkIfRestart(inputFileStringMPI.c_str());
+  restartFromCheckpoint = checkIfRestartFromCheckpoint(inputFileStringMPI.c_str());
+  parallelTemperingEnabled = checkIfParallelTemperingEnabled(inputFileStringMPI.c_str());
+}
 
 
 bool ParallelTemperingPreprocessor::checkIfExpandedEnsemble(const char *fileName)
@@ -159,7 +185,9 @@ void ParallelTemperingPreprocessor::checkIfValid(const char *fileName)
       std::cout << "provide only one temperature or only one chemical potential.\n";
       std::cout << "Number of temperatures provided: " << numberOfTemperatures << "\n";
       std::cout << "Number of chemical potentials provided: " << *it << "\n";
+#if GOMC_LIB_MPI
       MPI_Finalize();
+#endif
       exit(EXIT_FAILURE);
     }
   }
@@ -168,7 +196,9 @@ void ParallelTemperingPreprocessor::checkIfValid(const char *fileName)
     std::cout << "Error: Unequal number of LambdaCoulombs and LambdaVDWs in Free Energy calculation!\n";
     std::cout << "Number of temperatures provided: " << numberOfLambdaCoulombs << "\n";
     std::cout << "Number of temperatures provided: " << numberOfLambdaVDWs << "\n";
+#if GOMC_LIB_MPI
     MPI_Finalize();
+#endif
     exit(EXIT_FAILURE);
   }
 }
@@ -223,7 +253,7 @@ std::string ParallelTemperingPreprocessor::getInputFolderName(const char *fileNa
       continue;
     } else if(line[0] == "InputFolderName") {
       std::stringstream ss;
-      for (int i = 1; i < line.size(); i++) {
+      for (uint i = 1; i < line.size(); i++) {
         if (line[i] == " ") {
           ss << '_';
         } else {
@@ -256,7 +286,7 @@ std::string ParallelTemperingPreprocessor::getOutputFolderName(const char *fileN
       continue;
     } else if(line[0] == "OutputFolderName") {
       std::stringstream ss;
-      for (int i = 1; i < line.size(); i++) {
+      for (uint i = 1; i < line.size(); i++) {
         if (line[i] == " ") {
           ss << '_';
         } else {
@@ -324,7 +354,9 @@ std::string ParallelTemperingPreprocessor::getChemicalPotential(const char *file
         chemPotStream << "_" << resName << "_" << val;
       } else if(line.size() != 3) {
         std::cout << "Error: Chemical potential parameters are not specified!\n";
+#if GOMC_LIB_MPI
         MPI_Finalize();
+#endif
         exit(EXIT_FAILURE);
       } else {
         resName = line[1];
@@ -411,6 +443,7 @@ void ParallelTemperingPreprocessor::setupReplicaDirectoriesAndRedirectSTDOUTToFi
   replicaTemp << "temp_" << temperature;
   std::string replicaDirectory = replicaTemp.str();
   mkdirWrapper(multiSimTitle, replicaDirectory);
+  redirectSTDOUTToFile();
 }
 
 void ParallelTemperingPreprocessor::setupReplicaDirectoriesAndRedirectSTDOUTToFile(std::string multiSimTitle, std::string temperature, std::string chemPot)
@@ -419,6 +452,7 @@ void ParallelTemperingPreprocessor::setupReplicaDirectoriesAndRedirectSTDOUTToFi
   replicaTemp << "temp_" << temperature << chemPot;
   std::string replicaDirectory = replicaTemp.str();
   mkdirWrapper(multiSimTitle, replicaDirectory);
+  redirectSTDOUTToFile();
 }
 
 void ParallelTemperingPreprocessor::mkdirWrapper(std::string multisimDirectoryName, std::string replicaDirectoryName)
@@ -432,7 +466,6 @@ void ParallelTemperingPreprocessor::mkdirWrapper(std::string multisimDirectoryNa
 
   std::stringstream replicaInputStream;
   std::stringstream replicaOutputStream;
-  std::stringstream replicaErrorStream;
 
   replicaInputStream << multiSimInputFolder << OS_SEP
                      << replicaDirectoryName << OS_SEP;
@@ -440,10 +473,6 @@ void ParallelTemperingPreprocessor::mkdirWrapper(std::string multisimDirectoryNa
   replicaOutputStream << multiSimOutputFolder << OS_SEP
                       << replicaDirectoryName << OS_SEP;
 
-  replicaErrorStream << multiSimOutputFolder << OS_SEP
-                     << replicaDirectoryName << OS_SEP;
-
-
   // If InputFolderName not provided, use empty string.
   if(multiSimInputFolder.empty()) {
     replicaInputDirectoryPath = multiSimInputFolder;
@@ -454,15 +483,19 @@ void ParallelTemperingPreprocessor::mkdirWrapper(std::string multisimDirectoryNa
   replicaOutputDirectoryPath = replicaOutputStream.str();
 
   //printf("Creating directory : %s\n", multisimDirectoryName.c_str());
+#ifdef WIN32
+  _mkdir(multiSimOutputFolder.c_str());
+  _mkdir(replicaOutputDirectoryPath.c_str());
+#else
   mkdir(multiSimOutputFolder.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
   mkdir(replicaOutputDirectoryPath.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+#endif
+}
 
-  replicaOutputStream << "ConsoleOut.dat";
-
-  replicaErrorStream  << "ErrorsMessages.dat";
-
-  std::string pathToReplicaLogFile = replicaOutputStream.str();
-  std::string pathToReplicaErrorLogFile = replicaErrorStream.str();
+void ParallelTemperingPreprocessor::redirectSTDOUTToFile()
+{
+  std::string pathToReplicaLogFile = replicaOutputDirectoryPath + "ConsoleOut.dat";
+  std::string pathToReplicaErrorLogFile = replicaOutputDirectoryPath + "ErrorsMessages.dat";
   if(worldRank == 0) {
     std::cout << "Monitor progress of your simulation by navigating to a replica output directory and issuing:\n"
               << "\t$ tail -f \"YourUniqueFileName\".console" << std::endl;
@@ -474,11 +507,11 @@ void ParallelTemperingPreprocessor::mkdirWrapper(std::string multisimDirectoryNa
 
 bool ParallelTemperingPreprocessor::checkString(std::string str1, std::string str2)
 {
-  for(int k = 0; k < str1.length(); k++) {
+  for(uint k = 0; k < str1.length(); k++) {
     str1[k] = toupper(str1[k]);
   }
 
-  for(int j = 0; j < str2.length(); j++) {
+  for(uint j = 0; j < str2.length(); j++) {
     str2[j] = toupper(str2[j]);
   }
 
@@ -487,7 +520,7 @@ bool ParallelTemperingPreprocessor::checkString(std::string str1, std::string st
 
 bool ParallelTemperingPreprocessor::checkBool(std::string str)
 {
-  int k;
+  uint k;
   // capitalize string
   for(k = 0; k < str.length(); k++) {
     str[k] = toupper(str[k]);
@@ -504,10 +537,9 @@ bool ParallelTemperingPreprocessor::checkBool(std::string str)
 MultiSim::MultiSim(ParallelTemperingPreprocessor & pt) :
   worldSize(pt.worldSize), worldRank(pt.worldRank), replicaInputDirectoryPath(pt.replicaInputDirectoryPath),
   replicaOutputDirectoryPath(pt.replicaOutputDirectoryPath), restart(pt.restart),
-  restartFromCheckpoint(pt.restartFromCheckpoint), parallelTemperingEnabled(pt.parallelTemperingEnabled)
+  restartFromCheckpoint(pt.restartFromCheckpoint), parallelTemperingEnabled(pt.parallelTemperingEnabled),
+  threadedReplicas(pt.threadedReplicas)
 {
   std::string filename = replicaOutputDirectoryPath + "ParallelTempering.dat";
   fplog =  fopen(filename.c_str(), "w");
 }
-
-#endif
\ No newline at end of file
@@ -20,6 +20,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #endif
 
 #ifdef WIN32
+#include <direct.h>
 #define OS_SEP '\\'
 #else
 #define OS_SEP '/'
@@ -30,10 +31,14 @@ class ParallelTemperingPreprocessor
 public:
 
 #if GOMC_LIB_MPI
-
   explicit ParallelTemperingPreprocessor( int argc,
                                           char *argv[]);
   bool checkIfValidRank();
+#endif
+  //Replica of a threaded run, all replicas share this process
+  explicit ParallelTemperingPreprocessor(const char *fileName);
+  void setupThreadedReplica(int numberOfReplicas, int replica);
+
   bool checkIfExpandedEnsemble(const char *fileName);
   void checkIfValid(const char *fileName);
   bool checkIfParallelTemperingEnabled(const char *fileName);
@@ -47,6 +52,7 @@ public:
   void setupReplicaDirectoriesAndRedirectSTDOUTToFile(std::string multiSimTitle, std::string temperature);
   void setupReplicaDirectoriesAndRedirectSTDOUTToFile(std::string multiSimTitle, std::string temperature, std::string chemPot);
   void mkdirWrapper(std::string multisimDirectoryName, std::string replicaDirectoryName);
+  void redirectSTDOUTToFile();
   bool checkString(std::string str1, std::string str2);
   bool checkBool(std::string str);
 
@@ -59,13 +65,11 @@ private:
   bool restartFromCheckpoint = false;
   bool restart = false;
   bool parallelTemperingEnabled = false;
+  bool threadedReplicas = false;
   std::string replicaInputDirectoryPath;
   std::string replicaOutputDirectoryPath;
   FILE * stdOut;
   FILE * stdErr;
-
-#endif
-
 };
 
 class MultiSim
@@ -77,6 +81,8 @@ public:
   const std::string replicaOutputDirectoryPath;
   bool restart, restartFromCheckpoint;
   bool parallelTemperingEnabled;
+  //replicas run as thread teams of one process and share stdout
+  bool threadedReplicas;
   FILE * fplog;
 private:
 };
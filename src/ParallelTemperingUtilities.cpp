@@ -52,11 +52,12 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 ********************************************************************************/
 
 #include "ParallelTemperingUtilities.h"
+#include <algorithm>
 
 #if GOMC_LIB_MPI
 
-ParallelTemperingUtilities::ParallelTemperingUtilities(MultiSim const*const& multisim, System & sys, StaticVals const& statV, ulong parallelTempFreq, ulong parallelTemperingAttemptsPerExchange):
-  ms(multisim), fplog(multisim->fplog), sysPotRef(sys.potential), parallelTempFreq(parallelTempFreq), parallelTemperingAttemptsPerExchange(parallelTemperingAttemptsPerExchange), prng(*sys.prngParallelTemp), newMolsPos(sys.boxDimRef, newCOMs, sys.molLookupRef, sys.prng, statV.mol),
+ParallelTemperingUtilities::ParallelTemperingUtilities(MultiSim const*const& multisim, System & sys, StaticVals const& statV, ulong parallelTempFreq, ulong parallelTemperingAttemptsPerExchange, bool swapLabels):
+  ms(multisim), fplog(multisim->fplog), sysPotRef(sys.potential), dirtyMolRef(sys.dirtyMols), rigidPoseRef(sys.rigidPoses), parallelTempFreq(parallelTempFreq), parallelTemperingAttemptsPerExchange(parallelTemperingAttemptsPerExchange), swapLabels(swapLabels), slotRef(sys.temperatureSlot), prng(*sys.prngParallelTemp), newMolsPos(sys.boxDimRef, newCOMs, sys.molLookupRef, sys.prng, statV.mol),
   newCOMs(sys.boxDimRef, newMolsPos, sys.molLookupRef, statV.mol)
 {
 
@@ -75,6 +76,8 @@ ParallelTemperingUtilities::ParallelTemperingUtilities(MultiSim const*const& mul
   global_energies.resize(2, std::vector<double>(ms->worldSize, 0.0));
 #endif
   global_betas.resize(ms->worldSize, 0.0);
+  global_temperatures.resize(ms->worldSize, 0.0);
+  replicaAt.resize(ms->worldSize, 0);
   ind.resize(ms->worldSize, 0);
   pind.resize(ms->worldSize, 0);
   exchangeProbabilities.resize(ms->worldSize, 0.0);
@@ -86,6 +89,7 @@ ParallelTemperingUtilities::ParallelTemperingUtilities(MultiSim const*const& mul
   nattempt.resize(2, 0);
   nmoves.resize(ms->worldSize, std::vector<int>(ms->worldSize, 0));
   global_betas[ms->worldRank] = statV.forcefield.beta;
+  global_temperatures[ms->worldRank] = statV.forcefield.T_in_K;
   cyclic.resize(ms->worldSize, std::vector<int>(ms->worldSize + 1, -1));
   order.resize(ms->worldSize, std::vector<int>(ms->worldSize, -1));
   incycle.resize(ms->worldSize, false);
@@ -93,10 +97,38 @@ ParallelTemperingUtilities::ParallelTemperingUtilities(MultiSim const*const& mul
 
   MPI_Allreduce(MPI_IN_PLACE, &global_betas[0], ms->worldSize, MPI_DOUBLE, MPI_SUM,
                 MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &global_temperatures[0], ms->worldSize, MPI_DOUBLE, MPI_SUM,
+                MPI_COMM_WORLD);
   for (int i = 0; i < ms->worldSize; i++) {
     ind[i] = i;
     allswaps[i] = i;
+    replicaAt[i] = i;
+  }
+  //A restarted run resumes at the temperature slot saved in the checkpoints
+  std::vector<int> slots(ms->worldSize, 0);
+  MPI_Allgather(&slotRef, 1, MPI_INT, &slots[0], 1, MPI_INT, MPI_COMM_WORLD);
+  std::vector<int> at(ms->worldSize, -1);
+  bool moved = false, valid = true;
+  for (int i = 0; i < ms->worldSize; i++) {
+    moved |= (slots[i] != i);
+    if (slots[i] < 0 || slots[i] >= ms->worldSize || at[slots[i]] != -1)
+      valid = false;
+    else
+      at[slots[i]] = i;
   }
+  if (moved && swapLabels && valid) {
+    replicaAt = at;
+    if (slotRef != ms->worldRank)
+      fprintf(fplog, "Replica %d restarts at temperature %.4f\n", ms->worldRank,
+              global_temperatures[slotRef]);
+  } else {
+    if (moved && ms->worldRank == 0)
+      printf("Warning: The checkpoints do not hold a usable temperature "
+             "permutation, every replica restarts at its own temperature!\n");
+    slotRef = ms->worldRank;
+  }
+  if (swapLabels)
+    fprintf(fplog, "Exchanging temperatures, the Repl ex lines list the replica at each temperature.\n");
 }
 
 void ParallelTemperingUtilities::evaluateExchangeCriteria(ulong step)
@@ -112,8 +144,10 @@ void ParallelTemperingUtilities::evaluateExchangeCriteria(ulong step)
   std::memset(&global_energies[1], 0, ms->worldSize * sizeof(double));
 #endif
 
+  //pind starts as the replica at each temperature, which is the identity
+  //unless the labels move
   for (int i = 0; i < ms->worldSize; i++) {
-    pind[i] = ind[i];
+    pind[i] = swapLabels ? replicaAt[i] : ind[i];
   }
 
   //for (int i = 0; i < 2; i++){
@@ -199,7 +233,7 @@ void ParallelTemperingUtilities::evaluateExchangeCriteria(ulong step)
       bPrint = ms->worldRank == i || ms->worldRank == i - 1;
       if (i % 2 == parity) {
 #if ENSEMBLE == NVT
-        uBoltz = exp((global_betas[i] - global_betas[i - 1]) * (global_energies[i] - global_energies[i - 1]));
+        uBoltz = exp((global_betas[i] - global_betas[i - 1]) * (global_energies[pind[i]] - global_energies[pind[i - 1]]));
 #endif
         exchangeProbabilities[i] = std::min(uBoltz, 1.0);
         exchangeResults[i] = (printRecord = prng()) < uBoltz;
@@ -217,7 +251,7 @@ void ParallelTemperingUtilities::evaluateExchangeCriteria(ulong step)
         exchangeProbabilities[i] = 0.0;
       }
     }
-    print_ind(fplog, "ex", ms->worldSize, ind, exchangeResults);
+    print_ind(fplog, "ex", ms->worldSize, swapLabels ? replicaAt : ind, exchangeResults);
     print_prob(fplog, "pr", ms->worldSize, exchangeProbabilities);
     fprintf(fplog, "\n");
     nattempt[parity]++;
@@ -231,6 +265,33 @@ void ParallelTemperingUtilities::evaluateExchangeCriteria(ulong step)
 
 }
 
+double ParallelTemperingUtilities::exchangeLabels(MoveSettings & moveSettings)
+{
+  int oldPos = std::find(replicaAt.begin(), replicaAt.end(), ms->worldRank) - replicaAt.begin();
+  int newPos = std::find(pind.begin(), pind.end(), ms->worldRank) - pind.begin();
+
+  if (oldPos != newPos) {
+    /* The settings belong to the temperature. Ours go to the replica that
+       takes over our old temperature, and we receive the settings of the
+       previous owner of our new one. */
+    std::vector<double> mine, theirs;
+    moveSettings.Pack(mine);
+    theirs.resize(mine.size());
+    MPI_Sendrecv(&mine[0], mine.size(), MPI_DOUBLE, pind[oldPos], 0,
+                 &theirs[0], theirs.size(), MPI_DOUBLE, replicaAt[newPos], 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    moveSettings.Unpack(theirs);
+  }
+  replicaAt = pind;
+  slotRef = newPos;
+  return global_temperatures[newPos];
+}
+
+double ParallelTemperingUtilities::slotTemperature(void) const
+{
+  return global_temperatures[slotRef];
+}
+
 void ParallelTemperingUtilities::prepareToDoExchange(const int replica_id, int* maxswap, bool* bThisReplicaExchanged)
 {
 
@@ -389,6 +450,8 @@ void ParallelTemperingUtilities::conductExchanges(Coordinates & coordCurrRef, CO
         exchangeCOMsNonBlocking(newCOMs, ms, exchangePartner);
 
         swap(coordCurrRef, newMolsPos);
+        dirtyMolRef.MarkAll();
+        rigidPoseRef.InvalidateAll();
         swap(comCurrRef, newCOMs);
       }
     }
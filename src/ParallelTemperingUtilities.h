@@ -68,8 +68,13 @@ class ParallelTemperingUtilities
 public:
 
 #if GOMC_LIB_MPI
-  explicit ParallelTemperingUtilities(MultiSim const*const& multisim, System & sys, StaticVals const& statV, ulong parallelTempFreq, ulong parallelTemperingAttemptsPerExchange);
+  explicit ParallelTemperingUtilities(MultiSim const*const& multisim, System & sys, StaticVals const& statV, ulong parallelTempFreq, ulong parallelTemperingAttemptsPerExchange, bool swapLabels);
   void evaluateExchangeCriteria(ulong step);
+  //Applies the exchange by moving temperatures and move settings between
+  //replicas instead of configurations. Returns the new temperature.
+  double exchangeLabels(MoveSettings & moveSettings);
+  //Temperature of the slot this replica runs at, restored on restart
+  double slotTemperature(void) const;
   void prepareToDoExchange(const int replica_id, int* maxswap, bool* bThisReplicaExchanged);
   void cyclicDecomposition(const std::vector<int> destinations, std::vector< std::vector<int> > & cyclic, std::vector<bool> & incycle, const int nrepl, int * nswap);
   void computeExchangeOrder(std::vector< std::vector<int> > & cyclic, std::vector< std::vector<int> > & order, const int nrepl, const int maxswap);
@@ -99,8 +104,18 @@ private:
   PRNG & prng;
   SystemPotential & sysPotRef;
   SystemPotential sysPotNew;
+#if GOMC_LIB_MPI
+  DirtyMolecules & dirtyMolRef;
+  RigidPoses & rigidPoseRef;
+#endif
   ulong parallelTempFreq, parallelTemperingAttemptsPerExchange;
-  std::vector<double> global_betas;
+  std::vector<double> global_betas, global_temperatures;
+  //with swapLabels, the replica at each temperature
+  bool swapLabels;
+#if GOMC_LIB_MPI
+  int & slotRef;
+#endif
+  std::vector<int> replicaAt;
   std::vector<int> ind, pind;
   std::vector<bool> exchangeResults;
   std::vector<double> exchangeProbabilities;
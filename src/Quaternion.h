@@ -0,0 +1,124 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef QUATERNION_H
+#define QUATERNION_H
+
+#include "BasicTypes.h"
+#include "TransformMatrix.h"
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+#include <math.h>
+
+//Unit quaternion w + xi + yj + zk, the orientation of a rigid molecule.
+//Composing two of them and renormalizing keeps an orientation exact over
+//any number of rotations, a product of rotation matrices slowly drifts away
+//from a rotation.
+class Quaternion
+{
+public:
+  Quaternion() : w(1.0), x(0.0), y(0.0), z(0.0) {}
+  Quaternion(double w, double x, double y, double z) :
+    w(w), x(x), y(y), z(z) {}
+
+  //rotation of theta radians about the unit vector axis
+  static Quaternion FromAxisAngle(double theta, const XYZ& axis);
+
+  //returns a uniformly random rotation if u1/2/3 are uniformly random on
+  //[0,1] (Shoemake, 1992)
+  static Quaternion UniformRandom(double u1, double u2, double u3);
+
+  //rotation of the orthonormal matrix m
+  static Quaternion FromMatrix(const RotationMatrix& m);
+
+  //rotation by rhs followed by this one
+  Quaternion operator*(const Quaternion& rhs) const;
+
+  void Normalize();
+
+  RotationMatrix Matrix() const;
+
+  double w, x, y, z;
+};
+
+inline Quaternion Quaternion::FromAxisAngle(double theta, const XYZ& axis)
+{
+  double sinHalf = sin(0.5 * theta);
+  return Quaternion(cos(0.5 * theta), axis.x * sinHalf, axis.y * sinHalf,
+                    axis.z * sinHalf);
+}
+
+inline Quaternion Quaternion::UniformRandom(double u1, double u2, double u3)
+{
+  double r1 = sqrt(1.0 - u1);
+  double r2 = sqrt(u1);
+  u2 *= 2.0 * M_PI;
+  u3 *= 2.0 * M_PI;
+  return Quaternion(r2 * cos(u3), r1 * sin(u2), r1 * cos(u2), r2 * sin(u3));
+}
+
+inline Quaternion Quaternion::FromMatrix(const RotationMatrix& m)
+{
+  //Shepperd's method, built from the largest of the four components so
+  //the square root is never taken of a small number
+  const double (&a)[3][3] = m.matrix;
+  double trace = a[0][0] + a[1][1] + a[2][2];
+  Quaternion q;
+  if(trace > a[0][0] && trace > a[1][1] && trace > a[2][2]) {
+    double s = 2.0 * sqrt(1.0 + trace);
+    q = Quaternion(0.25 * s, (a[2][1] - a[1][2]) / s,
+                   (a[0][2] - a[2][0]) / s, (a[1][0] - a[0][1]) / s);
+  } else if(a[0][0] > a[1][1] && a[0][0] > a[2][2]) {
+    double s = 2.0 * sqrt(1.0 + a[0][0] - a[1][1] - a[2][2]);
+    q = Quaternion((a[2][1] - a[1][2]) / s, 0.25 * s,
+                   (a[0][1] + a[1][0]) / s, (a[0][2] + a[2][0]) / s);
+  } else if(a[1][1] > a[2][2]) {
+    double s = 2.0 * sqrt(1.0 - a[0][0] + a[1][1] - a[2][2]);
+    q = Quaternion((a[0][2] - a[2][0]) / s, (a[0][1] + a[1][0]) / s,
+                   0.25 * s, (a[1][2] + a[2][1]) / s);
+  } else {
+    double s = 2.0 * sqrt(1.0 - a[0][0] - a[1][1] + a[2][2]);
+    q = Quaternion((a[1][0] - a[0][1]) / s, (a[0][2] + a[2][0]) / s,
+                   (a[1][2] + a[2][1]) / s, 0.25 * s);
+  }
+  q.Normalize();
+  return q;
+}
+
+inline Quaternion Quaternion::operator*(const Quaternion& o) const
+{
+  return Quaternion(w * o.w - x * o.x - y * o.y - z * o.z,
+                    w * o.x + x * o.w + y * o.z - z * o.y,
+                    w * o.y - x * o.z + y * o.w + z * o.x,
+                    w * o.z + x * o.y - y * o.x + z * o.w);
+}
+
+inline void Quaternion::Normalize()
+{
+  double inv = 1.0 / sqrt(w * w + x * x + y * y + z * z);
+  w *= inv;
+  x *= inv;
+  y *= inv;
+  z *= inv;
+}
+
+inline RotationMatrix Quaternion::Matrix() const
+{
+  RotationMatrix m;
+  m.matrix[0][0] = 1.0 - 2.0 * (y * y + z * z);
+  m.matrix[0][1] = 2.0 * (x * y - w * z);
+  m.matrix[0][2] = 2.0 * (x * z + w * y);
+  m.matrix[1][0] = 2.0 * (x * y + w * z);
+  m.matrix[1][1] = 1.0 - 2.0 * (x * x + z * z);
+  m.matrix[1][2] = 2.0 * (y * z - w * x);
+  m.matrix[2][0] = 2.0 * (x * z - w * y);
+  m.matrix[2][1] = 2.0 * (y * z + w * x);
+  m.matrix[2][2] = 1.0 - 2.0 * (x * x + y * y);
+  return m;
+}
+
+#endif /*QUATERNION_H*/
@@ -89,6 +89,13 @@ public:
     file.seekg(0, std::ios::beg);
   }
 
+  //Go to byte offset pos of the file
+  void FileSeek(const std::streamoff pos)
+  {
+    file.clear();
+    file.seekg(pos, std::ios::beg);
+  }
+
   void SkipLine(void)
   {
     file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -0,0 +1,516 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "ReplicaExchange.h"
+#include "EnsemblePreprocessor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+ReplicaExchange::ReplicaExchange(char const*const configFileName,
+                                 const int numThreads) : prng(NULL),
+  fplog(NULL)
+{
+#if ENSEMBLE != NVT
+  std::cout << "Error: Parallel tempering without MPI is only supported in "
+            << "the NVT ensemble!\n";
+  exit(EXIT_FAILURE);
+#endif
+  ParallelTemperingPreprocessor pt(configFileName);
+  pt.checkIfValid(configFileName);
+  numReplicas = pt.getNumberOfReplicas(configFileName);
+  printf("%-40s %-d \n", "Info: Number of replicas", numReplicas);
+
+  //Setup reads the input files, so the replicas are built one at a time
+  multisim.resize(numReplicas, NULL);
+  sims.resize(numReplicas, NULL);
+  for(int r = 0; r < numReplicas; r++) {
+    pt.setupThreadedReplica(numReplicas, r);
+    multisim[r] = new MultiSim(pt);
+    sims[r] = new Simulation(configFileName, multisim[r]);
+  }
+
+  Simulation const& first = *sims[0];
+  startStep = first.startStep;
+  totalSteps = first.totalSteps;
+  equilSteps = first.cpu->equilSteps;
+  exchangeFreq = first.set.config.sys.step.parallelTempFreq;
+  pinning = first.set.config.sys.step.replicaPinning;
+  swapLabels = first.set.config.sys.step.parallelTempSwapLabels;
+  async = first.set.config.sys.step.parallelTempAsync;
+  maxWait = first.set.config.sys.step.parallelTempMaxWait;
+  prng = first.system->prngParallelTemp;
+  fplog = multisim[0]->fplog;
+  for(int r = 1; r < numReplicas; r++) {
+    if(sims[r]->startStep != startStep) {
+      std::cout << "Error: Replica " << r << " restarts from step "
+                << sims[r]->startStep << ", replica 0 from step " << startStep
+                << "!\n";
+      exit(EXIT_FAILURE);
+    }
+  }
+  if(first.set.config.sys.step.parallelTemperingAttemptsPerExchange > 1) {
+    printf("Warning: ParallelTemperingAttemptsPerExchange is only supported "
+           "with MPI, using nearest neighbor exchange!\n");
+  }
+  if(async) {
+    //other replicas exchange with a waiting one while it checkpoints
+    for(int r = 0; r < numReplicas; r++)
+      sims[r]->system->exchangeLock = &asyncMutex;
+    fprintf(fplog, "Using asynchronous nearest neighbor exchange, waiting "
+            "at most %lu ms.\n", maxWait);
+  } else
+    fprintf(fplog, "Using standard nearest neighbor exchange.\n");
+  if(swapLabels) {
+    fprintf(fplog, "Exchanging temperatures, the exchange lines list the "
+            "replicas in temperature order.\n");
+  }
+
+  beta.resize(numReplicas);
+  temperature.resize(numReplicas);
+  replicaAt.resize(numReplicas);
+  for(int r = 0; r < numReplicas; r++) {
+    beta[r] = sims[r]->staticValues->forcefield.beta;
+    temperature[r] = sims[r]->staticValues->forcefield.T_in_K;
+    replicaAt[r] = r;
+  }
+  RestoreLabels();
+  energy.resize(numReplicas, 0.0);
+  swapped.resize(numReplicas, false);
+  waiting.resize(numReplicas, false);
+  released.resize(numReplicas, false);
+  waitTime.resize(numReplicas, 0.0);
+
+  //Split the threads evenly, the first replicas take the remainder
+  numCores = 1;
+#ifdef _OPENMP
+  numCores = omp_get_num_procs();
+#endif
+  if(numThreads < numReplicas) {
+    printf("Warning: Fewer threads (%d) than replicas (%d), replicas will "
+           "share cores!\n", numThreads, numReplicas);
+  }
+  int perReplica = std::max(numThreads / numReplicas, 1);
+  int extra = (numThreads > numReplicas ? numThreads % numReplicas : 0);
+  threads.resize(numReplicas);
+  firstCore.resize(numReplicas);
+  int core = 0;
+  for(int r = 0; r < numReplicas; r++) {
+    threads[r] = perReplica + (r < extra ? 1 : 0);
+    firstCore[r] = core % numCores;
+    core += threads[r];
+  }
+  printf("%-40s %-d \n", "Info: Threads per replica", perReplica);
+
+  exchangeResults.resize(numReplicas, false);
+  exchangeProbabilities.resize(numReplicas, 0.0);
+  probSum.resize(numReplicas, 0.0);
+  nexchange.resize(numReplicas, 0);
+  pairAttempts.resize(numReplicas, 0);
+  nattempt.resize(2, 0);
+}
+
+ReplicaExchange::~ReplicaExchange()
+{
+  for(int r = 0; r < numReplicas; r++) {
+    delete sims[r];
+    fclose(multisim[r]->fplog);
+    delete multisim[r];
+  }
+}
+
+void ReplicaExchange::RunSimulation(void)
+{
+#ifdef _OPENMP
+#if _OPENMP < 201811
+  omp_set_nested(1);
+#endif
+  omp_set_max_active_levels(2);
+#endif
+  if(async) {
+    RunAsync();
+  } else {
+    ulong step = startStep;
+    while(step < totalSteps) {
+      ulong next = NextExchange(step);
+      bool exchange = next < totalSteps;
+      ulong end = (exchange ? next + 1 : totalSteps);
+      RunSegment(step, end, exchange);
+      if(exchange)
+        Exchange(next);
+      step = end;
+    }
+  }
+
+  for(int r = 0; r < numReplicas; r++) {
+    printf("\nReplica %d, %.2f K:\n", r,
+           sims[r]->set.config.sys.T.inKelvin);
+    sims[r]->Finish();
+  }
+  PrintStatistics();
+}
+
+ulong ReplicaExchange::NextExchange(const ulong step) const
+{
+  //same steps as the MPI exchange, step > equilSteps and a multiple of
+  //the frequency
+  ulong s = std::max(step, equilSteps + 1);
+  if(s % exchangeFreq != 0)
+    s += exchangeFreq - s % exchangeFreq;
+  return std::min(s, totalSteps);
+}
+
+void ReplicaExchange::RunSegment(const ulong begin, const ulong end,
+                                 const bool exchange)
+{
+  typedef std::chrono::steady_clock Clock;
+  std::vector<double> busy(numReplicas, 0.0);
+  Clock::time_point start = Clock::now();
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(numReplicas) schedule(static, 1)
+#endif
+  for(int r = 0; r < numReplicas; r++) {
+#ifdef _OPENMP
+    omp_set_num_threads(threads[r]);
+#endif
+    if(pinning)
+      PinThreads(r);
+    Simulation & sim = *sims[r];
+    sim.RunSteps(begin, end);
+    if(exchange) {
+      sim.system->potential = sim.system->calcEnergy.SystemTotal();
+      energy[r] = sim.system->potential.totalEnergy.total;
+    }
+    busy[r] = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  //the replicas that finished early idle at the barrier
+  double wall = std::chrono::duration<double>(Clock::now() - start).count();
+  for(int r = 0; r < numReplicas; r++)
+    waitTime[r] += wall - busy[r];
+}
+
+void ReplicaExchange::Exchange(const ulong step)
+{
+  int parity = step / exchangeFreq % 2;
+  std::vector<int> before(replicaAt);
+  std::fill(swapped.begin(), swapped.end(), false);
+
+  for(int i = 1; i < numReplicas; i++) {
+    if(i % 2 == parity) {
+      int a = replicaAt[i - 1], b = replicaAt[i];
+      double uBoltz = exp((beta[i] - beta[i - 1]) * (energy[b] - energy[a]));
+      exchangeProbabilities[i] = std::min(uBoltz, 1.0);
+      exchangeResults[i] = (*prng)() < uBoltz;
+      probSum[i] += exchangeProbabilities[i];
+      pairAttempts[i]++;
+      if(exchangeResults[i]) {
+        if(swapLabels) {
+          SwapTemperatures(i - 1, i);
+        } else {
+          SwapConfigurations(*sims[i - 1], *sims[i]);
+          swapped[i - 1] = swapped[i] = true;
+        }
+        nexchange[i]++;
+      }
+    } else {
+      exchangeResults[i] = false;
+      exchangeProbabilities[i] = 0.0;
+    }
+  }
+  fprintf(fplog, "Replica exchange at step %lu\n", step);
+  PrintInd("ex", before, exchangeResults);
+  PrintProb("pr", exchangeProbabilities);
+  fprintf(fplog, "\n");
+  nattempt[parity]++;
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(numReplicas) schedule(static, 1)
+#endif
+  for(int r = 0; r < numReplicas; r++) {
+    if(swapped[r]) {
+#ifdef _OPENMP
+      omp_set_num_threads(threads[r]);
+#endif
+      Refresh(*sims[r]);
+    }
+  }
+}
+
+void ReplicaExchange::RunAsync(void)
+{
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(numReplicas) schedule(static, 1)
+#endif
+  for(int r = 0; r < numReplicas; r++) {
+#ifdef _OPENMP
+    omp_set_num_threads(threads[r]);
+#endif
+    Simulation & sim = *sims[r];
+    ulong step = startStep;
+    while(step < totalSteps) {
+      ulong next = NextExchange(step);
+      bool exchange = next < totalSteps;
+      ulong end = (exchange ? next + 1 : totalSteps);
+      if(pinning)
+        PinThreads(r);
+      sim.RunSteps(step, end);
+      if(exchange)
+        AsyncExchange(r, next);
+      step = end;
+    }
+  }
+}
+
+void ReplicaExchange::AsyncExchange(const int replica, const ulong step)
+{
+  typedef std::chrono::steady_clock Clock;
+  Simulation & sim = *sims[replica];
+  sim.system->potential = sim.system->calcEnergy.SystemTotal();
+  bool refresh = false;
+
+  std::unique_lock<std::mutex> lock(asyncMutex);
+  energy[replica] = sim.system->potential.totalEnergy.total;
+  int slot = std::find(replicaAt.begin(), replicaAt.end(), replica) -
+             replicaAt.begin();
+  int ready[2], numReady = 0;
+  if(slot > 0 && waiting[replicaAt[slot - 1]])
+    ready[numReady++] = slot - 1;
+  if(slot < numReplicas - 1 && waiting[replicaAt[slot + 1]])
+    ready[numReady++] = slot + 1;
+
+  if(numReady > 0) {
+    int other = ready[numReady == 1 ? 0 : prng->randIntExc(2)];
+    int lo = std::min(slot, other), hi = std::max(slot, other);
+    int a = replicaAt[lo], b = replicaAt[hi];
+    int partner = replicaAt[other];
+    double uBoltz = exp((beta[hi] - beta[lo]) * (energy[b] - energy[a]));
+    bool accept = (*prng)() < uBoltz;
+    probSum[hi] += std::min(uBoltz, 1.0);
+    pairAttempts[hi]++;
+    if(accept) {
+      //the partner is frozen while it waits, so its state can change here
+      if(swapLabels) {
+        SwapTemperatures(lo, hi);
+      } else {
+        SwapConfigurations(*sims[a], *sims[b]);
+        swapped[partner] = refresh = true;
+      }
+      nexchange[hi]++;
+    }
+    fprintf(fplog, "Repl as %2d %c %2d  step %lu  pr %4.2f\n", a,
+            accept ? 'x' : ' ', b, step, std::min(uBoltz, 1.0));
+    waiting[partner] = false;
+    released[partner] = true;
+    lock.unlock();
+    asyncReady.notify_all();
+  } else {
+    waiting[replica] = true;
+    released[replica] = false;
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + std::chrono::milliseconds(maxWait);
+    while(!released[replica]) {
+      if(asyncReady.wait_until(lock, deadline) == std::cv_status::timeout)
+        break;
+    }
+    waiting[replica] = false;
+    refresh = swapped[replica];
+    swapped[replica] = false;
+    waitTime[replica] +=
+      std::chrono::duration<double>(Clock::now() - start).count();
+    lock.unlock();
+  }
+  if(refresh)
+    Refresh(sim);
+}
+
+void ReplicaExchange::SwapConfigurations(Simulation & a, Simulation & b)
+{
+  //The buffers change owner, no coordinates are copied. The energies are
+  //exact and temperature independent, so they move with the coordinates.
+  System & sysA = *a.system;
+  System & sysB = *b.system;
+  swap(sysA.coordinates, sysB.coordinates);
+  sysA.dirtyMols.MarkAll();
+  sysB.dirtyMols.MarkAll();
+  sysA.rigidPoses.InvalidateAll();
+  sysB.rigidPoses.InvalidateAll();
+  swap(sysA.com, sysB.com);
+  sysA.cellList.Swap(sysB.cellList);
+  std::swap(sysA.potential, sysB.potential);
+}
+
+void ReplicaExchange::SwapTemperatures(const int posA, const int posB)
+{
+  //The configurations and their energies stay, only the temperature and
+  //the step sizes tuned for it move. No O(N) work is needed.
+  Simulation & a = *sims[replicaAt[posA]];
+  Simulation & b = *sims[replicaAt[posB]];
+  std::vector<double> settingsA, settingsB;
+  a.system->moveSettings.Pack(settingsA);
+  b.system->moveSettings.Pack(settingsB);
+  a.system->moveSettings.Unpack(settingsB);
+  b.system->moveSettings.Unpack(settingsA);
+  a.SetTemperature(temperature[posB]);
+  b.SetTemperature(temperature[posA]);
+  a.system->temperatureSlot = posB;
+  b.system->temperatureSlot = posA;
+  std::swap(replicaAt[posA], replicaAt[posB]);
+}
+
+void ReplicaExchange::RestoreLabels(void)
+{
+  //A restarted run resumes each replica at the temperature slot saved in
+  //its checkpoint, the identity unless the labels were exchanged
+  std::vector<int> at(numReplicas, -1);
+  bool moved = false, valid = true;
+  for(int r = 0; r < numReplicas; r++) {
+    int slot = sims[r]->system->temperatureSlot;
+    moved |= (slot != r);
+    if(slot < 0 || slot >= numReplicas || at[slot] != -1)
+      valid = false;
+    else
+      at[slot] = r;
+  }
+  if(!moved)
+    return;
+  if(!swapLabels || !valid) {
+    printf("Warning: The checkpoints do not hold a usable temperature "
+           "permutation, every replica restarts at its own temperature!\n");
+    for(int r = 0; r < numReplicas; r++)
+      sims[r]->system->temperatureSlot = r;
+    return;
+  }
+  replicaAt = at;
+  for(int r = 0; r < numReplicas; r++) {
+    int slot = sims[r]->system->temperatureSlot;
+    if(slot != r) {
+      sims[r]->SetTemperature(temperature[slot]);
+      fprintf(fplog, "Replica %d restarts at temperature %.4f\n", r,
+              temperature[slot]);
+    }
+  }
+}
+
+void ReplicaExchange::Refresh(Simulation & sim)
+{
+  System & sys = *sim.system;
+  sys.calcEnergy.InvalidateMoleculeIntra();
+  if(sim.staticValues->forcefield.ewald) {
+    for(int box = 0; box < BOX_TOTAL; box++) {
+      sys.calcEwald->BoxReciprocalSetup(box, sys.coordinates);
+      sys.potential.boxEnergy[box].recip = sys.calcEwald->BoxReciprocal(box);
+      sys.calcEwald->UpdateRecip(box);
+    }
+  }
+  sys.potential.Total();
+  //forces of the multiparticle move belong to the old configuration
+  sys.moveSettings.SetSingleMoveAccepted();
+}
+
+void ReplicaExchange::PinThreads(const int replica) const
+{
+#if defined(__linux__) && defined(_OPENMP)
+  int first = firstCore[replica];
+  int cores = numCores;
+  #pragma omp parallel
+  {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET((first + omp_get_thread_num()) % cores, &mask);
+    //best effort, the run continues unpinned if this fails
+    sched_setaffinity(0, sizeof(mask), &mask);
+  }
+#endif
+}
+
+void ReplicaExchange::PrintInd(const char* leg, const std::vector<int>& ind,
+                               const std::vector<bool>& bEx) const
+{
+  fprintf(fplog, "Repl %2s %2d", leg, ind[0]);
+  for(int i = 1; i < numReplicas; i++) {
+    fprintf(fplog, " %c %2d", (!bEx.empty() && bEx[i]) ? 'x' : ' ', ind[i]);
+  }
+  fprintf(fplog, "\n");
+}
+
+void ReplicaExchange::PrintProb(const char* leg,
+                                const std::vector<double>& prob) const
+{
+  char buf[8];
+  fprintf(fplog, "Repl %2s ", leg);
+  for(int i = 1; i < numReplicas; i++) {
+    if(prob[i] >= 0) {
+      sprintf(buf, "%4.2f", prob[i]);
+      fprintf(fplog, "  %3s", buf[0] == '1' ? "1.0" : buf + 1);
+    } else {
+      fprintf(fplog, "     ");
+    }
+  }
+  fprintf(fplog, "\n");
+}
+
+void ReplicaExchange::PrintCount(const char* leg,
+                                 const std::vector<int>& count) const
+{
+  fprintf(fplog, "Repl %2s ", leg);
+  for(int i = 1; i < numReplicas; i++) {
+    fprintf(fplog, " %4d", count[i]);
+  }
+  fprintf(fplog, "\n");
+}
+
+void ReplicaExchange::PrintStatistics()
+{
+  std::vector<bool> nullVec;
+  std::vector<int> ind(numReplicas);
+  std::vector<double> average(numReplicas, 0.0);
+  for(int i = 0; i < numReplicas; i++)
+    ind[i] = i;
+
+  fprintf(fplog, "\nReplica exchange statistics\n");
+  if(async) {
+    fprintf(fplog, "Repl  attempts per pair:\n");
+    PrintInd("", ind, nullVec);
+    PrintCount("", pairAttempts);
+  } else {
+    fprintf(fplog, "Repl  %d attempts, %d odd, %d even\n",
+            nattempt[0] + nattempt[1], nattempt[1], nattempt[0]);
+  }
+
+  fprintf(fplog, "Repl  average probabilities:\n");
+  for(int i = 1; i < numReplicas; i++) {
+    if(pairAttempts[i] != 0)
+      average[i] = probSum[i] / pairAttempts[i];
+  }
+  PrintInd("", ind, nullVec);
+  PrintProb("", average);
+
+  fprintf(fplog, "Repl  number of exchanges:\n");
+  PrintInd("", ind, nullVec);
+  PrintCount("", nexchange);
+
+  fprintf(fplog, "Repl  average number of exchanges:\n");
+  for(int i = 1; i < numReplicas; i++) {
+    average[i] = 0.0;
+    if(pairAttempts[i] != 0)
+      average[i] = static_cast<double>(nexchange[i]) / pairAttempts[i];
+  }
+  PrintInd("", ind, nullVec);
+  PrintProb("", average);
+
+  fprintf(fplog, "Repl  wait time of each replica (s):\n");
+  fprintf(fplog, "Repl   ");
+  for(int r = 0; r < numReplicas; r++)
+    fprintf(fplog, " %8.3f", waitTime[r]);
+  fprintf(fplog, "\n\n");
+}
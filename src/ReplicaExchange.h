@@ -0,0 +1,97 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef REPLICA_EXCHANGE_H
+#define REPLICA_EXCHANGE_H
+
+#include "BasicTypes.h"
+#include "Simulation.h"
+#include "ParallelTemperingPreprocessor.h"
+#include "PRNG.h"
+#include <vector>
+#include <cstdio>
+#include <mutex>
+#include <condition_variable>
+
+//Parallel tempering without MPI. All replicas live in this process and
+//each runs on its own team of OpenMP threads. Between exchanges the
+//replicas are independent. At an exchange step neighbor temperatures are
+//swapped with the same criterion as ParallelTemperingUtilities, but the
+//configurations change places by swapping buffers instead of messages.
+//With ParallelTemperingSwapLabels the configurations stay and the
+//temperatures and move settings change places instead.
+//
+//With ParallelTemperingAsync the replicas do not meet at a barrier. Each
+//runs its own steps and, at its exchange steps, attempts an exchange with
+//a temperature neighbor that is waiting at one of its own exchange steps.
+//If none is, it waits up to the configured time and then carries on. The
+//pair is picked by readiness only and accepted with the usual Metropolis
+//criterion, so every attempt is a valid move on the labels of two frozen
+//replicas (the asynchronous scheme of Gallicchio et al., JCTC 2015).
+//Runs are not reproducible, since the pairs follow the wall clock.
+class ReplicaExchange
+{
+public:
+  ReplicaExchange(char const*const configFileName, const int numThreads);
+  ~ReplicaExchange();
+
+  void RunSimulation(void);
+
+private:
+  //First exchange step at or after step, totalSteps if there is none
+  ulong NextExchange(const ulong step) const;
+  //Runs all replicas concurrently over steps [begin, end)
+  void RunSegment(const ulong begin, const ulong end, const bool exchange);
+  void Exchange(const ulong step);
+  //Each replica runs to the end on its own, exchanging when it can
+  void RunAsync(void);
+  void AsyncExchange(const int replica, const ulong step);
+  void SwapConfigurations(Simulation & a, Simulation & b);
+  void SwapTemperatures(const int posA, const int posB);
+  //Puts the replicas back at the temperatures of their checkpoints
+  void RestoreLabels(void);
+  //Rebuilds the coordinate dependent caches after a swap
+  void Refresh(Simulation & sim);
+  void PinThreads(const int replica) const;
+
+  void PrintInd(const char* leg, const std::vector<int>& ind,
+                const std::vector<bool>& bEx) const;
+  void PrintProb(const char* leg, const std::vector<double>& prob) const;
+  void PrintCount(const char* leg, const std::vector<int>& count) const;
+  void PrintStatistics();
+
+  int numReplicas;
+  std::vector<MultiSim *> multisim;
+  std::vector<Simulation *> sims;
+  //thread team size and first core of each replica
+  std::vector<int> threads, firstCore;
+  int numCores;
+  //beta and temperature of each temperature slot, energy of each replica
+  std::vector<double> beta, temperature, energy;
+  std::vector<bool> swapped;
+  //asynchronous exchange, all guarded by asyncMutex
+  bool async;
+  ulong maxWait;
+  std::mutex asyncMutex;
+  std::condition_variable asyncReady;
+  std::vector<bool> waiting, released;
+  //replica at each temperature, the identity unless the labels move
+  std::vector<int> replicaAt;
+  bool swapLabels;
+  PRNG * prng;
+  FILE * fplog;
+  ulong startStep, totalSteps, equilSteps, exchangeFreq;
+  bool pinning;
+
+  //statistics, in the layout of ParallelTemperingUtilities
+  std::vector<bool> exchangeResults;
+  std::vector<double> exchangeProbabilities, probSum;
+  std::vector<int> nexchange, nattempt, pairAttempts;
+  //seconds each replica spent waiting for others
+  std::vector<double> waitTime;
+};
+
+#endif /*REPLICA_EXCHANGE_H*/
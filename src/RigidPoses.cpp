@@ -0,0 +1,155 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "RigidPoses.h"
+#include "BoxDimensions.h"
+#include "COM.h"
+#include "MoleculeLookup.h"
+#include "Molecules.h"
+#include "MoleculeKind.h"
+#include "PRNG.h"
+#include <algorithm>
+#include <cstdio>
+
+//RMS deviation (A) warned about, above the rounding of PDB coordinates
+static const double RIGID_TOLERANCE = 1e-3;
+
+uint RigidPoses::Init(const bool on)
+{
+  orientation.clear();
+  stale.clear();
+  posedKind.assign(molRef.GetKindsCount(), false);
+  frame.assign(molRef.GetKindsCount(), XYZArray());
+  bool anyRigid = false;
+  for(uint b = 0; b < BOX_TOTAL; ++b) {
+    MoleculeLookup::box_iterator current = molLookRef.BoxBegin(b),
+                                 end = molLookRef.BoxEnd(b);
+    for(; current != end; ++current) {
+      const uint k = molRef.GetMolKind(*current);
+      if(!molRef.kinds[k].IsRigid() || posedKind[k])
+        continue;
+      Unwrap(*current, b);
+      double rms = molRef.kinds[k].SetBodyFrame(unwrapped, 0);
+      if(rms > RIGID_TOLERANCE) {
+        printf("Warning: Input geometry of rigid kind %s is off its fixed "
+               "bonds and angles by %.6f A (RMS), it is kept.\n",
+               molRef.kinds[k].name.c_str(), rms);
+      }
+      frame[k] = molRef.kinds[k].BodyFrame();
+      posedKind[k] = anyRigid = true;
+    }
+  }
+  if(!on || !anyRigid) {
+    posedKind.clear();
+    return 0;
+  }
+
+  orientation.resize(molRef.count);
+  stale.assign(molRef.count, true);
+  uint placed = 0;
+  XYZArray pos;
+  std::vector<uint> snapped(molRef.GetKindsCount(), 0);
+  std::vector<double> maxRMS(molRef.GetKindsCount(), 0.0);
+  for(uint b = 0; b < BOX_TOTAL; ++b) {
+    MoleculeLookup::box_iterator current = molLookRef.BoxBegin(b),
+                                 end = molLookRef.BoxEnd(b);
+    for(; current != end; ++current) {
+      const uint m = *current, k = molRef.GetMolKind(m);
+      if(!Posed(k))
+        continue;
+      uint pStart = 0, pLen = 0;
+      molRef.GetRangeStartLength(pStart, pLen, m);
+      //the body frame is centered as the COM is, so the center stays put
+      Place(pos, m, comRef.Get(m), Orientation(m, b), b);
+      double sumSq = 0.0;
+      for(uint p = 0; p < pLen; ++p) {
+        sumSq += boxDimRef.MinImage(pos.Difference(p, coordRef, pStart + p),
+                                    b).LengthSq();
+      }
+      double rms = sqrt(sumSq / pLen);
+      if(rms > RIGID_TOLERANCE) {
+        ++snapped[k];
+        maxRMS[k] = std::max(maxRMS[k], rms);
+      }
+      pos.CopyRange(coordRef, 0, pStart, pLen);
+      ++placed;
+    }
+  }
+  for(uint k = 0; k < molRef.GetKindsCount(); ++k) {
+    if(snapped[k] > 0) {
+      printf("Warning: %u molecules of rigid kind %s were moved onto its "
+             "body frame, by up to %.6f A (RMS).\n", snapped[k],
+             molRef.kinds[k].name.c_str(), maxRMS[k]);
+    }
+  }
+  return placed;
+}
+
+void RigidPoses::RestoreBodyFrames()
+{
+  for(uint k = 0; k < frame.size(); ++k) {
+    if(frame[k].Count() > 0)
+      molRef.kinds[k].SetBodyFrame(frame[k], 0);
+  }
+}
+
+void RigidPoses::Unwrap(const uint m, const uint b)
+{
+  uint pStart = 0, pLen = 0;
+  molRef.GetRangeStartLength(pStart, pLen, m);
+  unwrapped.Uninit();
+  unwrapped.Init(pLen);
+  coordRef.CopyRange(unwrapped, pStart, 0, pLen);
+  boxDimRef.UnwrapPBC(unwrapped, b, comRef.Get(m));
+}
+
+Quaternion const& RigidPoses::Orientation(const uint m, const uint b)
+{
+  if(stale[m]) {
+    Unwrap(m, b);
+    orientation[m] =
+      Quaternion::FromMatrix(molRef.GetKind(m).BodyRotation(unwrapped, 0));
+    stale[m] = false;
+  }
+  return orientation[m];
+}
+
+void RigidPoses::Place(XYZArray & dest, const uint m, XYZ const& com,
+                       Quaternion const& orient, const uint b) const
+{
+  XYZArray const& body = molRef.GetKind(m).BodyFrame();
+  RotationMatrix rot = orient.Matrix();
+  if(dest.Count() != body.Count()) {
+    dest.Uninit();
+    dest.Init(body.Count());
+  }
+  for(uint p = 0; p < body.Count(); ++p)
+    dest.Set(p, com + rot.Apply(body.Get(p)));
+  boxDimRef.WrapPBC(dest, b);
+}
+
+void RigidPoses::TranslateRand(XYZArray & dest, XYZ & newCOM, uint & pStart,
+                               uint & pLen, const uint m, const uint b,
+                               const double max)
+{
+  XYZ shift = prngRef.SymXYZ(max);
+  molRef.GetRangeStartLength(pStart, pLen, m);
+  newCOM = boxDimRef.WrapPBC(comRef.Get(m) + shift, b);
+  Place(dest, m, newCOM, Orientation(m, b), b);
+}
+
+void RigidPoses::RotateRand(XYZArray & dest, Quaternion & newOrient,
+                            uint & pStart, uint & pLen, const uint m,
+                            const uint b, const double max)
+{
+  //Rotate (-max, max) radians about a uniformly random vector
+  double theta = prngRef.Sym(max);
+  newOrient = Quaternion::FromAxisAngle(theta, prngRef.PickOnUnitSphere()) *
+              Orientation(m, b);
+  newOrient.Normalize();
+  molRef.GetRangeStartLength(pStart, pLen, m);
+  Place(dest, m, comRef.Get(m), newOrient, b);
+}
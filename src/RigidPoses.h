@@ -0,0 +1,110 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef RIGID_POSES_H
+#define RIGID_POSES_H
+
+#include "BasicTypes.h"
+#include "EnsemblePreprocessor.h" //For BOX_TOTAL
+#include "XYZArray.h"
+#include "Quaternion.h"
+#include <vector>
+
+class BoxDimensions;
+class COM;
+class MoleculeLookup;
+class Molecules;
+class PRNG;
+
+//Pose of every molecule of a rigid kind: its center, kept in COM, and a
+//unit quaternion taking the kind's body frame to the box. Displacements
+//and rotations of a rigid molecule update the pose and place the body
+//frame from it, so its bond lengths and angles never drift.
+//A move that writes the coordinates some other way invalidates the
+//molecule, which makes its orientation stale; it is fitted again from the
+//coordinates the next time it is asked for. Poses are kept only when
+//CBMC_Rigid is on and the run is not a trajectory recalculation.
+//The body frame of a rigid kind is taken from its first molecule in the
+//input, so the input internal geometry is kept.
+class RigidPoses
+{
+public:
+  RigidPoses(BoxDimensions & box, XYZArray & coordinates, COM & com,
+             MoleculeLookup & molLook, PRNG & prng, Molecules & mol) :
+    boxDimRef(box), coordRef(coordinates), comRef(com),
+    molLookRef(molLook), prngRef(prng), molRef(mol) {}
+
+  //Takes the body frame of every rigid kind from the input. If on, places
+  //every rigid molecule on its body frame at its fitted pose and returns
+  //the number of them. Warns when the input geometry is off the fixed bonds
+  //and angles, or when molecules are moved to fit the body frame.
+  uint Init(const bool on);
+
+  //Gives the rigid kinds their body frames again after the molecules were
+  //built anew, see StaticVals::InitOver
+  void RestoreBodyFrames();
+
+  //True if molecules of kind k move by pose
+  bool Posed(const uint k) const
+  {
+    return !posedKind.empty() && posedKind[k];
+  }
+
+  void Invalidate(const uint m)
+  {
+    if(!stale.empty())
+      stale[m] = true;
+  }
+
+  void InvalidateAll()
+  {
+    stale.assign(stale.size(), true);
+  }
+
+  //Orientation of rigid molecule m in box b
+  Quaternion const& Orientation(const uint m, const uint b);
+
+  void Set(const uint m, Quaternion const& orient)
+  {
+    orientation[m] = orient;
+    stale[m] = false;
+  }
+
+  //Atoms of rigid molecule m at center com and orientation orient
+  void Place(XYZArray & dest, const uint m, XYZ const& com,
+             Quaternion const& orient, const uint b) const;
+
+  //Translate rigid molecule m by a random amount, draws as
+  //Coordinates::TranslateRand does
+  void TranslateRand(XYZArray & dest, XYZ & newCOM, uint & pStart,
+                     uint & pLen, const uint m, const uint b,
+                     const double max);
+
+  //Rotate rigid molecule m by a random amount about its center, draws as
+  //Coordinates::RotateRand does
+  void RotateRand(XYZArray & dest, Quaternion & newOrient, uint & pStart,
+                  uint & pLen, const uint m, const uint b, const double max);
+
+private:
+  //Unwraps the atoms of molecule m in box b into unwrapped
+  void Unwrap(const uint m, const uint b);
+
+  BoxDimensions & boxDimRef;
+  XYZArray & coordRef;
+  COM & comRef;
+  MoleculeLookup & molLookRef;
+  PRNG & prngRef;
+  Molecules & molRef;
+
+  std::vector<Quaternion> orientation;
+  std::vector<bool> stale, posedKind;
+  //body frame of each rigid kind as taken from the input
+  std::vector<XYZArray> frame;
+  //unwrapped atoms of the molecule being fitted
+  XYZArray unwrapped;
+};
+
+#endif /*RIGID_POSES_H*/
@@ -13,42 +13,68 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "ConfigSetup.h"
 #include "FFSetup.h"
 #include "PDBSetup.h"
+#include "DCDSetup.h"
 #include "PRNGSetup.h"
 #include "MolSetup.h"
 #include "GOMC_Config.h"    //For PT
 #include "ParallelTemperingPreprocessor.h"
+#include "Clock.h"          //For startup timing
+#include "SystemImage.h"
 class Setup
 {
 public:
   //Read order follows each item
   ConfigSetup config;  //1
   PDBSetup pdb;        //2
+  DCDSetup dcd;        //2
   FFSetup ff;          //3
   PRNGSetup prng;      //4
-#if GOMC_LIB_MPI
   PRNGSetup prngParallelTemp;      //4
-#endif
   MolSetup mol;        //5
 
   void Init(char const*const configFileName, MultiSim const*const& multisim)
   {
+    Clock timer;
+    timer.SetStart();
     //Read in all config data
     config.Init(configFileName, multisim);
+    timer.Lap("Info: Time to read config file");
     //Read in FF data.
     ff.Init(config.in.files.param.name, config.in.ffKind.isCHARMM);
+    timer.Lap("Info: Time to read parameter file");
     //Read PDB data
     pdb.Init(config.in.restart, config.in.files.pdb.name);
+    timer.Lap("Info: Time to read PDB files");
+    //Open the DCD trajectory to recalculate
+    if(config.in.restart.recalcFromDCD)
+      dcd.Init(config.in.files.dcd.name, pdb.atoms);
     //Initialize PRNG
     prng.Init(config.in.restart, config.in.prng, config.in.files.seed.name);
-#if GOMC_LIB_MPI
-    if(multisim->parallelTemperingEnabled)
+    if(multisim != NULL && multisim->parallelTemperingEnabled)
       prngParallelTemp.Init(config.in.restart, config.in.prngParallelTempering, config.in.files.seed.name);
-#endif
-    //Read molecule data from psf
-    if(mol.Init(config.in.restart, config.in.files.psf.name) != 0) {
-      exit(EXIT_FAILURE);
+    //Read molecule data from psf, or from the image of the same inputs
+    uint64_t imageHash = 0;
+    bool fromImage = false;
+    if(config.in.files.image.name != "") {
+      imageHash = system_image::InputHash(config, pdb.atoms);
+      fromImage = system_image::Read(config.in.files.image.name, imageHash,
+                                     mol.kindMap);
+    }
+    if(fromImage) {
+      mol_setup::PrintMolMapVerbose(mol.kindMap);
+      timer.Lap("Info: Time to read system image");
+      mol.PrintKinds(ff);
+    } else {
+      if(mol.Init(config.in.restart, config.in.files.psf.name) != 0) {
+        exit(EXIT_FAILURE);
+      }
+      timer.Lap("Info: Time to read PSF files");
+      mol.AssignKinds(pdb.atoms, ff);
+      if(config.in.files.image.name != "")
+        system_image::Write(config.in.files.image.name, imageHash,
+                            mol.kindMap);
     }
-    mol.AssignKinds(pdb.atoms, ff);
+    timer.Lap("Info: Time to assign molecule kinds");
 
   }
 };
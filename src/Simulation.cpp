@@ -11,6 +11,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "PSFOutput.h"
 #include <iostream>
 #include <iomanip>
+#include <climits>
 #include "CUDAMemoryManager.cuh"
 
 #define EPSILON 0.001
@@ -23,13 +24,22 @@ Simulation::Simulation(char const*const configFileName, MultiSim const*const& mu
   //as system depends on staticValues, and cpu sometimes depends on both.
   set.Init(configFileName, multisim);
   totalSteps = set.config.sys.step.total;
+  Clock timer;
+  timer.SetStart();
   staticValues = new StaticVals(set);
   system = new System(*staticValues, multisim);
   staticValues->Init(set, *system);
+  timer.Lap("Info: Time to build molecules");
   system->Init(set, startStep);
   //recal Init for static value for initializing ewald since ewald is
   //initialized in system
   staticValues->InitOver(set, *system);
+  timer.Lap("Info: Time to initialize system");
+  //Threaded replicas share the console, only the first one prints it
+  if(ms != NULL && ms->threadedReplicas && ms->worldRank > 0) {
+    set.config.out.console.enable = false;
+    set.config.out.console.frequency = ULONG_MAX;
+  }
   cpu = new CPUSide(*system, *staticValues);
   cpu->Init(set.pdb, set.config.out, set.config.sys.step.equil,
             totalSteps, startStep);
@@ -42,13 +52,20 @@ Simulation::Simulation(char const*const configFileName, MultiSim const*const& mu
             << set.config.out.state.files.psf.name << '\n';
 
   if(totalSteps == 0) {
-    frameSteps = set.pdb.GetFrameSteps(set.config.in.files.pdb.name);
+    if(set.config.in.restart.recalcFromDCD)
+      frameSteps = set.dcd.GetFrameSteps();
+    else
+      frameSteps = set.pdb.GetFrameSteps(set.config.in.restart,
+                                         set.config.in.files.pdb.name);
   }
 #if GOMC_LIB_MPI
   // set.config.sys.step.parallelTemp is a boolean for enabling/disabling parallel tempering
-  PTUtils = set.config.sys.step.parallelTemp ? new ParallelTemperingUtilities(ms, *system, *staticValues, set.config.sys.step.parallelTempFreq, set.config.sys.step.parallelTemperingAttemptsPerExchange) : NULL;
+  PTUtils = set.config.sys.step.parallelTemp ? new ParallelTemperingUtilities(ms, *system, *staticValues, set.config.sys.step.parallelTempFreq, set.config.sys.step.parallelTemperingAttemptsPerExchange, set.config.sys.step.parallelTempSwapLabels) : NULL;
   exchangeResults.resize(ms->worldSize, false);
+  if(PTUtils != NULL && system->temperatureSlot != ms->worldRank)
+    SetTemperature(PTUtils->slotTemperature());
 #endif
+  startEnergy = system->potential.totalEnergy.total;
 }
 
 Simulation::~Simulation()
@@ -63,10 +80,11 @@ Simulation::~Simulation()
 
 void Simulation::RunSimulation(void)
 {
-  double startEnergy = system->potential.totalEnergy.total;
   if(totalSteps == 0) {
     for(int i = 0; i < frameSteps.size(); i++) {
-      if(i == 0) {
+      //The first PDB frame is the one already loaded, the PDB files only
+      //give the topology of a DCD trajectory
+      if(i == 0 && !set.config.in.restart.recalcFromDCD) {
         cpu->Output(frameSteps[0] - 1);
         continue;
       }
@@ -74,7 +92,13 @@ void Simulation::RunSimulation(void)
       cpu->Output(frameSteps[i] - 1);
     }
   }
-  for (ulong step = startStep; step < totalSteps; step++) {
+  RunSteps(startStep, totalSteps);
+  Finish();
+}
+
+void Simulation::RunSteps(ulong begin, ulong end)
+{
+  for (ulong step = begin; step < end; step++) {
     system->moveSettings.AdjustMoves(step);
     system->ChooseAndRunMove(step);
     cpu->Output(step);
@@ -103,27 +127,39 @@ void Simulation::RunSimulation(void)
 
       system->potential = system->calcEnergy.SystemTotal();
       PTUtils->evaluateExchangeCriteria(step);
-      PTUtils->prepareToDoExchange(ms->worldRank, &maxSwap, &bThisReplicaExchanged);
-      PTUtils->conductExchanges(system->coordinates, system->com, ms, maxSwap, bThisReplicaExchanged);
-      system->cellList.GridAll(system->boxDimRef, system->coordinates, system->molLookup);
-      if (staticValues->forcefield.ewald) {
-        for(int box = 0; box < BOX_TOTAL; box++) {
-          system->calcEwald->BoxReciprocalSetup(box, system->coordinates);
-          system->potential.boxEnergy[box].recip = system->calcEwald->BoxReciprocal(box);
-          system->calcEwald->UpdateRecip(box);
+      if (set.config.sys.step.parallelTempSwapLabels) {
+        //the configuration stays, so no energy or cell list changes
+        SetTemperature(PTUtils->exchangeLabels(system->moveSettings));
+      } else {
+        PTUtils->prepareToDoExchange(ms->worldRank, &maxSwap, &bThisReplicaExchanged);
+        PTUtils->conductExchanges(system->coordinates, system->com, ms, maxSwap, bThisReplicaExchanged);
+        system->calcEnergy.InvalidateMoleculeIntra();
+        system->cellList.GridAll(system->boxDimRef, system->coordinates, system->molLookup);
+        if (staticValues->forcefield.ewald) {
+          for(int box = 0; box < BOX_TOTAL; box++) {
+            system->calcEwald->BoxReciprocalSetup(box, system->coordinates);
+            system->potential.boxEnergy[box].recip = system->calcEwald->BoxReciprocal(box);
+            system->calcEwald->UpdateRecip(box);
+          }
         }
+        system->potential = system->calcEnergy.SystemTotal();
       }
-      system->potential = system->calcEnergy.SystemTotal();
-
     }
 
 #endif
 
-#ifndef NDEBUG
+#ifdef NDEBUG
+    if(staticValues->intraCacheCheck && (step + 1) % 1000 == 0)
+#else
     if((step + 1) % 1000 == 0)
-      RecalculateAndCheck();
 #endif
+      RecalculateAndCheck();
   }
+}
+
+void Simulation::Finish(void)
+{
+  cpu->Flush();
   if(!RecalculateAndCheck()) {
     std::cerr << "Warning: Updated energy differs from Recalculated Energy!\n";
   }
@@ -135,6 +171,14 @@ void Simulation::RunSimulation(void)
 #endif
 }
 
+void Simulation::SetTemperature(const double temperature)
+{
+  //moves and output read the temperature through references
+  set.config.sys.T.inKelvin = temperature;
+  staticValues->forcefield.T_in_K = temperature;
+  staticValues->forcefield.beta = 1 / temperature;
+}
+
 bool Simulation::RecalculateAndCheck(void)
 {
   system->calcEwald->UpdateVectorsAndRecipTerms(false);
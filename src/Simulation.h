@@ -23,9 +23,16 @@ public:
   ~Simulation();
 
   void RunSimulation(void);
+  //Runs steps [begin, end) of the move loop
+  void RunSteps(ulong begin, ulong end);
+  //Final energy check and statistics, after the last step
+  void Finish(void);
   bool RecalculateAndCheck(void);
+  //Runs the replica at another temperature, the configuration stays
+  void SetTemperature(const double temperature);
 
 private:
+  friend class ReplicaExchange;
   StaticVals * staticValues;
   System * system;
   CPUSide * cpu;
@@ -34,7 +41,8 @@ private:
   std::vector<ulong> frameSteps;
   uint remarksCount;
   ulong startStep;
-  MultiSim const*const& ms;
+  double startEnergy;
+  MultiSim const*const ms;
 #if GOMC_LIB_MPI
   ParallelTemperingUtilities * PTUtils;
   std::vector<bool> exchangeResults;
@@ -8,6 +8,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "ConfigSetup.h" //For types directly read from config. file
 #include "GeomLib.h"
 #include "Setup.h" //For source of setup data.
+#include "System.h"
 
 using namespace geom;
 
@@ -23,6 +24,8 @@ void StaticVals::Init(Setup & set, System& sys)
 #endif
 #ifndef VARIABLE_PARTICLE_NUMBER
   molLookup.Init(mol, set.pdb.atoms);
+#else
+  reservoirSize = set.config.sys.cbmcTrials.reservoir;
 #endif
   InitMovePercents(set.config.sys.moves);
 #if ENSEMBLE == GEMC || ENSEMBLE == NPT
@@ -36,6 +39,7 @@ void StaticVals::InitOver(Setup & set, System& sys)
 {
   mol.~Molecules();
   mol.Init(set, forcefield, sys);
+  sys.rigidPoses.RestoreBodyFrames();
 }
 
 void StaticVals::InitMovePercents(config_setup::MovePercents const& perc)
@@ -131,9 +135,15 @@ void StaticVals::IsBoxOrthogonal(const double cellAngle[][3])
 StaticVals::StaticVals(Setup & set) : memcVal(set.config.sys.memcVal),
   intraMemcVal(set.config.sys.intraMemcVal),
   cfcmcVal(set.config.sys.cfcmcVal),
-  freeEnVal(set.config.sys.freeEn)
+  freeEnVal(set.config.sys.freeEn),
+  volSurrogate(set.config.sys.volSurrogate),
+  mpSurrogate(set.config.sys.mpSurrogate)
 {
   multiParticleEnabled = set.config.sys.moves.multiParticleEnabled;
+  boxParallel = set.config.sys.boxParallel;
+  recipParallel = set.config.sys.recipParallel;
+  earlyReject = set.config.sys.earlyReject;
+  intraCacheCheck = set.config.sys.intraCacheCheck;
   isOrthogonal = true;
   if(set.config.in.restart.enable) {
     IsBoxOrthogonal(set.pdb.cryst.cellAngle);
@@ -48,6 +48,10 @@ public:
 #endif
   bool isOrthogonal;
   bool multiParticleEnabled;
+  bool boxParallel;
+  bool recipParallel;
+  bool earlyReject;
+  bool intraCacheCheck;
 
   Forcefield forcefield;
   SimEventFrequency simEventFreq;
@@ -58,6 +62,7 @@ public:
   double totalPerc;
   config_setup::MEMCVal  intraMemcVal;
   config_setup::FreeEnergy  freeEnVal;
+  config_setup::Surrogate  volSurrogate, mpSurrogate;
 
   //Only include these variables if they're static for this ensemble...
 #ifndef VARIABLE_VOLUME
@@ -69,6 +74,7 @@ public:
 #ifdef  VARIABLE_PARTICLE_NUMBER
   config_setup::MEMCVal   memcVal;
   config_setup::CFCMCVal  cfcmcVal;
+  uint reservoirSize;
 #endif
 
   bool IsEquil(const uint step)
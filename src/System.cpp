@@ -45,20 +45,21 @@ System::System(StaticVals& statics, MultiSim const*const& multisim) :
 #else
   molLookupRef(statics.molLookup),
 #endif
-  prng(molLookupRef),
-#if GOMC_LIB_MPI
-  ms(multisim),
-#endif
+  moveSettings(boxDimRef),
   coordinates(boxDimRef, com, molLookupRef, prng, statics.mol),
   com(boxDimRef, coordinates, molLookupRef, statics.mol),
-  moveSettings(boxDimRef), cellList(statics.mol, boxDimRef),
-  calcEnergy(statics, *this), checkpointSet(*this, statics)
+  rigidPoses(boxDimRef, coordinates, com, molLookupRef, prng, statics.mol),
+  calcEnergy(statics, *this), cellList(statics.mol, boxDimRef),
+  prng(molLookupRef),
+  ms(multisim),
+  checkpointSet(*this, statics)
 {
   calcEwald = NULL;
-#if GOMC_LIB_MPI
-  if(ms->parallelTemperingEnabled)
+  prngParallelTemp = NULL;
+  if(ms != NULL && ms->parallelTemperingEnabled)
     prngParallelTemp = new PRNG(molLookupRef);
-#endif
+  temperatureSlot = (ms != NULL ? ms->worldRank : 0);
+  exchangeLock = NULL;
 }
 
 System::~System()
@@ -84,20 +85,16 @@ System::~System()
   delete moves[mv::MEMC];
   delete moves[mv::CFCMC];
 #endif
-#if GOMC_LIB_MPI
-  if(ms->parallelTemperingEnabled)
+  if(prngParallelTemp != NULL)
     delete prngParallelTemp;
-#endif
 }
 
 void System::Init(Setup const& set, ulong & startStep)
 {
   prng.Init(set.prng.prngMaker.prng);
   r123wrapper.SetRandomSeed(set.config.in.prng.seed);
-#if GOMC_LIB_MPI
-  if(ms->parallelTemperingEnabled)
+  if(prngParallelTemp != NULL)
     prngParallelTemp->Init(set.prngParallelTemp.prngMaker.prng);
-#endif
 #ifdef VARIABLE_VOLUME
   boxDimensions->Init(set.config.in.restart,
                       set.config.sys.volume, set.pdb.cryst,
@@ -111,6 +108,8 @@ void System::Init(Setup const& set, ulong & startStep)
   //the molecule lookup initialization, in case we're in a constant
   //particle/molecule ensemble, e.g. NVT
   coordinates.InitFromPDB(set.pdb.atoms);
+  dirtyMols.Init(statV.mol.count, set.config.out.checkpoint.enable &&
+                 set.config.out.deltaCheckpoint.enable);
 
   // At this point see if checkpoint is enabled. if so re-initialize
   // coordinates, prng, mollookup, step, boxdim, and movesettings
@@ -122,13 +121,21 @@ void System::Init(Setup const& set, ulong & startStep)
     checkpointSet.SetCoordinates(coordinates);
     checkpointSet.SetMoleculeLookup(molLookupRef);
     checkpointSet.SetMoveSettings(moveSettings);
-#if GOMC_LIB_MPI
-    if(checkpointSet.CheckIfParallelTemperingWasEnabled() && ms->parallelTemperingEnabled)
+    if(checkpointSet.CheckIfParallelTemperingWasEnabled() &&
+        prngParallelTemp != NULL) {
       checkpointSet.SetPRNGVariablesPT(*prngParallelTemp);
-#endif
+      if(checkpointSet.GetTemperatureSlot() >= 0)
+        temperatureSlot = checkpointSet.GetTemperatureSlot();
+    }
   }
 
   com.CalcCOM();
+  //before any energy is taken, rigid molecules sit exactly on their kind,
+  //a recalculation evaluates every frame as it was written
+  uint rigidCount = rigidPoses.Init(set.config.sys.cbmcTrials.rigid &&
+                                    !set.config.in.restart.recalcTrajectory);
+  if(rigidCount > 0)
+    printf("%-40s %-u \n", "Info: Rigid molecules placed", rigidCount);
   // Allocate space for atom forces
   atomForceRef.Init(set.pdb.atoms.beta.size());
   molForceRef.Init(com.Count());
@@ -136,6 +143,8 @@ void System::Init(Setup const& set, ulong & startStep)
   atomForceRecRef.Init(set.pdb.atoms.beta.size());
   molForceRecRef.Init(com.Count());
   cellList.SetCutoff();
+  if(set.config.sys.memcVal.enable || set.config.sys.intraMemcVal.enable)
+    cellList.EnableMolCells();
   cellList.GridAll(boxDimRef, coordinates, molLookupRef);
 
   //check if we have to use cached version of ewlad or not.
@@ -186,7 +195,7 @@ void System::InitMoves(Setup const& set)
   moves[mv::VOL_TRANSFER] = new VolumeTransfer(*this, statV);
 #endif
 #if ENSEMBLE == GEMC || ENSEMBLE == GCMC
-  moves[mv::MOL_TRANSFER] = new MoleculeTransfer(*this, statV);
+  moves[mv::MOL_TRANSFER] = new MoleculeTransfer(*this, statV, set);
   if(set.config.sys.memcVal.MEMC1) {
     moves[mv::MEMC] = new MoleculeExchange1(*this, statV);
   } else if (set.config.sys.memcVal.MEMC2) {
@@ -258,7 +267,10 @@ void System::InitLambda()
 
 void System::RecalculateTrajectory(Setup &set, uint frameNum)
 {
-  set.pdb.Init(set.config.in.restart, set.config.in.files.pdb.name, frameNum);
+  if(set.config.in.restart.recalcFromDCD)
+    set.dcd.ReadFrame(frameNum, set.pdb);
+  else
+    set.pdb.Init(set.config.in.restart, set.config.in.files.pdb.name, frameNum);
   statV.InitOver(set, *this);
 #ifdef VARIABLE_PARTICLE_NUMBER
   molLookup.Init(statV.mol, set.pdb.atoms);
@@ -24,8 +24,11 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "CellList.h"
 #include "Clock.h"
 #include "CheckpointSetup.h"
+#include "DirtyMolecules.h"
+#include "RigidPoses.h"
 #include "../lib/Lambda.h"
 #include "Random123Wrapper.h"
+#include <mutex>
 
 //Initialization variables
 class Setup;
@@ -45,6 +48,10 @@ public:
   void ChooseAndRunMove(const uint step);
 
   // Recalculate Trajectory
+  // Frames are evaluated one at a time on this System. StaticVals::InitOver
+  // rebuilds Molecules from each frame and the outputs hold references to
+  // this System, so frames cannot be given to System copies. The energy
+  // loops of a frame already use all OpenMP threads.
   void RecalculateTrajectory(Setup & set, uint frameNum);
 
   //print move time
@@ -103,6 +110,10 @@ public:
   XYZArray molForceRecRef;
   Lambda lambdaRef;
   COM com;
+  //orientations of the molecules of rigid kinds
+  RigidPoses rigidPoses;
+  //molecules moved since the last checkpoint
+  DirtyMolecules dirtyMols;
 
   CalculateEnergy calcEnergy;
   Ewald *calcEwald;
@@ -110,10 +121,16 @@ public:
   PRNG prng;
   Random123Wrapper r123wrapper;
 
-#if GOMC_LIB_MPI
-  MultiSim const*const& ms;
+  //NULL unless this system is a replica
+  MultiSim const*const ms;
+  //exchange decisions, replicas draw the same stream
   PRNG * prngParallelTemp;
-#endif
+  //temperature this replica runs at, as an index into the replica
+  //temperatures, it only moves when the labels are exchanged
+  int temperatureSlot;
+  //held while other replicas may exchange with this one, so the exchange
+  //generator and slot are checkpointed whole, NULL if they can't
+  std::mutex * exchangeLock;
 
 
   CheckpointSetup checkpointSet;
@@ -0,0 +1,291 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "SystemImage.h"
+#include "ConfigSetup.h"
+#include "PDBSetup.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <vector>
+#ifdef _WIN32
+#include <process.h> //for _getpid
+#else
+#include <unistd.h> //for getpid
+#endif
+
+namespace
+{
+const char MAGIC[8] = {'G', 'O', 'M', 'C', 'S', 'I', 'M', 'G'};
+const uint32_t VERSION = 1;
+//magic, version, input hash, payload size and payload hash
+const size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint32_t) +
+                           3 * sizeof(uint64_t);
+
+//64-bit FNV-1a, continued from hash
+uint64_t Hash(const char * data, const size_t size,
+              uint64_t hash = 14695981039346656037ULL)
+{
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= (unsigned char)data[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+bool HashFile(std::string const& name, uint64_t & hash)
+{
+  MappedFile file;
+  if (!file.Open(name))
+    return false;
+  uint64_t size = file.End() - file.Begin();
+  hash = Hash((const char *)&size, sizeof(size), hash);
+  hash = Hash(file.Begin(), size, hash);
+  return true;
+}
+
+uint64_t HashString(std::string const& str, const uint64_t hash)
+{
+  uint64_t size = str.size();
+  return Hash(str.data(), str.size(),
+              Hash((const char *)&size, sizeof(size), hash));
+}
+
+//Appends to the image
+class ImageWriter
+{
+public:
+  std::vector<char> data;
+  template <typename T>
+  void Put(const T value)
+  {
+    const char * bytes = (const char *)&value;
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+  }
+  void Put(std::string const& str)
+  {
+    Put((uint32_t)str.size());
+    data.insert(data.end(), str.begin(), str.end());
+  }
+};
+
+//Reads the image back, good turns false on reading past its end
+class ImageReader
+{
+public:
+  ImageReader(const char * begin, const char * last) :
+    pos(begin), end(last), good(true) {}
+  template <typename T>
+  T Get()
+  {
+    T value = T();
+    if (good && (size_t)(end - pos) >= sizeof(T)) {
+      memcpy(&value, pos, sizeof(T));
+      pos += sizeof(T);
+    } else {
+      good = false;
+    }
+    return value;
+  }
+  std::string GetString()
+  {
+    uint32_t size = Get<uint32_t>();
+    if (!good || (size_t)(end - pos) < size) {
+      good = false;
+      return "";
+    }
+    std::string str(pos, size);
+    pos += size;
+    return str;
+  }
+  const char * pos;
+  const char * end;
+  bool good;
+};
+}
+
+namespace system_image
+{
+uint64_t InputHash(ConfigSetup const& config, pdb_setup::Atoms const& atoms)
+{
+  config_setup::Input const& in = config.in;
+  uint64_t hash = Hash((const char *)&VERSION, sizeof(VERSION));
+  //A restart reads only the PSF file of box 0
+  uint psfFiles = in.restart.enable ? 1 : BOX_TOTAL;
+  for (uint b = 0; b < psfFiles; b++) {
+    if (!HashFile(in.files.psf.name[b], hash))
+      return 0;
+  }
+  if (!HashFile(in.files.param.name, hash))
+    return 0;
+  char ffKind[3] = {in.ffKind.isCHARMM, in.ffKind.isMARTINI,
+                    in.ffKind.isEXOTIC
+                   };
+  hash = Hash(ffKind, sizeof(ffKind), hash);
+  for (uint k = 0; k < atoms.resKindNames.size(); k++)
+    hash = HashString(atoms.resKindNames[k], hash);
+  return hash;
+}
+
+bool Read(std::string const& name, const uint64_t hash,
+          mol_setup::MolMap & kindMap)
+{
+  using namespace mol_setup;
+  MappedFile file;
+  if (hash == 0 || !file.Open(name))
+    return false;
+  ImageReader image(file.Begin(), file.End());
+  char magic[sizeof(MAGIC)];
+  for (uint i = 0; i < sizeof(MAGIC); i++)
+    magic[i] = image.Get<char>();
+  if (!image.good || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      image.Get<uint32_t>() != VERSION || image.Get<uint64_t>() != hash)
+    return false;
+  uint64_t size = image.Get<uint64_t>();
+  uint64_t payloadHash = image.Get<uint64_t>();
+  if (!image.good || size != (uint64_t)(image.end - image.pos) ||
+      Hash(image.pos, size) != payloadHash) {
+    printf("%-40s %-s \n", "Warning: Damaged system image", name.c_str());
+    return false;
+  }
+
+  kindMap.clear();
+  uint32_t kinds = image.Get<uint32_t>();
+  for (uint32_t k = 0; k < kinds && image.good; k++) {
+    MolKind & kind = kindMap[image.GetString()];
+    kind.kindIndex = image.Get<uint32_t>();
+    kind.firstAtomID = image.Get<uint32_t>();
+    kind.firstMolID = image.Get<uint32_t>();
+    kind.incomplete = image.Get<char>() != 0;
+    uint32_t count = image.Get<uint32_t>();
+    for (uint32_t i = 0; i < count && image.good; i++) {
+      std::string atomName = image.GetString();
+      std::string type = image.GetString();
+      double charge = image.Get<double>();
+      double mass = image.Get<double>();
+      kind.atoms.push_back(Atom(atomName, type, charge, mass));
+      kind.atoms.back().kind = image.Get<uint32_t>();
+    }
+    count = image.Get<uint32_t>();
+    for (uint32_t i = 0; i < count && image.good; i++) {
+      uint32_t a0 = image.Get<uint32_t>();
+      uint32_t a1 = image.Get<uint32_t>();
+      kind.bonds.push_back(Bond(a0, a1));
+      kind.bonds.back().kind = image.Get<uint32_t>();
+    }
+    count = image.Get<uint32_t>();
+    for (uint32_t i = 0; i < count && image.good; i++) {
+      uint32_t a0 = image.Get<uint32_t>();
+      uint32_t a1 = image.Get<uint32_t>();
+      uint32_t a2 = image.Get<uint32_t>();
+      kind.angles.push_back(Angle(a0, a1, a2));
+      kind.angles.back().kind = image.Get<uint32_t>();
+    }
+    count = image.Get<uint32_t>();
+    for (uint32_t i = 0; i < count && image.good; i++) {
+      uint32_t a0 = image.Get<uint32_t>();
+      uint32_t a1 = image.Get<uint32_t>();
+      uint32_t a2 = image.Get<uint32_t>();
+      uint32_t a3 = image.Get<uint32_t>();
+      kind.dihedrals.push_back(Dihedral(a0, a1, a2, a3));
+      kind.dihedrals.back().kind = image.Get<uint32_t>();
+    }
+  }
+  if (!image.good || image.pos != image.end) {
+    kindMap.clear();
+    return false;
+  }
+  printf("%-40s %-s \n", "Info: Read system image", name.c_str());
+  return true;
+}
+
+void Write(std::string const& name, const uint64_t hash,
+           mol_setup::MolMap const& kindMap)
+{
+  using namespace mol_setup;
+  if (hash == 0)
+    return;
+  ImageWriter image;
+  image.Put((uint32_t)kindMap.size());
+  for (MolMap::const_iterator it = kindMap.begin(); it != kindMap.end();
+       ++it) {
+    MolKind const& kind = it->second;
+    image.Put(it->first);
+    image.Put((uint32_t)kind.kindIndex);
+    image.Put((uint32_t)kind.firstAtomID);
+    image.Put((uint32_t)kind.firstMolID);
+    image.Put((char)kind.incomplete);
+    image.Put((uint32_t)kind.atoms.size());
+    for (uint i = 0; i < kind.atoms.size(); i++) {
+      image.Put(kind.atoms[i].name);
+      image.Put(kind.atoms[i].type);
+      image.Put(kind.atoms[i].charge);
+      image.Put(kind.atoms[i].mass);
+      image.Put((uint32_t)kind.atoms[i].kind);
+    }
+    image.Put((uint32_t)kind.bonds.size());
+    for (uint i = 0; i < kind.bonds.size(); i++) {
+      image.Put((uint32_t)kind.bonds[i].a0);
+      image.Put((uint32_t)kind.bonds[i].a1);
+      image.Put((uint32_t)kind.bonds[i].kind);
+    }
+    image.Put((uint32_t)kind.angles.size());
+    for (uint i = 0; i < kind.angles.size(); i++) {
+      image.Put((uint32_t)kind.angles[i].a0);
+      image.Put((uint32_t)kind.angles[i].a1);
+      image.Put((uint32_t)kind.angles[i].a2);
+      image.Put((uint32_t)kind.angles[i].kind);
+    }
+    image.Put((uint32_t)kind.dihedrals.size());
+    for (uint i = 0; i < kind.dihedrals.size(); i++) {
+      image.Put((uint32_t)kind.dihedrals[i].a0);
+      image.Put((uint32_t)kind.dihedrals[i].a1);
+      image.Put((uint32_t)kind.dihedrals[i].a2);
+      image.Put((uint32_t)kind.dihedrals[i].a3);
+      image.Put((uint32_t)kind.dihedrals[i].kind);
+    }
+  }
+
+  ImageWriter header;
+  header.data.insert(header.data.end(), MAGIC, MAGIC + sizeof(MAGIC));
+  header.Put(VERSION);
+  header.Put(hash);
+  header.Put((uint64_t)image.data.size());
+  header.Put(Hash(&image.data[0], image.data.size()));
+
+  //Replace an older image only once the new one is complete, runs that
+  //share the image may read it meanwhile. Each process writes its own
+  //temporary file, so runs that rebuild the image together don't mix
+  std::stringstream tempStrm;
+#ifdef _WIN32
+  tempStrm << name << "." << _getpid() << ".tmp";
+#else
+  tempStrm << name << "." << getpid() << ".tmp";
+#endif
+  std::string tempName = tempStrm.str();
+  FILE * outputFile = fopen(tempName.c_str(), "wb");
+  bool good = outputFile != NULL &&
+              fwrite(&header.data[0], 1, HEADER_SIZE, outputFile) ==
+              HEADER_SIZE &&
+              fwrite(&image.data[0], 1, image.data.size(), outputFile) ==
+              image.data.size();
+  if (outputFile != NULL)
+    good = fclose(outputFile) == 0 && good;
+#ifdef _WIN32
+  //rename does not replace an existing file on Windows
+  if (good)
+    remove(name.c_str());
+#endif
+  if (!good || rename(tempName.c_str(), name.c_str()) != 0) {
+    printf("%-40s %-s \n", "Warning: Could not write system image",
+           name.c_str());
+    remove(tempName.c_str());
+    return;
+  }
+  printf("%-40s %-s \n", "Info: Wrote system image", name.c_str());
+}
+}
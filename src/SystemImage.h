@@ -0,0 +1,36 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef SYSTEM_IMAGE_H
+#define SYSTEM_IMAGE_H
+
+#include <string>
+#include <stdint.h>
+
+#include "MolSetup.h" //For MolMap
+
+class ConfigSetup;
+
+//Binary image of the molecule kinds read from the PSF files, with the
+//force field kinds of their atoms, bonds, angles and dihedrals assigned.
+//A later run of the same system loads it instead of parsing the PSF files
+//and looking up each kind in the parameters. The image carries a hash of
+//the contents of the PSF and parameter files and of the residue kinds of
+//the PDB files, and is only used if the inputs still hash to it.
+namespace system_image
+{
+//Hash of the inputs the molecule kinds are built from, 0 if a file could
+//not be read
+uint64_t InputHash(ConfigSetup const& config,
+                   pdb_setup::Atoms const& atoms);
+//False if the image is missing, damaged or built from other inputs
+bool Read(std::string const& name, const uint64_t hash,
+          mol_setup::MolMap & kindMap);
+void Write(std::string const& name, const uint64_t hash,
+           mol_setup::MolMap const& kindMap);
+}
+
+#endif /*SYSTEM_IMAGE_H*/
@@ -0,0 +1,68 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef THREAD_SPLIT_H
+#define THREAD_SPLIT_H
+
+#include "BasicTypes.h" //for uint
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//Splits the threads between two independent tasks that run at once, in
+//proportion to their measured cost (running time times threads used).
+//The cost is a running average, so the split follows the system as it
+//changes.
+class ThreadSplit
+{
+public:
+  ThreadSplit() : enable(false)
+  {
+    cost[0] = cost[1] = 0.0;
+  }
+
+  void Init(const bool enabled)
+  {
+    enable = enabled;
+  }
+
+  //Fills the thread count of each task. Returns false if the tasks should
+  //run one after the other with all threads.
+  bool Threads(int * threads) const
+  {
+#ifdef _OPENMP
+    int total = omp_get_max_threads();
+    if(!enable || total < 2 || omp_in_parallel())
+      return false;
+
+    int t0 = total / 2;
+    if(cost[0] > 0.0 && cost[1] > 0.0)
+      t0 = (int)(total * cost[0] / (cost[0] + cost[1]) + 0.5);
+    threads[0] = std::min(std::max(t0, 1), total - 1);
+    threads[1] = total - threads[0];
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  //Records the running time (seconds) of a task and its thread count
+  void Record(const uint task, const double time, const int threads)
+  {
+    if(cost[task] == 0.0)
+      cost[task] = time * threads;
+    else
+      cost[task] += AVERAGE_WEIGHT * (time * threads - cost[task]);
+  }
+
+private:
+  static constexpr double AVERAGE_WEIGHT = 0.05;
+  bool enable;
+  double cost[2];
+};
+
+#endif /*THREAD_SPLIT_H*/
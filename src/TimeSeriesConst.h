@@ -0,0 +1,50 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef TIME_SERIES_CONST_H
+#define TIME_SERIES_CONST_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+
+//Layout of the binary time series files. The header is MAGIC, the version,
+//the number of metadata entries and, for each, the length of its key, the
+//key, the length of its value and the value. Then the number of columns
+//and, for each column, the length of its name and the name. The rows follow
+//in chunks: the number of rows in the chunk, then each column in turn as
+//that many float64 values. All numbers are little endian, whatever the
+//host. Version 1 files have no metadata entries.
+namespace time_series
+{
+static const char MAGIC[8] = {'G', 'O', 'M', 'C', 'T', 'S', 'E', 'R'};
+static const uint32_t VERSION = 2;
+
+//Rows buffered before a chunk is written
+static const uint32_t CHUNK_ROWS = 1024;
+
+inline bool LittleEndianHost()
+{
+  const uint16_t one = 1;
+  return *(const unsigned char *)&one == 1;
+}
+
+//Copies the size bytes at from to to, reversing them on big endian hosts.
+//Converts to little endian and back.
+inline void Swap(void * to, const void * from, const size_t size)
+{
+  if (LittleEndianHost()) {
+    memcpy(to, from, size);
+  } else {
+    const char * in = (const char *)from;
+    char * out = (char *)to;
+    for (size_t i = 0; i < size; ++i)
+      out[i] = in[size - 1 - i];
+  }
+}
+}
+
+#endif /*TIME_SERIES_CONST_H*/
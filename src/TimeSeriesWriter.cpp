@@ -0,0 +1,133 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "TimeSeriesWriter.h"
+#include "TimeSeriesConst.h"
+#include <cstdlib>
+
+using namespace time_series;
+
+TimeSeriesWriter::TimeSeriesWriter(void) : outF(NULL), rows(0),
+  header(false)
+{}
+
+TimeSeriesWriter::~TimeSeriesWriter(void)
+{
+  Close();
+}
+
+void TimeSeriesWriter::Open(std::string const& name)
+{
+  fileName = name;
+  outF = fopen(fileName.c_str(), "wb");
+  if (outF == NULL) {
+    fprintf(stderr, "Error opening time series output file %s\n",
+            fileName.c_str());
+    exit(EXIT_FAILURE);
+  }
+  rows = 0;
+  header = false;
+}
+
+void TimeSeriesWriter::Close(void)
+{
+  if (outF == NULL)
+    return;
+  Flush();
+  fclose(outF);
+  outF = NULL;
+}
+
+void TimeSeriesWriter::Flush(void)
+{
+  if (outF == NULL)
+    return;
+  WriteHeader();
+  WriteChunk();
+}
+
+void TimeSeriesWriter::WriteHeader(void)
+{
+  if (header)
+    return;
+  std::vector<char> data(sizeof(MAGIC) + 2 * sizeof(uint32_t));
+  uint32_t value = VERSION;
+  memcpy(&data[0], MAGIC, sizeof(MAGIC));
+  Swap(&data[sizeof(MAGIC)], &value, sizeof(uint32_t));
+  value = metadata.size();
+  Swap(&data[sizeof(MAGIC) + sizeof(uint32_t)], &value, sizeof(uint32_t));
+  for (uint m = 0; m < metadata.size(); ++m) {
+    AddString(data, metadata[m].first);
+    AddString(data, metadata[m].second);
+  }
+  char count[sizeof(uint32_t)];
+  value = columns.size();
+  Swap(count, &value, sizeof(uint32_t));
+  data.insert(data.end(), count, count + sizeof(uint32_t));
+  for (uint c = 0; c < columns.size(); ++c)
+    AddString(data, columns[c]);
+  Write(&data[0], data.size());
+  fflush(outF);
+  buffer.reserve(CHUNK_ROWS * columns.size());
+  header = true;
+}
+
+//Appends the length of str and str
+void TimeSeriesWriter::AddString(std::vector<char> & data,
+                                 std::string const& str)
+{
+  char length[sizeof(uint32_t)];
+  uint32_t value = str.size();
+  Swap(length, &value, sizeof(uint32_t));
+  data.insert(data.end(), length, length + sizeof(uint32_t));
+  data.insert(data.end(), str.begin(), str.end());
+}
+
+void TimeSeriesWriter::EndRow(void)
+{
+  if (outF == NULL)
+    return;
+  if (buffer.size() != (rows + 1) * columns.size()) {
+    fprintf(stderr, "Error: Row of %lu values in time series output file %s "
+            "with %lu columns\n", (ulong)(buffer.size() - rows * columns.size()),
+            fileName.c_str(), (ulong)columns.size());
+    exit(EXIT_FAILURE);
+  }
+  WriteHeader();
+  if (++rows == CHUNK_ROWS)
+    WriteChunk();
+}
+
+void TimeSeriesWriter::WriteChunk(void)
+{
+  if (rows == 0)
+    return;
+  //Stored column by column
+  const uint count = columns.size();
+  std::vector<char> chunk(sizeof(uint32_t) + buffer.size() * sizeof(double));
+  uint32_t value = rows;
+  Swap(&chunk[0], &value, sizeof(uint32_t));
+  char * pos = &chunk[sizeof(uint32_t)];
+  for (uint c = 0; c < count; ++c) {
+    for (uint r = 0; r < rows; ++r) {
+      Swap(pos, &buffer[r * count + c], sizeof(double));
+      pos += sizeof(double);
+    }
+  }
+  Write(&chunk[0], chunk.size());
+  fflush(outF);
+  buffer.clear();
+  rows = 0;
+}
+
+void TimeSeriesWriter::Write(const void * data, const size_t size)
+{
+  if (fwrite(data, 1, size, outF) != size) {
+    fprintf(stderr, "Error writing time series output file %s\n",
+            fileName.c_str());
+    exit(EXIT_FAILURE);
+  }
+}
@@ -0,0 +1,75 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef TIME_SERIES_WRITER_H
+#define TIME_SERIES_WRITER_H
+
+#include "BasicTypes.h" //For uint
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdio>
+
+//Rows of float64 values stored in a binary time series file, laid out as
+//in TimeSeriesConst.h. The columns and metadata are given before the first
+//row, which writes the header. Rows are buffered and written a chunk at a
+//time, the rest on Flush or when the file is closed. Does nothing unless
+//the file is open.
+class TimeSeriesWriter
+{
+public:
+  TimeSeriesWriter(void);
+  ~TimeSeriesWriter(void);
+
+  void AddColumn(std::string const& column)
+  {
+    columns.push_back(column);
+  }
+  //Stores a key and value in the header, e.g. the temperature
+  void AddMetadata(std::string const& key, std::string const& value)
+  {
+    metadata.push_back(std::make_pair(key, value));
+  }
+  //Creates the file, exits if it can't
+  void Open(std::string const& name);
+  void Close(void);
+  bool IsOpen(void) const
+  {
+    return outF != NULL;
+  }
+
+  //Appends value to the current row
+  void Add(const double value)
+  {
+    if (outF != NULL)
+      buffer.push_back(value);
+  }
+  //Ends the current row, which must have a value for each column
+  void EndRow(void);
+  //Writes the header and the buffered rows, so the file is complete up to
+  //the last row
+  void Flush(void);
+
+private:
+  TimeSeriesWriter(TimeSeriesWriter const&);
+  TimeSeriesWriter & operator=(TimeSeriesWriter const&);
+
+  void WriteHeader(void);
+  void WriteChunk(void);
+  void Write(const void * data, const size_t size);
+  void AddString(std::vector<char> & data, std::string const& str);
+
+  FILE * outF;
+  std::string fileName;
+  std::vector<std::string> columns;
+  std::vector<std::pair<std::string, std::string> > metadata;
+  //values of the buffered rows, one row after the other
+  std::vector<double> buffer;
+  uint rows;
+  bool header;
+};
+
+#endif /*TIME_SERIES_WRITER_H*/
@@ -0,0 +1,109 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+//Times MoleculeLookup::ShiftMolBox for one kind split between two boxes.
+//Each shift moves a random molecule into the other box. The "find" column
+//first does the linear search over the box that ShiftMolBox did before
+//molPosition was kept; the "index" column calls ShiftMolBox alone. After
+//each run, the contents of molLookup are checked against the shifts.
+//
+//  GOMC_MolLookupBench [shifts]
+#include "MoleculeLookup.h"
+#include "Molecules.h"
+#include "PDBSetup.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace
+{
+const uint SIZES[] = { 1000, 10000, 100000, 1000000 };
+
+void Setup(Molecules & mols, pdb_setup::Atoms & atoms, const uint count)
+{
+  mols.count = count;
+  mols.kindsCount = 1;
+  mols.kIndex = new uint[count]();
+  atoms.box.resize(count);
+  atoms.startIdxRes.resize(count);
+  atoms.molBeta.assign(count, 0);
+  for (uint m = 0; m < count; ++m) {
+    atoms.box[m] = m % 2;
+    atoms.startIdxRes[m] = m;
+  }
+}
+
+//Returns the time per shift in ns, or a negative value if molLookup does
+//not match the box of every molecule afterwards
+double Run(const uint count, const uint shifts, const bool find)
+{
+  Molecules mols;
+  pdb_setup::Atoms atoms;
+  Setup(mols, atoms, count);
+  MoleculeLookup lookup;
+  lookup.Init(mols, atoms);
+
+  std::vector<uint> box(atoms.box);
+  std::mt19937 gen(count);
+  uint found = 0;
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  for (uint s = 0; s < shifts; ++s) {
+    uint from = gen() % 2;
+    if (lookup.NumKindInBox(0, from) == 0)
+      from = 1 - from;
+    uint mol = lookup.GetMolNum(gen() % lookup.NumKindInBox(0, from), 0,
+                                from);
+    if (find) {
+      MoleculeLookup::box_iterator it = lookup.BoxBegin(from);
+      MoleculeLookup::box_iterator end = lookup.BoxEnd(from);
+      while (it != end && *it != mol)
+        ++it;
+      found += (it != end);
+    }
+    lookup.ShiftMolBox(mol, from, 1 - from, 0);
+    box[mol] = 1 - from;
+  }
+  double elapsed = std::chrono::duration<double, std::nano>(
+                     std::chrono::steady_clock::now() - start).count();
+
+  if (find && found != shifts)
+    return -1.0;
+  uint seen = 0;
+  for (uint b = 0; b < BOX_TOTAL; ++b) {
+    MoleculeLookup::box_iterator end = lookup.BoxEnd(b);
+    for (MoleculeLookup::box_iterator it = lookup.BoxBegin(b); it != end;
+         ++it, ++seen) {
+      if (box[*it] != b)
+        return -1.0;
+    }
+  }
+  return seen == count ? elapsed / shifts : -1.0;
+}
+}
+
+int main(int argc, char * argv[])
+{
+  uint shifts = argc > 1 ? atoi(argv[1]) : 200000;
+  if (shifts == 0) {
+    fprintf(stderr, "Usage: %s [shifts]\n", argv[0]);
+    return 1;
+  }
+  printf("%10s %14s %14s\n", "N", "find (ns)", "index (ns)");
+  for (uint i = 0; i < sizeof(SIZES) / sizeof(SIZES[0]); ++i) {
+    double withFind = Run(SIZES[i], shifts, true);
+    double withIndex = Run(SIZES[i], shifts, false);
+    if (withFind < 0.0 || withIndex < 0.0) {
+      fprintf(stderr, "Error: molLookup does not match the shifts for "
+              "N = %u\n", SIZES[i]);
+      return 1;
+    }
+    printf("%10u %14.1f %14.1f\n", SIZES[i], withFind, withIndex);
+  }
+  return 0;
+}
@@ -0,0 +1,125 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "ConformerReservoir.h"
+#include "TrialMol.h"
+#include "Molecules.h"
+#include "MoleculeKind.h"
+#include "CalculateEnergy.h"
+#include "BoxDimensions.h"
+#include "PRNG.h"
+#include "System.h"
+#include "Setup.h"
+#include "CBMC.h"
+#include <climits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace cbmc
+{
+
+ConformerReservoir::ConformerReservoir(System& sys, Setup const& set,
+                                       Molecules const& mols,
+                                       const uint size)
+  : mols(mols), calc(sys.calcEnergy), boxDim(sys.boxDimRef), size(size)
+{
+  if(size == 0)
+    return;
+
+  uint workers = 1;
+#ifdef _OPENMP
+  workers = omp_get_max_threads();
+#endif
+  //the streams are seeded from the system PRNG, so a run is repeatable
+  //for a given number of threads
+  for(uint w = 0; w < workers; ++w) {
+    streams.push_back(new PRNG(sys.molLookupRef));
+    streams[w]->Init(new MTRand(sys.prng.randInt(UINT_MAX)));
+  }
+
+  conformers.resize(mols.GetKindsCount());
+  builders.resize(mols.GetKindsCount());
+  for(uint k = 0; k < mols.GetKindsCount(); ++k) {
+    //monatomic, diatomic and rigid kinds gain nothing from stored conformers
+    if(mols.kinds[k].NumAtoms() < 3 || mols.kinds[k].IsRigid())
+      continue;
+    //any molecule of the kind can lend its index to the growth
+    for(uint m = 0; m < mols.count; ++m) {
+      if(mols.GetMolKind(m) == k) {
+        conformers[k].molIndex = m;
+        for(uint w = 0; w < workers; ++w) {
+          builders[k].push_back(MakeCBMC(sys, sys.statV.forcefield,
+                                         mols.kinds[k], set, streams[w]));
+        }
+        Fill(k);
+        break;
+      }
+    }
+  }
+}
+
+ConformerReservoir::~ConformerReservoir()
+{
+  for(uint k = 0; k < builders.size(); ++k)
+    for(uint w = 0; w < builders[k].size(); ++w)
+      delete builders[k][w];
+  for(uint w = 0; w < streams.size(); ++w)
+    delete streams[w];
+}
+
+void ConformerReservoir::Fill(const uint kind)
+{
+  MoleculeKind& molKind = mols.kinds[kind];
+  Store& store = conformers[kind];
+  store.coords.resize(size);
+  store.weight.resize(size);
+  store.next = 0;
+
+  const uint molIndex = store.molIndex;
+  const int workers = builders[kind].size();
+  calc.SetIdealGas(true);
+  //conformer i is grown by worker i % workers, whatever the scheduling
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(workers) schedule(static, 1)
+#endif
+  for(int w = 0; w < workers; ++w) {
+    for(uint i = w; i < size; i += workers) {
+      TrialMol trial(molKind, boxDim, 0);
+      builders[kind][w]->BuildNew(trial, molIndex);
+      //an overlapping growth stays in the reservoir, its insertion is
+      //rejected as it would be with a growth done in the move
+      store.weight[i] = trial.HasOverlap() ? 0.0 : trial.GetWeight();
+      //stored unwrapped, so it can be placed in a box of any size
+      store.coords[i] = trial.GetCoords();
+      boxDim.UnwrapPBC(store.coords[i], 0, store.coords[i].Get(0));
+    }
+  }
+  calc.SetIdealGas(false);
+}
+
+double ConformerReservoir::Draw(TrialMol& newMol, const uint kind)
+{
+  Store& store = conformers[kind];
+  if(store.next == size)
+    Fill(kind);
+  newMol.SetCoords(store.coords[store.next], 0);
+  return store.weight[store.next++];
+}
+
+double ConformerReservoir::OldWeight(TrialMol const& oldMol,
+                                     const uint molIndex)
+{
+  MoleculeKind& molKind = mols.kinds[mols.GetMolKind(molIndex)];
+  TrialMol trial(molKind, boxDim, oldMol.GetBox());
+  trial.SetCoords(oldMol.GetCoords(), 0);
+  calc.SetIdealGas(true);
+  molKind.BuildOld(trial, molIndex);
+  calc.SetIdealGas(false);
+  return trial.GetWeight();
+}
+
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef CONFORMERRESERVOIR_H
+#define CONFORMERRESERVOIR_H
+#include "BasicTypes.h"
+#include "XYZArray.h"
+#include <vector>
+
+class Molecules;
+class CalculateEnergy;
+class BoxDimensions;
+class PRNG;
+class Setup;
+class System;
+
+namespace cbmc
+{
+class TrialMol;
+class CBMC;
+
+//Stores, for every flexible kind, internal conformations grown with CBMC
+//with intermolecular interactions switched off, together with the
+//intramolecular Rosenbluth weight of each growth.
+//A swap can then insert a stored conformer with rigid-body CBMC only. The
+//stored weight enters the insertion ratio, and the weight of an ideal gas
+//old growth of the removed molecule enters the deletion ratio, so the move
+//is a full CBMC swap whose intramolecular part was grown ahead of time.
+//Each conformer is used once. When a kind runs out, the next batch is
+//grown on all OpenMP threads, each with its own builder and PRNG stream.
+class ConformerReservoir
+{
+public:
+  ConformerReservoir(System& sys, Setup const& set, Molecules const& mols,
+                     const uint size);
+  ~ConformerReservoir();
+
+  bool Enabled(const uint kind) const
+  {
+    return kind < conformers.size() && !builders[kind].empty();
+  }
+
+  //Copy the next unused conformer of kind into newMol, returns its
+  //intramolecular Rosenbluth weight
+  double Draw(TrialMol& newMol, const uint kind);
+
+  //Intramolecular Rosenbluth weight of the conformation of oldMol
+  double OldWeight(TrialMol const& oldMol, const uint molIndex);
+
+private:
+  struct Store {
+    std::vector<XYZArray> coords;
+    std::vector<double> weight;
+    //next unused conformer and a molecule of the kind to grow with
+    uint next, molIndex;
+  };
+
+  void Fill(const uint kind);
+
+  Molecules const& mols;
+  CalculateEnergy& calc;
+  BoxDimensions const& boxDim;
+  const uint size;
+  std::vector<Store> conformers;
+  //builders[kind][worker] and streams[worker]
+  std::vector< std::vector<CBMC *> > builders;
+  std::vector<PRNG *> streams;
+};
+}
+
+#endif /*CONFORMERRESERVOIR_H*/
@@ -21,8 +21,9 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 namespace cbmc
 {
 DCCyclic::DCCyclic(System& sys, const Forcefield& ff,
-                   const MoleculeKind& kind, const Setup& set)
-  : data(sys, ff, set)
+                   const MoleculeKind& kind, const Setup& set,
+                   PRNG* prng)
+  : data(sys, ff, set, prng)
 {
   using namespace mol_setup;
   MolMap::const_iterator it = set.mol.kindMap.find(kind.name);
@@ -30,7 +30,8 @@ class DCCyclic : public CBMC
 {
 public:
   DCCyclic(System& sys, const Forcefield& ff,
-           const MoleculeKind& kind, const Setup& set);
+           const MoleculeKind& kind, const Setup& set,
+           PRNG* prng = NULL);
 
   void Build(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
   void Regrowth(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
@@ -11,6 +11,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "Setup.h"
 #include "System.h"
 #include "CBMC.h"
+#include "TrialLibrary.h"
 #include <vector>
 #include <algorithm>
 
@@ -24,8 +25,9 @@ namespace cbmc
 class DCData
 {
 public:
+  //stream replaces the system PRNG, for builders used off the main thread
   explicit  DCData(System& sys, const Forcefield& forcefield,
-                   const Setup& set);
+                   const Setup& set, PRNG* stream = NULL);
   ~DCData();
 
   const CalculateEnergy& calc;
@@ -64,17 +66,23 @@ public:
   bool* overlapT;     //For detecting overlap for each LJ trial. Used in DCRotateCOM
 
   XYZArray multiPositions[MAX_BONDS];
+
+  //precomputed trial orientations and bend/torsion distributions
+  TrialLibrary library;
 };
 
-inline DCData::DCData(System& sys, const Forcefield& forcefield, const Setup& set):
+inline DCData::DCData(System& sys, const Forcefield& forcefield, const Setup& set,
+                      PRNG* stream):
 
   calc(sys.calcEnergy), ff(forcefield),
-  prng(sys.prng), axes(sys.boxDimRef),
+  prng(stream != NULL ? *stream : sys.prng), axes(sys.boxDimRef),
   nAngleTrials(set.config.sys.cbmcTrials.bonded.ang),
   nDihTrials(set.config.sys.cbmcTrials.bonded.dih),
   nLJTrialsFirst(set.config.sys.cbmcTrials.nonbonded.first),
   nLJTrialsNth(set.config.sys.cbmcTrials.nonbonded.nth),
-  positions(*multiPositions)
+  positions(*multiPositions),
+  library(forcefield, set.config.sys.cbmcTrials.nonbonded.nth,
+          set.config.sys.cbmcTrials.library)
 {
   calcEwald = sys.GetEwald();
   uint maxLJTrials = nLJTrialsFirst;
@@ -29,7 +29,8 @@ class DCGraph : public CBMC
 {
 public:
   DCGraph(System& sys, const Forcefield& ff,
-          const MoleculeKind& kind, const Setup& set);
+          const MoleculeKind& kind, const Setup& set,
+          PRNG* prng = NULL);
 
   void Build(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
   void Regrowth(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
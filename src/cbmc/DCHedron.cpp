@@ -73,6 +73,10 @@ DCHedron::DCHedron(DCData* data, const mol_setup::MolKind& kind,
     }
   }
 
+  for (uint i = 0; i < nBonds; ++i) {
+    data->library.AddBend(angleKinds[i][i]);
+  }
+
   phi[0] = 0.0;
   phiWeight[0] = 1.0;
 
@@ -122,9 +126,16 @@ void DCHedron::GenerateAnglesNew(TrialMol& newMol, uint molIndex,
     thetaFix = data->ff.angles->Angle(kind);
   }
 
+  //angleWeights holds the sampling bias factor until weights are computed
+  const TrialLibrary& library = data->library;
+  bool useLibrary = !angleFix && library.HasBend(kind);
   for (int i = 0; i < nTrials; ++i) {
+    data->angleWeights[i] = 1.0;
     if(angleFix)
       data->angles[i] = thetaFix;
+    else if(useLibrary)
+      data->angles[i] = library.SampleBend(kind, data->prng,
+                                           data->angleWeights[i]);
     else
       data->angles[i] = data->prng.rand(M_PI);
   }
@@ -140,8 +151,8 @@ void DCHedron::GenerateAnglesNew(TrialMol& newMol, uint molIndex,
     nonbonded_1_3[i] =
       data->calc.IntraEnergy_1_3(distSq, prev, bonded[bType], molIndex);
 
-    data->angleWeights[i] = exp((data->angleEnergy[i] + nonbonded_1_3[i])
-                                * -data->ff.beta);
+    data->angleWeights[i] *= exp((data->angleEnergy[i] + nonbonded_1_3[i])
+                                 * -data->ff.beta);
   }
 }
 
@@ -158,9 +169,16 @@ void DCHedron::GenerateAnglesOld(TrialMol& oldMol, uint molIndex,
     thetaFix = data->ff.angles->Angle(kind);
   }
 
+  //angleWeights holds the sampling bias factor until weights are computed
+  const TrialLibrary& library = data->library;
+  bool useLibrary = !angleFix && library.HasBend(kind);
   for (int i = 0; i < nTrials; ++i) {
+    data->angleWeights[i] = 1.0;
     if(angleFix)
       data->angles[i] = thetaFix;
+    else if(useLibrary)
+      data->angles[i] = library.SampleBend(kind, data->prng,
+                                           data->angleWeights[i]);
     else
       data->angles[i] = data->prng.rand(M_PI);
   }
@@ -176,8 +194,8 @@ void DCHedron::GenerateAnglesOld(TrialMol& oldMol, uint molIndex,
     nonbonded_1_3[i] =
       data->calc.IntraEnergy_1_3(distSq, prev, bonded[bType], molIndex);
 
-    data->angleWeights[i] = exp((data->angleEnergy[i] + nonbonded_1_3[i])
-                                * -data->ff.beta);
+    data->angleWeights[i] *= exp((data->angleEnergy[i] + nonbonded_1_3[i])
+                                 * -data->ff.beta);
   }
 }
 
@@ -237,7 +255,11 @@ void DCHedron::IncorporateOld(TrialMol& oldMol, uint molIndex)
     double nonbondedEn =
       data->calc.IntraEnergy_1_3(distSq, prev, bonded[b], molIndex);
 
-    thetaWeight[b] += exp(-1 * data->ff.beta * (thetaEnergy + nonbondedEn));
+    double thetaBias = 1.0;
+    if(data->library.HasBend(angleKinds[b][b]))
+      thetaBias = data->library.BendFactor(angleKinds[b][b], theta[b]);
+    thetaWeight[b] += thetaBias *
+                      exp(-1 * data->ff.beta * (thetaEnergy + nonbondedEn));
     bendEnergy += thetaEnergy;
     oneThree += nonbondedEn;
 
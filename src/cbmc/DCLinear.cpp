@@ -13,8 +13,9 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 using namespace cbmc;
 
 DCLinear::DCLinear(System& sys, const Forcefield& ff,
-                   const MoleculeKind& kind, const Setup& set) :
-  data(sys, ff, set)
+                   const MoleculeKind& kind, const Setup& set,
+                   PRNG* prng) :
+  data(sys, ff, set, prng)
 {
   mol_setup::MolMap::const_iterator it = set.mol.kindMap.find(kind.name);
   assert(it != set.mol.kindMap.end());
@@ -23,7 +23,8 @@ class DCLinear : public CBMC
 {
 public:
   DCLinear(System& sys, const Forcefield& ff,
-           const MoleculeKind& kind, const Setup& set);
+           const MoleculeKind& kind, const Setup& set,
+           PRNG* prng = NULL);
 
   void Build(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
   void Regrowth(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
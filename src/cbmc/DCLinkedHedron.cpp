@@ -73,6 +73,12 @@ DCLinkedHedron::DCLinkedHedron
     }
   }
 
+  torLibrary = false;
+  if(hed.NumBond() > 0 && nPrevBonds > 0) {
+    data->library.AddTorsion(dihKinds[0][0]);
+    torLibrary = data->library.HasTorsion(dihKinds[0][0]);
+  }
+
   if(data->nLJTrialsNth < 1) {
     std::cout << "Error: CBMC secondary atom trials must be greater than 0.\n";
     exit(EXIT_FAILURE);
@@ -278,8 +284,19 @@ void DCLinkedHedron::BuildOld(TrialMol& oldMol, uint molIndex)
     }
   }
   ljWeights[0] = 0.0;
+  double phi0 = torLibrary ? hed.Phi(0) - prevPhi[0] : 0.0;
   for (uint tor = 0; tor < nDihTrials; ++tor) {
-    torsion[tor] = (tor == 0) ? 0.0 : data->prng.rand(M_PI * 2);
+    double torBias = 1.0;
+    if(tor == 0) {
+      torsion[tor] = 0.0;
+      if(torLibrary)
+        torBias = data->library.TorsionFactor(dihKinds[0][0], phi0);
+    } else if(torLibrary) {
+      torsion[tor] = data->library.SampleTorsion(dihKinds[0][0], data->prng,
+                     torBias) - phi0;
+    } else {
+      torsion[tor] = data->prng.rand(M_PI * 2);
+    }
     torEnergy[tor] = 0.0;
     nonbonded_1_4[tor] = 0.0;
     for (uint b = 0; b < hed.NumBond(); ++b) {
@@ -307,7 +324,8 @@ void DCLinkedHedron::BuildOld(TrialMol& oldMol, uint molIndex)
                                             trialPhi - prevPhi[p]);
       }
     }
-    ljWeights[0] += exp(-ff.beta * (torEnergy[tor] + nonbonded_1_4[tor]));
+    ljWeights[0] += torBias *
+                    exp(-ff.beta * (torEnergy[tor] + nonbonded_1_4[tor]));
   }
   bondedEn[0] = torEnergy[0];
   oneFour[0] = nonbonded_1_4[0];
@@ -378,9 +396,17 @@ void DCLinkedHedron::ChooseTorsion(TrialMol& mol, uint molIndex,
   std::fill_n(nonbonded_1_4, data->nDihTrials, 0.0);
 
   const XYZ center = mol.AtomPosition(hed.Focus());
+  //dihedral between bonded[0] and prevBonded[0] before applying torsion
+  double phi0 = torLibrary ? hed.Phi(0) - prevPhi[0] : 0.0;
   //select torsion based on all dihedral angles
   for (uint tor = 0; tor < nDihTrials; ++tor) {
-    torsion[tor] = data->prng.rand(M_PI * 2);
+    torWeights[tor] = 1.0;
+    if(torLibrary) {
+      torsion[tor] = data->library.SampleTorsion(dihKinds[0][0], data->prng,
+                     torWeights[tor]) - phi0;
+    } else {
+      torsion[tor] = data->prng.rand(M_PI * 2);
+    }
     torEnergy[tor] = 0.0;
     nonbonded_1_4[tor] = 0.0;
     for (uint b = 0; b < hed.NumBond(); ++b) {
@@ -408,7 +434,7 @@ void DCLinkedHedron::ChooseTorsion(TrialMol& mol, uint molIndex,
                                             trialPhi - prevPhi[p]);
       }
     }
-    torWeights[tor] = exp(-ff.beta * (torEnergy[tor] + nonbonded_1_4[tor]));
+    torWeights[tor] *= exp(-ff.beta * (torEnergy[tor] + nonbonded_1_4[tor]));
   }
 }
 
@@ -46,6 +46,8 @@ private:
   uint prevBonded[MAX_BONDS];
   //kind[bonded][previous]
   uint dihKinds[MAX_BONDS][MAX_BONDS];
+  //true if torsions are drawn from the library table of dihKinds[0][0]
+  bool torLibrary;
 
   //bond energy of built branch
   double bondEnergy;
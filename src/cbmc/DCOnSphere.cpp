@@ -4,6 +4,8 @@ Copyright (C) 2018  GOMC Group
 A copy of the GNU General Public License can be found in the COPYRIGHT.txt
 along with this program, also can be found at <http://www.gnu.org/licenses/>.
 ********************************************************************************/
+#define _USE_MATH_DEFINES
+#include <math.h>
 #include "DCOnSphere.h"
 #include "TrialMol.h"
 #include "DCData.h"
@@ -70,8 +72,25 @@ void DCOnSphere::BuildOld(TrialMol& oldMol, uint molIndex)
   SetBondLengthOld(oldMol);
   bondEnergy = BondEnergyOld(oldMol);
 
-  data->prng.FillWithRandomOnSphere(positions, nLJTrials, bondLength,
-                                    oldMol.AtomPosition(focus));
+  const TrialLibrary& library = data->library;
+  if(nLJTrials > 1 && library.OrientCount() == nLJTrials) {
+    //rotate the library so that a random slot points along the old bond
+    const XYZ center = oldMol.AtomPosition(focus);
+    XYZ bond = data->axes.MinImage(oldMol.AtomPosition(atom) - center,
+                                   oldMol.GetBox());
+    bond.Normalize();
+    uint slot = data->prng.randIntExc(nLJTrials);
+    RotationMatrix spin = TrialLibrary::Align(library.Direction(slot), bond,
+                          data->prng.rand(2.0 * M_PI));
+    for (uint trial = 1; trial < nLJTrials; trial++) {
+      uint dir = (slot + trial) % nLJTrials;
+      positions.Set(trial, spin.Apply(library.Direction(dir)) * bondLength +
+                    center);
+    }
+  } else {
+    data->prng.FillWithRandomOnSphere(positions, nLJTrials, bondLength,
+                                      oldMol.AtomPosition(focus));
+  }
   positions.Set(0, oldMol.AtomPosition(atom));
   data->axes.WrapPBC(positions, oldMol.GetBox());
 
@@ -109,8 +128,19 @@ void DCOnSphere::BuildNew(TrialMol& newMol, uint molIndex)
   SetBondLengthNew(newMol);
   bondEnergy = BondEnergyNew(newMol);
 
-  data->prng.FillWithRandomOnSphere(positions, nLJTrials, bondLength,
-                                    newMol.AtomPosition(focus));
+  const TrialLibrary& library = data->library;
+  if(nLJTrials > 1 && library.OrientCount() == nLJTrials) {
+    const XYZ center = newMol.AtomPosition(focus);
+    RotationMatrix spin = RotationMatrix::UniformRandom(data->prng(),
+                          data->prng(), data->prng());
+    for (uint trial = 0; trial < nLJTrials; trial++) {
+      positions.Set(trial, spin.Apply(library.Direction(trial)) * bondLength +
+                    center);
+    }
+  } else {
+    data->prng.FillWithRandomOnSphere(positions, nLJTrials, bondLength,
+                                      newMol.AtomPosition(focus));
+  }
   data->axes.WrapPBC(positions, newMol.GetBox());
 
   data->calc.ParticleInter(inter, real, positions, overlap, atom, molIndex,
@@ -0,0 +1,94 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#include "DCRigid.h"
+#include "DCGraph.h"
+#include "DCLinear.h"
+#include "DCCyclic.h"
+#include "TrialMol.h"
+#include "MoleculeKind.h"
+#include "Quaternion.h"
+#include "PRNG.h"
+#include "CalculateEnergy.h"
+#include <algorithm>
+
+namespace cbmc
+{
+
+DCRigid::DCRigid(System& sys, const Forcefield& ff,
+                 const MoleculeKind& kind, const Setup& set, PRNG* prng) :
+  kind(kind), data(sys, ff, set, prng)
+{
+  if(kind.NumBonds() > kind.NumAtoms() - 1)
+    flexible = new DCCyclic(sys, ff, kind, set, prng);
+  else if(kind.NumAtoms() > 2)
+    flexible = new DCGraph(sys, ff, kind, set, prng);
+  else
+    flexible = new DCLinear(sys, ff, kind, set, prng);
+  trialPos.assign(kind.NumAtoms(), XYZArray(data.nLJTrialsFirst));
+}
+
+void DCRigid::Build(TrialMol& oldMol, TrialMol& newMol, uint molIndex)
+{
+  PlaceTrials(newMol, 0);
+  double stepWeight = Weigh(newMol, molIndex);
+  uint winner = data.prng.PickWeighted(data.ljWeights, data.nLJTrialsFirst,
+                                       stepWeight);
+  for(uint a = 0; a < kind.NumAtoms(); ++a)
+    newMol.AddAtom(a, trialPos[a][winner]);
+  newMol.UpdateOverlap(data.overlap[winner]);
+  newMol.AddEnergy(Energy(0.0, 0.0, data.inter[winner], data.real[winner],
+                          0.0, 0.0, 0.0));
+  newMol.AddEnergy(data.calc.MoleculeIntra(newMol, molIndex));
+
+  for(uint a = 0; a < kind.NumAtoms(); ++a)
+    trialPos[a].Set(0, oldMol.AtomPosition(a));
+  PlaceTrials(oldMol, 1);
+  Weigh(oldMol, molIndex);
+  for(uint a = 0; a < kind.NumAtoms(); ++a)
+    oldMol.AddAtom(a, trialPos[a][0]);
+  oldMol.UpdateOverlap(data.overlap[0]);
+  oldMol.AddEnergy(Energy(0.0, 0.0, data.inter[0], data.real[0],
+                          0.0, 0.0, 0.0));
+  oldMol.AddEnergy(data.calc.MoleculeIntra(oldMol, molIndex));
+}
+
+void DCRigid::PlaceTrials(TrialMol& mol, const uint first)
+{
+  PRNG& prng = data.prng;
+  XYZArray const& body = kind.BodyFrame();
+  XYZ center;
+  for(uint t = first; t < data.nLJTrialsFirst; ++t) {
+    prng.FillWithRandom(center, data.axes, mol.GetBox());
+    double u1 = prng(), u2 = prng(), u3 = prng();
+    RotationMatrix spin = Quaternion::UniformRandom(u1, u2, u3).Matrix();
+    for(uint a = 0; a < kind.NumAtoms(); ++a)
+      trialPos[a].Set(t, center + spin.Apply(body.Get(a)));
+  }
+}
+
+double DCRigid::Weigh(TrialMol& mol, uint molIndex)
+{
+  const uint trials = data.nLJTrialsFirst;
+  std::fill_n(data.inter, trials, 0.0);
+  std::fill_n(data.real, trials, 0.0);
+  std::fill_n(data.overlap, trials, false);
+  for(uint a = 0; a < kind.NumAtoms(); ++a) {
+    data.axes.WrapPBC(trialPos[a], mol.GetBox());
+    data.calc.ParticleInter(data.inter, data.real, trialPos[a], data.overlap,
+                            a, molIndex, mol.GetBox(), trials);
+  }
+
+  double stepWeight = 0.0;
+  for(uint t = 0; t < trials; ++t) {
+    data.ljWeights[t] = exp(-data.ff.beta * (data.inter[t] + data.real[t]));
+    stepWeight += data.ljWeights[t];
+  }
+  mol.MultWeight(stepWeight / trials);
+  return stepWeight;
+}
+
+}
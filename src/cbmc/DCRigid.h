@@ -0,0 +1,88 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef DCRIGID_H
+#define DCRIGID_H
+#include "CBMC.h"
+#include "DCData.h"
+#include "XYZArray.h"
+#include <vector>
+
+class System;
+class Forcefield;
+class MoleculeKind;
+class Setup;
+
+namespace cbmc
+{
+
+//CBMC of a rigid kind. A swap places the kind's body frame at CBMC_First
+//trial poses, each a random center and a uniformly random orientation, so
+//the molecule is built whole instead of atom by atom and the old molecule
+//is weighted with the same kind of trials. The other moves are left to the
+//flexible builder of the kind, whose fixed bonds and angles keep its shape,
+//the cyclic one if the kind has a ring.
+class DCRigid : public CBMC
+{
+public:
+  DCRigid(System& sys, const Forcefield& ff,
+          const MoleculeKind& kind, const Setup& set,
+          PRNG* prng = NULL);
+  ~DCRigid()
+  {
+    delete flexible;
+  }
+
+  void Build(TrialMol& oldMol, TrialMol& newMol, uint molIndex);
+  void Regrowth(TrialMol& oldMol, TrialMol& newMol, uint molIndex)
+  {
+    flexible->Regrowth(oldMol, newMol, molIndex);
+  }
+  void CrankShaft(TrialMol& oldMol, TrialMol& newMol, uint molIndex)
+  {
+    flexible->CrankShaft(oldMol, newMol, molIndex);
+  }
+  void BuildIDNew(TrialMol& newMol, uint molIndex)
+  {
+    flexible->BuildIDNew(newMol, molIndex);
+  }
+  void BuildIDOld(TrialMol& oldMol, uint molIndex)
+  {
+    flexible->BuildIDOld(oldMol, molIndex);
+  }
+  void BuildNew(TrialMol& newMol, uint molIndex)
+  {
+    flexible->BuildNew(newMol, molIndex);
+  }
+  void BuildOld(TrialMol& oldMol, uint molIndex)
+  {
+    flexible->BuildOld(oldMol, molIndex);
+  }
+  void BuildGrowNew(TrialMol& newMol, uint molIndex)
+  {
+    flexible->BuildGrowNew(newMol, molIndex);
+  }
+  void BuildGrowOld(TrialMol& oldMol, uint molIndex)
+  {
+    flexible->BuildGrowOld(oldMol, molIndex);
+  }
+
+private:
+  //Trial poses of the body frame, trial 0 of the old molecule is where it is
+  void PlaceTrials(TrialMol& mol, const uint first);
+  //Multiplies the weight of mol by the Rosenbluth weight of the trials,
+  //returns the sum of their Boltzmann factors
+  double Weigh(TrialMol& mol, uint molIndex);
+
+  const MoleculeKind& kind;
+  CBMC* flexible;
+  //trial positions of each atom
+  std::vector<XYZArray> trialPos;
+  DCData data;
+};
+}
+
+#endif /*DCRIGID_H*/
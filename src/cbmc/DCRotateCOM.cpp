@@ -168,6 +168,11 @@ void DCRotateCOM::BuildNew(TrialMol& newMol, uint molIndex)
     }
   }
 
+  const TrialLibrary& library = data->library;
+  bool useLibrary = !newMol.RotateBB() && nLJTrials > 1 &&
+                    library.OrientCount() == nLJTrials;
+  RotationMatrix randomSet;
+
 
   for (uint p = 0; p < fLJTrials; ++p) {
     //Pick a new position for COM and transfer the molecule
@@ -182,11 +187,18 @@ void DCRotateCOM::BuildNew(TrialMol& newMol, uint molIndex)
       multiPosRotions[a].Add(index, -center);
     }
 
+    //one random rotation of the whole library set per COM trial
+    if(useLibrary) {
+      randomSet = RotationMatrix::UniformRandom(prng(), prng(), prng());
+    }
+
     //Rotational trial the molecule around COM
     for (uint r = nLJTrials; r-- > 0;) {
       if(newMol.RotateBB()) {
         //we only perform rotation around z axis
         RandRotateZ();
+      } else if(useLibrary) {
+        spin = library.Rotation(r) * randomSet;
       } else {
         //convert chosen torsion to 3D positions
         spin = RotationMatrix::UniformRandom(prng(), prng(), prng());
@@ -270,6 +282,12 @@ void DCRotateCOM::BuildOld(TrialMol& oldMol, uint molIndex)
     }
   }
 
+  const TrialLibrary& library = data->library;
+  bool useLibrary = !oldMol.RotateBB() && nLJTrials > 1 &&
+                    library.OrientCount() == nLJTrials;
+  RotationMatrix randomSet;
+  uint oldSlot = 0;
+
   const XYZ orgCenter = COM;
 
   for (uint p = 0; p < fLJTrials; ++p) {
@@ -285,6 +303,17 @@ void DCRotateCOM::BuildOld(TrialMol& oldMol, uint molIndex)
       multiPosRotions[a].Add(index, -center);
     }
 
+    //The current orientation must be a member of the library set of the
+    //first COM trial, so pick its slot at random and rotate the set to it
+    if(useLibrary) {
+      if(p == 0) {
+        oldSlot = prng.randIntExc(nLJTrials);
+        randomSet = library.Rotation(oldSlot).Inverse();
+      } else {
+        randomSet = RotationMatrix::UniformRandom(prng(), prng(), prng());
+      }
+    }
+
     //Rotational trial the molecule around COM
     for (uint r = nLJTrials; r-- > 0;) {
       if((index + r) == 0)
@@ -293,6 +322,9 @@ void DCRotateCOM::BuildOld(TrialMol& oldMol, uint molIndex)
       if(oldMol.RotateBB()) {
         //we only perform rotation around z axis
         RandRotateZ();
+      } else if(useLibrary) {
+        uint slot = (p == 0 ? (oldSlot + r) % nLJTrials : r);
+        spin = library.Rotation(slot) * randomSet;
       } else {
         //convert chosen torsion to 3D positions
         spin =  RotationMatrix::UniformRandom(prng(), prng(), prng());
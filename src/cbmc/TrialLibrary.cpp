@@ -0,0 +1,218 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include "TrialLibrary.h"
+#include "Forcefield.h"
+#include "PRNG.h"
+#include "GeomLib.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+//Number of bins for the bend/torsion tables
+const uint TABLE_BINS = 1000;
+//Fraction of the table probability spread uniformly, so no bin is ever
+//impossible to draw and weight factors stay bounded by 1/TABLE_MIX
+const double TABLE_MIX = 0.05;
+
+//Right-handed orthonormal frame with v as the third column
+RotationMatrix Frame(const XYZ& v)
+{
+  XYZ ref = (fabs(v.x) < 0.8 ? XYZ(1.0, 0.0, 0.0) : XYZ(0.0, 1.0, 0.0));
+  XYZ e1 = geom::Cross(ref, v);
+  e1.Normalize();
+  XYZ e2 = geom::Cross(v, e1);
+  RotationMatrix frame;
+  frame.BasisRotation(e1, e2, v);
+  return frame;
+}
+}
+
+namespace cbmc
+{
+const uint TrialLibrary::NO_TABLE;
+
+TrialLibrary::TrialLibrary(const Forcefield& ff, uint nOrient, bool enable)
+  : ff(ff), enable(enable), nOrient(enable ? nOrient : 0)
+{
+  if(!enable)
+    return;
+
+  //Super-Fibonacci spiral, Alexa (CVPR 2022)
+  const double phi = sqrt(2.0);
+  const double psi = 1.533751168755204288118041;
+  rotations.resize(nOrient);
+  for(uint i = 0; i < nOrient; ++i) {
+    double s = i + 0.5;
+    double t = s / nOrient;
+    double r = sqrt(t);
+    double R = sqrt(1.0 - t);
+    double alpha = 2.0 * M_PI * s / phi;
+    double beta = 2.0 * M_PI * s / psi;
+    double x = r * sin(alpha), y = r * cos(alpha);
+    double z = R * sin(beta), w = R * cos(beta);
+
+    RotationMatrix& m = rotations[i];
+    m.matrix[0][0] = 1.0 - 2.0 * (y * y + z * z);
+    m.matrix[0][1] = 2.0 * (x * y - z * w);
+    m.matrix[0][2] = 2.0 * (x * z + y * w);
+    m.matrix[1][0] = 2.0 * (x * y + z * w);
+    m.matrix[1][1] = 1.0 - 2.0 * (x * x + z * z);
+    m.matrix[1][2] = 2.0 * (y * z - x * w);
+    m.matrix[2][0] = 2.0 * (x * z - y * w);
+    m.matrix[2][1] = 2.0 * (y * z + x * w);
+    m.matrix[2][2] = 1.0 - 2.0 * (x * x + y * y);
+  }
+
+  //Spherical Fibonacci lattice
+  const double golden = M_PI * (3.0 - sqrt(5.0));
+  directions.resize(nOrient);
+  for(uint i = 0; i < nOrient; ++i) {
+    double z = 1.0 - (2.0 * i + 1.0) / nOrient;
+    double rho = sqrt(std::max(0.0, 1.0 - z * z));
+    directions[i] = XYZ(rho * cos(golden * i), rho * sin(golden * i), z);
+  }
+}
+
+void TrialLibrary::AddBend(uint kind)
+{
+  if(!enable || HasBend(kind) || ff.angles->AngleFixed(kind))
+    return;
+  if(bendIndex.size() <= kind)
+    bendIndex.resize(kind + 1, NO_TABLE);
+  bendIndex[kind] = tables.size();
+  tables.push_back(Table());
+  BuildTable(tables.back(), M_PI, true, kind);
+}
+
+void TrialLibrary::AddTorsion(uint kind)
+{
+  if(!enable || HasTorsion(kind))
+    return;
+  if(torsionIndex.size() <= kind)
+    torsionIndex.resize(kind + 1, NO_TABLE);
+  torsionIndex[kind] = tables.size();
+  tables.push_back(Table());
+  BuildTable(tables.back(), 2.0 * M_PI, false, kind);
+}
+
+void TrialLibrary::BuildTable(Table& table, double range, bool isBend,
+                              uint kind)
+{
+  table.width = range / TABLE_BINS;
+  table.prob.resize(TABLE_BINS);
+  table.accept.resize(TABLE_BINS);
+  table.alias.resize(TABLE_BINS);
+
+  //energy at the bin centers, shifted by its minimum to avoid underflow
+  double minEn = std::numeric_limits<double>::max();
+  for(uint b = 0; b < TABLE_BINS; ++b) {
+    double x = (b + 0.5) * table.width;
+    table.prob[b] = isBend ? ff.angles->Calc(kind, x) :
+                    ff.dihedrals.Calc(kind, x);
+    minEn = std::min(minEn, table.prob[b]);
+  }
+
+  double sum = 0.0;
+  for(uint b = 0; b < TABLE_BINS; ++b) {
+    table.prob[b] = exp(-ff.beta * (table.prob[b] - minEn));
+    sum += table.prob[b];
+  }
+  for(uint b = 0; b < TABLE_BINS; ++b) {
+    table.prob[b] = (1.0 - TABLE_MIX) * table.prob[b] / sum +
+                    TABLE_MIX / TABLE_BINS;
+  }
+
+  //Vose's construction of the alias table
+  std::vector<uint> small, large;
+  for(uint b = 0; b < TABLE_BINS; ++b) {
+    table.accept[b] = table.prob[b] * TABLE_BINS;
+    table.alias[b] = b;
+    if(table.accept[b] < 1.0)
+      small.push_back(b);
+    else
+      large.push_back(b);
+  }
+  while(!small.empty() && !large.empty()) {
+    uint s = small.back(), l = large.back();
+    small.pop_back();
+    table.alias[s] = l;
+    table.accept[l] -= 1.0 - table.accept[s];
+    if(table.accept[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  //leftovers are full bins up to round-off
+  for(uint i = 0; i < small.size(); ++i)
+    table.accept[small[i]] = 1.0;
+  for(uint i = 0; i < large.size(); ++i)
+    table.accept[large[i]] = 1.0;
+}
+
+double TrialLibrary::Sample(const Table& table, PRNG& prng,
+                            double& factor) const
+{
+  //a single uniform picks the bin, the alias decision and the offset
+  //within the chosen bin
+  double u = prng() * TABLE_BINS;
+  uint bin = std::min((uint)u, TABLE_BINS - 1);
+  double f = std::min(u - bin, 1.0);
+  double accept = table.accept[bin];
+  double frac;
+  if(f < accept || accept >= 1.0) {
+    frac = std::min(f / accept, 1.0);
+  } else {
+    frac = (f - accept) / (1.0 - accept);
+    bin = table.alias[bin];
+  }
+  factor = 1.0 / (TABLE_BINS * table.prob[bin]);
+  return (bin + frac) * table.width;
+}
+
+double TrialLibrary::Factor(const Table& table, double x) const
+{
+  int bin = (int)(x / table.width);
+  bin = std::min(std::max(bin, 0), (int)TABLE_BINS - 1);
+  return 1.0 / (TABLE_BINS * table.prob[bin]);
+}
+
+double TrialLibrary::SampleBend(uint kind, PRNG& prng, double& factor) const
+{
+  return Sample(tables[bendIndex[kind]], prng, factor);
+}
+
+double TrialLibrary::BendFactor(uint kind, double theta) const
+{
+  return Factor(tables[bendIndex[kind]], theta);
+}
+
+double TrialLibrary::SampleTorsion(uint kind, PRNG& prng,
+                                   double& factor) const
+{
+  return Sample(tables[torsionIndex[kind]], prng, factor);
+}
+
+double TrialLibrary::TorsionFactor(uint kind, double phi) const
+{
+  phi = fmod(phi, 2.0 * M_PI);
+  if(phi < 0.0)
+    phi += 2.0 * M_PI;
+  return Factor(tables[torsionIndex[kind]], phi);
+}
+
+RotationMatrix TrialLibrary::Align(const XYZ& from, const XYZ& to,
+                                   double psi)
+{
+  RotationMatrix twist;
+  twist.AddRotationZ(psi);
+  return Frame(to) * twist * Frame(from).Inverse();
+}
+
+}
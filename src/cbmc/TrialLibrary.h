@@ -0,0 +1,103 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef TRIALLIBRARY_H
+#define TRIALLIBRARY_H
+#include "BasicTypes.h"
+#include "TransformMatrix.h"
+#include <vector>
+#include <climits>
+
+class Forcefield;
+class PRNG;
+
+namespace cbmc
+{
+//Per-kind lookup tables used to generate CBMC trials.
+//Orientations come from a fixed quasi-uniform set that is randomized by one
+//Haar-random rotation per growth step, bend and torsion angles are drawn in
+//O(1) from alias tables of the Boltzmann distribution of the bare
+//angle/dihedral potential.
+//Every biased draw returns a factor (uniform density / table density) that
+//the caller multiplies into the trial weight, so Rosenbluth weights stay
+//exact.
+class TrialLibrary
+{
+public:
+  TrialLibrary(const Forcefield& ff, uint nOrient, bool enable);
+
+  bool Enabled() const
+  {
+    return enable;
+  }
+
+  //Build the tables for an angle/dihedral kind if not built yet.
+  //Must be called during initialization only (not thread safe).
+  void AddBend(uint kind);
+  void AddTorsion(uint kind);
+
+  bool HasBend(uint kind) const
+  {
+    return kind < bendIndex.size() && bendIndex[kind] != NO_TABLE;
+  }
+  bool HasTorsion(uint kind) const
+  {
+    return kind < torsionIndex.size() && torsionIndex[kind] != NO_TABLE;
+  }
+
+  //Draw theta in [0, PI] and return it with its weight factor
+  double SampleBend(uint kind, PRNG& prng, double& factor) const;
+  double BendFactor(uint kind, double theta) const;
+  //Draw phi in [0, 2PI) and return it with its weight factor
+  double SampleTorsion(uint kind, PRNG& prng, double& factor) const;
+  double TorsionFactor(uint kind, double phi) const;
+
+  //Quasi-uniform rotations (super-Fibonacci) and directions (spherical
+  //Fibonacci), both of size nOrient
+  uint OrientCount() const
+  {
+    return nOrient;
+  }
+  const RotationMatrix& Rotation(uint i) const
+  {
+    return rotations[i];
+  }
+  const XYZ& Direction(uint i) const
+  {
+    return directions[i];
+  }
+
+  //Returns a rotation that maps unit vector "from" to unit vector "to",
+  //followed by a twist of psi radians around "to"
+  static RotationMatrix Align(const XYZ& from, const XYZ& to, double psi);
+
+private:
+  static const uint NO_TABLE = UINT_MAX;
+
+  //Walker alias table over equal-width bins
+  struct Table {
+    double width;
+    std::vector<double> prob;   //bin probability
+    std::vector<double> accept; //probability of keeping the drawn bin
+    std::vector<uint> alias;    //bin to use otherwise
+  };
+
+  void BuildTable(Table& table, double range, bool isBend, uint kind);
+  double Sample(const Table& table, PRNG& prng, double& factor) const;
+  double Factor(const Table& table, double x) const;
+
+  const Forcefield& ff;
+  bool enable;
+  uint nOrient;
+  //kind -> position in tables, NO_TABLE if the kind is sampled uniformly
+  std::vector<uint> bendIndex, torsionIndex;
+  std::vector<Table> tables;
+  std::vector<RotationMatrix> rotations;
+  std::vector<XYZ> directions;
+};
+}
+
+#endif /*TRIALLIBRARY_H*/
@@ -212,7 +212,7 @@ inline uint CFCMC::Transform()
   molRef.kinds[kindIndex].BuildIDNew(newMolCFCMC, molIndex);
   overlapCFCMC = newMolCFCMC.HasOverlap();
   //Add bonded energy because we dont considered in DCRotate.cpp
-  newMolCFCMC.AddEnergy(calcEnRef.MoleculeIntra(newMolCFCMC, molIndex));
+  newMolCFCMC.AddEnergy(calcEnRef.MoleculeIntraCached(newMolCFCMC, molIndex));
   ShiftMolToDestBox();
 
   do {
@@ -226,13 +226,13 @@ inline uint CFCMC::Transform()
       //removing the fractional molecule in last steps using CBMC in sourceBox
       molRef.kinds[kindIndex].BuildIDOld(oldMolCFCMC, molIndex);
       //Add bonded energy because we dont considered in DCRotate.cpp
-      oldMolCFCMC.AddEnergy(calcEnRef.MoleculeIntra(oldMolCFCMC, molIndex));
+      oldMolCFCMC.AddEnergy(calcEnRef.MoleculeIntraCached(oldMolCFCMC, molIndex));
     } else if(lambdaIdxNew == lambdaWindow) {
       //removing the inserted fractional molecule using CBMC in destBox
       cellList.RemoveMol(molIndex, destBox, coordCurrRef);
       molRef.kinds[kindIndex].BuildIDOld(newMolCFCMC, molIndex);
       //Add bonded energy because we dont considered in DCRotate.cpp
-      newMolCFCMC.AddEnergy(calcEnRef.MoleculeIntra(newMolCFCMC, molIndex));
+      newMolCFCMC.AddEnergy(calcEnRef.MoleculeIntraCached(newMolCFCMC, molIndex));
       cellList.AddMol(molIndex, destBox, coordCurrRef);
     }
     //Calculate the old and new energy in source and destBox(if we dont do CBMC)
@@ -440,6 +440,8 @@ inline void CFCMC::ShiftMolToSourceBox()
   cellList.RemoveMol(molIndex, destBox, coordCurrRef);
   //Set coordinates, new COM; shift index to new box's list
   oldMolCFCMC.GetCoords().CopyRange(coordCurrRef, 0, pStartCFCMC, pLenCFCMC);
+  dirtyMolRef.Mark(molIndex);
+  rigidPoseRef.Invalidate(molIndex);
   comCurrRef.SetNew(molIndex, sourceBox);
   molLookRef.ShiftMolBox(molIndex, destBox, sourceBox, kindIndex);
   cellList.AddMol(molIndex, sourceBox, coordCurrRef);
@@ -450,6 +452,8 @@ inline void CFCMC::ShiftMolToDestBox()
   cellList.RemoveMol(molIndex, sourceBox, coordCurrRef);
   //Set coordinates, new COM; shift index to new box's list
   newMolCFCMC.GetCoords().CopyRange(coordCurrRef, 0, pStartCFCMC, pLenCFCMC);
+  dirtyMolRef.Mark(molIndex);
+  rigidPoseRef.Invalidate(molIndex);
   comCurrRef.SetNew(molIndex, destBox);
   molLookRef.ShiftMolBox(molIndex, sourceBox, destBox, kindIndex);
   cellList.AddMol(molIndex, destBox, coordCurrRef);
@@ -702,6 +706,8 @@ inline void CFCMC::AcceptRelaxing(uint b)
 
       //Copy coords
       newMolPos.CopyRange(coordCurrRef, 0, pStart, pLen);
+      dirtyMolRef.Mark(m);
+      rigidPoseRef.Invalidate(m);
       comCurrRef.Set(m, newCOM);
       calcEwald->UpdateRecip(b);
 
@@ -144,7 +144,10 @@ inline void CrankShaft::Accept(const uint rejectState, const uint step)
 
       //Set coordinates, new COM; shift index to new box's list
       newMol.GetCoords().CopyRange(coordCurrRef, 0, pStart, pLen);
+      dirtyMolRef.Mark(molIndex);
+      rigidPoseRef.Invalidate(molIndex);
       comCurrRef.SetNew(molIndex, destBox);
+      calcEnRef.InvalidateMoleculeIntra(molIndex);
       cellList.AddMol(molIndex, destBox, coordCurrRef);
 
 
@@ -0,0 +1,104 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+#ifndef DELAYEDACCEPT_H
+#define DELAYEDACCEPT_H
+
+#include "BasicTypes.h"
+#include "ConfigSetup.h"
+#include "EnergyTypes.h"
+#include "EnsemblePreprocessor.h"
+#include <cmath>
+#include <cstdio>
+
+//Two-stage (delayed acceptance) Metropolis test, Christen and Fox (2005).
+//Stage one accepts the trial with min(1, coeff * exp(-beta * dU_surr)),
+//where dU_surr is the change of a cheap surrogate energy. Only trials that
+//pass get their exact energy, and stage two accepts them with
+//min(1, (coeff_exact / coeff) * exp(-beta * (dU - dU_surr))). The second
+//stage divides the surrogate back out, so sampling stays exact.
+class DelayedAccept
+{
+public:
+  DelayedAccept(config_setup::Surrogate const& surr) : surr(surr),
+    coeff(1.0), dU(0.0)
+  {
+    for(uint b = 0; b < BOX_TOTAL; b++) {
+      trials[b] = 0;
+      rejected[b] = 0;
+    }
+  }
+
+  bool Enabled() const
+  {
+    return surr.kind != surr.SURR_NONE;
+  }
+  //real space energy of the trial, old reciprocal term
+  bool IsReal() const
+  {
+    return surr.kind == surr.SURR_REAL;
+  }
+  //LJ energy of the trial with a shorter cutoff
+  bool IsLJ() const
+  {
+    return surr.kind == surr.SURR_LJ;
+  }
+  double Cutoff() const
+  {
+    return surr.cutoff;
+  }
+
+  //Surrogate energy of SURR_REAL for a box
+  static double RealSpace(SystemPotential const& pot, const uint box)
+  {
+    return pot.boxEnergy[box].inter + pot.boxEnergy[box].real +
+           pot.boxEnergy[box].tc;
+  }
+
+  //Stage one. Returns true if the trial goes on to the exact energy.
+  bool Screen(const double surrCoeff, const double surrDU, const double beta,
+              const double rand)
+  {
+    coeff = surrCoeff;
+    dU = surrDU;
+    return rand < coeff * exp(-beta * dU);
+  }
+
+  //Stage two acceptance probability of a trial that passed stage one
+  double Correct(const double exactCoeff, const double exactDU,
+                 const double beta) const
+  {
+    return exactCoeff / coeff * exp(-beta * (exactDU - dU));
+  }
+
+  void Record(const uint box, const bool pass)
+  {
+    trials[box]++;
+    if(!pass)
+      rejected[box]++;
+  }
+
+  void PrintRejected(const char * move) const
+  {
+    if(!Enabled())
+      return;
+    printf("%-37s", move);
+    for(uint b = 0; b < BOX_TOTAL; b++) {
+      double percent = (trials[b] == 0 ? 0.0 :
+                        100.0 * rejected[b] / (double)trials[b]);
+      printf("%10.5f ", percent);
+    }
+    printf("\n");
+  }
+
+private:
+  config_setup::Surrogate surr;
+  //stage one values of the current trial
+  double coeff, dU;
+  ulong trials[BOX_TOTAL], rejected[BOX_TOTAL];
+};
+
+#endif /*DELAYEDACCEPT_H*/
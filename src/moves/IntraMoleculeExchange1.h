@@ -445,7 +445,7 @@ inline uint IntraMoleculeExchange1::Transform()
     cellList.RemoveMol(molIndexA[n], sourceBox, coordCurrRef);
     molRef.kinds[kindIndexA[n]].BuildIDOld(oldMolA[n], molIndexA[n]);
     // Add bonded energy because we don't consider it in DCRotate.cpp
-    oldMolA[n].AddEnergy(calcEnRef.MoleculeIntra(oldMolA[n], molIndexA[n]));
+    oldMolA[n].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolA[n], molIndexA[n]));
   }
 
   // Calc old energy before deleting
@@ -453,7 +453,7 @@ inline uint IntraMoleculeExchange1::Transform()
     cellList.RemoveMol(molIndexB[n], sourceBox, coordCurrRef);
     molRef.kinds[kindIndexB[n]].BuildIDOld(oldMolB[n], molIndexB[n]);
     // Add bonded energy because we don't consider it in DCRotate.cpp
-    oldMolB[n].AddEnergy(calcEnRef.MoleculeIntra(oldMolB[n], molIndexB[n]));
+    oldMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolB[n], molIndexB[n]));
   }
 
   // Insert kindL to cavity of  center A
@@ -462,7 +462,7 @@ inline uint IntraMoleculeExchange1::Transform()
     ShiftMol(n, false);
     cellList.AddMol(molIndexB[n], sourceBox, coordCurrRef);
     // Add bonded energy because we don't consider it in DCRotate.cpp
-    newMolB[n].AddEnergy(calcEnRef.MoleculeIntra(newMolB[n], molIndexB[n]));
+    newMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolB[n], molIndexB[n]));
     overlap |= newMolB[n].HasOverlap();
   }
 
@@ -472,7 +472,7 @@ inline uint IntraMoleculeExchange1::Transform()
     ShiftMol(n, true);
     cellList.AddMol(molIndexA[n], sourceBox, coordCurrRef);
     // Add bonded energy because we don't consider it in DCRotate.cpp
-    newMolA[n].AddEnergy(calcEnRef.MoleculeIntra(newMolA[n], molIndexA[n]));
+    newMolA[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolA[n], molIndexA[n]));
     overlap |= newMolA[n].HasOverlap();
   }
 
@@ -509,12 +509,16 @@ inline void IntraMoleculeExchange1::ShiftMol(const uint n, const bool typeA)
   if(typeA) {
     //update coordinate of molecule typeA
     newMolA[n].GetCoords().CopyRange(coordCurrRef, 0, pStartA[n], pLenA[n]);
+    dirtyMolRef.Mark(molIndexA[n]);
+    rigidPoseRef.Invalidate(molIndexA[n]);
 
     // update COM based on the new coordinates
     comCurrRef.SetNew(molIndexA[n], sourceBox);
   } else {
     //update coordinate of molecule typeA
     newMolB[n].GetCoords().CopyRange(coordCurrRef, 0, pStartB[n], pLenB[n]);
+    dirtyMolRef.Mark(molIndexB[n]);
+    rigidPoseRef.Invalidate(molIndexB[n]);
 
     // update COM based on the new coordinates
     comCurrRef.SetNew(molIndexB[n], sourceBox);
@@ -529,6 +533,8 @@ inline void IntraMoleculeExchange1::RecoverMol(const uint n, const bool typeA)
     boxDimRef.WrapPBC(molA, sourceBox);
 
     molA.CopyRange(coordCurrRef, 0, pStartA[n], pLenA[n]);
+    dirtyMolRef.Mark(molIndexA[n]);
+    rigidPoseRef.Invalidate(molIndexA[n]);
     comCurrRef.SetNew(molIndexA[n], sourceBox);
   } else {
     XYZArray molB(pLenB[n]);
@@ -536,6 +542,8 @@ inline void IntraMoleculeExchange1::RecoverMol(const uint n, const bool typeA)
     boxDimRef.WrapPBC(molB, sourceBox);
 
     molB.CopyRange(coordCurrRef, 0, pStartB[n], pLenB[n]);
+    dirtyMolRef.Mark(molIndexB[n]);
+    rigidPoseRef.Invalidate(molIndexB[n]);
     comCurrRef.SetNew(molIndexB[n], sourceBox);
   }
 }
@@ -298,7 +298,7 @@ inline uint IntraMoleculeExchange2::Transform()
     cellList.RemoveMol(molIndexA[n - 1], sourceBox, coordCurrRef);
     molRef.kinds[kindIndexA[n - 1]].BuildIDOld(oldMolA[n - 1], molIndexA[n - 1]);
     // Add bonded energy because we don't considered in DCRotate.cpp
-    oldMolA[n - 1].AddEnergy(calcEnRef.MoleculeIntra(oldMolA[n - 1], molIndexA[n - 1]));
+    oldMolA[n - 1].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolA[n - 1], molIndexA[n - 1]));
   }
 
   // Calc old energy before deleting
@@ -306,7 +306,7 @@ inline uint IntraMoleculeExchange2::Transform()
     cellList.RemoveMol(molIndexB[n], sourceBox, coordCurrRef);
     molRef.kinds[kindIndexB[n]].BuildIDOld(oldMolB[n], molIndexB[n]);
     // Add bonded energy because we don't considered in DCRotate.cpp
-    oldMolB[n].AddEnergy(calcEnRef.MoleculeIntra(oldMolB[n], molIndexB[n]));
+    oldMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolB[n], molIndexB[n]));
   }
 
   // Insert kindL to cavity of center A
@@ -315,7 +315,7 @@ inline uint IntraMoleculeExchange2::Transform()
     ShiftMol(n, false);
     cellList.AddMol(molIndexB[n], sourceBox, coordCurrRef);
     // Add bonded energy because we don't considered in DCRotate.cpp
-    newMolB[n].AddEnergy(calcEnRef.MoleculeIntra(newMolB[n], molIndexB[n]));
+    newMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolB[n], molIndexB[n]));
     overlap |= newMolB[n].HasOverlap();
   }
 
@@ -325,7 +325,7 @@ inline uint IntraMoleculeExchange2::Transform()
     ShiftMol(n, true);
     cellList.AddMol(molIndexA[n], sourceBox, coordCurrRef);
     // Add bonded energy because we don't considered in DCRotate.cpp
-    newMolA[n].AddEnergy(calcEnRef.MoleculeIntra(newMolA[n], molIndexA[n]));
+    newMolA[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolA[n], molIndexA[n]));
     overlap |= newMolA[n].HasOverlap();
   }
 
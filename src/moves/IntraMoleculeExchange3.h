@@ -254,7 +254,7 @@ inline uint IntraMoleculeExchange3::Transform()
     cellList.RemoveMol(molIndexA[n - 1], sourceBox, coordCurrRef);
     molRef.kinds[kindIndexA[n - 1]].BuildIDOld(oldMolA[n - 1], molIndexA[n - 1]);
     //Add bonded energy because we dont considered in DCRotate.cpp
-    oldMolA[n - 1].AddEnergy(calcEnRef.MoleculeIntra(oldMolA[n - 1], molIndexA[n - 1]));
+    oldMolA[n - 1].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolA[n - 1], molIndexA[n - 1]));
   }
 
   //Calc old energy before deleting
@@ -266,6 +266,8 @@ inline uint IntraMoleculeExchange3::Transform()
   //Insert kindL to cavity of  center A using CD-CBMC
   for(uint n = 0; n < numInCavB; n++) {
     molRef.kinds[kindIndexB[n]].BuildGrowNew(newMolB[n], molIndexB[n]);
+    //conformation changes, the cache is rebuilt lazily even if rejected
+    calcEnRef.InvalidateMoleculeIntra(molIndexB[n]);
     ShiftMol(n, false);
     cellList.AddMol(molIndexB[n], sourceBox, coordCurrRef);
     overlap |= newMolB[n].HasOverlap();
@@ -277,7 +279,7 @@ inline uint IntraMoleculeExchange3::Transform()
     ShiftMol(n, true);
     cellList.AddMol(molIndexA[n], sourceBox, coordCurrRef);
     //Add bonded energy because we dont considered in DCRotate.cpp
-    newMolA[n].AddEnergy(calcEnRef.MoleculeIntra(newMolA[n], molIndexA[n]));
+    newMolA[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolA[n], molIndexA[n]));
     overlap |= newMolA[n].HasOverlap();
   }
 
@@ -508,7 +508,7 @@ inline uint MoleculeExchange1::Transform()
     cellList.RemoveMol(molIndexA[n], sourceBox, coordCurrRef);
     molRef.kinds[kindIndexA[n]].BuildIDOld(oldMolA[n], molIndexA[n]);
     //Add bonded energy because we dont considered in DCRotate.cpp
-    oldMolA[n].AddEnergy(calcEnRef.MoleculeIntra(oldMolA[n], molIndexA[n]));
+    oldMolA[n].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolA[n], molIndexA[n]));
   }
 
   //Calc old energy and delete B from destBox
@@ -516,7 +516,7 @@ inline uint MoleculeExchange1::Transform()
     cellList.RemoveMol(molIndexB[n], destBox, coordCurrRef);
     molRef.kinds[kindIndexB[n]].BuildIDOld(oldMolB[n], molIndexB[n]);
     //Add bonded energy because we dont considered in DCRotate.cpp
-    oldMolB[n].AddEnergy(calcEnRef.MoleculeIntra(oldMolB[n], molIndexB[n]));
+    oldMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolB[n], molIndexB[n]));
   }
 
   //Insert A to destBox
@@ -525,7 +525,7 @@ inline uint MoleculeExchange1::Transform()
     ShiftMol(true, n, sourceBox, destBox);
     cellList.AddMol(molIndexA[n], destBox, coordCurrRef);
     //Add bonded energy because we dont considered in DCRotate.cpp
-    newMolA[n].AddEnergy(calcEnRef.MoleculeIntra(newMolA[n], molIndexA[n]));
+    newMolA[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolA[n], molIndexA[n]));
     overlap |= newMolA[n].HasOverlap();
   }
 
@@ -535,7 +535,7 @@ inline uint MoleculeExchange1::Transform()
     ShiftMol(false, n, destBox, sourceBox);
     cellList.AddMol(molIndexB[n], sourceBox, coordCurrRef);
     //Add bonded energy because we dont considered in DCRotate.cpp
-    newMolB[n].AddEnergy(calcEnRef.MoleculeIntra(newMolB[n], molIndexB[n]));
+    newMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolB[n], molIndexB[n]));
     overlap |= newMolB[n].HasOverlap();
   }
 
@@ -675,11 +675,15 @@ inline void MoleculeExchange1::ShiftMol(const bool A, const uint n,
   if(A) {
     //Add type A to dest box
     newMolA[n].GetCoords().CopyRange(coordCurrRef, 0, pStartA[n], pLenA[n]);
+    dirtyMolRef.Mark(molIndexA[n]);
+    rigidPoseRef.Invalidate(molIndexA[n]);
     comCurrRef.SetNew(molIndexA[n], to);
     molLookRef.ShiftMolBox(molIndexA[n], from, to, kindIndexA[n]);
   } else {
     //Add type B to source box
     newMolB[n].GetCoords().CopyRange(coordCurrRef, 0, pStartB[n], pLenB[n]);
+    dirtyMolRef.Mark(molIndexB[n]);
+    rigidPoseRef.Invalidate(molIndexB[n]);
     comCurrRef.SetNew(molIndexB[n], to);
     molLookRef.ShiftMolBox(molIndexB[n], from, to, kindIndexB[n]);
   }
@@ -694,6 +698,8 @@ inline void MoleculeExchange1::RecoverMol(const bool A, const uint n,
     boxDimRef.WrapPBC(molA, to);
 
     molA.CopyRange(coordCurrRef, 0, pStartA[n], pLenA[n]);
+    dirtyMolRef.Mark(molIndexA[n]);
+    rigidPoseRef.Invalidate(molIndexA[n]);
     comCurrRef.SetNew(molIndexA[n], to);
     molLookRef.ShiftMolBox(molIndexA[n], from, to, kindIndexA[n]);
   } else {
@@ -702,6 +708,8 @@ inline void MoleculeExchange1::RecoverMol(const bool A, const uint n,
     boxDimRef.WrapPBC(molB, to);
 
     molB.CopyRange(coordCurrRef, 0, pStartB[n], pLenB[n]);
+    dirtyMolRef.Mark(molIndexB[n]);
+    rigidPoseRef.Invalidate(molIndexB[n]);
     comCurrRef.SetNew(molIndexB[n], to);
     molLookRef.ShiftMolBox(molIndexB[n], from, to, kindIndexB[n]);
   }
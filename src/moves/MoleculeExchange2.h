@@ -337,14 +337,14 @@ inline uint MoleculeExchange2::Transform()
       cellList.RemoveMol(molIndexA[n - 1], sourceBox, coordCurrRef);
       molRef.kinds[kindIndexA[n - 1]].BuildIDOld(oldMolA[n - 1], molIndexA[n - 1]);
       //Add bonded energy because we dont considered in DCRotate.cpp
-      oldMolA[n - 1].AddEnergy(calcEnRef.MoleculeIntra(oldMolA[n - 1], molIndexA[n - 1]));
+      oldMolA[n - 1].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolA[n - 1], molIndexA[n - 1]));
     }
   } else {
     for(uint n = 0; n < numInCavA; n++) {
       cellList.RemoveMol(molIndexA[n], sourceBox, coordCurrRef);
       molRef.kinds[kindIndexA[n]].BuildIDOld(oldMolA[n], molIndexA[n]);
       //Add bonded energy because we dont considered in DCRotate.cpp
-      oldMolA[n].AddEnergy(calcEnRef.MoleculeIntra(oldMolA[n], molIndexA[n]));
+      oldMolA[n].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolA[n], molIndexA[n]));
     }
   }
 
@@ -353,7 +353,7 @@ inline uint MoleculeExchange2::Transform()
     cellList.RemoveMol(molIndexB[n], destBox, coordCurrRef);
     molRef.kinds[kindIndexB[n]].BuildIDOld(oldMolB[n], molIndexB[n]);
     //Add bonded energy because we dont considered in DCRotate.cpp
-    oldMolB[n].AddEnergy(calcEnRef.MoleculeIntra(oldMolB[n], molIndexB[n]));
+    oldMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolB[n], molIndexB[n]));
   }
 
   //Insert A to destBox
@@ -362,7 +362,7 @@ inline uint MoleculeExchange2::Transform()
     ShiftMol(true, n, sourceBox, destBox);
     cellList.AddMol(molIndexA[n], destBox, coordCurrRef);
     //Add bonded energy because we dont considered in DCRotate.cpp
-    newMolA[n].AddEnergy(calcEnRef.MoleculeIntra(newMolA[n], molIndexA[n]));
+    newMolA[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolA[n], molIndexA[n]));
     overlap |= newMolA[n].HasOverlap();
   }
 
@@ -372,7 +372,7 @@ inline uint MoleculeExchange2::Transform()
     ShiftMol(false, n, destBox, sourceBox);
     cellList.AddMol(molIndexB[n], sourceBox, coordCurrRef);
     //Add bonded energy because we dont considered in DCRotate.cpp
-    newMolB[n].AddEnergy(calcEnRef.MoleculeIntra(newMolB[n], molIndexB[n]));
+    newMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolB[n], molIndexB[n]));
     overlap |= newMolB[n].HasOverlap();
   }
 
@@ -290,7 +290,7 @@ inline uint MoleculeExchange3::Transform()
       cellList.RemoveMol(molIndexA[n - 1], sourceBox, coordCurrRef);
       molRef.kinds[kindIndexA[n - 1]].BuildIDOld(oldMolA[n - 1], molIndexA[n - 1]);
       //Add bonded energy because we dont considered in DCRotate.cpp
-      oldMolA[n - 1].AddEnergy(calcEnRef.MoleculeIntra(oldMolA[n - 1], molIndexA[n - 1]));
+      oldMolA[n - 1].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolA[n - 1], molIndexA[n - 1]));
     }
     //Calc old energy and delete Large kind from dest box
     for(uint n = 0; n < numInCavB; n++) {
@@ -307,7 +307,7 @@ inline uint MoleculeExchange3::Transform()
     for(uint n = 0; n < numInCavB; n++) {
       cellList.RemoveMol(molIndexB[n], destBox, coordCurrRef);
       molRef.kinds[kindIndexB[n]].BuildIDOld(oldMolB[n], molIndexB[n]);
-      oldMolB[n].AddEnergy(calcEnRef.MoleculeIntra(oldMolB[n], molIndexB[n]));
+      oldMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(oldMolB[n], molIndexB[n]));
     }
   }
 
@@ -318,12 +318,14 @@ inline uint MoleculeExchange3::Transform()
       molRef.kinds[kindIndexA[n]].BuildIDNew(newMolA[n], molIndexA[n]);
       ShiftMol(true, n, sourceBox, destBox);
       cellList.AddMol(molIndexA[n], destBox, coordCurrRef);
-      newMolA[n].AddEnergy(calcEnRef.MoleculeIntra(newMolA[n], molIndexA[n]));
+      newMolA[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolA[n], molIndexA[n]));
       overlap |= newMolA[n].HasOverlap();
     }
     //Insert Large kind to sourceBox
     for(uint n = 0; n < numInCavB; n++) {
       molRef.kinds[kindIndexB[n]].BuildGrowNew(newMolB[n], molIndexB[n]);
+      //conformation changes, the cache is rebuilt lazily even if rejected
+      calcEnRef.InvalidateMoleculeIntra(molIndexB[n]);
       ShiftMol(false, n, destBox, sourceBox);
       cellList.AddMol(molIndexB[n], sourceBox, coordCurrRef);
       overlap |= newMolB[n].HasOverlap();
@@ -332,6 +334,7 @@ inline uint MoleculeExchange3::Transform()
     //Insert Large kind to destBox
     for(uint n = 0; n < numInCavA; n++) {
       molRef.kinds[kindIndexA[n]].BuildNew(newMolA[n], molIndexA[n]);
+      calcEnRef.InvalidateMoleculeIntra(molIndexA[n]);
       ShiftMol(true, n, sourceBox, destBox);
       cellList.AddMol(molIndexA[n], destBox, coordCurrRef);
       overlap |= newMolA[n].HasOverlap();
@@ -342,7 +345,7 @@ inline uint MoleculeExchange3::Transform()
       ShiftMol(false, n, destBox, sourceBox);
       cellList.AddMol(molIndexB[n], sourceBox, coordCurrRef);
       //Add bonded energy because we dont considered in DCRotate.cpp
-      newMolB[n].AddEnergy(calcEnRef.MoleculeIntra(newMolB[n], molIndexB[n]));
+      newMolB[n].AddEnergy(calcEnRef.MoleculeIntraCached(newMolB[n], molIndexB[n]));
       overlap |= newMolB[n].HasOverlap();
     }
   }
@@ -11,6 +11,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 
 #include "MoveBase.h"
 #include "TrialMol.h"
+#include "ConformerReservoir.h"
 
 //#define DEBUG_MOVES
 
@@ -18,9 +19,11 @@ class MoleculeTransfer : public MoveBase
 {
 public:
 
-  MoleculeTransfer(System &sys, StaticVals const& statV) :
+  MoleculeTransfer(System &sys, StaticVals const& statV,
+                   Setup const& set) :
     ffRef(statV.forcefield), molLookRef(sys.molLookupRef),
-    MoveBase(sys, statV) {}
+    MoveBase(sys, statV),
+    reservoir(sys, set, statV.mol, statV.reservoirSize) {}
 
   virtual uint Prep(const double subDraw, const double movPerc);
   virtual uint Transform();
@@ -43,6 +46,7 @@ private:
   Intermolecular tcLose, tcGain, recipLose, recipGain;
   MoleculeLookup & molLookRef;
   Forcefield const& ffRef;
+  cbmc::ConformerReservoir reservoir;
 };
 
 void MoleculeTransfer::PrintAcceptKind()
@@ -96,7 +100,25 @@ inline uint MoleculeTransfer::Prep(const double subDraw, const double movPerc)
 inline uint MoleculeTransfer::Transform()
 {
   cellList.RemoveMol(molIndex, sourceBox, coordCurrRef);
-  molRef.kinds[kindIndex].Build(oldMol, newMol, molIndex);
+  MoleculeKind& kind = molRef.kinds[kindIndex];
+  if(reservoir.Enabled(kindIndex)) {
+    //Only the rigid-body placement is sampled. The new molecule takes a
+    //conformer from the ideal gas reservoir, and the intramolecular
+    //Rosenbluth weights of the stored and the removed conformation
+    //multiply the rigid-body weights.
+    double intraOld = reservoir.OldWeight(oldMol, molIndex);
+    double intraNew = reservoir.Draw(newMol, kindIndex);
+    oldMol.SetSeed(false, false, false);
+    kind.BuildIDOld(oldMol, molIndex);
+    oldMol.MultWeight(intraOld);
+    oldMol.AddEnergy(calcEnRef.MoleculeIntraCached(oldMol, molIndex));
+    newMol.SetSeed(false, false, false);
+    kind.BuildIDNew(newMol, molIndex);
+    newMol.MultWeight(intraNew);
+    newMol.AddEnergy(calcEnRef.MoleculeIntra(newMol, molIndex));
+  } else {
+    kind.Build(oldMol, newMol, molIndex);
+  }
   overlap = newMol.HasOverlap();
   return mv::fail_state::NO_FAIL;
 }
@@ -200,7 +222,10 @@ inline void MoleculeTransfer::Accept(const uint rejectState, const uint step)
 
       //Set coordinates, new COM; shift index to new box's list
       newMol.GetCoords().CopyRange(coordCurrRef, 0, pStart, pLen);
+      dirtyMolRef.Mark(molIndex);
+      rigidPoseRef.Invalidate(molIndex);
       comCurrRef.SetNew(molIndex, destBox);
+      calcEnRef.InvalidateMoleculeIntra(molIndex);
       molLookRef.ShiftMolBox(molIndex, sourceBox, destBox,
                              kindIndex);
       cellList.AddMol(molIndex, destBox, coordCurrRef);
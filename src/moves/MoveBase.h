@@ -25,6 +25,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #include "NoEwald.h"
 #include "MolPick.h"
 #include "Forcefield.h"
+#include "ThreadSplit.h"
 
 class MoveBase
 {
@@ -34,7 +35,8 @@ public:
     boxDimRef(sys.boxDimRef), moveSetRef(sys.moveSettings),
     sysPotRef(sys.potential),
     calcEnRef(sys.calcEnergy), comCurrRef(sys.com),
-    coordCurrRef(sys.coordinates), prng(sys.prng), molRef(statV.mol),
+    coordCurrRef(sys.coordinates), dirtyMolRef(sys.dirtyMols),
+    rigidPoseRef(sys.rigidPoses), prng(sys.prng), molRef(statV.mol),
     BETA(statV.forcefield.beta), ewald(statV.forcefield.ewald),
     cellList(sys.cellList), molRemoved(false),
     atomForceRef(sys.atomForceRef),
@@ -48,6 +50,8 @@ public:
     molRemoved = false;
     overlap = false;
     multiParticleEnabled = sys.statV.multiParticleEnabled;
+    recipSplit.Init(statV.recipParallel && ewald);
+    earlyReject = statV.earlyReject;
   }
 
   //Based on the random draw, determine the move kind, box, and
@@ -79,6 +83,10 @@ protected:
   MoveSettings & moveSetRef;
   SystemPotential & sysPotRef;
   Coordinates & coordCurrRef;
+  //every molecule copied into coordCurrRef is marked here
+  DirtyMolecules & dirtyMolRef;
+  //and has its rigid orientation invalidated here
+  RigidPoses & rigidPoseRef;
   COM & comCurrRef;
   CalculateEnergy & calcEnRef;
   Ewald * calcEwald;
@@ -92,13 +100,104 @@ protected:
   PRNG & prng;
   BoxDimensions & boxDimRef;
   Molecules const& molRef;
-  const double BETA;
+  //follows the temperature of the replica, which may change at exchanges
+  double const& BETA;
   const bool ewald;
   CellList& cellList;
   bool molRemoved, fixBox0, overlap;
   bool multiParticleEnabled;
+  //threads of the real space (0) and reciprocal (1) tasks
+  ThreadSplit recipSplit;
+  //draw the acceptance uniform first and stop the energy once rejected
+  bool earlyReject;
+  MolPairs molPairs;
+
+  //Real space and reciprocal energy change of molecule m at molPos, the
+  //two run concurrently if recipSplit allows. Returns true on overlap, in
+  //which case recip is not set.
+  bool MoleculeInterRecip(Intermolecular &inter_LJ, Intermolecular &inter_Real,
+                          Intermolecular &recip, XYZArray const& molPos,
+                          const uint m, const uint b);
+
+  //Same as MoleculeInterRecip, with the acceptance uniform pr drawn in
+  //advance. Returns true on overlap or once exp(-BETA * dU) < pr is certain,
+  //in which case no energy is set.
+  bool MoleculeInterEarly(Intermolecular &inter_LJ, Intermolecular &inter_Real,
+                          Intermolecular &recip, XYZArray const& molPos,
+                          const uint m, const uint b, const double pr);
 };
 
+inline bool MoveBase::MoleculeInterRecip(Intermolecular &inter_LJ,
+    Intermolecular &inter_Real,
+    Intermolecular &recip,
+    XYZArray const& molPos,
+    const uint m, const uint b)
+{
+  int threads[2];
+  if(!recipSplit.Threads(threads)) {
+    //calculate LJ interaction and real term of electrostatic interaction
+    bool isOverlap = calcEnRef.MoleculeInter(inter_LJ, inter_Real, molPos, m,
+                     b);
+    if(!isOverlap) {
+      //calculate reciprocate term of electrostatic interaction
+      recip.energy = calcEwald->MolReciprocal(molPos, m, b);
+    }
+    return isOverlap;
+  }
+
+  bool isOverlap = false;
+  double recipEn = 0.0;
+#ifdef _OPENMP
+  #pragma omp parallel sections num_threads(2)
+  {
+    #pragma omp section
+    {
+      double start = omp_get_wtime();
+      omp_set_num_threads(threads[0]);
+      isOverlap = calcEnRef.MoleculeInter(inter_LJ, inter_Real, molPos, m, b);
+      recipSplit.Record(0, omp_get_wtime() - start, threads[0]);
+    }
+    #pragma omp section
+    {
+      double start = omp_get_wtime();
+      omp_set_num_threads(threads[1]);
+      recipEn = calcEwald->MolReciprocal(molPos, m, b);
+      recipSplit.Record(1, omp_get_wtime() - start, threads[1]);
+    }
+  }
+#endif
+  //the reciprocal term was computed anyway, undo its cache update since
+  //the caller only restores molecules without overlap
+  if(isOverlap)
+    calcEwald->RestoreMol(m);
+  else
+    recip.energy = recipEn;
+  return isOverlap;
+}
+
+inline bool MoveBase::MoleculeInterEarly(Intermolecular &inter_LJ,
+    Intermolecular &inter_Real,
+    Intermolecular &recip,
+    XYZArray const& molPos,
+    const uint m, const uint b,
+    const double pr)
+{
+  //overlaps are found before any energy of the new position
+  if(calcEnRef.MoleculePairs(molPairs, molPos, m, b))
+    return true;
+
+  recip.energy = calcEwald->MolReciprocal(molPos, m, b);
+  //any energy change above this is rejected by pr
+  double maxChange = -log(pr) / BETA - recip.energy;
+  if(calcEnRef.MoleculePairsEnergy(inter_LJ, inter_Real, molPairs, molPos, m,
+                                   b, maxChange)) {
+    //the caller only restores molecules without overlap
+    calcEwald->RestoreMol(m);
+    return true;
+  }
+  return false;
+}
+
 //Data needed for transforming a molecule's position via inter or intrabox
 //moves.
 class MolTransformBase
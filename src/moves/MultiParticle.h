@@ -8,6 +8,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #define MULTIPARTICLE_H
 
 #include "MoveBase.h"
+#include "DelayedAccept.h"
 #include "System.h"
 #include "StaticVals.h"
 #include <cmath>
@@ -55,6 +56,8 @@ private:
 #endif
   Random123Wrapper &r123wrapper;
   const Molecules& mols;
+  DelayedAccept screen;
+  bool screened;
 
   double GetCoeff();
   void CalculateTrialDistRot();
@@ -71,7 +74,8 @@ inline MultiParticle::MultiParticle(System &sys, StaticVals const &statV) :
 
   newMolsPos(sys.boxDimRef, newCOMs, sys.molLookupRef, sys.prng, statV.mol),
   newCOMs(sys.boxDimRef, newMolsPos, sys.molLookupRef, statV.mol),
-  molLookup(sys.molLookup), r123wrapper(sys.r123wrapper), mols(statV.mol)
+  molLookup(sys.molLookup), r123wrapper(sys.r123wrapper), mols(statV.mol),
+  screen(statV.mpSurrogate), screened(false)
 {
   molTorqueNew.Init(sys.com.Count());
   molTorqueRef.Init(sys.com.Count());
@@ -112,6 +116,7 @@ inline void MultiParticle::PrintAcceptKind()
     printf("%10.5f ", 100.0 * moveSetRef.GetAccept(b, mv::MULTIPARTICLE));
   }
   std::cout << std::endl;
+  screen.PrintRejected("% Screened out MultiParticle ");
 }
 
 
@@ -279,22 +284,85 @@ inline void MultiParticle::CalcEn()
 {
   // Calculate the new force and energy and we will compare that to the
   // reference values in Accept() function
+  //LJ surrogate of the old configuration, while the grid still holds it
+  double surrOld = 0.0;
+  if(screen.IsLJ())
+    surrOld = calcEnRef.BoxLJ(coordCurrRef, boxDimRef, bPick, screen.Cutoff());
+
   cellList.GridAll(boxDimRef, newMolsPos, molLookup);
 
   //back up cached Fourier term
   calcEwald->backupMolCache();
-  //setup reciprocate vectors for new positions
-  calcEwald->BoxReciprocalSetup(bPick, newMolsPos);
-
-  sysPotNew = sysPotRef;
-  //calculate short range energy and force
-  sysPotNew = calcEnRef.BoxForce(sysPotNew, newMolsPos, atomForceNew,
-                                 molForceNew, boxDimRef, bPick);
-  //calculate long range of new electrostatic energy
-  sysPotNew.boxEnergy[bPick].recip = calcEwald->BoxReciprocal(bPick);
-  //Calculate long range of new electrostatic force
-  calcEwald->BoxForceReciprocal(newMolsPos, atomForceRecNew, molForceRecNew,
-                                bPick);
+
+  //Stage one of the delayed acceptance. The proposal ratio needs the forces
+  //at the new positions, so it is left to stage two.
+  screened = false;
+  //the Real surrogate computes the short range energy and force of the
+  //trial, stage two only adds the reciprocal terms
+  bool shortRangeDone = false;
+  if(screen.Enabled()) {
+    double dU;
+    if(screen.IsLJ()) {
+      dU = calcEnRef.BoxLJ(newMolsPos, boxDimRef, bPick, screen.Cutoff()) -
+           surrOld;
+    } else {
+      sysPotNew = calcEnRef.BoxForce(sysPotRef, newMolsPos, atomForceNew,
+                                     molForceNew, boxDimRef, bPick);
+      shortRangeDone = true;
+      dU = DelayedAccept::RealSpace(sysPotNew, bPick) -
+           DelayedAccept::RealSpace(sysPotRef, bPick);
+    }
+    screened = !screen.Screen(1.0, dU, BETA, prng());
+    screen.Record(bPick, !screened);
+    if(screened)
+      return;
+  }
+
+  int threads[2];
+  if(shortRangeDone || !recipSplit.Threads(threads)) {
+    //setup reciprocate vectors for new positions
+    calcEwald->BoxReciprocalSetup(bPick, newMolsPos);
+
+    if(!shortRangeDone) {
+      sysPotNew = sysPotRef;
+      //calculate short range energy and force
+      sysPotNew = calcEnRef.BoxForce(sysPotNew, newMolsPos, atomForceNew,
+                                     molForceNew, boxDimRef, bPick);
+    }
+    //calculate long range of new electrostatic energy
+    sysPotNew.boxEnergy[bPick].recip = calcEwald->BoxReciprocal(bPick);
+    //Calculate long range of new electrostatic force
+    calcEwald->BoxForceReciprocal(newMolsPos, atomForceRecNew, molForceRecNew,
+                                  bPick);
+  } else {
+    //short range and long range terms write to separate force arrays, so
+    //they run on separate thread teams
+    double recipEn = 0.0;
+#ifdef _OPENMP
+    #pragma omp parallel sections num_threads(2)
+    {
+      #pragma omp section
+      {
+        double start = omp_get_wtime();
+        omp_set_num_threads(threads[0]);
+        sysPotNew = calcEnRef.BoxForce(sysPotRef, newMolsPos, atomForceNew,
+                                       molForceNew, boxDimRef, bPick);
+        recipSplit.Record(0, omp_get_wtime() - start, threads[0]);
+      }
+      #pragma omp section
+      {
+        double start = omp_get_wtime();
+        omp_set_num_threads(threads[1]);
+        calcEwald->BoxReciprocalSetup(bPick, newMolsPos);
+        recipEn = calcEwald->BoxReciprocal(bPick);
+        calcEwald->BoxForceReciprocal(newMolsPos, atomForceRecNew,
+                                      molForceRecNew, bPick);
+        recipSplit.Record(1, omp_get_wtime() - start, threads[1]);
+      }
+    }
+#endif
+    sysPotNew.boxEnergy[bPick].recip = recipEn;
+  }
 
   if(moveType == mp::MPROTATE) {
     //Calculate Torque for new positions
@@ -371,14 +439,22 @@ inline void MultiParticle::Accept(const uint rejectState, const uint step)
 {
   // Here we compare the values of reference and trial and decide whether to
   // accept or reject the move
-  double MPCoeff = GetCoeff();
-  double uBoltz = exp(-BETA * (sysPotNew.Total() - sysPotRef.Total()));
-  double accept = MPCoeff * uBoltz;
+  double accept = 0.0;
+  if(!screen.Enabled()) {
+    double MPCoeff = GetCoeff();
+    double uBoltz = exp(-BETA * (sysPotNew.Total() - sysPotRef.Total()));
+    accept = MPCoeff * uBoltz;
+  } else if(!screened) {
+    accept = screen.Correct(GetCoeff(), sysPotNew.Total() - sysPotRef.Total(),
+                            BETA);
+  }
   double pr = prng();
   bool result = (rejectState == mv::fail_state::NO_FAIL) && pr < accept;
   if(result) {
     sysPotRef = sysPotNew;
     swap(coordCurrRef, newMolsPos);
+    dirtyMolRef.MarkAll();
+    rigidPoseRef.InvalidateAll();
     swap(comCurrRef, newCOMs);
     swap(molForceRef, molForceNew);
     swap(atomForceRef, atomForceNew);
@@ -21,6 +21,9 @@ public:
   virtual void PrintAcceptKind();
 private:
   Intermolecular inter_LJ, inter_Real, recip;
+  //trial orientation of a rigid molecule
+  Quaternion newOrient;
+  double pr; //acceptance uniform
 };
 
 void Rotate::PrintAcceptKind()
@@ -47,8 +50,13 @@ inline uint Rotate::Prep(const double subDraw, const double movPerc)
 
 inline uint Rotate::Transform()
 {
-  coordCurrRef.RotateRand(newMolPos, pStart, pLen, m, b,
+  if(rigidPoseRef.Posed(mk)) {
+    rigidPoseRef.RotateRand(newMolPos, newOrient, pStart, pLen, m, b,
                           moveSetRef.Scale(b, mv::ROTATE, mk));
+  } else {
+    coordCurrRef.RotateRand(newMolPos, pStart, pLen, m, b,
+                            moveSetRef.Scale(b, mv::ROTATE, mk));
+  }
   return mv::fail_state::NO_FAIL;
 }
 
@@ -58,11 +66,14 @@ inline void Rotate::CalcEn()
   molRemoved = true;
   overlap = false;
 
-  //calculate LJ interaction and real term of electrostatic interaction
-  overlap = calcEnRef.MoleculeInter(inter_LJ, inter_Real, newMolPos, m, b);
-  if(!overlap) {
-    //calculate reciprocate term of electrostatic interaction
-    recip.energy = calcEwald->MolReciprocal(newMolPos, m, b);
+  //calculate LJ interaction, real and reciprocate terms of electrostatic
+  //interaction
+  if(earlyReject) {
+    pr = prng();
+    overlap = MoleculeInterEarly(inter_LJ, inter_Real, recip, newMolPos, m, b,
+                                 pr);
+  } else {
+    overlap = MoleculeInterRecip(inter_LJ, inter_Real, recip, newMolPos, m, b);
   }
 }
 
@@ -71,7 +82,9 @@ inline void Rotate::Accept(const uint rejectState, const uint step)
   bool res = false;
 
   if(rejectState == mv::fail_state::NO_FAIL) {
-    double pr = prng();
+    //with early rejection pr was drawn in CalcEn
+    if(!earlyReject)
+      pr = prng();
     res = pr < exp(-BETA * (inter_LJ.energy + inter_Real.energy +
                             recip.energy));
   }
@@ -88,6 +101,9 @@ inline void Rotate::Accept(const uint rejectState, const uint step)
 
     //Copy coords
     newMolPos.CopyRange(coordCurrRef, 0, pStart, pLen);
+    dirtyMolRef.Mark(m);
+    if(rigidPoseRef.Posed(mk))
+      rigidPoseRef.Set(m, newOrient);
     calcEwald->UpdateRecip(b);
 
     sysPotRef.Total();
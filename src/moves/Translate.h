@@ -27,6 +27,9 @@ public:
 private:
   Intermolecular inter_LJ, inter_Real, recip;
   XYZ newCOM;
+  //orientation of a rigid molecule, a displacement keeps it
+  Quaternion orient;
+  double pr; //acceptance uniform
 };
 
 void Translate::PrintAcceptKind()
@@ -56,8 +59,14 @@ inline uint Translate::Prep(const double subDraw, const double movPerc)
 
 inline uint Translate::Transform()
 {
-  coordCurrRef.TranslateRand(newMolPos, newCOM, pStart, pLen,
+  if(rigidPoseRef.Posed(mk)) {
+    orient = rigidPoseRef.Orientation(m, b);
+    rigidPoseRef.TranslateRand(newMolPos, newCOM, pStart, pLen,
                              m, b, moveSetRef.Scale(b, mv::DISPLACE, mk));
+  } else {
+    coordCurrRef.TranslateRand(newMolPos, newCOM, pStart, pLen,
+                               m, b, moveSetRef.Scale(b, mv::DISPLACE, mk));
+  }
   return mv::fail_state::NO_FAIL;
 }
 
@@ -67,11 +76,14 @@ inline void Translate::CalcEn()
   molRemoved = true;
   overlap = false;
 
-  //calculate LJ interaction and real term of electrostatic interaction
-  overlap = calcEnRef.MoleculeInter(inter_LJ, inter_Real, newMolPos, m, b);
-  if(!overlap) {
-    //calculate reciprocate term of electrostatic interaction
-    recip.energy = calcEwald->MolReciprocal(newMolPos, m, b);
+  //calculate LJ interaction, real and reciprocate terms of electrostatic
+  //interaction
+  if(earlyReject) {
+    pr = prng();
+    overlap = MoleculeInterEarly(inter_LJ, inter_Real, recip, newMolPos, m, b,
+                                 pr);
+  } else {
+    overlap = MoleculeInterRecip(inter_LJ, inter_Real, recip, newMolPos, m, b);
   }
 }
 
@@ -79,7 +91,9 @@ inline void Translate::Accept(const uint rejectState, const uint step)
 {
   bool res = false;
   if (rejectState == mv::fail_state::NO_FAIL) {
-    double pr = prng();
+    //with early rejection pr was drawn in CalcEn
+    if(!earlyReject)
+      pr = prng();
     res = pr < exp(-BETA * (inter_LJ.energy + inter_Real.energy +
                             recip.energy));
   }
@@ -96,6 +110,9 @@ inline void Translate::Accept(const uint rejectState, const uint step)
 
     //Copy coords
     newMolPos.CopyRange(coordCurrRef, 0, pStart, pLen);
+    dirtyMolRef.Mark(m);
+    if(rigidPoseRef.Posed(mk))
+      rigidPoseRef.Set(m, orient);
     comCurrRef.Set(m, newCOM);
     calcEwald->UpdateRecip(b);
 
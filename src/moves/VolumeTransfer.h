@@ -8,6 +8,7 @@ along with this program, also can be found at <http://www.gnu.org/licenses/>.
 #define VOLUMETRANSFER_H
 
 #include "MoveBase.h" //For uint.
+#include "DelayedAccept.h"
 
 #ifdef GOMC_CUDA
 #include "ConstantDefinitionsCUDAKernel.cuh"
@@ -27,6 +28,9 @@ public:
   virtual void Accept(const uint rejectState, const uint step);
   virtual void PrintAcceptKind();
 private:
+  BoxDimensions & NewDim();
+  bool ScreenOut(const double dU);
+
   //Note: This is only used for GEMC-NVT
   uint bPick[2];
   //Note: This is only used for GEMC-NPT and NPT
@@ -42,6 +46,10 @@ private:
   const double PRESSURE;
   bool regrewGrid, isOrth;
   bool fixBox0;
+  //number of boxes changed by the move and their index
+  uint nBox, *boxes;
+  DelayedAccept screen;
+  bool screened;
 };
 
 inline VolumeTransfer::VolumeTransfer(System &sys, StaticVals const& statV)  :
@@ -51,12 +59,15 @@ inline VolumeTransfer::VolumeTransfer(System &sys, StaticVals const& statV)  :
   newDim(), newDimNonOrth(),
   newCOMs(sys.boxDimRef, newMolsPos, sys.molLookupRef,
           statV.mol), GEMC_KIND(statV.kindOfGEMC),
-  PRESSURE(statV.pressure), regrewGrid(false)
+  PRESSURE(statV.pressure), regrewGrid(false),
+  screen(statV.volSurrogate), screened(false)
 {
   newMolsPos.Init(sys.coordinates.Count());
   newCOMs.Init(statV.mol.count);
   isOrth = statV.isOrthogonal;
   fixBox0 = statV.fixVolBox0;
+  nBox = (GEMC_KIND == mv::GEMC_NVT ? 2 : 1);
+  boxes = (GEMC_KIND == mv::GEMC_NVT ? bPick : &box);
 }
 
 void VolumeTransfer::PrintAcceptKind()
@@ -66,6 +77,15 @@ void VolumeTransfer::PrintAcceptKind()
     printf("%10.5f ", 100.0 * moveSetRef.GetAccept(b, mv::VOL_TRANSFER));
   }
   std::cout << std::endl;
+  screen.PrintRejected("% Screened out Volume-Transfer ");
+}
+
+inline BoxDimensions & VolumeTransfer::NewDim()
+{
+  if(isOrth)
+    return newDim;
+  else
+    return newDimNonOrth;
 }
 
 inline uint VolumeTransfer::Prep(const double subDraw, const double movePerc)
@@ -135,64 +155,100 @@ inline uint VolumeTransfer::Transform()
 
 inline void VolumeTransfer::CalcEn()
 {
-  if (GEMC_KIND == mv::GEMC_NVT) {
-    if(isOrth) {
-      cellList.GridAll(newDim, newMolsPos, molLookRef);
-    } else {
-      cellList.GridAll(newDimNonOrth, newMolsPos, molLookRef);
+  BoxDimensions & dim = NewDim();
+  //LJ surrogate of the old configuration, while the grid still holds it
+  double surrOld = 0.0;
+  if(screen.IsLJ()) {
+    for(uint b = 0; b < nBox; b++) {
+      surrOld += calcEnRef.BoxLJ(coordCurrRef, boxDimRef, boxes[b],
+                                 screen.Cutoff());
     }
+  }
+
+  if (GEMC_KIND == mv::GEMC_NVT) {
+    cellList.GridAll(dim, newMolsPos, molLookRef);
   } else {
-    if(isOrth) {
-      cellList.GridBox(newDim, newMolsPos, molLookRef, box);
-    } else {
-      cellList.GridBox(newDimNonOrth, newMolsPos, molLookRef, box);
-    }
+    cellList.GridBox(dim, newMolsPos, molLookRef, box);
   }
 
   regrewGrid = true;
   //back up cached Fourier term
   calcEwald->backupMolCache();
   sysPotNew = sysPotRef;
+  screened = false;
 
-  if (GEMC_KIND == mv::GEMC_NVT) {
-    for(uint b = 0; b < 2; b++) {
-      //calculate new K vectors
-      if(isOrth) {
-        calcEwald->RecipInit(bPick[b], newDim);
-        //setup reciprocate terms
-        calcEwald->BoxReciprocalSetup(bPick[b], newMolsPos);
-        sysPotNew = calcEnRef.BoxInter(sysPotNew, newMolsPos, newDim, bPick[b]);
-      } else {
-        calcEwald->RecipInit(bPick[b], newDimNonOrth);
-        //setup reciprocate terms
-        calcEwald->BoxReciprocalSetup(bPick[b], newMolsPos);
-        sysPotNew = calcEnRef.BoxInter(sysPotNew, newMolsPos, newDimNonOrth,
-                                       bPick[b]);
-      }
-      //calculate reciprocate term of electrostatic interaction
-      sysPotNew.boxEnergy[bPick[b]].recip = calcEwald->BoxReciprocal(bPick[b]);
+  if(screen.IsLJ()) {
+    double surrNew = 0.0;
+    for(uint b = 0; b < nBox; b++) {
+      surrNew += calcEnRef.BoxLJ(newMolsPos, dim, boxes[b], screen.Cutoff());
     }
-  } else {
-    //calculate new K vectors
-    if(isOrth) {
-      calcEwald->RecipInit(box, newDim);
-      //setup reciprocate terms
-      calcEwald->BoxReciprocalSetup(box, newMolsPos);
-      sysPotNew = calcEnRef.BoxInter(sysPotNew, newMolsPos, newDim, box);
-    } else {
-      calcEwald->RecipInit(box, newDimNonOrth);
-      //setup reciprocate terms
-      calcEwald->BoxReciprocalSetup(box, newMolsPos);
-      sysPotNew = calcEnRef.BoxInter(sysPotNew, newMolsPos, newDimNonOrth, box);
+    if(ScreenOut(surrNew - surrOld))
+      return;
+  }
+
+  //each box works on its own copy, so both boxes can run concurrently
+  SystemPotential boxPot[2];
+  double recip[2];
+  int threads[2];
+  bool concurrent = (nBox == 2) &&
+                    calcEnRef.BoxThreads(threads, bPick[0], bPick[1]);
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(2) schedule(static, 1) if(concurrent)
+#endif
+  for(uint b = 0; b < nBox; b++) {
+#ifdef _OPENMP
+    if(concurrent)
+      omp_set_num_threads(threads[b]);
+#endif
+    boxPot[b] = calcEnRef.BoxInter(sysPotNew, newMolsPos, dim, boxes[b]);
+  }
+  for(uint b = 0; b < nBox; b++) {
+    sysPotNew.boxEnergy[boxes[b]] = boxPot[b].boxEnergy[boxes[b]];
+    sysPotNew.boxVirial[boxes[b]] = boxPot[b].boxVirial[boxes[b]];
+  }
+
+  //real space is final here, only the reciprocal term is left out
+  if(screen.IsReal()) {
+    double dU = 0.0;
+    for(uint b = 0; b < nBox; b++) {
+      dU += DelayedAccept::RealSpace(sysPotNew, boxes[b]) -
+            DelayedAccept::RealSpace(sysPotRef, boxes[b]);
     }
+    if(ScreenOut(dU))
+      return;
+  }
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(2) schedule(static, 1) if(concurrent)
+#endif
+  for(uint b = 0; b < nBox; b++) {
+#ifdef _OPENMP
+    if(concurrent)
+      omp_set_num_threads(threads[b]);
+#endif
+    //calculate new K vectors
+    calcEwald->RecipInit(boxes[b], dim);
+    //setup reciprocate terms
+    calcEwald->BoxReciprocalSetup(boxes[b], newMolsPos);
     //calculate reciprocate term of electrostatic interaction
-    sysPotNew.boxEnergy[box].recip = calcEwald->BoxReciprocal(box);
+    recip[b] = calcEwald->BoxReciprocal(boxes[b]);
+  }
+  for(uint b = 0; b < nBox; b++) {
+    sysPotNew.boxEnergy[boxes[b]].recip = recip[b];
   }
 
   sysPotNew.Total();
 }
 
-
+//Stage one of the delayed acceptance, returns true if the trial is rejected
+inline bool VolumeTransfer::ScreenOut(const double dU)
+{
+  screened = !screen.Screen(GetCoeff(), dU, BETA, prng());
+  for(uint b = 0; b < nBox; b++) {
+    screen.Record(boxes[b], !screened);
+  }
+  return screened;
+}
 
 inline double VolumeTransfer::GetCoeff() const
 {
@@ -229,8 +285,14 @@ inline double VolumeTransfer::GetCoeff() const
 inline void VolumeTransfer::Accept(const uint rejectState, const uint step)
 {
   double volTransCoeff = GetCoeff();
-  double uBoltz = exp(-BETA * (sysPotNew.Total() - sysPotRef.Total()));
-  double accept = volTransCoeff * uBoltz;
+  double accept = 0.0;
+  if(!screen.Enabled()) {
+    double uBoltz = exp(-BETA * (sysPotNew.Total() - sysPotRef.Total()));
+    accept = volTransCoeff * uBoltz;
+  } else if(!screened) {
+    accept = screen.Correct(volTransCoeff,
+                            sysPotNew.Total() - sysPotRef.Total(), BETA);
+  }
   bool result = (rejectState == mv::fail_state::NO_FAIL) && prng() < accept;
   if (result) {
     //Set new energy.
@@ -239,6 +301,8 @@ inline void VolumeTransfer::Accept(const uint rejectState, const uint step)
     //NOTE:
     //This will be less efficient for NPT, but necessary evil.
     swap(coordCurrRef, newMolsPos);
+    dirtyMolRef.MarkAll();
+    rigidPoseRef.InvalidateAll();
     swap(comCurrRef, newCOMs);
     if(isOrth)
       boxDimRef = newDim;
@@ -0,0 +1,199 @@
+/*******************************************************************************
+GPU OPTIMIZED MONTE CARLO (GOMC) 2.70
+Copyright (C) 2018  GOMC Group
+A copy of the GNU General Public License can be found in the COPYRIGHT.txt
+along with this program, also can be found at <http://www.gnu.org/licenses/>.
+********************************************************************************/
+//Reads the binary time series files written with StatisticsFormat BINARY
+//or BOTH. Prints the metadata as #key = value lines, then the rows as CSV,
+//or the count, mean, standard deviation, minimum and maximum of each
+//column.
+//
+//  GOMC_TimeSeries <file.bin> [csv | stats]
+#include "TimeSeriesConst.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace time_series;
+
+namespace
+{
+bool ReadUint(FILE * inF, uint32_t & value)
+{
+  char data[sizeof(uint32_t)];
+  if (fread(data, 1, sizeof(data), inF) != sizeof(data))
+    return false;
+  Swap(&value, data, sizeof(uint32_t));
+  return true;
+}
+
+bool ReadString(FILE * inF, std::string & str)
+{
+  uint32_t length;
+  if (!ReadUint(inF, length))
+    return false;
+  str.resize(length);
+  return length == 0 || fread(&str[0], 1, length, inF) == length;
+}
+
+bool ReadHeader(FILE * inF, std::vector<std::string> & columns,
+                std::vector<std::string> & metadata)
+{
+  char magic[sizeof(MAGIC)];
+  uint32_t version, count;
+  if (fread(magic, 1, sizeof(magic), inF) != sizeof(magic) ||
+      memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+    fprintf(stderr, "Error: Not a GOMC time series file\n");
+    return false;
+  }
+  if (!ReadUint(inF, version) || version < 1 || version > VERSION) {
+    fprintf(stderr, "Error: Unsupported time series version\n");
+    return false;
+  }
+  //Key and value of each entry, one after the other
+  if (version >= 2) {
+    if (!ReadUint(inF, count))
+      return false;
+    metadata.resize(2 * count);
+    for (uint32_t m = 0; m < metadata.size(); ++m) {
+      if (!ReadString(inF, metadata[m]))
+        return false;
+    }
+  }
+  if (!ReadUint(inF, count))
+    return false;
+  columns.resize(count);
+  for (uint32_t c = 0; c < count; ++c) {
+    if (!ReadString(inF, columns[c]))
+      return false;
+  }
+  return true;
+}
+
+//Reads the next chunk into values, column by column. False at the end of
+//the file, or after a chunk cut short by a run that did not finish.
+bool ReadChunk(FILE * inF, const size_t count, uint32_t & rows,
+               std::vector<double> & values)
+{
+  if (!ReadUint(inF, rows))
+    return false;
+  std::vector<char> data(rows * count * sizeof(double));
+  if (fread(data.data(), 1, data.size(), inF) != data.size()) {
+    fprintf(stderr, "Warning: Skipped incomplete chunk of %u rows\n", rows);
+    return false;
+  }
+  values.resize(rows * count);
+  for (size_t v = 0; v < values.size(); ++v)
+    Swap(&values[v], &data[v * sizeof(double)], sizeof(double));
+  return true;
+}
+
+//Column names such as DelE(L->(0.0000,0.1000)) hold commas, so they are
+//quoted
+void PrintName(std::string const& name)
+{
+  printf("\"");
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (name[i] == '"')
+      printf("\"\"");
+    else
+      printf("%c", name[i]);
+  }
+  printf("\"");
+}
+
+void PrintCSV(std::vector<std::string> const& columns,
+              uint32_t rows, std::vector<double> const& values)
+{
+  for (uint32_t r = 0; r < rows; ++r) {
+    for (size_t c = 0; c < columns.size(); ++c) {
+      printf(c == 0 ? "%.17g" : ",%.17g", values[c * rows + r]);
+    }
+    printf("\n");
+  }
+}
+
+//Running sums of one column, with the mean and variance updated as in
+//Welford's method
+struct Summary {
+  Summary() : count(0), mean(0.0), m2(0.0), min(HUGE_VAL), max(-HUGE_VAL) {}
+  void Add(const double value)
+  {
+    const double delta = value - mean;
+    ++count;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+    if (value < min)
+      min = value;
+    if (value > max)
+      max = value;
+  }
+  unsigned long count;
+  double mean, m2, min, max;
+};
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Usage: %s <file.bin> [csv | stats]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  std::string mode = (argc == 3 ? argv[2] : "csv");
+  if (mode != "csv" && mode != "stats") {
+    fprintf(stderr, "Error: Unknown mode %s, use csv or stats\n",
+            mode.c_str());
+    return EXIT_FAILURE;
+  }
+  FILE * inF = fopen(argv[1], "rb");
+  if (inF == NULL) {
+    fprintf(stderr, "Error opening time series file %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+  std::vector<std::string> columns, metadata;
+  if (!ReadHeader(inF, columns, metadata)) {
+    fprintf(stderr, "Error reading the header of %s\n", argv[1]);
+    fclose(inF);
+    return EXIT_FAILURE;
+  }
+
+  const bool csv = (mode == "csv");
+  std::vector<Summary> summary(columns.size());
+  std::vector<double> values;
+  uint32_t rows;
+  for (size_t m = 0; m < metadata.size(); m += 2)
+    printf("#%s = %s\n", metadata[m].c_str(), metadata[m + 1].c_str());
+  if (csv) {
+    for (size_t c = 0; c < columns.size(); ++c) {
+      if (c != 0)
+        printf(",");
+      PrintName(columns[c]);
+    }
+    printf("\n");
+  }
+  while (ReadChunk(inF, columns.size(), rows, values)) {
+    if (csv) {
+      PrintCSV(columns, rows, values);
+    } else {
+      for (size_t c = 0; c < columns.size(); ++c)
+        for (uint32_t r = 0; r < rows; ++r)
+          summary[c].Add(values[c * rows + r]);
+    }
+  }
+  fclose(inF);
+
+  if (!csv) {
+    printf("%-30s %12s %20s %20s %20s %20s\n", "#COLUMN", "COUNT", "MEAN",
+           "STDDEV", "MIN", "MAX");
+    for (size_t c = 0; c < columns.size(); ++c) {
+      Summary const& s = summary[c];
+      double stddev = (s.count > 1 ? sqrt(s.m2 / (s.count - 1)) : 0.0);
+      printf("%-30s %12lu %20.10e %20.10e %20.10e %20.10e\n",
+             columns[c].c_str(), s.count, s.mean, stddev, s.min, s.max);
+    }
+  }
+  return EXIT_SUCCESS;
+}